@@ -66,9 +66,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  * between 2 to 4 minutes on most of the systems. */
 #define CONNECTION_CLEANUP_RETRY_TIMEOUT_MS (MAX_HW_TIME_US / 1000 * 240)
 
-/* PID associated with Connection currently being purged by Cleanup thread */
-static IMG_PID gCurrentPurgeConnectionPid;
-
 static PVRSRV_ERROR ConnectionDataDestroy(CONNECTION_DATA *psConnection)
 {
 	PVRSRV_ERROR eError;
@@ -329,7 +326,7 @@ static PVRSRV_ERROR _CleanupThreadPurgeConnectionData(void *pvConnectionData)
 	PVRSRV_ERROR eErrorConnection, eErrorKernel;
 	CONNECTION_DATA *psConnectionData = pvConnectionData;
 
-	gCurrentPurgeConnectionPid = psConnectionData->pid;
+	PVRSRVCleanupThreadSetPurgePid(psConnectionData->pid);
 
 	eErrorConnection = ConnectionDataDestroy(psConnectionData);
 	if (eErrorConnection != PVRSRV_OK)
@@ -350,7 +347,7 @@ static PVRSRV_ERROR _CleanupThreadPurgeConnectionData(void *pvConnectionData)
 	eErrorKernel = PVRSRVPurgeHandles(KERNEL_HANDLE_BASE);
 	PVR_LOG_IF_ERROR(eErrorKernel, "PVRSRVPurgeHandles");
 
-	gCurrentPurgeConnectionPid = 0;
+	PVRSRVCleanupThreadSetPurgePid(0);
 
 	return eErrorConnection;
 }
@@ -426,7 +423,7 @@ void PVRSRVCommonConnectionDisconnect(void *pvDataPtr)
 
 IMG_PID PVRSRVGetPurgeConnectionPid(void)
 {
-	return gCurrentPurgeConnectionPid;
+	return PVRSRVCleanupThreadGetPurgePid();
 }
 
 /* Prefix for debug messages about Active Connections */
@@ -523,6 +520,24 @@ void PVRSRVConnectionDebugNotify(PVRSRV_DEVICE_NODE *psDevNode,
 		}
 #undef MAX_DEBUG_DUMP_STRING_LEN
 #undef MAX_DEBUG_DUMP_CONNECTIONS_PER_LINE
+
+		/* Handle base lock contention per connection */
+		dllist_foreach_node(&psDevNode->sConnections, pNode, pNext)
+		{
+			CONNECTION_DATA *sData = IMG_CONTAINER_OF(pNode, CONNECTION_DATA, sConnectionListNode);
+			PVRSRV_HANDLE_BASE_STATS sStats;
+
+			if (sData->psHandleBase == NULL)
+			{
+				continue;
+			}
+
+			PVRSRVGetHandleBaseStats(sData->psHandleBase, &sStats);
+			PVR_DUMPDEBUG_LOG(" P%d-T%d handle lock: %" IMG_UINT64_FMTSPEC " acquired, "
+			                  "lockless lookups: %u (%u fallbacks)",
+			                  sData->pid, sData->tid, sStats.ui64LockAcquired,
+			                  sStats.ui32LocklessLookups, sStats.ui32LocklessFallbacks);
+		}
 	}
 	OSLockRelease(psDevNode->hConnectionsLock);
 }
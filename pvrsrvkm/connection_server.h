@@ -120,7 +120,8 @@ void PVRSRVCommonConnectionDisconnect(void *pvPrivData);
 @Function       PVRSRVGetPurgeConnectionPid
 
 @Description    Returns PID associated with Connection currently being purged by
-                Cleanup Thread. If no Connection is purged 0 is returned.
+                the calling Cleanup Thread worker. If the caller is not a
+                worker or no Connection is purged 0 is returned.
 
 @Return         PID associated with currently purged connection or 0 if no
                 connection is being purged
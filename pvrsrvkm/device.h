@@ -309,6 +309,18 @@ typedef struct _LISR_EXECUTION_INFO_
 #define UPDATE_MISR_DBG_COUNTER()
 #endif /* defined(PVRSRV_DEBUG_LISR_EXECUTION) */
 
+/* Number of cleanup queues per device, one per PVRSRV_CLEANUP_PRIORITY class */
+#define PVRSRV_CLEANUP_QUEUE_COUNT 3
+
+/* Cleanup thread work queue. Protected by the PVRSRV_DATA cleanup work list
+ * lock. */
+typedef struct _PVRSRV_CLEANUP_QUEUE_
+{
+	DLLIST_NODE sWorkList;   /*!< Items ready to be processed, in queue order */
+	DLLIST_NODE sRetryList;  /*!< Items waiting for their retry time after a failed attempt */
+	IMG_BOOL    bBusy;       /*!< Set while a cleanup worker is processing items of the queue */
+} PVRSRV_CLEANUP_QUEUE;
+
 typedef struct _PVRSRV_DEVICE_NODE_
 {
 	PVRSRV_DEVICE_IDENTIFIER	sDevId;
@@ -378,6 +390,11 @@ typedef struct _PVRSRV_DEVICE_NODE_
 
 	PVRSRV_ERROR (*pfnMMUCacheInvalidateKickAndWait)(struct _PVRSRV_DEVICE_NODE_ *psDevNode);
 
+	/* Callback pfnMMUCacheInvalidateKickDeferred may be NULL, in which case
+	 * callers fall back to pfnMMUCacheInvalidateKick */
+	PVRSRV_ERROR (*pfnMMUCacheInvalidateKickDeferred)(struct _PVRSRV_DEVICE_NODE_ *psDevNode,
+	                                                  IMG_UINT32 *pui32NextMMUInvalidateUpdate);
+
 	IMG_UINT32 (*pfnMMUCacheGetInvalidateCounter)(struct _PVRSRV_DEVICE_NODE_ *psDevNode);
 
 	/* Callback pfnMMUTopLevelPxWorkarounds may be NULL if not required */
@@ -541,6 +558,7 @@ typedef struct _PVRSRV_DEVICE_NODE_
 	IMG_UINT32				ui32SyncCheckpointRecordCount;
 	IMG_UINT32				ui32SyncCheckpointRecordCountHighWatermark;
 	DLLIST_NODE				sSyncCheckpointRecordList;
+	struct _HASH_TABLE_		*psSyncCheckpointRecordHash; /*!< Live records indexed by FW address */
 	struct SYNC_CHECKPOINT_RECORD	*apsSyncCheckpointRecordsFreed[PVRSRV_FULL_SYNC_TRACKING_HISTORY_LEN];
 	IMG_UINT32				uiSyncCheckpointRecordFreeIdx;
 
@@ -560,6 +578,7 @@ typedef struct _PVRSRV_DEVICE_NODE_
 	IMG_HANDLE				hDbgReqNotify;
 	IMG_HANDLE				hAppHintDbgReqNotify;
 	IMG_HANDLE				hPhysHeapDbgReqNotify;
+	IMG_HANDLE				hMMUDbgReqNotify;
 
 	/* Device MMU common module can support one other larger page size
 	 * (e.g. 16KB) in addition to the default OS page size (often 4KB).
@@ -572,6 +591,12 @@ typedef struct _PVRSRV_DEVICE_NODE_
 	PVRSRV_DEF_PAGE			sScratchPage;
 	PVRSRV_DEF_PAGE			sDevZeroPage;
 
+	/* PTE write statistics for MMU_MapPMRFast(), see MMU_MAP_STATS */
+	MMU_MAP_STATS			sMMUMapStats;
+
+	/* MMU cache invalidate batching state, see MMU_CACHE_INVAL_STATS */
+	MMU_CACHE_INVAL_STATS	sMMUCacheInvalStats;
+
 	/* Lock protects access to sMemoryContextPageFaultNotifyListHead and
 	 * per memory context DEVMEMINT_CTX::sProcessNotifyListHead lists. */
 	POSWR_LOCK				hPageFaultNotifyLock;
@@ -630,7 +655,7 @@ typedef struct _PVRSRV_DEVICE_NODE_
 	IMG_BOOL                bEnablePFDebug;      /*!< EnablePageFaultDebug AppHint setting for device */
 	IMG_BOOL                bCleanupThreadDisabled; /*!< Set to disable further Cleanup queue requests for device */
 
-	DLLIST_NODE             sCleanupThreadWorkList; /*!< List of work for the cleanup thread associated with the device */
+	PVRSRV_CLEANUP_QUEUE    asCleanupQueue[PVRSRV_CLEANUP_QUEUE_COUNT]; /*!< Cleanup work queues of the device, one per priority class */
 	ATOMIC_T                i32NumCleanupItems;   /*!< Number of cleanup thread work items. Includes items being freed. */
 #if defined(SUPPORT_PMR_DEFERRED_FREE)
 	/* Data for the deferred freeing of a PMR physical pages for a given device */
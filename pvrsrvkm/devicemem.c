@@ -951,7 +951,9 @@ DevmemCreateHeap(DEVMEM_CONTEXT *psCtx,
 	 * Granularity has been chosen to support the max possible practically used OS page size. */
 	PVR_LOG_RETURN_IF_INVALID_PARAM((uiReservedRegionLength % DEVMEM_HEAP_RESERVED_SIZE_GRANULARITY) == 0, "uiReservedRegionLength");
 
-	ui32PolicyVMRA = RA_POLICY_DEFAULT;
+	/* The device virtual address arena of a heap sees many differently
+	 * aligned imports, index its free segments by size */
+	ui32PolicyVMRA = RA_POLICY_DEFAULT | RA_POLICY_FREE_INDEX_TREE;
 
 	PVR_ASSERT(uiReservedRegionLength + DEVMEM_HEAP_MINIMUM_SIZE <= uiLength);
 
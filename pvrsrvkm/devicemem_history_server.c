@@ -71,8 +71,28 @@ typedef uint16_t ALLOC_INDEX_T;
 typedef uint32_t ALLOC_INDEX_T;
 #endif
 
+/* the most recent map or unmap of an allocation, kept alongside the
+ * allocation so that the VA index can answer queries without walking
+ * the circular buffer
+ */
+typedef struct _RECORD_EVENT_
+{
+	/* time stamp of the command (masked as for COMMAND_TIMESTAMP) */
+	IMG_UINT64 ui64Time;
+	/* page range for MAP_RANGE/UNMAP_RANGE commands */
+	IMG_UINT32 ui32StartPage;
+	IMG_UINT32 ui32PageCount;
+	/* COMMAND_TYPE of the command, COMMAND_TYPE_NONE if there was none */
+	IMG_UINT8 ui8Type;
+} RECORD_EVENT;
+
+#define RECORD_EVENT_MAP   0
+#define RECORD_EVENT_UNMAP 1
+#define RECORD_EVENT_COUNT 2
+
 /* a record describing a single allocation known to DeviceMemHistory.
- * this is an element in a doubly linked list of allocations
+ * this is an element in a doubly linked list of allocations and a node
+ * of the VA index
  */
 typedef struct _RECORD_ALLOCATION_
 {
@@ -92,6 +112,15 @@ typedef struct _RECORD_ALLOCATION_
 	ALLOC_INDEX_T ui32Prev;
 	/* index of next allocation in the list */
 	ALLOC_INDEX_T ui32Next;
+	/* children of this allocation in the VA index */
+	ALLOC_INDEX_T uiVAIdxLeft;
+	ALLOC_INDEX_T uiVAIdxRight;
+	/* height of this allocation's subtree, 0 if it is not in the VA index */
+	IMG_UINT8 ui8VAIdxHeight;
+	/* highest end address (exclusive) in this allocation's subtree */
+	IMG_UINT64 ui64VAIdxMaxEnd;
+	/* most recent map and unmap of this allocation */
+	RECORD_EVENT asLastEvent[RECORD_EVENT_COUNT];
 	/* annotation/name of this allocation */
 	IMG_CHAR szName[DEVMEM_ANNOTATION_MAX_LEN];
 } RECORD_ALLOCATION;
@@ -196,6 +225,8 @@ typedef struct __attribute__((__packed__))_COMMAND_WRAPPER_
 #define END_OF_LIST 0xFFFFFFFF
 #define ALLOC_INDEX_TO_PTR(psDevHData, idx) (&((psDevHData)->sRecords.pasAllocations[idx]))
 #define CHECK_ALLOC_INDEX(idx) (idx < ALLOCATION_LIST_NUM_ENTRIES)
+/* index value denoting no child in the VA index */
+#define VA_INDEX_NONE ((IMG_UINT32)(ALLOC_INDEX_T)~0U)
 
 /* wrapper structure for the allocation records and the commands circular buffer */
 typedef struct _RECORDS_
@@ -214,6 +245,16 @@ typedef struct _RECORDS_
 	IMG_UINT64 ui64MapRangeCount;//Incremented by InsertMapRangeCommand()
 	IMG_UINT64 ui64UnMapRangeCount;//Incremented by InsertUnmapRangeCommand()
 	IMG_UINT64 ui64TimeStampCount;//Incremented by InsertTimeStampCommand()
+
+	/* root of the VA index: an AVL tree of the allocation records ordered
+	 * by base DevVAddr, augmented with the highest end address of each
+	 * subtree so that it can be searched as an interval tree */
+	IMG_UINT32 ui32VAIndexRoot;
+	/* Query statistics, to compare the VA index against the buffer walk */
+	IMG_UINT64 ui64IndexQueryCount;
+	IMG_UINT64 ui64IndexQueryTimeNs;
+	IMG_UINT64 ui64WalkQueryCount;
+	IMG_UINT64 ui64WalkQueryTimeNs;
 } RECORDS;
 
 typedef struct _DEVICEMEM_HISTORY_DATA_
@@ -427,6 +468,34 @@ static void EmitPDumpMapUnmapRange(PVRSRV_DEVICE_NODE *psDeviceNode,
 
 #endif
 
+/* RecordAllocationEvent:
+ * Remember the given map/unmap command as the most recent one of its kind
+ * for the allocation, for use by the VA index
+ */
+static void RecordAllocationEvent(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                  IMG_UINT32 ui32AllocIndex,
+                                  COMMAND_TYPE eType,
+                                  IMG_UINT32 ui32StartPage,
+                                  IMG_UINT32 ui32Count)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32AllocIndex);
+	RECORD_EVENT *psEvent;
+
+	if ((eType == COMMAND_TYPE_MAP_ALL) || (eType == COMMAND_TYPE_MAP_RANGE))
+	{
+		psEvent = &psAlloc->asLastEvent[RECORD_EVENT_MAP];
+	}
+	else
+	{
+		psEvent = &psAlloc->asLastEvent[RECORD_EVENT_UNMAP];
+	}
+
+	psEvent->ui64Time = DO_TIME_STAMP_MASK(OSClockns64());
+	psEvent->ui32StartPage = ui32StartPage;
+	psEvent->ui32PageCount = ui32Count;
+	psEvent->ui8Type = eType;
+}
+
 /* InsertTimeStampCommand:
  * Insert a timestamp command into the circular buffer.
  */
@@ -466,6 +535,7 @@ static void InsertMapAllCommand(PVRSRV_DEVICE_NODE *psDeviceNode,
 	psCommand->ui8Type = COMMAND_TYPE_MAP_ALL;
 	psCommand->u.sMapAll.uiAllocIndex = ui32AllocIndex;
 	psDevHData->sRecords.ui64MapAllCount++;
+	RecordAllocationEvent(psDevHData, ui32AllocIndex, COMMAND_TYPE_MAP_ALL, 0, 0);
 
 #if defined(PDUMP)
 	EmitPDumpMapUnmapAll(psDeviceNode, COMMAND_TYPE_MAP_ALL, ui32AllocIndex);
@@ -491,6 +561,7 @@ static void InsertUnmapAllCommand(PVRSRV_DEVICE_NODE *psDeviceNode,
 	psCommand->ui8Type = COMMAND_TYPE_UNMAP_ALL;
 	psCommand->u.sUnmapAll.uiAllocIndex = ui32AllocIndex;
 	psDevHData->sRecords.ui64UnMapAllCount++;
+	RecordAllocationEvent(psDevHData, ui32AllocIndex, COMMAND_TYPE_UNMAP_ALL, 0, 0);
 
 #if defined(PDUMP)
 	EmitPDumpMapUnmapAll(psDeviceNode, COMMAND_TYPE_UNMAP_ALL, ui32AllocIndex);
@@ -572,6 +643,7 @@ static void InsertMapRangeCommand(PVRSRV_DEVICE_NODE *psDeviceNode,
 	psCommand->ui8Type = COMMAND_TYPE_MAP_RANGE;
 	psCommand->u.sMapRange.uiAllocIndex = ui32AllocIndex;
 	psDevHData->sRecords.ui64MapRangeCount++;
+	RecordAllocationEvent(psDevHData, ui32AllocIndex, COMMAND_TYPE_MAP_RANGE, ui32StartPage, ui32Count);
 
 	MapRangePack(&psCommand->u.sMapRange, ui32StartPage, ui32Count);
 
@@ -606,6 +678,7 @@ static void InsertUnmapRangeCommand(PVRSRV_DEVICE_NODE *psDeviceNode,
 	psCommand->ui8Type = COMMAND_TYPE_UNMAP_RANGE;
 	psCommand->u.sMapRange.uiAllocIndex = ui32AllocIndex;
 	psDevHData->sRecords.ui64UnMapRangeCount++;
+	RecordAllocationEvent(psDevHData, ui32AllocIndex, COMMAND_TYPE_UNMAP_RANGE, ui32StartPage, ui32Count);
 
 	MapRangePack(&psCommand->u.sMapRange, ui32StartPage, ui32Count);
 
@@ -760,6 +833,250 @@ static IMG_UINT32 GetFreeAllocation(DEVICEMEM_HISTORY_DATA *psDevHData)
 }
 
 
+static INLINE IMG_UINT64 VAIndexEnd(const RECORD_ALLOCATION *psAlloc)
+{
+	return psAlloc->sDevVAddr.uiAddr + psAlloc->uiSize;
+}
+
+static INLINE IMG_UINT32 VAIndexHeight(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	return (ui32Alloc != VA_INDEX_NONE) ?
+	       ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc)->ui8VAIdxHeight : 0;
+}
+
+/* VAIndexLess:
+ * VA index ordering, by base DevVAddr then by record index
+ */
+static INLINE IMG_BOOL VAIndexLess(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                   IMG_UINT32 ui32AllocA,
+                                   IMG_UINT32 ui32AllocB)
+{
+	RECORD_ALLOCATION *psA = ALLOC_INDEX_TO_PTR(psDevHData, ui32AllocA);
+	RECORD_ALLOCATION *psB = ALLOC_INDEX_TO_PTR(psDevHData, ui32AllocB);
+
+	if (psA->sDevVAddr.uiAddr != psB->sDevVAddr.uiAddr)
+	{
+		return psA->sDevVAddr.uiAddr < psB->sDevVAddr.uiAddr;
+	}
+
+	return ui32AllocA < ui32AllocB;
+}
+
+/* VAIndexUpdate:
+ * Recompute the height and highest end address of a node from its children
+ */
+static void VAIndexUpdate(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+	IMG_UINT32 ui32Left = psAlloc->uiVAIdxLeft;
+	IMG_UINT32 ui32Right = psAlloc->uiVAIdxRight;
+	IMG_UINT32 ui32HeightLeft = VAIndexHeight(psDevHData, ui32Left);
+	IMG_UINT32 ui32HeightRight = VAIndexHeight(psDevHData, ui32Right);
+	IMG_UINT64 ui64MaxEnd = VAIndexEnd(psAlloc);
+
+	if (ui32Left != VA_INDEX_NONE)
+	{
+		ui64MaxEnd = MAX(ui64MaxEnd, ALLOC_INDEX_TO_PTR(psDevHData, ui32Left)->ui64VAIdxMaxEnd);
+	}
+
+	if (ui32Right != VA_INDEX_NONE)
+	{
+		ui64MaxEnd = MAX(ui64MaxEnd, ALLOC_INDEX_TO_PTR(psDevHData, ui32Right)->ui64VAIdxMaxEnd);
+	}
+
+	psAlloc->ui8VAIdxHeight = MAX(ui32HeightLeft, ui32HeightRight) + 1;
+	psAlloc->ui64VAIdxMaxEnd = ui64MaxEnd;
+}
+
+static IMG_UINT32 VAIndexRotateRight(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+	IMG_UINT32 ui32Pivot = psAlloc->uiVAIdxLeft;
+	RECORD_ALLOCATION *psPivot = ALLOC_INDEX_TO_PTR(psDevHData, ui32Pivot);
+
+	psAlloc->uiVAIdxLeft = psPivot->uiVAIdxRight;
+	psPivot->uiVAIdxRight = ui32Alloc;
+	VAIndexUpdate(psDevHData, ui32Alloc);
+	VAIndexUpdate(psDevHData, ui32Pivot);
+
+	return ui32Pivot;
+}
+
+static IMG_UINT32 VAIndexRotateLeft(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+	IMG_UINT32 ui32Pivot = psAlloc->uiVAIdxRight;
+	RECORD_ALLOCATION *psPivot = ALLOC_INDEX_TO_PTR(psDevHData, ui32Pivot);
+
+	psAlloc->uiVAIdxRight = psPivot->uiVAIdxLeft;
+	psPivot->uiVAIdxLeft = ui32Alloc;
+	VAIndexUpdate(psDevHData, ui32Alloc);
+	VAIndexUpdate(psDevHData, ui32Pivot);
+
+	return ui32Pivot;
+}
+
+/* VAIndexBalance:
+ * Restore the AVL invariant of a subtree whose children are balanced
+ * but may differ in height by two. Returns the new root of the subtree.
+ */
+static IMG_UINT32 VAIndexBalance(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+	IMG_INT32 iBalance;
+
+	VAIndexUpdate(psDevHData, ui32Alloc);
+	iBalance = (IMG_INT32)VAIndexHeight(psDevHData, psAlloc->uiVAIdxLeft) -
+	           (IMG_INT32)VAIndexHeight(psDevHData, psAlloc->uiVAIdxRight);
+
+	if (iBalance > 1)
+	{
+		RECORD_ALLOCATION *psLeft = ALLOC_INDEX_TO_PTR(psDevHData, psAlloc->uiVAIdxLeft);
+
+		if (VAIndexHeight(psDevHData, psLeft->uiVAIdxLeft) <
+		    VAIndexHeight(psDevHData, psLeft->uiVAIdxRight))
+		{
+			psAlloc->uiVAIdxLeft = VAIndexRotateLeft(psDevHData, psAlloc->uiVAIdxLeft);
+		}
+		return VAIndexRotateRight(psDevHData, ui32Alloc);
+	}
+
+	if (iBalance < -1)
+	{
+		RECORD_ALLOCATION *psRight = ALLOC_INDEX_TO_PTR(psDevHData, psAlloc->uiVAIdxRight);
+
+		if (VAIndexHeight(psDevHData, psRight->uiVAIdxRight) <
+		    VAIndexHeight(psDevHData, psRight->uiVAIdxLeft))
+		{
+			psAlloc->uiVAIdxRight = VAIndexRotateRight(psDevHData, psAlloc->uiVAIdxRight);
+		}
+		return VAIndexRotateLeft(psDevHData, ui32Alloc);
+	}
+
+	return ui32Alloc;
+}
+
+static IMG_UINT32 VAIndexInsertNode(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                    IMG_UINT32 ui32Root,
+                                    IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psRoot;
+
+	if (ui32Root == VA_INDEX_NONE)
+	{
+		RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+
+		psAlloc->uiVAIdxLeft = VA_INDEX_NONE;
+		psAlloc->uiVAIdxRight = VA_INDEX_NONE;
+		VAIndexUpdate(psDevHData, ui32Alloc);
+		return ui32Alloc;
+	}
+
+	psRoot = ALLOC_INDEX_TO_PTR(psDevHData, ui32Root);
+
+	if (VAIndexLess(psDevHData, ui32Alloc, ui32Root))
+	{
+		psRoot->uiVAIdxLeft = VAIndexInsertNode(psDevHData, psRoot->uiVAIdxLeft, ui32Alloc);
+	}
+	else
+	{
+		psRoot->uiVAIdxRight = VAIndexInsertNode(psDevHData, psRoot->uiVAIdxRight, ui32Alloc);
+	}
+
+	return VAIndexBalance(psDevHData, ui32Root);
+}
+
+static IMG_UINT32 VAIndexRemoveMin(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                   IMG_UINT32 ui32Root,
+                                   IMG_UINT32 *pui32Min)
+{
+	RECORD_ALLOCATION *psRoot = ALLOC_INDEX_TO_PTR(psDevHData, ui32Root);
+
+	if (psRoot->uiVAIdxLeft == VA_INDEX_NONE)
+	{
+		*pui32Min = ui32Root;
+		return psRoot->uiVAIdxRight;
+	}
+
+	psRoot->uiVAIdxLeft = VAIndexRemoveMin(psDevHData, psRoot->uiVAIdxLeft, pui32Min);
+
+	return VAIndexBalance(psDevHData, ui32Root);
+}
+
+static IMG_UINT32 VAIndexRemoveNode(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                    IMG_UINT32 ui32Root,
+                                    IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psRoot;
+
+	PVR_ASSERT(ui32Root != VA_INDEX_NONE);
+
+	if (unlikely(ui32Root == VA_INDEX_NONE))
+	{
+		return VA_INDEX_NONE;
+	}
+
+	psRoot = ALLOC_INDEX_TO_PTR(psDevHData, ui32Root);
+
+	if (ui32Root == ui32Alloc)
+	{
+		IMG_UINT32 ui32Left = psRoot->uiVAIdxLeft;
+		IMG_UINT32 ui32Right = psRoot->uiVAIdxRight;
+		IMG_UINT32 ui32Min;
+		RECORD_ALLOCATION *psMin;
+
+		if (ui32Right == VA_INDEX_NONE)
+		{
+			return ui32Left;
+		}
+
+		ui32Right = VAIndexRemoveMin(psDevHData, ui32Right, &ui32Min);
+		psMin = ALLOC_INDEX_TO_PTR(psDevHData, ui32Min);
+		psMin->uiVAIdxLeft = ui32Left;
+		psMin->uiVAIdxRight = ui32Right;
+
+		return VAIndexBalance(psDevHData, ui32Min);
+	}
+
+	if (VAIndexLess(psDevHData, ui32Alloc, ui32Root))
+	{
+		psRoot->uiVAIdxLeft = VAIndexRemoveNode(psDevHData, psRoot->uiVAIdxLeft, ui32Alloc);
+	}
+	else
+	{
+		psRoot->uiVAIdxRight = VAIndexRemoveNode(psDevHData, psRoot->uiVAIdxRight, ui32Alloc);
+	}
+
+	return VAIndexBalance(psDevHData, ui32Root);
+}
+
+/* VAIndexInsert:
+ * Add an initialised allocation record to the VA index
+ */
+static void VAIndexInsert(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	psDevHData->sRecords.ui32VAIndexRoot =
+		VAIndexInsertNode(psDevHData, psDevHData->sRecords.ui32VAIndexRoot, ui32Alloc);
+}
+
+/* VAIndexRemove:
+ * Remove an allocation record from the VA index, if it is in the index.
+ * Must be called before the base address or size of the record change.
+ */
+static void VAIndexRemove(DEVICEMEM_HISTORY_DATA *psDevHData, IMG_UINT32 ui32Alloc)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+
+	if (psAlloc->ui8VAIdxHeight == 0)
+	{
+		return;
+	}
+
+	psDevHData->sRecords.ui32VAIndexRoot =
+		VAIndexRemoveNode(psDevHData, psDevHData->sRecords.ui32VAIndexRoot, ui32Alloc);
+	psAlloc->ui8VAIdxHeight = 0;
+}
+
 /* InitialiseAllocation:
  * Initialise the given allocation structure with the given properties
  */
@@ -778,6 +1095,7 @@ static void InitialiseAllocation(RECORD_ALLOCATION *psAlloc,
 	psAlloc->uiSize = uiSize;
 	psAlloc->ui32Log2PageSize = ui32Log2PageSize;
 	psAlloc->ui64CreationTime = OSClockns64();
+	OSCachedMemSet(psAlloc->asLastEvent, 0, sizeof(psAlloc->asLastEvent));
 }
 
 /* CreateAllocation:
@@ -809,6 +1127,9 @@ static PVRSRV_ERROR CreateAllocation(PVRSRV_DEVICE_NODE *psDeviceNode,
 
 	psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
 
+	/* the record may be recycled from an older allocation at another address */
+	VAIndexRemove(psDevHData, ui32Alloc);
+
 	InitialiseAllocation(psAlloc,
 			     pszName,
 			     ui64Serial,
@@ -817,6 +1138,8 @@ static PVRSRV_ERROR CreateAllocation(PVRSRV_DEVICE_NODE *psDeviceNode,
 			     uiSize,
 			     ui32Log2PageSize);
 
+	VAIndexInsert(psDevHData, ui32Alloc);
+
 	/* put the newly initialised allocation at the front of the MRU list */
 	TouchBusyAllocation(psDevHData, ui32Alloc);
 
@@ -1743,6 +2066,17 @@ void DevicememHistoryDumpRecordStats(PVRSRV_DEVICE_NODE *psDevNode,
 							  psDevHData->sRecords.ui64TimeStampCount,
 							  (IMG_UINT64)CIRCULAR_BUFFER_NUM_COMMANDS,
 							  psDevHData->sRecords.ui32Head);
+		/* queries answered by the VA index (IQ) and by walking the
+		 * circular buffer (WQ), with their total time in ns */
+		PVR_DUMPDEBUG_LOG("    DevmemHistoryQueryStats -"
+							  " IQC:%"IMG_UINT64_FMTSPEC
+							  " IQT:%"IMG_UINT64_FMTSPEC
+							  " WQC:%"IMG_UINT64_FMTSPEC
+							  " WQT:%"IMG_UINT64_FMTSPEC,
+							  psDevHData->sRecords.ui64IndexQueryCount,
+							  psDevHData->sRecords.ui64IndexQueryTimeNs,
+							  psDevHData->sRecords.ui64WalkQueryCount,
+							  psDevHData->sRecords.ui64WalkQueryTimeNs);
 	}
 	else
 	{
@@ -1750,69 +2084,245 @@ void DevicememHistoryDumpRecordStats(PVRSRV_DEVICE_NODE *psDevNode,
 	}
 }
 
-/* DevicememHistoryQuery:
- * Entry point for rgxdebug to look up addresses relating to a page fault
+/* QueryOutInsertResult:
+ * Insert a result into the query output, keeping the results ordered
+ * newest first and dropping the oldest once the output is full
  */
-IMG_BOOL DevicememHistoryQuery(DEVICEMEM_HISTORY_QUERY_IN *psQueryIn,
-                               DEVICEMEM_HISTORY_QUERY_OUT *psQueryOut,
-                               IMG_UINT32 ui32PageSizeBytes,
-                               IMG_BOOL bMatchAnyAllocInPage)
+static void QueryOutInsertResult(DEVICEMEM_HISTORY_QUERY_OUT *psQueryOut,
+                                 const DEVICEMEM_HISTORY_QUERY_OUT_RESULT *psResult)
 {
-	IMG_UINT32 ui32Head, ui32Iter;
-	COMMAND_TYPE eType = COMMAND_TYPE_NONE;
-	COMMAND_WRAPPER *psCommand = NULL;
-	IMG_BOOL bLast = IMG_FALSE;
-	IMG_UINT64 ui64StartTime = OSClockns64();
-	IMG_UINT64 ui64TimeNs = 0;
-	DEVICEMEM_HISTORY_DATA *psDevHData;
+	IMG_UINT32 ui32Pos, i;
 
-	/* initialise the results count for the caller */
-	psQueryOut->ui32NumResults = 0;
-	psQueryOut->ui64SearchCount = 0;
+	for (ui32Pos = 0; ui32Pos < psQueryOut->ui32NumResults; ui32Pos++)
+	{
+		if (psResult->ui64When > psQueryOut->sResults[ui32Pos].ui64When)
+		{
+			break;
+		}
+	}
 
-	psDevHData = DevmemFindDataFromDev(psQueryIn->psDevNode);
+	if (ui32Pos == DEVICEMEM_HISTORY_QUERY_OUT_MAX_RESULTS)
+	{
+		return;
+	}
 
-	if (psDevHData == NULL)
+	if (psQueryOut->ui32NumResults < DEVICEMEM_HISTORY_QUERY_OUT_MAX_RESULTS)
 	{
-		return IMG_FALSE;
+		psQueryOut->ui32NumResults++;
 	}
 
-	DevicememHistoryLock(psDevHData);
+	for (i = psQueryOut->ui32NumResults - 1; i > ui32Pos; i--)
+	{
+		psQueryOut->sResults[i] = psQueryOut->sResults[i - 1];
+	}
 
-	/* if the search is constrained to a particular PID then we
-	 * first search the list of allocations to see if this
-	 * PID is known to us
-	 */
-	if (psQueryIn->uiPID != DEVICEMEM_HISTORY_PID_ANY)
+	psQueryOut->sResults[ui32Pos] = *psResult;
+}
+
+/* state of a query answered from the VA index */
+typedef struct _VA_INDEX_QUERY_
+{
+	DEVICEMEM_HISTORY_QUERY_IN *psQueryIn;
+	DEVICEMEM_HISTORY_QUERY_OUT *psQueryOut;
+	IMG_UINT32 ui32PageSizeBytes;
+	IMG_BOOL bMatchAnyAllocInPage;
+	IMG_UINT64 ui64StartTime;
+	/* inclusive window of addresses an allocation must overlap */
+	IMG_UINT64 ui64WindowStart;
+	IMG_UINT64 ui64WindowEnd;
+	/* set when the most recent commands of an allocation cannot tell
+	 * whether an older command in the circular buffer would match */
+	IMG_BOOL bNeedWalk;
+} VA_INDEX_QUERY;
+
+/* VAIndexQueryAllocation:
+ * Match the most recent map and unmap of an allocation found in the VA
+ * index against the query, as the circular buffer walk would have done
+ */
+static void VAIndexQueryAllocation(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                   IMG_UINT32 ui32Alloc,
+                                   VA_INDEX_QUERY *psQuery)
+{
+	RECORD_ALLOCATION *psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+	IMG_UINT64 ui64Addr = psQuery->psQueryIn->sDevVAddr.uiAddr;
+	IMG_UINT32 i;
+
+	if ((psQuery->psQueryIn->uiPID != DEVICEMEM_HISTORY_PID_ANY) &&
+		(psAlloc->uiPID != psQuery->psQueryIn->uiPID))
 	{
-		IMG_UINT32 ui32Alloc;
-		ui32Alloc = psDevHData->sRecords.ui32AllocationsListHead;
+		return;
+	}
 
-		while (ui32Alloc != END_OF_LIST)
+	for (i = 0; i < RECORD_EVENT_COUNT; i++)
+	{
+		RECORD_EVENT *psEvent = &psAlloc->asLastEvent[i];
+		IMG_BOOL bRange = (psEvent->ui8Type == COMMAND_TYPE_MAP_RANGE) ||
+		                  (psEvent->ui8Type == COMMAND_TYPE_UNMAP_RANGE);
+		IMG_DEV_VIRTADDR sAllocStartAddrOrig, sAllocEndAddrOrig;
+		IMG_DEV_VIRTADDR sAllocStartAddr, sAllocEndAddr;
+		DEVICEMEM_HISTORY_QUERY_OUT_RESULT sResult;
+
+		if (psEvent->ui8Type == COMMAND_TYPE_NONE)
 		{
-			RECORD_ALLOCATION *psAlloc;
+			continue;
+		}
 
-			psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+		psQuery->psQueryOut->ui64SearchCount++;
 
-			if (psAlloc->uiPID == psQueryIn->uiPID)
-			{
-				goto found_pid;
-			}
+		if (bRange)
+		{
+			sAllocStartAddrOrig.uiAddr = psAlloc->sDevVAddr.uiAddr +
+					((1ULL << psAlloc->ui32Log2PageSize) * psEvent->ui32StartPage);
+			sAllocEndAddrOrig.uiAddr = sAllocStartAddrOrig.uiAddr +
+					((1ULL << psAlloc->ui32Log2PageSize) * psEvent->ui32PageCount) - 1;
+		}
+		else
+		{
+			sAllocStartAddrOrig = psAlloc->sDevVAddr;
+			sAllocEndAddrOrig.uiAddr = sAllocStartAddrOrig.uiAddr + psAlloc->uiSize - 1;
+		}
 
-			if (ui32Alloc == psDevHData->sRecords.ui32AllocationsListHead)
+		sAllocStartAddr = sAllocStartAddrOrig;
+		sAllocEndAddr = sAllocEndAddrOrig;
+
+		if (psQuery->bMatchAnyAllocInPage)
+		{
+			sAllocStartAddr.uiAddr = sAllocStartAddr.uiAddr & ~(IMG_UINT64) (psQuery->ui32PageSizeBytes - 1);
+			sAllocEndAddr.uiAddr = PVR_ALIGN(sAllocEndAddr.uiAddr, (IMG_UINT64)psQuery->ui32PageSizeBytes);
+		}
+
+		if ((ui64Addr < sAllocStartAddr.uiAddr) ||
+			(ui64Addr >= sAllocEndAddr.uiAddr))
+		{
+			/* an older range command of this allocation may still cover
+			 * the address, only the circular buffer knows about it */
+			if (bRange)
 			{
-				/* gone through whole list */
-				break;
+				psQuery->bNeedWalk = IMG_TRUE;
 			}
+			continue;
 		}
 
-		/* PID not found, so we do not have any suitable data for this
-		 * page fault
-		 */
-		goto out_unlock;
+		OSStringSafeCopy(sResult.szString, psAlloc->szName, sizeof(sResult.szString));
+		sResult.sBaseDevVAddr = psAlloc->sDevVAddr;
+		sResult.uiSize = psAlloc->uiSize;
+		sResult.bMap = (i == RECORD_EVENT_MAP);
+		sResult.ui64Age = _CalculateAge(psQuery->ui64StartTime, psEvent->ui64Time, TIME_STAMP_MASK);
+		sResult.ui64When = psEvent->ui64Time;
+		sResult.sProcessInfo.uiPID = psAlloc->uiPID;
+		sResult.bRange = bRange;
+
+		if (bRange)
+		{
+			sResult.ui32StartPage = psEvent->ui32StartPage;
+			sResult.ui32PageCount = psEvent->ui32PageCount;
+			sResult.bAll = (psEvent->ui32PageCount * (1U << psAlloc->ui32Log2PageSize))
+								== psAlloc->uiSize;
+			sResult.sMapStartAddr = sAllocStartAddrOrig;
+			sResult.sMapEndAddr = sAllocEndAddrOrig;
+		}
+		else
+		{
+			sResult.bAll = IMG_TRUE;
+		}
+
+		QueryOutInsertResult(psQuery->psQueryOut, &sResult);
 	}
+}
 
-found_pid:
+/* VAIndexQueryNode:
+ * Visit every allocation in the subtree overlapping the query window
+ */
+static void VAIndexQueryNode(DEVICEMEM_HISTORY_DATA *psDevHData,
+                             IMG_UINT32 ui32Node,
+                             VA_INDEX_QUERY *psQuery)
+{
+	RECORD_ALLOCATION *psNode;
+
+	if (ui32Node == VA_INDEX_NONE)
+	{
+		return;
+	}
+
+	psNode = ALLOC_INDEX_TO_PTR(psDevHData, ui32Node);
+
+	/* nothing in this subtree ends after the start of the window */
+	if (psNode->ui64VAIdxMaxEnd <= psQuery->ui64WindowStart)
+	{
+		return;
+	}
+
+	VAIndexQueryNode(psDevHData, psNode->uiVAIdxLeft, psQuery);
+
+	/* this node and its right subtree start after the window */
+	if (psNode->sDevVAddr.uiAddr > psQuery->ui64WindowEnd)
+	{
+		return;
+	}
+
+	if (VAIndexEnd(psNode) > psQuery->ui64WindowStart)
+	{
+		VAIndexQueryAllocation(psDevHData, ui32Node, psQuery);
+	}
+
+	VAIndexQueryNode(psDevHData, psNode->uiVAIdxRight, psQuery);
+}
+
+/* DevicememHistoryQueryIndex:
+ * Answer a query from the most recent map/unmap of the allocations whose
+ * VA range is near the address. Returns IMG_FALSE if the circular buffer
+ * has to be walked instead.
+ */
+static IMG_BOOL DevicememHistoryQueryIndex(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                           DEVICEMEM_HISTORY_QUERY_IN *psQueryIn,
+                                           DEVICEMEM_HISTORY_QUERY_OUT *psQueryOut,
+                                           IMG_UINT32 ui32PageSizeBytes,
+                                           IMG_BOOL bMatchAnyAllocInPage,
+                                           IMG_UINT64 ui64StartTime)
+{
+	VA_INDEX_QUERY sQuery;
+	IMG_UINT64 ui64Addr = psQueryIn->sDevVAddr.uiAddr;
+
+	sQuery.psQueryIn = psQueryIn;
+	sQuery.psQueryOut = psQueryOut;
+	sQuery.ui32PageSizeBytes = ui32PageSizeBytes;
+	sQuery.bMatchAnyAllocInPage = bMatchAnyAllocInPage;
+	sQuery.ui64StartTime = ui64StartTime;
+	sQuery.bNeedWalk = IMG_FALSE;
+
+	/* rounding out to the page can only extend an allocation by less
+	 * than a page either side */
+	if (bMatchAnyAllocInPage)
+	{
+		sQuery.ui64WindowStart = (ui64Addr > ui32PageSizeBytes) ? ui64Addr - ui32PageSizeBytes : 0;
+		sQuery.ui64WindowEnd = ui64Addr + ui32PageSizeBytes;
+	}
+	else
+	{
+		sQuery.ui64WindowStart = ui64Addr;
+		sQuery.ui64WindowEnd = ui64Addr;
+	}
+
+	VAIndexQueryNode(psDevHData, psDevHData->sRecords.ui32VAIndexRoot, &sQuery);
+
+	return !sQuery.bNeedWalk;
+}
+
+/* DevicememHistoryQueryWalk:
+ * Answer a query by walking the whole circular buffer backwards
+ */
+static void DevicememHistoryQueryWalk(DEVICEMEM_HISTORY_DATA *psDevHData,
+                                      DEVICEMEM_HISTORY_QUERY_IN *psQueryIn,
+                                      DEVICEMEM_HISTORY_QUERY_OUT *psQueryOut,
+                                      IMG_UINT32 ui32PageSizeBytes,
+                                      IMG_BOOL bMatchAnyAllocInPage,
+                                      IMG_UINT64 ui64StartTime)
+{
+	IMG_UINT32 ui32Head, ui32Iter;
+	COMMAND_TYPE eType = COMMAND_TYPE_NONE;
+	COMMAND_WRAPPER *psCommand = NULL;
+	IMG_BOOL bLast = IMG_FALSE;
+	IMG_UINT64 ui64TimeNs = 0;
 
 	CircularBufferIterateStart(psDevHData, &ui32Head, &ui32Iter);
 
@@ -1824,7 +2334,7 @@ found_pid:
 			PVR_DPF((PVR_DBG_ERROR,
 			         "%s: CircularBufferIteratePrevious returned NULL psCommand",
 			         __func__));
-			return IMG_FALSE;
+			return;
 		}
 
 		if (eType == COMMAND_TYPE_TIMESTAMP)
@@ -1927,6 +2437,99 @@ found_pid:
 			}
 		}
 	}
+}
+
+/* DevicememHistoryQuery:
+ * Entry point for rgxdebug to look up addresses relating to a page fault
+ */
+IMG_BOOL DevicememHistoryQuery(DEVICEMEM_HISTORY_QUERY_IN *psQueryIn,
+                               DEVICEMEM_HISTORY_QUERY_OUT *psQueryOut,
+                               IMG_UINT32 ui32PageSizeBytes,
+                               IMG_BOOL bMatchAnyAllocInPage)
+{
+	IMG_UINT64 ui64StartTime = OSClockns64();
+	DEVICEMEM_HISTORY_DATA *psDevHData;
+
+	/* initialise the results count for the caller */
+	psQueryOut->ui32NumResults = 0;
+	psQueryOut->ui64SearchCount = 0;
+	psQueryOut->ui64SearchTimeNs = 0;
+	psQueryOut->bIndexed = IMG_FALSE;
+
+	psDevHData = DevmemFindDataFromDev(psQueryIn->psDevNode);
+
+	if (psDevHData == NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	DevicememHistoryLock(psDevHData);
+
+	/* if the search is constrained to a particular PID then we
+	 * first search the list of allocations to see if this
+	 * PID is known to us
+	 */
+	if (psQueryIn->uiPID != DEVICEMEM_HISTORY_PID_ANY)
+	{
+		IMG_UINT32 ui32Alloc;
+		ui32Alloc = psDevHData->sRecords.ui32AllocationsListHead;
+
+		while (ui32Alloc != END_OF_LIST)
+		{
+			RECORD_ALLOCATION *psAlloc;
+
+			psAlloc = ALLOC_INDEX_TO_PTR(psDevHData, ui32Alloc);
+
+			if (psAlloc->uiPID == psQueryIn->uiPID)
+			{
+				goto found_pid;
+			}
+
+			if (ui32Alloc == psDevHData->sRecords.ui32AllocationsListHead)
+			{
+				/* gone through whole list */
+				break;
+			}
+		}
+
+		/* PID not found, so we do not have any suitable data for this
+		 * page fault
+		 */
+		goto out_unlock;
+	}
+
+found_pid:
+
+	if (DevicememHistoryQueryIndex(psDevHData, psQueryIn, psQueryOut,
+	                               ui32PageSizeBytes, bMatchAnyAllocInPage,
+	                               ui64StartTime))
+	{
+		psQueryOut->bIndexed = IMG_TRUE;
+	}
+	else
+	{
+		/* the index could not rule out older range commands, redo the
+		 * query the slow way */
+		psQueryOut->ui32NumResults = 0;
+		psQueryOut->ui64SearchCount = 0;
+
+		DevicememHistoryQueryWalk(psDevHData, psQueryIn, psQueryOut,
+		                          ui32PageSizeBytes, bMatchAnyAllocInPage,
+		                          ui64StartTime);
+	}
+
+	psQueryOut->ui64SearchTimeNs = OSClockns64() - ui64StartTime;
+
+	if (psQueryOut->bIndexed)
+	{
+		psDevHData->sRecords.ui64IndexQueryCount++;
+		psDevHData->sRecords.ui64IndexQueryTimeNs += psQueryOut->ui64SearchTimeNs;
+	}
+	else
+	{
+		psDevHData->sRecords.ui64WalkQueryCount++;
+		psDevHData->sRecords.ui64WalkQueryTimeNs += psQueryOut->ui64SearchTimeNs;
+	}
 
 out_unlock:
 	DevicememHistoryUnlock(psDevHData);
@@ -2151,6 +2754,9 @@ static void InitialiseRecords(DEVICEMEM_HISTORY_DATA *psDevHData)
 	psDevHData->sRecords.pasAllocations[ALLOCATION_LIST_NUM_ENTRIES - 1].ui32Next = 0;
 
 	psDevHData->sRecords.ui32AllocationsListHead = 0;
+
+	/* no record is initialised yet, so the VA index starts empty */
+	psDevHData->sRecords.ui32VAIndexRoot = VA_INDEX_NONE;
 }
 
 static void DevicememHistoryDevDeInitUnit(IMG_UINT32 uiUnit);
@@ -150,6 +150,10 @@ typedef struct _DEVICEMEM_HISTORY_QUERY_OUT_
 {
 	IMG_UINT32 ui32NumResults;
 	IMG_UINT64 ui64SearchCount;
+	/* time taken by the query, and whether the VA index answered it
+	 * rather than a walk of the whole history */
+	IMG_UINT64 ui64SearchTimeNs;
+	IMG_BOOL bIndexed;
 	/* result 0 is the newest */
 	DEVICEMEM_HISTORY_QUERY_OUT_RESULT sResults[DEVICEMEM_HISTORY_QUERY_OUT_MAX_RESULTS];
 } DEVICEMEM_HISTORY_QUERY_OUT;
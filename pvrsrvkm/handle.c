@@ -53,6 +53,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #if defined(__linux__)
 #include <linux/stddef.h>
+#include <linux/rcupdate.h>
 #else
 #include <stddef.h>
 #endif
@@ -72,6 +73,18 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define	TEST_FLAG(v, f) BITMASK_HAS(v, f)
 #define	TEST_ALLOC_FLAG(psHandleData, f) BITMASK_HAS((psHandleData)->eFlag, f)
 
+#if defined(__linux__)
+/* The IDR back-end lookup is RCU safe, which allows handles to be looked up
+ * and referenced without taking the handle base lock. Handle data freed
+ * while lockless readers may still hold a pointer to it is released after
+ * an RCU grace period. */
+#define HANDLE_LOCKLESS_LOOKUP
+#endif
+
+/* Lookup count value of a handle that is being (or has been) destroyed. Once
+ * a handle has this value no new references can be taken on it. */
+#define HANDLE_LOOKUP_DEAD (-1)
+
 
 /* Linked list structure. Used for both the list head and list items */
 typedef struct _HANDLE_LIST_
@@ -110,13 +123,20 @@ typedef struct _HANDLE_DATA_
 	HANDLE_LIST sSiblings;
 
 	/* Reference count of lookups made. It helps track which resources are in
-	 * use in concurrent bridge calls. */
-	IMG_INT32 iLookupCount;
+	 * use in concurrent bridge calls. Set to HANDLE_LOOKUP_DEAD while the
+	 * handle is not yet published or is being destroyed, so that lockless
+	 * lookups can't take a reference on it. */
+	ATOMIC_T iLookupCount;
 	/* State of a handle. If the handle was already destroyed this is false.
 	 * If this is false and iLookupCount is 0 the pfnReleaseData callback is
 	 * called on the handle. */
 	IMG_BOOL bCanLookup;
 
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+	/* Used to defer freeing of the structure until lockless readers are done */
+	struct rcu_head sRCUHead;
+#endif
+
 #if defined(PVRSRV_DEBUG_HANDLE_LOCK)
 	/* Store the handle base used for this handle, so we
 	 * can later access the handle base lock (or check if
@@ -144,6 +164,13 @@ struct _HANDLE_BASE_
 
 	/* Can be connection, process, global */
 	PVRSRV_HANDLE_BASE_TYPE eType;
+
+	/* Lock statistics, updated with hLock held */
+	IMG_UINT64 ui64LockAcquired;
+
+	/* Lockless lookup statistics */
+	ATOMIC_T iLocklessLookups;
+	ATOMIC_T iLocklessFallbacks;
 };
 
 /*
@@ -192,6 +219,7 @@ static HASH_TABLE *g_psProcessHandleBaseTable;
 void LockHandle(PVRSRV_HANDLE_BASE *psBase)
 {
 	OSLockAcquire(psBase->hLock);
+	psBase->ui64LockAcquired++;
 }
 
 void UnlockHandle(PVRSRV_HANDLE_BASE *psBase)
@@ -221,13 +249,15 @@ static inline IMG_UINT32 HandleGet(HANDLE_DATA *psHandleData)
 
 #ifdef DEBUG_REFCNT
 	PVR_DPF((PVR_DBG_ERROR, "%s: bCanLookup = %u, iLookupCount %d -> %d",
-	        __func__, psHandleData->bCanLookup, psHandleData->iLookupCount,
-	        psHandleData->iLookupCount + 1));
+	        __func__, psHandleData->bCanLookup,
+	        OSAtomicRead(&psHandleData->iLookupCount),
+	        OSAtomicRead(&psHandleData->iLookupCount) + 1));
 #endif /* DEBUG_REFCNT */
 
 	PVR_ASSERT(psHandleData->bCanLookup);
+	PVR_ASSERT(OSAtomicRead(&psHandleData->iLookupCount) >= 0);
 
-	return ++psHandleData->iLookupCount;
+	return OSAtomicIncrement(&psHandleData->iLookupCount);
 }
 
 /* Decrease the lookup reference count on the given handle.
@@ -246,14 +276,81 @@ static inline IMG_UINT32 HandlePut(HANDLE_DATA *psHandleData)
 
 #ifdef DEBUG_REFCNT
 	PVR_DPF((PVR_DBG_ERROR, "%s: bCanLookup = %u, iLookupCount %d -> %d",
-	        __func__, psHandleData->bCanLookup, psHandleData->iLookupCount,
-	        psHandleData->iLookupCount - 1));
+	        __func__, psHandleData->bCanLookup,
+	        OSAtomicRead(&psHandleData->iLookupCount),
+	        OSAtomicRead(&psHandleData->iLookupCount) - 1));
 #endif /* DEBUG_REFCNT */
 
 	/* psHandleData->bCanLookup can be false at this point */
-	PVR_ASSERT(psHandleData->iLookupCount > 0);
+	PVR_ASSERT(OSAtomicRead(&psHandleData->iLookupCount) > 0);
+
+	return OSAtomicDecrement(&psHandleData->iLookupCount);
+}
+
+/* Mark the handle as destroyed so no further lookups can be made on it.
+ * The handle lock must already be acquired.
+ * Returns: IMG_FALSE if the handle is still referenced by a lookup
+ */
+static inline IMG_BOOL HandleMarkForFree(HANDLE_DATA *psHandleData)
+{
+	/* Lockless lookups only take a reference if the count is not
+	 * HANDLE_LOOKUP_DEAD, so swapping 0 for it atomically guarantees that
+	 * no reference can be taken behind our back. */
+	if (OSAtomicCompareExchange(&psHandleData->iLookupCount, 0,
+	                            HANDLE_LOOKUP_DEAD) != 0)
+	{
+		return IMG_FALSE;
+	}
+
+	psHandleData->bCanLookup = IMG_FALSE;
+
+	return IMG_TRUE;
+}
+
+/* Undo HandleMarkForFree() so the handle can be looked up again.
+ * The handle lock must already be acquired.
+ */
+static inline void HandleUnmarkForFree(HANDLE_DATA *psHandleData)
+{
+	PVR_ASSERT(OSAtomicRead(&psHandleData->iLookupCount) == HANDLE_LOOKUP_DEAD);
+
+	psHandleData->bCanLookup = IMG_TRUE;
+	(void) OSAtomicCompareExchange(&psHandleData->iLookupCount,
+	                               HANDLE_LOOKUP_DEAD, 0);
+}
+
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+static void HandleDataFreeRCU(struct rcu_head *psRCUHead)
+{
+	HANDLE_DATA *psHandleData = IMG_CONTAINER_OF(psRCUHead, HANDLE_DATA, sRCUHead);
+
+	OSFreeMemNoStats(psHandleData);
+}
+#endif
+
+/* With HANDLE_LOCKLESS_LOOKUP handle data is freed from an RCU callback,
+ * which runs in softirq context on whichever CPU, long after the owning
+ * process may have gone. The per-process kmalloc stats can't be updated
+ * from there, so the handle data is allocated without stats in that
+ * configuration and is no longer included in the process's kmalloc
+ * figures. */
+static inline HANDLE_DATA *HandleDataAlloc(void)
+{
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+	return OSAllocZMemNoStats(sizeof(HANDLE_DATA));
+#else
+	return OSAllocZMem(sizeof(HANDLE_DATA));
+#endif
+}
 
-	return --psHandleData->iLookupCount;
+/* Free handle data once no lockless lookup can be referencing it */
+static inline void HandleDataFree(HANDLE_DATA *psHandleData)
+{
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+	call_rcu(&psHandleData->sRCUHead, HandleDataFreeRCU);
+#else
+	OSFreeMem(psHandleData);
+#endif
 }
 
 #if defined(PVRSRV_NEED_PVR_DPF)
@@ -919,8 +1016,11 @@ static PVRSRV_ERROR AllocHandle(PVRSRV_HANDLE_BASE *psBase,
 		PVR_ASSERT(FindHandle(psBase, pvData, eType, hParent) == NULL);
 	}
 
-	psNewHandleData = OSAllocZMem(sizeof(*psNewHandleData));
-	PVR_LOG_RETURN_IF_NOMEM(psNewHandleData, "OSAllocZMem");
+	psNewHandleData = HandleDataAlloc();
+	PVR_LOG_RETURN_IF_NOMEM(psNewHandleData, "HandleDataAlloc");
+
+	/* Don't allow lockless lookups until the handle data is initialised */
+	OSAtomicWrite(&psNewHandleData->iLookupCount, HANDLE_LOOKUP_DEAD);
 
 	eError = gpsHandleFuncs->pfnAcquireHandle(psBase->psImplBase, &hHandle,
 	                                          psNewHandleData);
@@ -951,7 +1051,6 @@ static PVRSRV_ERROR AllocHandle(PVRSRV_HANDLE_BASE *psBase,
 	psNewHandleData->eFlag = eFlag;
 	psNewHandleData->pvData = pvData;
 	psNewHandleData->pfnReleaseData = pfnReleaseData;
-	psNewHandleData->iLookupCount = 0;
 	psNewHandleData->bCanLookup = IMG_TRUE;
 
 #ifdef DEBUG_REFCNT
@@ -972,6 +1071,11 @@ static PVRSRV_ERROR AllocHandle(PVRSRV_HANDLE_BASE *psBase,
 	psNewHandleData->psBase = psBase;
 #endif
 
+	/* Publish the handle to lockless lookups. The exchange orders the
+	 * initialisation above before the count becomes usable. */
+	(void) OSAtomicCompareExchange(&psNewHandleData->iLookupCount,
+	                               HANDLE_LOOKUP_DEAD, 0);
+
 	/* Return the new handle to the client */
 	*phHandle = psNewHandleData->hHandle;
 
@@ -981,7 +1085,7 @@ ErrorReleaseHandle:
 	(void)gpsHandleFuncs->pfnReleaseHandle(psBase->psImplBase, hHandle, NULL);
 
 ErrorFreeHandleData:
-	OSFreeMem(psNewHandleData);
+	HandleDataFree(psNewHandleData);
 
 	return eError;
 }
@@ -1296,6 +1400,78 @@ PVRSRV_ERROR PVRSRVLookupHandleUnlocked(PVRSRV_HANDLE_BASE *psBase,
 	return PVRSRV_OK;
 }
 
+/*!
+*******************************************************************************
+ @Function      PVRSRVLookupHandleLockless
+ @Description   Lookup the data pointer corresponding to a handle and take a
+                reference on it without acquiring the handle lock. The
+                reference must be dropped with PVRSRVReleaseHandleLockless()
+                or PVRSRVReleaseHandle(). If the handle can't be referenced
+                locklessly (e.g. it is being destroyed concurrently) the
+                lookup falls back to PVRSRVLookupHandle().
+                Must not be called with the handle lock held.
+ @Input         hHandle - handle from client
+                eType - handle type
+ @Output        ppvData - points to the returned data pointer
+ @Return        Error code or PVRSRV_OK
+******************************************************************************/
+PVRSRV_ERROR PVRSRVLookupHandleLockless(PVRSRV_HANDLE_BASE *psBase,
+                                        void **ppvData,
+                                        IMG_HANDLE hHandle,
+                                        PVRSRV_HANDLE_TYPE eType)
+{
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+	HANDLE_DATA *psHandleData = NULL;
+	IMG_BOOL bReferenced = IMG_FALSE;
+	PVRSRV_ERROR eError;
+
+	/* PVRSRV_HANDLE_TYPE_NONE is reserved for internal use */
+	PVR_ASSERT(eType != PVRSRV_HANDLE_TYPE_NONE);
+	PVR_ASSERT(gpsHandleFuncs);
+
+	PVR_LOG_RETURN_IF_INVALID_PARAM(psBase != NULL, "psBase");
+
+	rcu_read_lock();
+
+	eError = gpsHandleFuncs->pfnGetHandleData(psBase->psImplBase,
+	                                          hHandle,
+	                                          (void **)&psHandleData);
+	if (likely(eError == PVRSRV_OK && psHandleData != NULL))
+	{
+		/* Take the reference first: once it is held the handle can't be
+		 * marked for free, so the checks below can't go stale. */
+		if (OSAtomicAddUnless(&psHandleData->iLookupCount, 1,
+		                      HANDLE_LOOKUP_DEAD) != HANDLE_LOOKUP_DEAD)
+		{
+			if (likely(psHandleData->eType == eType))
+			{
+				PVR_ASSERT(psHandleData->bCanLookup);
+				*ppvData = psHandleData->pvData;
+				bReferenced = IMG_TRUE;
+			}
+			else
+			{
+				(void) OSAtomicDecrement(&psHandleData->iLookupCount);
+			}
+		}
+	}
+
+	rcu_read_unlock();
+
+	if (likely(bReferenced))
+	{
+		OSAtomicIncrement(&psBase->iLocklessLookups);
+
+		return PVRSRV_OK;
+	}
+
+	/* Let the locked path produce the definitive result (and error report) */
+	OSAtomicIncrement(&psBase->iLocklessFallbacks);
+#endif /* defined(HANDLE_LOCKLESS_LOOKUP) */
+
+	return PVRSRVLookupHandle(psBase, ppvData, hHandle, eType, IMG_TRUE);
+}
+
 /*!
 *******************************************************************************
  @Function      PVRSRVLookupSubHandle
@@ -1413,13 +1589,80 @@ void PVRSRVReleaseHandleUnlocked(PVRSRV_HANDLE_BASE *psBase,
 	}
 
 	PVR_ASSERT(psHandleData->bCanLookup);
-	PVR_ASSERT(psHandleData->iLookupCount > 0);
+	PVR_ASSERT(OSAtomicRead(&psHandleData->iLookupCount) > 0);
 
 	/* If there are still outstanding lookups for this handle or the handle
 	 * has not been destroyed yet, return early */
 	HandlePut(psHandleData);
 }
 
+/*!
+*******************************************************************************
+ @Function      PVRSRVReleaseHandleLockless
+ @Description   Release a reference taken by PVRSRVLookupHandleLockless()
+                without acquiring the handle lock. The handle can't be
+                destroyed while the reference is held, so only the lookup of
+                the handle data needs protecting.
+                Must not be called with the handle lock held.
+ @Input         hHandle - handle from client
+                eType - handle type
+******************************************************************************/
+void PVRSRVReleaseHandleLockless(PVRSRV_HANDLE_BASE *psBase,
+                                 IMG_HANDLE hHandle,
+                                 PVRSRV_HANDLE_TYPE eType)
+{
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+	HANDLE_DATA *psHandleData = NULL;
+	PVRSRV_ERROR eError;
+
+	/* PVRSRV_HANDLE_TYPE_NONE is reserved for internal use */
+	PVR_ASSERT(eType != PVRSRV_HANDLE_TYPE_NONE);
+	PVR_ASSERT(gpsHandleFuncs);
+
+	PVR_LOG_RETURN_VOID_IF_FALSE(psBase != NULL, "invalid psBase");
+
+	rcu_read_lock();
+
+	eError = gpsHandleFuncs->pfnGetHandleData(psBase->psImplBase,
+	                                          hHandle,
+	                                          (void **)&psHandleData);
+	if (likely(eError == PVRSRV_OK && psHandleData != NULL &&
+	           psHandleData->eType == eType))
+	{
+		PVR_ASSERT(OSAtomicRead(&psHandleData->iLookupCount) > 0);
+
+		(void) OSAtomicDecrement(&psHandleData->iLookupCount);
+
+		rcu_read_unlock();
+		return;
+	}
+
+	rcu_read_unlock();
+#endif /* defined(HANDLE_LOCKLESS_LOOKUP) */
+
+	/* Let the locked path report the error */
+	PVRSRVReleaseHandle(psBase, hHandle, eType);
+}
+
+/*!
+*******************************************************************************
+ @Function      PVRSRVGetHandleBaseStats
+ @Description   Get the lock contention statistics of a handle base
+ @Input         psBase - pointer to handle base structure
+ @Output        psStats - statistics of the handle base
+******************************************************************************/
+void PVRSRVGetHandleBaseStats(PVRSRV_HANDLE_BASE *psBase,
+                              PVRSRV_HANDLE_BASE_STATS *psStats)
+{
+	PVR_ASSERT(psBase != NULL && psStats != NULL);
+
+	/* The lock counters are only read here, so a torn read just gives a
+	 * slightly stale value, which is fine for statistics. */
+	psStats->ui64LockAcquired = psBase->ui64LockAcquired;
+	psStats->ui32LocklessLookups = (IMG_UINT32) OSAtomicRead(&psBase->iLocklessLookups);
+	psStats->ui32LocklessFallbacks = (IMG_UINT32) OSAtomicRead(&psBase->iLocklessFallbacks);
+}
+
 /*!
 *******************************************************************************
  @Function      PVRSRVPurgeHandles
@@ -1470,19 +1713,17 @@ static PVRSRV_ERROR HandleUnrefAndMaybeMarkForFree(PVRSRV_HANDLE_BASE *psBase,
 		return PVRSRV_ERROR_HANDLE_NOT_FOUND;
 	}
 
-	if (psHandleData->iLookupCount > 0)
-	{
-		return PVRSRV_ERROR_OBJECT_STILL_REFERENCED;
-	}
-
 	/* Mark this handle as freed only if it's no longer referenced by any
 	 * lookup. The user space should retry freeing this handle once there are
 	 * no outstanding lookups. */
-	psHandleData->bCanLookup = IMG_FALSE;
+	if (!HandleMarkForFree(psHandleData))
+	{
+		return PVRSRV_ERROR_OBJECT_STILL_REFERENCED;
+	}
 
 #ifdef DEBUG_REFCNT
 	PVR_DPF((PVR_DBG_ERROR, "%s: bCanLookup = false, iLookupCount = %d", __func__,
-	        psHandleData->iLookupCount));
+	        OSAtomicRead(&psHandleData->iLookupCount)));
 #endif /* DEBUG_REFCNT */
 
 	/* Prepare children for destruction */
@@ -1492,7 +1733,7 @@ static PVRSRV_ERROR HandleUnrefAndMaybeMarkForFree(PVRSRV_HANDLE_BASE *psBase,
 	{
 		/* If there was a problem destroying any of the child handles,
 		 * the parent handle still needs to be able to be looked-up */
-		psHandleData->bCanLookup = IMG_TRUE;
+		HandleUnmarkForFree(psHandleData);
 	}
 	PVR_LOG_RETURN_IF_ERROR(eError, "HandleUnrefAndMaybeMarkForFreeWrapper");
 
@@ -1596,7 +1837,7 @@ static PVRSRV_ERROR HandleFreeDestroy(PVRSRV_HANDLE_BASE *psBase,
 	eError = gpsHandleFuncs->pfnReleaseHandle(psBase->psImplBase,
 	                                          psHandleData->hHandle,
 	                                          (void **)&psReleasedHandleData);
-	OSFreeMem(psHandleData);
+	HandleDataFree(psHandleData);
 	PVR_LOG_RETURN_IF_ERROR(eError, "pfnReleaseHandle");
 
 	return PVRSRV_OK;
@@ -1638,7 +1879,7 @@ static PVRSRV_ERROR DestroyHandle(PVRSRV_HANDLE_BASE *psBase,
 		 * handle must be kept alive so that the next destroy call can try again */
 		if (PVRSRVIsRetryError(eError))
 		{
-			psHandleData->bCanLookup = IMG_TRUE;
+			HandleUnmarkForFree(psHandleData);
 		}
 
 		return eError;
@@ -1833,7 +2074,7 @@ static PVRSRV_ERROR ListHandlesInBase(IMG_HANDLE hHandle, void *pvData)
 		PVR_DPF((PVR_DBG_WARNING,
 		        "    Handle: %6u, CanLookup: %u, LookupCount: %3u, Type: %s (%u), pvData<%p>",
 		       (IMG_UINT32) (uintptr_t) psHandleData->hHandle, psHandleData->bCanLookup,
-		       psHandleData->iLookupCount, HandleTypeToString(psHandleData->eType),
+		       OSAtomicRead(&psHandleData->iLookupCount), HandleTypeToString(psHandleData->eType),
 		       psHandleData->eType, psHandleData->pvData));
 	}
 
@@ -1939,7 +2180,8 @@ static PVRSRV_ERROR FreeHandleDataWrapper(IMG_HANDLE hHandle, void *pvData)
 		return PVRSRV_OK;
 	}
 
-	PVR_ASSERT(psHandleData->bCanLookup && psHandleData->iLookupCount == 0);
+	PVR_ASSERT(psHandleData->bCanLookup &&
+	           OSAtomicRead(&psHandleData->iLookupCount) == 0);
 
 	if (psHandleData->bCanLookup)
 	{
@@ -1963,6 +2205,7 @@ static PVRSRV_ERROR FreeHandleDataWrapper(IMG_HANDLE hHandle, void *pvData)
 		}
 
 		psHandleData->bCanLookup = IMG_FALSE;
+		OSAtomicWrite(&psHandleData->iLookupCount, HANDLE_LOOKUP_DEAD);
 	}
 
 	if (!TEST_ALLOC_FLAG(psHandleData, PVRSRV_HANDLE_ALLOC_FLAG_MULTI))
@@ -1986,7 +2229,7 @@ static PVRSRV_ERROR FreeHandleDataWrapper(IMG_HANDLE hHandle, void *pvData)
 	eError = gpsHandleFuncs->pfnSetHandleData(psData->psBase->psImplBase, hHandle, NULL);
 	PVR_RETURN_IF_ERROR(eError);
 
-	OSFreeMem(psHandleData);
+	HandleDataFree(psHandleData);
 
 	/* If we reach the end of the time slice release we can release the global
 	 * lock, invoke the scheduler and reacquire the lock */
@@ -2435,6 +2678,11 @@ PVRSRV_ERROR PVRSRVHandleDeInit(void)
 		gbLockInitialised = IMG_FALSE;
 	}
 
+#if defined(HANDLE_LOCKLESS_LOOKUP)
+	/* Wait for deferred handle data frees before the module goes away */
+	rcu_barrier();
+#endif
+
 	return eError;
 }
 
@@ -99,6 +99,14 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  * Given a handle for a resource of type eType, return the pointer to the
  * resource.
  *
+ * PVRSRV_ERROR PVRSRVLookupHandleLockless(PVRSRV_HANDLE_BASE *psBase,
+ *      void **ppvData, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
+ *
+ * Similar to PVRSRVLookupHandle, but looks the handle up and takes a
+ * reference on it without acquiring the handle base lock where the handle
+ * back-end allows it. The reference is dropped with
+ * PVRSRVReleaseHandleLockless.
+ *
  * PVRSRV_ERROR PVRSRVLookupSubHandle(PVRSRV_HANDLE_BASE *psBase,
  *      void **ppvData, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType,
  *      IMH_HANDLE hAncestor);
@@ -162,6 +170,13 @@ extern PVRSRV_HANDLE_BASE *gpsKernelHandleBase;
 
 typedef PVRSRV_ERROR (*PFN_HANDLE_RELEASE)(void *pvData);
 
+typedef struct _PVRSRV_HANDLE_BASE_STATS_
+{
+	IMG_UINT64 ui64LockAcquired;       /*!< Number of times the base lock was taken */
+	IMG_UINT32 ui32LocklessLookups;    /*!< Lookups served without the base lock */
+	IMG_UINT32 ui32LocklessFallbacks;  /*!< Lockless lookups that fell back to the locked path */
+} PVRSRV_HANDLE_BASE_STATS;
+
 PVRSRV_ERROR PVRSRVAllocHandle(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE *phHandle, void *pvData, PVRSRV_HANDLE_TYPE eType, PVRSRV_HANDLE_ALLOC_FLAG eFlag, PFN_HANDLE_RELEASE pfnReleaseData);
 PVRSRV_ERROR PVRSRVAllocHandleUnlocked(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE *phHandle, void *pvData, PVRSRV_HANDLE_TYPE eType, PVRSRV_HANDLE_ALLOC_FLAG eFlag, PFN_HANDLE_RELEASE pfnReleaseData);
 
@@ -173,11 +188,13 @@ PVRSRV_ERROR PVRSRVFindHandleUnlocked(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE *ph
 
 PVRSRV_ERROR PVRSRVLookupHandle(PVRSRV_HANDLE_BASE *psBase, void **ppvData, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType, IMG_BOOL bRef);
 PVRSRV_ERROR PVRSRVLookupHandleUnlocked(PVRSRV_HANDLE_BASE *psBase, void **ppvData, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType, IMG_BOOL bRef);
+PVRSRV_ERROR PVRSRVLookupHandleLockless(PVRSRV_HANDLE_BASE *psBase, void **ppvData, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
 
 PVRSRV_ERROR PVRSRVLookupSubHandle(PVRSRV_HANDLE_BASE *psBase, void **ppvData, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType, IMG_HANDLE hAncestor);
 
 void PVRSRVReleaseHandle(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
 void PVRSRVReleaseHandleUnlocked(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
+void PVRSRVReleaseHandleLockless(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
 
 PVRSRV_ERROR PVRSRVDestroyHandle(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
 PVRSRV_ERROR PVRSRVDestroyHandleUnlocked(PVRSRV_HANDLE_BASE *psBase, IMG_HANDLE hHandle, PVRSRV_HANDLE_TYPE eType);
@@ -185,6 +202,8 @@ PVRSRV_ERROR PVRSRVDestroyHandleStagedUnlocked(PVRSRV_HANDLE_BASE *psBase, IMG_H
 
 PVRSRV_ERROR PVRSRVPurgeHandles(PVRSRV_HANDLE_BASE *psBase);
 
+void PVRSRVGetHandleBaseStats(PVRSRV_HANDLE_BASE *psBase, PVRSRV_HANDLE_BASE_STATS *psStats);
+
 PVRSRV_ERROR PVRSRVAllocHandleBase(PVRSRV_HANDLE_BASE **ppsBase,
                                    PVRSRV_HANDLE_BASE_TYPE eType);
 
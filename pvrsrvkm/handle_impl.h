@@ -63,7 +63,9 @@ typedef struct _HANDLE_IMPL_FUNCTAB_
 	/* Release the given handle (optionally returning the data associated with it) */
 	PVRSRV_ERROR (*pfnReleaseHandle)(HANDLE_IMPL_BASE *psHandleBase, IMG_HANDLE hHandle, void **ppvData);
 
-	/* Get the data associated with the given handle */
+	/* Get the data associated with the given handle. On Linux this must be
+	 * safe to call under rcu_read_lock() concurrently with handle acquire
+	 * and release, as it is used by lockless lookups. */
 	PVRSRV_ERROR (*pfnGetHandleData)(HANDLE_IMPL_BASE *psHandleBase, IMG_HANDLE hHandle, void **ppvData);
 
 	/* Set the data associated with the given handle */
@@ -57,6 +57,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /* services/client/include/ or services/server/include/ */
 #include "osfunc_common.h"
 #include "allocmem.h"
+#include "log2.h"
 
 //#define PERF_DBG_RESIZE
 #if !defined(__KERNEL__) && defined(PERF_DBG_RESIZE)
@@ -85,6 +86,21 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #define NO_SHRINK 0
 
+/* Open addressed tables: slot states, smallest table, load thresholds, and
+ * the number of old table slots moved to the new table by each insert/remove
+ * while a resize is in progress. A resize leaves the new table at most 1/4
+ * full, and with a step of 8 the old table is drained long before inserts
+ * made during the resize can take the new table past its grow threshold.
+ */
+#define OA_SLOT_EMPTY      0
+#define OA_SLOT_USED       1
+#define OA_SLOT_TOMBSTONE  2
+#define OA_NO_SLOT         IMG_UINT32_MAX
+#define OA_MINIMUM_SIZE    8
+#define OA_MIGRATE_STEP    8
+#define OA_GROW_THRESHOLD(uSize)   ((uSize) >> 1)
+#define OA_SHRINK_THRESHOLD(uSize) ((uSize) >> 4)
+
 /* Each entry in a hash table is placed into a bucket */
 typedef struct _BUCKET_
 {
@@ -94,6 +110,23 @@ typedef struct _BUCKET_
 	                        /* override dynamic array declaration warning */
 } BUCKET;
 
+/* Each entry in an open addressed table is stored inline in a slot */
+typedef struct _OA_SLOT_
+{
+	uintptr_t uState;       /*!< OA_SLOT_EMPTY, OA_SLOT_USED or OA_SLOT_TOMBSTONE */
+	uintptr_t v;            /*!< entry value */
+	uintptr_t k[];          /* PRQA S 0642 */
+	                        /* override dynamic array declaration warning */
+} OA_SLOT;
+
+typedef struct _OA_TABLE_
+{
+	IMG_BYTE   *pbySlots;        /*!< slot array, NULL if not allocated */
+	IMG_UINT32 uSize;            /*!< number of slots */
+	IMG_UINT32 uCount;           /*!< number of used slots */
+	IMG_UINT32 uTombstones;      /*!< number of removed slots not yet reclaimed */
+} OA_TABLE;
+
 struct _HASH_TABLE_
 {
 	IMG_UINT32 uSize;            /*!< current size of the hash table */
@@ -105,6 +138,12 @@ struct _HASH_TABLE_
 	HASH_FUNC*     pfnHashFunc;  /*!< hash function */
 	HASH_KEY_COMP* pfnKeyComp;   /*!< key comparison function */
 	BUCKET**   ppBucketTable;    /*!< the hash table array */
+	HASH_TABLE_TYPE eType;       /*!< hash table backend */
+	IMG_UINT32 uSlotSize;        /*!< open addressed: size of a slot in bytes */
+	OA_TABLE   sOATable;         /*!< open addressed: table receiving inserts */
+	OA_TABLE   sOAOldTable;      /*!< open addressed: table being drained by a resize */
+	IMG_UINT32 uOAMigrateIndex;  /*!< open addressed: next old table slot to migrate */
+	IMG_UINT32 uIterating;       /*!< open addressed: resizing is held off while non-zero */
 #if defined(DEBUG)
 	const char*      pszFile;
 	unsigned int     ui32LineNum;
@@ -295,6 +334,397 @@ _Resize(HASH_TABLE *pHash, IMG_UINT32 uNewSize)
 }
 
 
+#define OA_SLOT_AT(pHash, psTable, uIndex) \
+	((OA_SLOT *)((psTable)->pbySlots + (size_t)(uIndex) * (pHash)->uSlotSize))
+
+/*************************************************************************/ /*!
+@Function       _OAKeyToIndex
+@Description    Map a key to its home slot. Linear probing is sensitive to
+                clustering, so the hash value is mixed before it is masked
+                down to the (power of two) table size.
+@Input          pHash        The hash table.
+@Input          psTable      The table the index is for.
+@Input          pKey         Pointer to key.
+@Return         Slot index.
+*/ /**************************************************************************/
+static INLINE IMG_UINT32
+_OAKeyToIndex(HASH_TABLE *pHash, OA_TABLE *psTable, void *pKey)
+{
+	IMG_UINT32 uHash = pHash->pfnHashFunc(pHash->uKeySize, pKey, psTable->uSize);
+
+	uHash ^= uHash >> 16;
+	uHash *= 0x45d9f3bU;
+	uHash ^= uHash >> 16;
+
+	return uHash & (psTable->uSize - 1);
+}
+
+/*************************************************************************/ /*!
+@Function       _OATableAlloc
+@Description    Allocate the slot array of an open addressed table. All slots
+                start out empty.
+@Input          pHash        The hash table.
+@Output         psTable      Table to initialise.
+@Input          uSize        Number of slots.
+@Return         IMG_TRUE Success
+                IMG_FALSE Failed
+*/ /**************************************************************************/
+static IMG_BOOL
+_OATableAlloc(HASH_TABLE *pHash, OA_TABLE *psTable, IMG_UINT32 uSize)
+{
+	psTable->pbySlots = _AllocZMem((size_t)pHash->uSlotSize * uSize);
+	if (psTable->pbySlots == NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	psTable->uSize = uSize;
+	psTable->uCount = 0;
+	psTable->uTombstones = 0;
+
+	return IMG_TRUE;
+}
+
+static void
+_OATableFree(OA_TABLE *psTable)
+{
+	if (psTable->pbySlots != NULL)
+	{
+		_FreeMem(psTable->pbySlots);
+	}
+
+	psTable->pbySlots = NULL;
+	psTable->uSize = 0;
+	psTable->uCount = 0;
+	psTable->uTombstones = 0;
+}
+
+/*************************************************************************/ /*!
+@Function       _OAFind
+@Description    Find the slot holding a key in an open addressed table.
+@Input          pHash        The hash table.
+@Input          psTable      The table to search.
+@Input          pKey         Pointer to key.
+@Return         Index of the slot, or OA_NO_SLOT if the key is missing.
+*/ /**************************************************************************/
+static IMG_UINT32
+_OAFind(HASH_TABLE *pHash, OA_TABLE *psTable, void *pKey)
+{
+	IMG_UINT32 uIndex;
+	IMG_UINT32 uProbe;
+
+	if (psTable->pbySlots == NULL)
+	{
+		return OA_NO_SLOT;
+	}
+
+	uIndex = _OAKeyToIndex(pHash, psTable, pKey);
+
+	for (uProbe = 0; uProbe < psTable->uSize; uProbe++)
+	{
+		OA_SLOT *pSlot = OA_SLOT_AT(pHash, psTable, uIndex);
+
+		if (pSlot->uState == OA_SLOT_EMPTY)
+		{
+			break;
+		}
+
+		/* PRQA S 0432,0541 1 */ /* ignore warning about dynamic array k */
+		if (pSlot->uState == OA_SLOT_USED && KEY_COMPARE(pHash, pSlot->k, pKey))
+		{
+			return uIndex;
+		}
+
+		if (++uIndex == psTable->uSize)
+		{
+			uIndex = 0;
+		}
+	}
+
+	return OA_NO_SLOT;
+}
+
+/*************************************************************************/ /*!
+@Function       _OAPlace
+@Description    Store a key value pair in the first free slot on its probe
+                sequence. The caller must ensure the table has a free slot.
+@Input          pHash        The hash table.
+@Input          psTable      The table to insert into.
+@Input          pKey         Pointer to key.
+@Input          v            The value associated with the key.
+@Return         None
+*/ /**************************************************************************/
+static void
+_OAPlace(HASH_TABLE *pHash, OA_TABLE *psTable, void *pKey, uintptr_t v)
+{
+	IMG_UINT32 uIndex = _OAKeyToIndex(pHash, psTable, pKey);
+	OA_SLOT *pSlot = OA_SLOT_AT(pHash, psTable, uIndex);
+
+	PVR_ASSERT(psTable->uCount + psTable->uTombstones < psTable->uSize);
+
+	while (pSlot->uState == OA_SLOT_USED)
+	{
+		if (++uIndex == psTable->uSize)
+		{
+			uIndex = 0;
+		}
+		pSlot = OA_SLOT_AT(pHash, psTable, uIndex);
+	}
+
+	if (pSlot->uState == OA_SLOT_TOMBSTONE)
+	{
+		psTable->uTombstones--;
+	}
+
+	pSlot->uState = OA_SLOT_USED;
+	pSlot->v = v;
+	/* PRQA S 0432,0541 1 */ /* ignore warning about dynamic array k */
+	OSCachedMemCopy(pSlot->k, pKey, pHash->uKeySize);
+
+	psTable->uCount++;
+}
+
+/*************************************************************************/ /*!
+@Function       _OAMigrate
+@Description    Move entries from the table being drained by a resize into
+                the current table. The old table is freed once it has been
+                fully scanned.
+@Input          pHash        The hash table.
+@Input          uSteps       Maximum number of old table slots to scan.
+@Return         None
+*/ /**************************************************************************/
+static void
+_OAMigrate(HASH_TABLE *pHash, IMG_UINT32 uSteps)
+{
+	OA_TABLE *psOld = &pHash->sOAOldTable;
+
+	if (psOld->pbySlots == NULL)
+	{
+		return;
+	}
+
+	while (uSteps-- > 0 && pHash->uOAMigrateIndex < psOld->uSize)
+	{
+		OA_SLOT *pSlot = OA_SLOT_AT(pHash, psOld, pHash->uOAMigrateIndex);
+
+		if (pSlot->uState == OA_SLOT_USED)
+		{
+			/* PRQA S 0432,0541 1 */ /* ignore warning about dynamic array k */
+			_OAPlace(pHash, &pHash->sOATable, pSlot->k, pSlot->v);
+			pSlot->uState = OA_SLOT_TOMBSTONE;
+			psOld->uCount--;
+			psOld->uTombstones++;
+		}
+
+		pHash->uOAMigrateIndex++;
+	}
+
+	if (pHash->uOAMigrateIndex >= psOld->uSize)
+	{
+		PVR_ASSERT(psOld->uCount == 0);
+		_OATableFree(psOld);
+		pHash->uOAMigrateIndex = 0;
+	}
+}
+
+/*************************************************************************/ /*!
+@Function       _OAResize
+@Description    Start an incremental resize of an open addressed table. A new
+                table becomes the target of inserts and the current one is
+                drained a few slots at a time by later inserts and removes.
+                As with _Resize, failure to allocate is not a hard failure.
+                Resizing to the current size reclaims tombstones.
+@Input          pHash        Hash table to resize.
+@Input          uNewSize     Required table size.
+@Return         IMG_TRUE Success
+                IMG_FALSE Failed
+*/ /**************************************************************************/
+static IMG_BOOL
+_OAResize(HASH_TABLE *pHash, IMG_UINT32 uNewSize)
+{
+	OA_TABLE sNewTable;
+#if !defined(__KERNEL__) && defined(PERF_DBG_RESIZE)
+	struct timeval start, end;
+
+	gettimeofday(&start, NULL);
+#endif
+
+	/* Only one resize may be in flight, complete any earlier one */
+	_OAMigrate(pHash, pHash->sOAOldTable.uSize);
+
+	if (!_OATableAlloc(pHash, &sNewTable, uNewSize))
+	{
+		return IMG_FALSE;
+	}
+
+	pHash->sOAOldTable = pHash->sOATable;
+	pHash->sOATable = sNewTable;
+	pHash->uOAMigrateIndex = 0;
+
+	pHash->uSize = uNewSize;
+	pHash->uGrowThreshold = OA_GROW_THRESHOLD(uNewSize);
+	pHash->uShrinkThreshold = (uNewSize <= pHash->uMinimumSize) ? NO_SHRINK : OA_SHRINK_THRESHOLD(uNewSize);
+
+	_OAMigrate(pHash, OA_MIGRATE_STEP);
+
+#if !defined(__KERNEL__) && defined(PERF_DBG_RESIZE)
+	gettimeofday(&end, NULL);
+	if (start.tv_usec > end.tv_usec)
+	{
+		end.tv_usec = 1000000 - start.tv_usec + end.tv_usec;
+	}
+	else
+	{
+		end.tv_usec -= start.tv_usec;
+	}
+
+	PVR_DPF((PVR_DBG_ERROR, "%s: H:%p N:%d C:%d G:%d S:%d T:%06luus", __func__, pHash, uNewSize, pHash->uCount, pHash->uGrowThreshold, pHash->uShrinkThreshold, end.tv_usec));
+#endif
+
+	return IMG_TRUE;
+}
+
+static IMG_BOOL
+_OAInsert(HASH_TABLE *pHash, void *pKey, uintptr_t v)
+{
+	OA_TABLE *psTable = &pHash->sOATable;
+
+	if (pHash->uIterating == 0)
+	{
+		_OAMigrate(pHash, OA_MIGRATE_STEP);
+
+		if (psTable->uCount + psTable->uTombstones >= pHash->uGrowThreshold)
+		{
+			IMG_UINT32 uNewSize = pHash->uSize;
+
+			/* Grow until the table is at most 1/4 full, or stay at the same
+			 * size if it is tombstones that are filling it up */
+			while ((pHash->uCount + 1) * 4 > uNewSize &&
+			       uNewSize <= (IMG_UINT32_MAX >> 1))
+			{
+				uNewSize <<= 1;
+			}
+
+			/* Ignore the return code from _OAResize because the hash table
+			   is still in a valid state and although not ideally sized, it
+			   is still functional */
+			_OAResize(pHash, uNewSize);
+		}
+	}
+
+	/* Always leave an empty slot so that probe sequences terminate */
+	if (psTable->uCount + psTable->uTombstones + 1 >= psTable->uSize)
+	{
+		return IMG_FALSE;
+	}
+
+	_OAPlace(pHash, psTable, pKey, v);
+
+	pHash->uCount++;
+
+	return IMG_TRUE;
+}
+
+static uintptr_t
+_OARemove(HASH_TABLE *pHash, void *pKey)
+{
+	OA_TABLE *psTable = &pHash->sOATable;
+	IMG_UINT32 uIndex = _OAFind(pHash, psTable, pKey);
+	IMG_UINT32 uNext;
+	OA_SLOT *pSlot;
+	uintptr_t v;
+
+	if (uIndex == OA_NO_SLOT)
+	{
+		psTable = &pHash->sOAOldTable;
+		uIndex = _OAFind(pHash, psTable, pKey);
+		if (uIndex == OA_NO_SLOT)
+		{
+			return 0;
+		}
+	}
+
+	pSlot = OA_SLOT_AT(pHash, psTable, uIndex);
+	v = pSlot->v;
+
+	/* A slot followed by an empty one is not on any other key's probe
+	 * sequence so it can be emptied instead of becoming a tombstone. The
+	 * old table is scanned in order while it is drained, so always leave
+	 * tombstones there. */
+	uNext = (uIndex + 1 == psTable->uSize) ? 0 : uIndex + 1;
+	if (psTable == &pHash->sOATable &&
+	    OA_SLOT_AT(pHash, psTable, uNext)->uState == OA_SLOT_EMPTY)
+	{
+		pSlot->uState = OA_SLOT_EMPTY;
+	}
+	else
+	{
+		pSlot->uState = OA_SLOT_TOMBSTONE;
+		psTable->uTombstones++;
+	}
+	psTable->uCount--;
+
+	pHash->uCount--;
+
+	if (pHash->uIterating == 0)
+	{
+		_OAMigrate(pHash, OA_MIGRATE_STEP);
+
+		/* check if we need to think about re-balancing, when the shrink
+		 * threshold is 0 we are at the minimum size, no further shrink */
+		if (pHash->sOAOldTable.pbySlots == NULL &&
+		    pHash->uCount < pHash->uShrinkThreshold)
+		{
+			_OAResize(pHash, MAX(pHash->uSize >> 1, pHash->uMinimumSize));
+		}
+	}
+
+	return v;
+}
+
+static uintptr_t*
+_OARetrieveHandle(HASH_TABLE *pHash, void *pKey)
+{
+	OA_TABLE *psTable = &pHash->sOATable;
+	IMG_UINT32 uIndex = _OAFind(pHash, psTable, pKey);
+
+	if (uIndex == OA_NO_SLOT)
+	{
+		psTable = &pHash->sOAOldTable;
+		uIndex = _OAFind(pHash, psTable, pKey);
+		if (uIndex == OA_NO_SLOT)
+		{
+			return NULL;
+		}
+	}
+
+	return &OA_SLOT_AT(pHash, psTable, uIndex)->v;
+}
+
+static PVRSRV_ERROR
+_OAIterateTable(HASH_TABLE *pHash, OA_TABLE *psTable, HASH_pfnCallback pfnCallback, void* args)
+{
+	IMG_UINT32 uIndex;
+
+	for (uIndex = 0; psTable->pbySlots != NULL && uIndex < psTable->uSize; uIndex++)
+	{
+		OA_SLOT *pSlot = OA_SLOT_AT(pHash, psTable, uIndex);
+
+		if (pSlot->uState == OA_SLOT_USED)
+		{
+			PVRSRV_ERROR eError;
+
+			eError = pfnCallback((uintptr_t) ((void *) *(pSlot->k)), pSlot->v, args);
+
+			/* The callback might want us to break out early */
+			if (eError != PVRSRV_OK)
+				return eError;
+		}
+	}
+
+	return PVRSRV_OK;
+}
+
 /*************************************************************************/ /*!
 @Function       HASH_Create_Extended
 @Description    Create a self scaling hash table, using the supplied key size,
@@ -309,6 +739,37 @@ _Resize(HASH_TABLE *pHash, IMG_UINT32 uNewSize)
 */ /**************************************************************************/
 IMG_INTERNAL
 HASH_TABLE * HASH_Create_Extended_Int (IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp)
+{
+	return HASH_Create_Extended_Type_Int(uInitialLen, uKeySize, pfnHashFunc, pfnKeyComp,
+	                                     HASH_TABLE_TYPE_CHAINED);
+}
+
+#if defined(DEBUG)
+IMG_INTERNAL
+HASH_TABLE * HASH_Create_Extended_Debug (IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp,
+										 const char *file, const unsigned int line)
+{
+	return HASH_Create_Extended_Type_Debug(uInitialLen, uKeySize, pfnHashFunc, pfnKeyComp,
+	                                       HASH_TABLE_TYPE_CHAINED, file, line);
+}
+#endif
+
+/*************************************************************************/ /*!
+@Function       HASH_Create_Extended_Type
+@Description    Create a self scaling hash table as HASH_Create_Extended does,
+                using the given backend.
+@Input          uInitialLen  Initial and minimum length of the hash table,
+                             where the length refers to the number of entries
+                             in the hash table, not its size in bytes.
+@Input          uKeySize     The size of the key, in bytes.
+@Input          pfnHashFunc  Pointer to hash function.
+@Input          pfnKeyComp   Pointer to key comparison function.
+@Input          eType        Hash table backend.
+@Return         NULL or hash table handle.
+*/ /**************************************************************************/
+IMG_INTERNAL
+HASH_TABLE * HASH_Create_Extended_Type_Int (IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp,
+                                            HASH_TABLE_TYPE eType)
 {
 	HASH_TABLE *pHash;
 
@@ -320,21 +781,43 @@ HASH_TABLE * HASH_Create_Extended_Int (IMG_UINT32 uInitialLen, size_t uKeySize,
 
 	PVR_DPF((PVR_DBG_MESSAGE, "%s: InitialSize=0x%x", __func__, uInitialLen));
 
-	pHash = _AllocMem(sizeof(HASH_TABLE));
+	pHash = _AllocZMem(sizeof(HASH_TABLE));
 	if (pHash == NULL)
 	{
 		return NULL;
 	}
 
+	if (eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		/* Slot indices are masked, so keep the table a power of two */
+		uInitialLen = RoundUpToNextPowerOfTwo(MAX(uInitialLen, OA_MINIMUM_SIZE));
+	}
+
+	pHash->eType = eType;
 	pHash->uCount = 0;
 	pHash->uSize = uInitialLen;
 	pHash->uMinimumSize = uInitialLen;
 	pHash->uKeySize = uKeySize;
-	pHash->uGrowThreshold = (uInitialLen >> 2) * 3;
+	pHash->uGrowThreshold = (eType == HASH_TABLE_TYPE_OPEN_ADDRESSED) ?
+	                        OA_GROW_THRESHOLD(uInitialLen) : (uInitialLen >> 2) * 3;
 	pHash->uShrinkThreshold = NO_SHRINK;
 	pHash->pfnHashFunc = pfnHashFunc;
 	pHash->pfnKeyComp = pfnKeyComp;
 
+	if (eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		pHash->uSlotSize = sizeof(OA_SLOT) + PVR_ALIGN(uKeySize, sizeof(uintptr_t));
+
+		if (!_OATableAlloc(pHash, &pHash->sOATable, pHash->uSize))
+		{
+			_FreeMem(pHash);
+			/*not nulling pointer, out of scope*/
+			return NULL;
+		}
+
+		return pHash;
+	}
+
 	pHash->ppBucketTable = _AllocZMem(sizeof(BUCKET *) * pHash->uSize);
 	if (pHash->ppBucketTable == NULL)
 	{
@@ -348,12 +831,12 @@ HASH_TABLE * HASH_Create_Extended_Int (IMG_UINT32 uInitialLen, size_t uKeySize,
 
 #if defined(DEBUG)
 IMG_INTERNAL
-HASH_TABLE * HASH_Create_Extended_Debug (IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp,
-										 const char *file, const unsigned int line)
+HASH_TABLE * HASH_Create_Extended_Type_Debug (IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp,
+                                              HASH_TABLE_TYPE eType, const char *file, const unsigned int line)
 {
 	HASH_TABLE *hash;
-	hash = HASH_Create_Extended_Int(uInitialLen, uKeySize,
-									pfnHashFunc, pfnKeyComp);
+	hash = HASH_Create_Extended_Type_Int(uInitialLen, uKeySize,
+										 pfnHashFunc, pfnKeyComp, eType);
 	if (hash)
 	{
 		hash->pszFile = file;
@@ -447,7 +930,7 @@ HASH_Delete_Extended(HASH_TABLE *pHash, IMG_BOOL bWarn)
 #endif
 			}
 
-			for (i = 0; i < pHash->uSize; i++)
+			for (i = 0; pHash->ppBucketTable != NULL && i < pHash->uSize; i++)
 			{
 				BUCKET *pBucket = pHash->ppBucketTable[i];
 				while (pBucket != NULL)
@@ -459,8 +942,17 @@ HASH_Delete_Extended(HASH_TABLE *pHash, IMG_BOOL bWarn)
 			}
 
 		}
-		_FreeMem(pHash->ppBucketTable);
-		pHash->ppBucketTable = NULL;
+		if (pHash->eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+		{
+			/* Entries are stored inline, nothing else to free */
+			_OATableFree(&pHash->sOAOldTable);
+			_OATableFree(&pHash->sOATable);
+		}
+		else
+		{
+			_FreeMem(pHash->ppBucketTable);
+			pHash->ppBucketTable = NULL;
+		}
 		_FreeMem(pHash);
 		/*not nulling pointer, copy on stack*/
 	}
@@ -502,6 +994,11 @@ HASH_Insert_Extended(HASH_TABLE *pHash, void *pKey, uintptr_t v)
 		return IMG_FALSE;
 	}
 
+	if (pHash->eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		return _OAInsert(pHash, pKey, v);
+	}
+
 	pBucket = _AllocMem(sizeof(BUCKET) + pHash->uKeySize);
 	if (pBucket == NULL)
 	{
@@ -566,6 +1063,11 @@ HASH_Remove_Extended(HASH_TABLE *pHash, void *pKey)
 		return 0;
 	}
 
+	if (pHash->eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		return _OARemove(pHash, pKey);
+	}
+
 	uIndex = KEY_TO_INDEX(pHash, pKey, pHash->uSize);
 
 	for (ppBucket = &(pHash->ppBucketTable[uIndex]); *ppBucket != NULL; ppBucket = &((*ppBucket)->pNext))
@@ -635,6 +1137,11 @@ HASH_Retrieve_Handle_Extended(HASH_TABLE *pHash, void *pKey)
 		return 0;
 	}
 
+	if (pHash->eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		return _OARetrieveHandle(pHash, pKey);
+	}
+
 	uIndex = KEY_TO_INDEX(pHash, pKey, pHash->uSize);
 
 	for (ppBucket = &(pHash->ppBucketTable[uIndex]); *ppBucket != NULL; ppBucket = &((*ppBucket)->pNext))
@@ -704,6 +1211,24 @@ IMG_INTERNAL PVRSRV_ERROR
 HASH_Iterate(HASH_TABLE *pHash, HASH_pfnCallback pfnCallback, void* args)
 {
 	IMG_UINT32 uIndex;
+
+	if (pHash->eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		PVRSRV_ERROR eError;
+
+		/* Hold off resizing so that callbacks removing the entry they are
+		 * given do not move the remaining entries under us */
+		pHash->uIterating++;
+		eError = _OAIterateTable(pHash, &pHash->sOATable, pfnCallback, args);
+		if (eError == PVRSRV_OK)
+		{
+			eError = _OAIterateTable(pHash, &pHash->sOAOldTable, pfnCallback, args);
+		}
+		pHash->uIterating--;
+
+		return eError;
+	}
+
 	for (uIndex=0; uIndex < pHash->uSize; uIndex++)
 	{
 		BUCKET *pBucket;
@@ -752,6 +1277,20 @@ HASH_Dump(HASH_TABLE *pHash)
 	IMG_UINT32 uEmptyCount=0;
 
 	PVR_ASSERT(pHash != NULL);
+
+	if (pHash->eType == HASH_TABLE_TYPE_OPEN_ADDRESSED)
+	{
+		PVR_TRACE(("open addressed hash table: uMinimumSize=%d  size=%d  count=%d  bytes=%zu",
+				   pHash->uMinimumSize, pHash->uSize, pHash->uCount,
+				   (size_t)pHash->uSlotSize * (pHash->sOATable.uSize + pHash->sOAOldTable.uSize)));
+		PVR_TRACE(("  tombstones=%d  resizing=%d (old size=%d count=%d next=%d)",
+				   pHash->sOATable.uTombstones,
+				   pHash->sOAOldTable.pbySlots != NULL,
+				   pHash->sOAOldTable.uSize, pHash->sOAOldTable.uCount,
+				   pHash->uOAMigrateIndex));
+		return;
+	}
+
 	for (uIndex=0; uIndex<pHash->uSize; uIndex++)
 	{
 		BUCKET *pBucket;
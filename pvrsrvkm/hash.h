@@ -60,6 +60,24 @@ typedef IMG_BOOL HASH_KEY_COMP(size_t uKeySize, void *pKey1, void *pKey2);
 
 typedef struct _HASH_TABLE_ HASH_TABLE;
 
+/*
+ * Hash table backend, selected at creation time.
+ *
+ * HASH_TABLE_TYPE_CHAINED uses separate chaining with one allocation per
+ * entry and rehashes the whole table in one pass when it is resized.
+ *
+ * HASH_TABLE_TYPE_OPEN_ADDRESSED stores keys and values inline in a linear
+ * probing table, so inserts do not allocate, and spreads a resize over the
+ * inserts and removes that follow it. Handles returned by
+ * HASH_Retrieve_Handle(_Extended) on such a table are only valid until the
+ * next insert or remove.
+ */
+typedef enum _HASH_TABLE_TYPE_
+{
+	HASH_TABLE_TYPE_CHAINED = 0,
+	HASH_TABLE_TYPE_OPEN_ADDRESSED
+} HASH_TABLE_TYPE;
+
 typedef PVRSRV_ERROR (*HASH_pfnCallback) (
 	uintptr_t k,
 	uintptr_t v,
@@ -114,6 +132,29 @@ HASH_TABLE * HASH_Create_Extended_Debug (IMG_UINT32 uInitialLen, size_t uKeySize
 #define HASH_Create_Extended	HASH_Create_Extended_Int
 #endif
 
+/*************************************************************************/ /*!
+@Function       HASH_Create_Extended_Type
+@Description    Create a self scaling hash table as HASH_Create_Extended does,
+                using the given backend.
+@Input          uInitialLen  Initial and minimum length of the hash table,
+                             where the length refers to the number of entries
+                             in the hash table, not its size in bytes.
+@Input          uKeySize     The size of the key, in bytes.
+@Input          pfnHashFunc  Pointer to hash function.
+@Input          pfnKeyComp   Pointer to key comparison function.
+@Input          eType        Hash table backend.
+@Return         NULL or hash table handle.
+*/ /**************************************************************************/
+HASH_TABLE * HASH_Create_Extended_Type_Int(IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp,
+                                           HASH_TABLE_TYPE eType);
+#if defined(DEBUG)
+#define HASH_Create_Extended_Type(LEN, KS, FUN, CMP, TYPE)	HASH_Create_Extended_Type_Debug(LEN, KS, FUN, CMP, TYPE, __FILE__, __LINE__)
+HASH_TABLE * HASH_Create_Extended_Type_Debug (IMG_UINT32 uInitialLen, size_t uKeySize, HASH_FUNC *pfnHashFunc, HASH_KEY_COMP *pfnKeyComp,
+                                              HASH_TABLE_TYPE eType, const char *file, const unsigned int line);
+#else
+#define HASH_Create_Extended_Type	HASH_Create_Extended_Type_Int
+#endif
+
 /*************************************************************************/ /*!
 @Function       HASH_Create
 @Description    Create a self scaling hash table with a key consisting of a
@@ -45,6 +45,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #ifndef KM_APPHINT_DEFS_COMMON_H
 #define KM_APPHINT_DEFS_COMMON_H
 
+/* Number of deferred cleanup workers, for builds which do not set it */
+#if !defined(PVRSRV_APPHINT_CLEANUPTHREADWORKERS)
+#define PVRSRV_APPHINT_CLEANUPTHREADWORKERS 2
+#endif
+
 /*
 *******************************************************************************
  Build variables
@@ -54,6 +59,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /* name,                            type,           class,       default,                                      helper,           guest,  */ \
 X(EnableTrustedDeviceAceConfig,     BOOL,           GPUVIRT_VAL, PVRSRV_APPHINT_ENABLETRUSTEDDEVICEACECONFIG,  NO_PARAM_TABLE,   ALWAYS   ) \
 X(CleanupThreadPriority,            UINT32,         NEVER,       PVRSRV_APPHINT_CLEANUPTHREADPRIORITY,         NO_PARAM_TABLE,   ALWAYS   ) \
+X(CleanupThreadWorkers,             UINT32,         NEVER,       PVRSRV_APPHINT_CLEANUPTHREADWORKERS,          NO_PARAM_TABLE,   ALWAYS   ) \
 X(WatchdogThreadPriority,           UINT32,         NEVER,       PVRSRV_APPHINT_WATCHDOGTHREADPRIORITY,        NO_PARAM_TABLE,   ALWAYS   ) \
 X(HWPerfClientBufferSize,           UINT32,         ALWAYS,      PVRSRV_APPHINT_HWPERFCLIENTBUFFERSIZE,        NO_PARAM_TABLE,   ALWAYS   ) \
 X(DevmemHistoryBufSizeLog2,         UINT32,         ALWAYS,      PVRSRV_APPHINT_DEVMEM_HISTORY_BUFSIZE_LOG2,   NO_PARAM_TABLE,   ALWAYS   ) \
@@ -268,6 +268,11 @@ typedef struct _MMU_Levelx_INFO_
 	struct _MMU_Levelx_INFO_ *apsNextLevel[IMG_FLEX_ARRAY_MEMBER];
 } MMU_Levelx_INFO;
 
+/* Number of range locks per MMU context. The locks of a range are taken
+ * nested, so this must not exceed the number of lockdep subclasses (8). */
+#define MMU_CTX_RANGE_LOCKS     8U
+#define MMU_CTX_RANGE_LOCK_ALL  ((1U << MMU_CTX_RANGE_LOCKS) - 1U)
+
 /*!
 	MMU context structure
  */
@@ -298,8 +303,15 @@ struct _MMU_CONTEXT_
 	 * designs in use between the architectures, See SLC_VIVT feature. */
 	ATOMIC_T sCacheFlags;
 
-	/*! Lock to ensure exclusive access when manipulating the MMU context or
-	 * reading and using its content
+	/*! Locks serialising operations on the page tables of a range of the
+	 * context's virtual address space. Each base level entry maps onto one
+	 * of the locks, see _MMU_RangeLockAcquire(). Taken before hLock.
+	 */
+	POS_LOCK ahRangeLock[MMU_CTX_RANGE_LOCKS];
+
+	/*! Lock protecting state shared by all ranges of the context: the base
+	 * level reference count and the Px memory arena. Nests inside the range
+	 * locks and is held on its own while the context is destroyed.
 	 */
 	POS_LOCK hLock;
 
@@ -426,12 +438,25 @@ _CleanupThread_FreeMMUMapping(void* pvData)
 		goto freeNow;
 	}
 
-	if (psCleanup->psSync == NULL)
+	if (psCleanup->psSync == NULL ||
+	    !PVRSRVHasCounter32Advanced(OSReadDeviceMem32(psCleanup->psSync->pui32LinAddr),
+	                                psCleanup->uiRequiredSyncVal))
 	{
 		IMG_UINT32 uiSyncVal;
-		/* Kick to invalidate the MMU caches and get sync info */
-		eError = psDevNode->pfnMMUCacheInvalidateKick(psDevNode,
-		                                              &uiSyncVal);
+		/* Kick to invalidate the MMU caches and get sync info. The deferred
+		 * kick may leave the invalidate batched with others, in which case
+		 * it is sent by a GPU kick or by one of our retries once the batch
+		 * deadline has passed, so keep kicking until the sync advances. */
+		if (psDevNode->pfnMMUCacheInvalidateKickDeferred != NULL)
+		{
+			eError = psDevNode->pfnMMUCacheInvalidateKickDeferred(psDevNode,
+			                                                      &uiSyncVal);
+		}
+		else
+		{
+			eError = psDevNode->pfnMMUCacheInvalidateKick(psDevNode,
+			                                              &uiSyncVal);
+		}
 		if (eError != PVRSRV_OK)
 		{
 			OSLockRelease(psMMUCtxCleanupData->hCleanupLock);
@@ -1525,6 +1550,71 @@ static void _SetupPxE(MMU_CONTEXT *psMMUContext,
  *****************************************************************************/
 
 
+/*************************************************************************/ /*!
+@Function       _MMU_LevelRefInc
+
+@Description    Takes a reference on a level. Levels below the base level are
+                only reachable through one base level entry and are protected
+                by that entry's range lock. The base level is shared by all
+                ranges, so its count is updated under the context hLock.
+
+@Input          psMMUContext    MMU context the level belongs to
+
+@Input          psLevel         Level to reference
+
+@Return         The new reference count
+ */
+/*****************************************************************************/
+static INLINE IMG_UINT32 _MMU_LevelRefInc(MMU_CONTEXT *psMMUContext,
+                                          MMU_Levelx_INFO *psLevel)
+{
+	IMG_UINT32 ui32RefCount;
+
+	if (psLevel != &psMMUContext->sBaseLevelInfo)
+	{
+		return ++psLevel->ui32RefCount;
+	}
+
+	OSLockAcquire(psMMUContext->hLock);
+	ui32RefCount = ++psLevel->ui32RefCount;
+	OSLockRelease(psMMUContext->hLock);
+
+	return ui32RefCount;
+}
+
+/*************************************************************************/ /*!
+@Function       _MMU_LevelRefDec
+
+@Description    Drops a reference on a level, see _MMU_LevelRefInc.
+
+@Input          psMMUContext    MMU context the level belongs to
+
+@Input          psLevel         Level to dereference
+
+@Return         None
+ */
+/*****************************************************************************/
+static INLINE void _MMU_LevelRefDec(MMU_CONTEXT *psMMUContext,
+                                    MMU_Levelx_INFO *psLevel)
+{
+	IMG_BOOL bBaseLevel = (psLevel == &psMMUContext->sBaseLevelInfo);
+
+	if (bBaseLevel)
+	{
+		OSLockAcquire(psMMUContext->hLock);
+	}
+
+	psLevel->ui32RefCount--;
+
+	/* Check we haven't wrapped around */
+	PVR_ASSERT(psLevel->ui32RefCount <= psLevel->ui32NumOfEntries);
+
+	if (bBaseLevel)
+	{
+		OSLockRelease(psMMUContext->hLock);
+	}
+}
+
 /*************************************************************************/ /*!
 @Function       _MMU_FreeLevel
 
@@ -1669,21 +1759,20 @@ static IMG_BOOL _MMU_FreeLevel(MMU_CONTEXT *psMMUContext,
 				/* Free table of the level below, pointed to by this table entry.
 				 * We don't destroy the table inside the above _MMU_FreeLevel call because we
 				 * first have to set the table entry of the level above to invalid. */
+				OSLockAcquire(psMMUContext->hLock);
 				_PxMemFree(psMMUContext, &psNextLevel->sMemDesc, aeMMULevel[*pui32CurrentLevel]);
+				OSLockRelease(psMMUContext->hLock);
 				OSFreeMem(psNextLevel);
 
 				/* The level below us is empty, drop the refcount and clear the pointer */
-				psLevel->ui32RefCount--;
+				_MMU_LevelRefDec(psMMUContext, psLevel);
 				psLevel->apsNextLevel[i] = NULL;
-
-				/* Check we haven't wrapped around */
-				PVR_ASSERT(psLevel->ui32RefCount <= psLevel->ui32NumOfEntries);
 			}
 			(*pui32CurrentLevel)--;
 		}
 		else
 		{
-			psLevel->ui32RefCount--;
+			_MMU_LevelRefDec(psMMUContext, psLevel);
 		}
 
 		/*
@@ -1691,7 +1780,7 @@ static IMG_BOOL _MMU_FreeLevel(MMU_CONTEXT *psMMUContext,
 		   level in which case it's part of the MMU context and should be freed
 		   when the MMU context is freed
 		 */
-		if ((psLevel->ui32RefCount == 0) && (psLevel != &psMMUContext->sBaseLevelInfo))
+		if ((psLevel != &psMMUContext->sBaseLevelInfo) && (psLevel->ui32RefCount == 0))
 		{
 			bFreed = IMG_TRUE;
 		}
@@ -1788,6 +1877,7 @@ static PVRSRV_ERROR _MMU_AllocLevel(MMU_CONTEXT *psMMUContext,
 	PVRSRV_ERROR eError = PVRSRV_ERROR_OUT_OF_MEMORY;
 	IMG_UINT32 uiAllocState = 99; /* Debug info to check what progress was made in the function. Updated during this function. */
 	IMG_UINT32 i;
+	IMG_UINT32 ui32RefCount = 0;
 	PVRSRV_DEVICE_NODE *psDevNode = psMMUContext->psPhysMemCtx->psDevNode;
 
 	/* Parameter check */
@@ -1837,7 +1927,9 @@ static PVRSRV_ERROR _MMU_AllocLevel(MMU_CONTEXT *psMMUContext,
 
 				psNextLevel->ui32NumOfEntries = uiNextEntries;
 				psNextLevel->ui32RefCount = 0;
-				/* Allocate Px memory for a sub level*/
+				/* Allocate Px memory for a sub level. The Px arena is shared
+				 * by all ranges of the context so this needs hLock. */
+				OSLockAcquire(psMMUContext->hLock);
 				eError = _PxMemAlloc(psMMUContext, uiNextEntries, apsConfig[uiThisLevel + 1],
 				                     aeMMULevel[uiThisLevel + 1],
 				                     &psNextLevel->sMemDesc,
@@ -1847,6 +1939,7 @@ static PVRSRV_ERROR _MMU_AllocLevel(MMU_CONTEXT *psMMUContext,
 #endif
 				                     psConfig->uiAddrLog2Align
 );
+				OSLockRelease(psMMUContext->hLock);
 				if (eError != PVRSRV_OK)
 				{
 					uiAllocState = 1;
@@ -1868,7 +1961,7 @@ static PVRSRV_ERROR _MMU_AllocLevel(MMU_CONTEXT *psMMUContext,
 				          0,
 				          uiLog2DataPageSize);
 
-				psLevel->ui32RefCount++;
+				ui32RefCount = _MMU_LevelRefInc(psMMUContext, psLevel);
 			}
 #if defined(PVRSRV_MMU_PARITY_ON_PTALLOC_AND_PTEUNMAP)
 			else
@@ -1935,10 +2028,10 @@ static PVRSRV_ERROR _MMU_AllocLevel(MMU_CONTEXT *psMMUContext,
 		else
 		{
 			/* All we need to do for level 1 is bump the refcount */
-			psLevel->ui32RefCount++;
+			ui32RefCount = _MMU_LevelRefInc(psMMUContext, psLevel);
 		}
 
-		if (psLevel->ui32RefCount > psLevel->ui32NumOfEntries)
+		if (ui32RefCount > psLevel->ui32NumOfEntries)
 		{
 			/* Given how the reference counting is implemented for MMU_LEVEL_2
 			 * and MMU_LEVEL_3 this should never happen for those levels. Only
@@ -1996,7 +2089,7 @@ e0:
 			if (psLevel->apsNextLevel[i] != NULL &&
 			    psLevel->apsNextLevel[i]->ui32RefCount == 0)
 			{
-				psLevel->ui32RefCount--;
+				_MMU_LevelRefDec(psMMUContext, psLevel);
 			}
 		}
 		if (uiAllocState >= 2)
@@ -2004,8 +2097,10 @@ e0:
 			if (psLevel->apsNextLevel[i] != NULL &&
 			    psLevel->apsNextLevel[i]->ui32RefCount == 0)
 			{
+				OSLockAcquire(psMMUContext->hLock);
 				_PxMemFree(psMMUContext, &psLevel->apsNextLevel[i]->sMemDesc,
 				           aeMMULevel[uiThisLevel + 1]);
+				OSLockRelease(psMMUContext->hLock);
 			}
 		}
 		if (psLevel->apsNextLevel[i] != NULL &&
@@ -2020,12 +2115,9 @@ e0:
 		/* This is a PT which means that we just need to dereference it. It's
 		 * going to be freed on the PD level in this error path in the `if`
 		 * clause above. */
-		psLevel->ui32RefCount--;
+		_MMU_LevelRefDec(psMMUContext, psLevel);
 	}
 
-	/* Check we haven't wrapped around */
-	PVR_ASSERT(psLevel->ui32RefCount <= psLevel->ui32NumOfEntries);
-
 e1:
 	i--;
 
@@ -2074,15 +2166,14 @@ e1:
 			                   uiNextStartIndex, uiNextEndIndex,
 			                   bNextFirst, bNextLast, uiLog2DataPageSize))
 			{
+				OSLockAcquire(psMMUContext->hLock);
 				_PxMemFree(psMMUContext, &psLevel->apsNextLevel[i]->sMemDesc,
 				           aeMMULevel[uiThisLevel + 1]);
+				OSLockRelease(psMMUContext->hLock);
 				OSFreeMem(psLevel->apsNextLevel[i]);
 				psLevel->apsNextLevel[i] = NULL;
 
-				psLevel->ui32RefCount--;
-
-				/* Check we haven't wrapped around */
-				PVR_ASSERT(psLevel->ui32RefCount <= psLevel->ui32NumOfEntries);
+				_MMU_LevelRefDec(psMMUContext, psLevel);
 			}
 			(*pui32CurrentLevel)--;
 		}
@@ -2090,10 +2181,7 @@ e1:
 		{
 			/* We should never come down this path, but it's here
 			   for completeness */
-			psLevel->ui32RefCount--;
-
-			/* Check we haven't wrapped around */
-			PVR_ASSERT(psLevel->ui32RefCount <= psLevel->ui32NumOfEntries);
+			_MMU_LevelRefDec(psMMUContext, psLevel);
 		}
 	}
 
@@ -2730,6 +2818,66 @@ UnlockAndReturn:
 /*
 	MMU_InitDevice
 */
+/*************************************************************************/ /*!
+@Function       _MMUDebugRequestNotify
+
+@Description    Dumps the MMU_MapPMRFast() PTE write and MMU cache
+                invalidate statistics of a device.
+*/
+/*****************************************************************************/
+static void _MMUDebugRequestNotify(PVRSRV_DBGREQ_HANDLE hDebugRequestHandle,
+                                   IMG_UINT32 ui32VerbLevel,
+                                   DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
+                                   void *pvDumpDebugFile)
+{
+	PVRSRV_DEVICE_NODE *psDevNode = (PVRSRV_DEVICE_NODE *) hDebugRequestHandle;
+	MMU_MAP_STATS sStats;
+	OS_SPINLOCK_FLAGS uiFlags;
+	IMG_UINT64 ui64PagesPerSec = 0;
+
+	if (!DD_VERB_LVL_ENABLED(ui32VerbLevel, DEBUG_REQUEST_VERBOSITY_MEDIUM))
+	{
+		return;
+	}
+
+	OSSpinLockAcquire(psDevNode->sMMUMapStats.hLock, uiFlags);
+	sStats = psDevNode->sMMUMapStats;
+	OSSpinLockRelease(psDevNode->sMMUMapStats.hLock, uiFlags);
+
+	if (sStats.ui64MapTimeNs != 0)
+	{
+		/* Scale down to microseconds so the divisor fits in 32 bits */
+		IMG_UINT32 ui32Rem;
+		IMG_UINT64 ui64TimeUs = OSDivide64r64(sStats.ui64MapTimeNs, 1000, &ui32Rem);
+
+		if (ui64TimeUs != 0 && ui64TimeUs <= IMG_UINT32_MAX)
+		{
+			ui64PagesPerSec = OSDivide64r64(sStats.ui64PagesMapped * 1000000,
+			                                (IMG_UINT32) ui64TimeUs, &ui32Rem);
+		}
+	}
+
+	PVR_DUMPDEBUG_LOG("------[ MMU PTE Write Stats Device ID:%d ]------",
+	                  psDevNode->sDevId.ui32InternalID);
+	PVR_DUMPDEBUG_LOG("MapPMRFast: calls %" IMG_UINT64_FMTSPEC
+	                  ", pages %" IMG_UINT64_FMTSPEC
+	                  ", contiguous runs %" IMG_UINT64_FMTSPEC
+	                  ", PTE write time %" IMG_UINT64_FMTSPEC "ns"
+	                  ", %" IMG_UINT64_FMTSPEC " pages/s",
+	                  sStats.ui64MapCalls, sStats.ui64PagesMapped,
+	                  sStats.ui64RunsWritten, sStats.ui64MapTimeNs,
+	                  ui64PagesPerSec);
+	/* Updated under the power lock, a torn read here is harmless */
+	PVR_DUMPDEBUG_LOG("Cache invalidate: requested %" IMG_UINT64_FMTSPEC
+	                  ", coalesced %" IMG_UINT64_FMTSPEC
+	                  ", issued %" IMG_UINT64_FMTSPEC
+	                  ", sent with GPU kicks %" IMG_UINT64_FMTSPEC,
+	                  psDevNode->sMMUCacheInvalStats.ui64Requested,
+	                  psDevNode->sMMUCacheInvalStats.ui64Coalesced,
+	                  psDevNode->sMMUCacheInvalStats.ui64Issued,
+	                  psDevNode->sMMUCacheInvalStats.ui64Piggybacked);
+}
+
 PVRSRV_ERROR MMU_InitDevice(struct _PVRSRV_DEVICE_NODE_ *psDevNode)
 {
 	PVRSRV_ERROR eError;
@@ -2779,8 +2927,23 @@ PVRSRV_ERROR MMU_InitDevice(struct _PVRSRV_DEVICE_NODE_ *psDevNode)
 	                               DEV_ZERO_PAGE);
 	PVR_LOG_GOTO_IF_ERROR(eError, "_MMU_AllocBackingPage.Zero", ErrFreeScratchPage);
 
+	OSCachedMemSet(&psDevNode->sMMUMapStats, 0, sizeof(psDevNode->sMMUMapStats));
+	eError = OSSpinLockCreate(&psDevNode->sMMUMapStats.hLock);
+	PVR_LOG_GOTO_IF_ERROR(eError, "OSSpinLockCreate.MapStats", ErrFreeZeroPage);
+
+	eError = PVRSRVRegisterDeviceDbgRequestNotify(&psDevNode->hMMUDbgReqNotify,
+	                                              psDevNode,
+	                                              _MMUDebugRequestNotify,
+	                                              DEBUG_REQUEST_SYS,
+	                                              psDevNode);
+	PVR_LOG_GOTO_IF_ERROR(eError, "PVRSRVRegisterDeviceDbgRequestNotify", ErrFreeMapStatsLock);
+
 	return PVRSRV_OK;
 
+ErrFreeMapStatsLock:
+	OSSpinLockDestroy(psDevNode->sMMUMapStats.hLock);
+ErrFreeZeroPage:
+	_MMU_FreeBackingPage(psDevNode, DEV_ZERO_PAGE);
 ErrFreeScratchPage:
 	_MMU_FreeBackingPage(psDevNode, SCRATCH_PAGE);
 ErrFreeZeroPageLock:
@@ -2798,6 +2961,15 @@ ErrReturnError:
 */
 void MMU_DeInitDevice(struct _PVRSRV_DEVICE_NODE_ *psDevNode)
 {
+	/* The map stats lock is only valid once the notifier is registered */
+	if (psDevNode->hMMUDbgReqNotify != NULL)
+	{
+		PVRSRVUnregisterDeviceDbgRequestNotify(psDevNode->hMMUDbgReqNotify);
+		psDevNode->hMMUDbgReqNotify = NULL;
+
+		OSSpinLockDestroy(psDevNode->sMMUMapStats.hLock);
+	}
+
 	if (psDevNode->sScratchPage.psPgLock != NULL)
 	{
 		_MMU_FreeBackingPage(psDevNode, SCRATCH_PAGE);
@@ -2831,6 +3003,7 @@ MMU_ContextCreate(CONNECTION_DATA *psConnection,
 	MMU_PHYSMEM_CONTEXT *psPhysMemCtx;
 	IMG_UINT32 ui32BaseObjects;
 	IMG_UINT32 ui32Size;
+	IMG_UINT32 i;
 	IMG_CHAR sBuf[40];
 	PVRSRV_ERROR eError = PVRSRV_OK;
 
@@ -2997,11 +3170,23 @@ MMU_ContextCreate(CONNECTION_DATA *psConnection,
 	eError = OSLockCreate(&psMMUContext->hLock);
 	PVR_LOG_GOTO_IF_ERROR(eError, "OSLockCreate", e6);
 
+	for (i = 0; i < MMU_CTX_RANGE_LOCKS; i++)
+	{
+		eError = OSLockCreate(&psMMUContext->ahRangeLock[i]);
+		PVR_LOG_GOTO_IF_ERROR(eError, "OSLockCreate", e7);
+	}
+
 	/* return context */
 	*ppsMMUContext = psMMUContext;
 
 	return PVRSRV_OK;
 
+e7:
+	while (i-- > 0)
+	{
+		OSLockDestroy(psMMUContext->ahRangeLock[i]);
+	}
+	OSLockDestroy(psMMUContext->hLock);
 e6:
 	_PxMemFree(psMMUContext, &psMMUContext->sBaseLevelInfo.sMemDesc, psDevAttrs->psBaseConfig->ePxLevel);
 e5:
@@ -3026,6 +3211,7 @@ MMU_ContextDestroy (MMU_CONTEXT *psMMUContext)
 {
 	PVRSRV_DATA *psPVRSRVData = PVRSRVGetPVRSRVData();
 	PDLLIST_NODE psNode, psNextNode;
+	IMG_UINT32 i;
 
 	PVRSRV_DEVICE_NODE *psDevNode = (PVRSRV_DEVICE_NODE *)psMMUContext->psPhysMemCtx->psDevNode;
 	MMU_CTX_CLEANUP_DATA *psCleanupData = psMMUContext->psPhysMemCtx->psCleanupData;
@@ -3100,6 +3286,10 @@ MMU_ContextDestroy (MMU_CONTEXT *psMMUContext)
 	}
 
 	OSLockDestroy(psMMUContext->hLock);
+	for (i = 0; i < MMU_CTX_RANGE_LOCKS; i++)
+	{
+		OSLockDestroy(psMMUContext->ahRangeLock[i]);
+	}
 
 	/* free the context itself. */
 	OSFreeMem(psMMUContext);
@@ -3108,6 +3298,144 @@ MMU_ContextDestroy (MMU_CONTEXT *psMMUContext)
 	PVR_DPF((PVR_DBG_MESSAGE, "%s: Exit", __func__));
 }
 
+/*************************************************************************/ /*!
+@Function       _MMU_RangeLockAcquire
+
+@Description    Acquires the range locks covering a virtual address range.
+                Base level entries are mapped onto the locks modulo
+                MMU_CTX_RANGE_LOCKS, so operations under different base level
+                entries can modify their page tables concurrently. Ranges
+                spanning as many entries as there are locks, and MMUs whose
+                base level is a page table, take every lock.
+                Locks are always taken in ascending order.
+
+@Input          psMMUContext    MMU context to operate on
+
+@Input          sDevVAddrStart  Start of the range
+
+@Input          sDevVAddrEnd    End of the range (exclusive)
+
+@Return         Mask of the locks taken, to pass to _MMU_RangeLockRelease
+ */
+/*****************************************************************************/
+static IMG_UINT32 _MMU_RangeLockAcquire(MMU_CONTEXT *psMMUContext,
+                                        IMG_DEV_VIRTADDR sDevVAddrStart,
+                                        IMG_DEV_VIRTADDR sDevVAddrEnd)
+{
+	const MMU_DEVVADDR_CONFIG *psDevVAddrConfig =
+	    psMMUContext->psDevAttrs->psTopLevelDevVAddrConfig;
+	IMG_UINT32 ui32LockMask = MMU_CTX_RANGE_LOCK_ALL;
+	IMG_UINT64 uiIndexMask = 0;
+	IMG_UINT8 uiIndexShift = 0;
+	IMG_UINT32 i;
+
+	switch (psMMUContext->psDevAttrs->psBaseConfig->ePxLevel)
+	{
+		case MMU_LEVEL_3:
+			uiIndexMask = psDevVAddrConfig->uiPCIndexMask;
+			uiIndexShift = psDevVAddrConfig->uiPCIndexShift;
+			break;
+		case MMU_LEVEL_2:
+			uiIndexMask = psDevVAddrConfig->uiPDIndexMask;
+			uiIndexShift = psDevVAddrConfig->uiPDIndexShift;
+			break;
+		default:
+			break;
+	}
+
+	if (uiIndexMask != 0 && sDevVAddrEnd.uiAddr > sDevVAddrStart.uiAddr)
+	{
+		IMG_UINT32 uiFirst = (IMG_UINT32)((sDevVAddrStart.uiAddr & uiIndexMask) >> uiIndexShift);
+		IMG_UINT32 uiLast = (IMG_UINT32)(((sDevVAddrEnd.uiAddr - 1) & uiIndexMask) >> uiIndexShift);
+
+		if (uiLast >= uiFirst && (uiLast - uiFirst) < MMU_CTX_RANGE_LOCKS)
+		{
+			ui32LockMask = 0;
+			for (i = uiFirst; i <= uiLast; i++)
+			{
+				ui32LockMask |= 1U << (i % MMU_CTX_RANGE_LOCKS);
+			}
+		}
+	}
+
+	for (i = 0; i < MMU_CTX_RANGE_LOCKS; i++)
+	{
+		if (ui32LockMask & (1U << i))
+		{
+			OSLockAcquireNested(psMMUContext->ahRangeLock[i], i);
+		}
+	}
+
+	return ui32LockMask;
+}
+
+/*************************************************************************/ /*!
+@Function       _MMU_RangeLockRelease
+
+@Description    Releases range locks taken by _MMU_RangeLockAcquire.
+
+@Input          psMMUContext    MMU context to operate on
+
+@Input          ui32LockMask    Mask returned by _MMU_RangeLockAcquire
+
+@Return         None
+ */
+/*****************************************************************************/
+static void _MMU_RangeLockRelease(MMU_CONTEXT *psMMUContext,
+                                  IMG_UINT32 ui32LockMask)
+{
+	IMG_UINT32 i;
+
+	for (i = MMU_CTX_RANGE_LOCKS; i-- > 0;)
+	{
+		if (ui32LockMask & (1U << i))
+		{
+			OSLockRelease(psMMUContext->ahRangeLock[i]);
+		}
+	}
+}
+
+/*************************************************************************/ /*!
+@Function       _MMU_RangeEnd
+
+@Description    Returns the exclusive end address of the pages touched by a
+                map or unmap call, taking sparse page indices into account.
+
+@Input          sDevVAddrBase   Base address of the call
+
+@Input          ui32PageCount   Number of pages
+
+@Input          paui32Indices   Optional page indices relative to the base
+
+@Input          uiLog2PageSize  Log2 of the page size
+
+@Return         End address of the range
+ */
+/*****************************************************************************/
+static IMG_DEV_VIRTADDR _MMU_RangeEnd(IMG_DEV_VIRTADDR sDevVAddrBase,
+                                      IMG_UINT32 ui32PageCount,
+                                      const IMG_UINT32 *paui32Indices,
+                                      IMG_UINT32 uiLog2PageSize)
+{
+	IMG_DEV_VIRTADDR sDevVAddrEnd = sDevVAddrBase;
+	IMG_UINT64 ui64NumPages = ui32PageCount;
+
+	if (paui32Indices != NULL)
+	{
+		IMG_UINT32 i;
+
+		ui64NumPages = 0;
+		for (i = 0; i < ui32PageCount; i++)
+		{
+			ui64NumPages = MAX(ui64NumPages, (IMG_UINT64)paui32Indices[i] + 1);
+		}
+	}
+
+	sDevVAddrEnd.uiAddr += ui64NumPages << uiLog2PageSize;
+
+	return sDevVAddrEnd;
+}
+
 /*
 	MMU_Alloc
  */
@@ -3128,6 +3456,7 @@ MMU_Alloc (MMU_CONTEXT *psMMUContext,
 
 	MMU_DEVICEATTRIBS *psDevAttrs;
 	IMG_HANDLE hPriv;
+	IMG_UINT32 ui32RangeLocks;
 
 #if !defined(DEBUG)
 	PVR_UNREFERENCED_PARAMETER(uiProtFlags);
@@ -3165,8 +3494,7 @@ MMU_Alloc (MMU_CONTEXT *psMMUContext,
 	sDevVAddrEnd = *psDevVAddr;
 	sDevVAddrEnd.uiAddr += uSize;
 
-	OSLockAcquire(psMMUContext->hLock);
-
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, *psDevVAddr, sDevVAddrEnd);
 
 #if defined(SUPPORT_TRUSTED_DEVICE) && defined(RGX_PREMAP_FW_HEAPS)
 	if (_MMU_IS_FWKM_CTX(psMMUContext))
@@ -3178,7 +3506,7 @@ MMU_Alloc (MMU_CONTEXT *psMMUContext,
 	{
 		eError = _AllocPageTables(psMMUContext, *psDevVAddr, sDevVAddrEnd, uiLog2PageSize);
 	}
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	if (eError != PVRSRV_OK)
 	{
@@ -3202,6 +3530,7 @@ MMU_Free (MMU_CONTEXT *psMMUContext,
 {
 	IMG_DEV_VIRTADDR sDevVAddrEnd;
 	MMU_PHYSMEM_CONTEXT *psPhysMemCtx;
+	IMG_UINT32 ui32RangeLocks;
 #if defined(SUPPORT_MMU_DEFERRED_FREE)
 	PVRSRV_DEV_POWER_STATE ePowerState;
 	PVRSRV_ERROR eError;
@@ -3220,12 +3549,12 @@ MMU_Free (MMU_CONTEXT *psMMUContext,
 	sDevVAddrEnd = sDevVAddr;
 	sDevVAddrEnd.uiAddr += uiSize;
 
-	/* The Cleanup lock has to be taken before the MMUContext hLock to
+	/* The Cleanup lock has to be taken before the MMUContext locks to
 	 * prevent deadlock scenarios. It is necessary only for parts of
 	 * _SetupCleanup_FreeMMUMapping though.*/
 	OSLockAcquire(psPhysMemCtx->psCleanupData->hCleanupLock);
 
-	OSLockAcquire(psMMUContext->hLock);
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddr, sDevVAddrEnd);
 
 #if defined(SUPPORT_TRUSTED_DEVICE) && defined(RGX_PREMAP_FW_HEAPS)
 	if (!_MMU_IS_FWKM_CTX(psMMUContext))
@@ -3237,6 +3566,9 @@ MMU_Free (MMU_CONTEXT *psMMUContext,
 		                uiLog2DataPageSize);
 	}
 
+	/* The defer-free list is shared by all ranges */
+	OSLockAcquire(psMMUContext->hLock);
+
 #if defined(SUPPORT_MMU_DEFERRED_FREE)
 	eError = PVRSRVGetDevicePowerState(psPhysMemCtx->psDevNode, &ePowerState);
 	if (eError != PVRSRV_OK)
@@ -3261,6 +3593,8 @@ MMU_Free (MMU_CONTEXT *psMMUContext,
 #endif
 	OSLockRelease(psMMUContext->hLock);
 
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
+
 	OSLockRelease(psMMUContext->psPhysMemCtx->psCleanupData->hCleanupLock);
 }
 
@@ -3302,6 +3636,7 @@ MMU_MapPages(MMU_CONTEXT *psMMUContext,
 	IMG_BOOL bValid;
 	IMG_BOOL bScratchBacking = IMG_FALSE, bZeroBacking = IMG_FALSE;
 	PVRSRV_DEVICE_NODE *psDevNode;
+	IMG_UINT32 ui32RangeLocks;
 
 #if defined(PDUMP)
 	IMG_UINT32 ui32MappedCount = 0;
@@ -3402,7 +3737,11 @@ MMU_MapPages(MMU_CONTEXT *psMMUContext,
 	PMRMarkForDeferFree(psPMR);
 #endif /* defined(SUPPORT_PMR_DEFERRED_FREE) */
 
-	OSLockAcquire(psMMUContext->hLock);
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddrBase,
+	                                       _MMU_RangeEnd(sDevVAddrBase,
+	                                                     ui32MapPageCount,
+	                                                     paui32MapIndices,
+	                                                     uiLog2HeapPageSize));
 
 	for (uiLoop = 0; uiLoop < ui32MapPageCount; uiLoop++)
 	{
@@ -3614,7 +3953,7 @@ MMU_MapPages(MMU_CONTEXT *psMMUContext,
 		PVR_LOG_GOTO_IF_ERROR(eError, "pfnMMUCacheInvalidateKickAndWait", ErrUnlockAndUnmapPages);
 	}
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	_MMU_PutPTConfig(psMMUContext, hPriv);
 
@@ -3639,7 +3978,7 @@ ErrUnlockAndUnmapPages:
 	                              paui32MapIndices,
 	                              uiLog2HeapPageSize);
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 ErrPutPTConfig:
 	_MMU_PutPTConfig(psMMUContext, hPriv);
 ErrFreeValidArray:
@@ -3692,7 +4031,7 @@ MMU_UnmapPagesUnlocked(MMU_CONTEXT *psMMUContext,
 	             ((IMG_UINT64)sDevVAddr.uiAddr) + (uiPageSize*ui32PageCount)-1);
 #endif
 
-	PVR_ASSERT(OSLockIsLocked(psMMUContext->hLock));
+	/* The caller holds the range locks covering the pages */
 
 	bScratchBacking = PVRSRV_IS_SPARSE_SCRATCH_BACKING_REQUIRED(uiMappingFlags);
 	bZeroBacking = PVRSRV_IS_ZERO_BACKING_REQUIRED(uiMappingFlags);
@@ -3860,8 +4199,13 @@ MMU_UnmapPages(MMU_CONTEXT *psMMUContext,
                IMG_UINT32 uiLog2PageSize)
 {
 	PVRSRV_ERROR eError;
+	IMG_UINT32 ui32RangeLocks;
 
-	OSLockAcquire(psMMUContext->hLock);
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddrBase,
+	                                       _MMU_RangeEnd(sDevVAddrBase,
+	                                                     ui32PageCount,
+	                                                     pai32FreeIndices,
+	                                                     uiLog2PageSize));
 
 	eError = MMU_UnmapPagesUnlocked(psMMUContext,
 	                                uiMappingFlags,
@@ -3870,7 +4214,7 @@ MMU_UnmapPages(MMU_CONTEXT *psMMUContext,
 	                                pai32FreeIndices,
 	                                uiLog2PageSize);
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	return eError;
 }
@@ -3903,6 +4247,7 @@ MMUX_MapVRangeToBackingPage(MMU_CONTEXT *psMMUContext,
 	IMG_HANDLE hPriv;
 
 	IMG_DEV_PHYADDR sDevPAddr;
+	IMG_UINT32 ui32RangeLocks;
 
 	PVRSRV_DEVICE_NODE *psDevNode = psMMUContext->psPhysMemCtx->psDevNode;
 
@@ -3982,7 +4327,11 @@ MMUX_MapVRangeToBackingPage(MMU_CONTEXT *psMMUContext,
 	}
 #endif /*DEBUG*/
 
-	OSLockAcquire(psMMUContext->hLock);
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddrBase,
+	                                       _MMU_RangeEnd(sDevVAddrBase,
+	                                                     ui32MapPageCount,
+	                                                     NULL,
+	                                                     uiLog2HeapPageSize));
 
 	for (uiLoop = 0; uiLoop < ui32MapPageCount; uiLoop++)
 	{
@@ -4056,7 +4405,7 @@ MMUX_MapVRangeToBackingPage(MMU_CONTEXT *psMMUContext,
 		PVR_GOTO_IF_ERROR(eError, ErrUnlockAndUnmapPages);
 	}
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	_MMU_PutPTConfig(psMMUContext, hPriv);
 
@@ -4076,12 +4425,93 @@ ErrUnlockAndUnmapPages:
 	                              NULL,
 	                              uiLog2HeapPageSize);
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 ErrPutPTConfig:
 	_MMU_PutPTConfig(psMMUContext, hPriv);
 	return eError;
 }
 
+/*************************************************************************/ /*!
+@Function       _MMU_WritePTEs64
+
+@Description    Writes a block of 8 byte PTEs. The block is walked as runs of
+                physically contiguous pages: the address field is derived
+                once per run and then advanced by a constant step, so the
+                per-page cost is an add and a store (plus the parity bit
+                when the MMU requires it).
+
+@Input          pui64PTE            First PTE to write
+@Input          pasDevPAddr         Device physical address of each page
+@Input          uiNumEntries        Number of PTEs to write
+@Input          psConfig            PTE configuration
+@Input          uiProtFlags         Protection bits common to all entries
+@Input          uiLog2PageSize      Log2 of the data page size
+@Input          psDevVAddrRunning   Device virtual address of the first page,
+                                    advanced past the block on return. NULL
+                                    if the PTEs carry no parity bit.
+
+@Return         Number of contiguous runs written
+*/
+/*****************************************************************************/
+static IMG_UINT32
+_MMU_WritePTEs64(IMG_UINT64 *pui64PTE,
+                 const IMG_DEV_PHYADDR *pasDevPAddr,
+                 IMG_UINT32 uiNumEntries,
+                 const MMU_PxE_CONFIG *psConfig,
+                 IMG_UINT64 uiProtFlags,
+                 IMG_UINT32 uiLog2PageSize,
+                 IMG_DEV_VIRTADDR *psDevVAddrRunning)
+{
+	const IMG_UINT64 uiPageSize = IMG_UINT64_C(1) << uiLog2PageSize;
+	const IMG_UINT64 uiAddrMask = psConfig->uiAddrMask;
+	const IMG_UINT8 uiAddrLog2Align = psConfig->uiAddrLog2Align;
+	const IMG_UINT8 uiAddrShift = psConfig->uiAddrShift;
+	const IMG_UINT8 uiParityShift = psConfig->uiParityBitShift;
+	IMG_UINT64 uiAddrStep;
+	IMG_UINT32 i = 0, uiRuns = 0;
+
+	/* A page smaller than the PTE address alignment cannot form a run */
+	uiAddrStep = (uiLog2PageSize >= uiAddrLog2Align) ?
+	             (uiPageSize >> uiAddrLog2Align) << uiAddrShift : 0;
+
+	while (i < uiNumEntries)
+	{
+		IMG_UINT64 uiAddrField =
+		    ((pasDevPAddr[i].uiAddr >> uiAddrLog2Align) << uiAddrShift) & uiAddrMask;
+
+		uiRuns++;
+
+		for (;;)
+		{
+			IMG_UINT64 ui64PxE = uiAddrField | uiProtFlags;
+
+			if (psDevVAddrRunning != NULL)
+			{
+				ui64PxE |= _GetParityBit(psDevVAddrRunning->uiAddr ^ pasDevPAddr[i].uiAddr) << uiParityShift;
+				psDevVAddrRunning->uiAddr += uiPageSize;
+			}
+
+			pui64PTE[i++] = ui64PxE;
+
+			if (i == uiNumEntries || uiAddrStep == 0 ||
+			    pasDevPAddr[i].uiAddr != pasDevPAddr[i - 1].uiAddr + uiPageSize)
+			{
+				break;
+			}
+
+			/* Restart the run if the step would carry out of the field, so
+			 * the result always matches the per-page computation. */
+			uiAddrField += uiAddrStep;
+			if ((uiAddrField & uiAddrMask) != uiAddrField)
+			{
+				break;
+			}
+		}
+	}
+
+	return uiRuns;
+}
+
 PVRSRV_ERROR
 MMU_MapPMRFast(MMU_CONTEXT *psMMUContext,
                IMG_DEV_VIRTADDR sDevVAddrBase,
@@ -4104,9 +4534,12 @@ MMU_MapPMRFast(MMU_CONTEXT *psMMUContext,
 	IMG_UINT8 uiAddrLog2Align, uiAddrShift, uiParityShift;
 	IMG_UINT64 uiAddrMask, uiProtFlags;
 	IMG_UINT32 uiBytesPerEntry;
-	IMG_UINT64 uiParityBit = 0;
 	IMG_BOOL bSetParity = IMG_FALSE;
 	IMG_DEV_VIRTADDR sDevVAddrRunning, sDevVAddrBaseCopy = sDevVAddrBase;
+	IMG_DEV_VIRTADDR sDevVAddrEnd;
+	IMG_UINT32 ui32RangeLocks;
+	IMG_UINT64 ui64StartNs, ui64RunsWritten = 0;
+	OS_SPINLOCK_FLAGS uiStatsFlags;
 
 	IMG_UINT64* pui64LevelBase;
 	IMG_UINT32* pui32LevelBase;
@@ -4182,7 +4615,10 @@ MMU_MapPMRFast(MMU_CONTEXT *psMMUContext,
 	PMRMarkForDeferFree(psPMR);
 #endif /* defined(SUPPORT_PMR_DEFERRED_FREE) */
 
-	OSLockAcquire(psMMUContext->hLock);
+	sDevVAddrEnd.uiAddr = sDevVAddrBase.uiAddr + uiSizeBytes;
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddrBase, sDevVAddrEnd);
+
+	ui64StartNs = OSClockns64();
 
 	do
 	{
@@ -4257,26 +4693,30 @@ MMU_MapPMRFast(MMU_CONTEXT *psMMUContext,
 
 			if (uiBytesPerEntry == 8)
 			{
-				for (i=0; i<uiNumPagesInBlock; i++)
-				{
-					if (bSetParity)
-					{
-						uiParityBit = _GetParityBit(sDevVAddrRunning.uiAddr ^ asDevPAddr[i].uiAddr);
-						uiParityBit <<= uiParityShift;
-
-						sDevVAddrRunning.uiAddr += (IMG_UINT64_C(1) << uiLog2HeapPageSize);
-					}
+				IMG_UINT64 *pui64PTE = &pui64LevelBase[uiPTEIndex + uiChunkStart];
 
-					if (eRemapPolicy == MMU_PTE_REMAP_POLICY_BLOCK &&
-					    pui64LevelBase[uiPTEIndex + uiChunkStart + i] & psConfig->uiValidEnMask &&
-					    (uiProtFlags & psConfig->uiValidEnMask))
+				/* Check the whole block up front so the write loop below
+				 * carries no per-entry policy test. */
+				if (eRemapPolicy == MMU_PTE_REMAP_POLICY_BLOCK &&
+				    (uiProtFlags & psConfig->uiValidEnMask))
+				{
+					for (i=0; i<uiNumPagesInBlock; i++)
 					{
-						/* Don't remap */
-						PVR_GOTO_WITH_ERROR(eError, PVRSRV_ERROR_MMU_REMAP_BLOCKED, unlock_mmu_context);
+						if (pui64PTE[i] & psConfig->uiValidEnMask)
+						{
+							/* Don't remap */
+							PVR_GOTO_WITH_ERROR(eError, PVRSRV_ERROR_MMU_REMAP_BLOCKED, unlock_mmu_context);
+						}
 					}
-					pui64LevelBase[uiPTEIndex + uiChunkStart + i] =
-						(((asDevPAddr[i].uiAddr >> uiAddrLog2Align) << uiAddrShift) & uiAddrMask) | uiProtFlags | uiParityBit;
 				}
+
+				ui64RunsWritten += _MMU_WritePTEs64(pui64PTE,
+				                                    asDevPAddr,
+				                                    uiNumPagesInBlock,
+				                                    psConfig,
+				                                    uiProtFlags,
+				                                    uiLog2HeapPageSize,
+				                                    bSetParity ? &sDevVAddrRunning : NULL);
 			}
 			else if (uiBytesPerEntry == 4)
 			{
@@ -4381,7 +4821,20 @@ MMU_MapPMRFast(MMU_CONTEXT *psMMUContext,
 
 	} while (ui32PagesDone < uiNumPages);
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
+
+	if (uiBytesPerEntry == 4)
+	{
+		/* The 4 byte path writes one entry at a time */
+		ui64RunsWritten = uiNumPages;
+	}
+
+	OSSpinLockAcquire(psDevNode->sMMUMapStats.hLock, uiStatsFlags);
+	psDevNode->sMMUMapStats.ui64MapCalls++;
+	psDevNode->sMMUMapStats.ui64PagesMapped += uiNumPages;
+	psDevNode->sMMUMapStats.ui64RunsWritten += ui64RunsWritten;
+	psDevNode->sMMUMapStats.ui64MapTimeNs += OSClockns64() - ui64StartNs;
+	OSSpinLockRelease(psDevNode->sMMUMapStats.hLock, uiStatsFlags);
 
 #if defined(PDUMP)
 	PDUMPCOMMENT(psDevNode, "Wired up %d Page Table entries (out of %d)", ui32MappedCount, uiNumPages);
@@ -4406,7 +4859,7 @@ unlock_mmu_context:
 		                                uiNumPages,
 		                                uiLog2HeapPageSize);
 	}
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 put_mmu_context:
 	_MMU_PutPTConfig(psMMUContext, hPriv);
 
@@ -4448,7 +4901,7 @@ MMU_UnmapPMRFastUnlocked(MMU_CONTEXT *psMMUContext,
 
 	PVRSRV_DEVICE_NODE *psDevNode = psMMUContext->psPhysMemCtx->psDevNode;
 
-	PVR_ASSERT(OSLockIsLocked(psMMUContext->hLock));
+	/* The caller holds the range locks covering the pages */
 
 	eError = _MMU_ConvertDevMemFlags(IMG_TRUE,
 	                                 0,
@@ -4628,15 +5081,20 @@ MMU_UnmapPMRFast(MMU_CONTEXT *psMMUContext,
                  IMG_UINT32 uiLog2PageSize)
 {
 	PVRSRV_ERROR eError;
+	IMG_UINT32 ui32RangeLocks;
 
-	OSLockAcquire(psMMUContext->hLock);
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddrBase,
+	                                       _MMU_RangeEnd(sDevVAddrBase,
+	                                                     ui32PageCount,
+	                                                     NULL,
+	                                                     uiLog2PageSize));
 
 	eError = MMU_UnmapPMRFastUnlocked(psMMUContext,
                                       sDevVAddrBase,
                                       ui32PageCount,
                                       uiLog2PageSize);
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	return eError;
 }
@@ -4665,6 +5123,7 @@ MMU_RemapPage(MMU_CONTEXT *psMMUContext,
 
 	IMG_DEV_PHYADDR sTargetDevPAddr;
 	IMG_BOOL bValid = IMG_FALSE;
+	IMG_UINT32 ui32RangeLocks;
 
 	/* Validate the most essential parameters */
 	PVR_LOG_RETURN_IF_INVALID_PARAM(psMMUContext != NULL, "psMMUContext");
@@ -4702,7 +5161,9 @@ MMU_RemapPage(MMU_CONTEXT *psMMUContext,
 		uiProtFlags = psMMUContext->psDevAttrs->pfnDerivePTEProt8(uiMMUProtFlags , uiLog2HeapPageSize);
 	}
 
-	OSLockAcquire(psMMUContext->hLock);
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddr,
+	                                       _MMU_RangeEnd(sDevVAddr, 1, NULL,
+	                                                     uiLog2HeapPageSize));
 
 	eError = PMR_DevPhysAddr(psOriginPMR,
 	                         uiLog2HeapPageSize,
@@ -4744,7 +5205,7 @@ MMU_RemapPage(MMU_CONTEXT *psMMUContext,
 	                            psConfig->uiBytesPerEntry);
 	PVR_LOG_GOTO_IF_ERROR(eError, "PhysHeapPagesClean", ErrUnlockAndUnmapPages);
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	_MMU_PutPTConfig(psMMUContext, hPriv);
 
@@ -4773,7 +5234,7 @@ ErrUnlockAndUnmapPages:
 	}
 
 ErrUnlockContext:
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 ErrPutPTConfig:
 	_MMU_PutPTConfig(psMMUContext, hPriv);
@@ -4995,8 +5456,12 @@ void MMU_CheckFaultAddress(MMU_CONTEXT *psMMUContext,
 	IMG_UINT32 ui32Log2PageSize;
 	MMU_FAULT_DATA sMMUFaultData = {0};
 	MMU_LEVEL_DATA *psMMULevelData;
+	IMG_DEV_VIRTADDR sDevVAddrEnd;
+	IMG_UINT32 ui32RangeLocks;
 
-	OSLockAcquire(psMMUContext->hLock);
+	/* Only the tables translating the faulting address are walked */
+	sDevVAddrEnd.uiAddr = psDevVAddr->uiAddr + 1;
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, *psDevVAddr, sDevVAddrEnd);
 
 	/*
 		At this point we don't know the page size so assume it's 4K.
@@ -5143,7 +5608,7 @@ void MMU_CheckFaultAddress(MMU_CONTEXT *psMMUContext,
 
 	/* Put the page size data back */
 	psDevAttrs->pfnPutPageSizeConfiguration(hPriv);
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	*psOutFaultData = sMMUFaultData;
 }
@@ -5158,8 +5623,11 @@ static IMG_UINT64 MMU_GetVDevAddrPTE(MMU_CONTEXT *psMMUContext,
 	IMG_UINT32 uiIndex = 0;
 	IMG_BOOL bStatus = IMG_FALSE;
 	IMG_UINT64 ui64Entry = 0;
+	IMG_DEV_VIRTADDR sDevVAddrEnd;
+	IMG_UINT32 ui32RangeLocks;
 
-	OSLockAcquire(psMMUContext->hLock);
+	sDevVAddrEnd.uiAddr = sDevVAddr.uiAddr + 1;
+	ui32RangeLocks = _MMU_RangeLockAcquire(psMMUContext, sDevVAddr, sDevVAddrEnd);
 
 	switch (psMMUContext->psDevAttrs->psBaseConfig->ePxLevel)
 	{
@@ -5197,7 +5665,7 @@ static IMG_UINT64 MMU_GetVDevAddrPTE(MMU_CONTEXT *psMMUContext,
 			break;
 	}
 
-	OSLockRelease(psMMUContext->hLock);
+	_MMU_RangeLockRelease(psMMUContext, ui32RangeLocks);
 
 	*pbStatusOut = bStatus;
 
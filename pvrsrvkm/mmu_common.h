@@ -89,6 +89,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pvrsrv_error.h"
 #include "servicesext.h"
 #include "sync_prim_internal.h"
+#include "lock.h"
 
 /*!
 	The level of the MMU
@@ -282,6 +283,35 @@ typedef struct _MMU_PAGESIZECONFIG_
 	IMG_UINT32 uiMaxRefCount;
 } MMU_PAGESIZECONFIG;
 
+/*
+ * Per-device statistics for the MMU_MapPMRFast() PTE write path. A "run" is
+ * a sequence of physically contiguous pages whose PTEs are derived from the
+ * first entry of the run rather than recomputed per page.
+ */
+typedef struct _MMU_MAP_STATS_
+{
+	POS_SPINLOCK hLock;
+	IMG_UINT64 ui64MapCalls;
+	IMG_UINT64 ui64PagesMapped;
+	IMG_UINT64 ui64RunsWritten;
+	IMG_UINT64 ui64MapTimeNs;
+} MMU_MAP_STATS;
+
+/*
+ * Per-device MMU cache invalidation state. Deferrable kicks fold their
+ * flags into a pending batch which is flushed by the next GPU kick, or by
+ * the next deferrable kick made after the batch deadline has passed.
+ * Updated with the device power lock held.
+ */
+typedef struct _MMU_CACHE_INVAL_STATS_
+{
+	IMG_UINT64 ui64BatchStartNs;  /*!< Time the pending batch was opened, 0 if none */
+	IMG_UINT64 ui64Requested;     /*!< Kicks requested by the MMU/PMR code */
+	IMG_UINT64 ui64Coalesced;     /*!< Deferrable kicks folded into a pending batch */
+	IMG_UINT64 ui64Issued;        /*!< Stand-alone MMU cache commands sent to the FW */
+	IMG_UINT64 ui64Piggybacked;   /*!< MMU cache commands sent ahead of a GPU kick */
+} MMU_CACHE_INVAL_STATS;
+
 /*************************************************************************/ /*!
 @Function       MMU_InitDevice
 
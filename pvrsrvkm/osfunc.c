@@ -906,6 +906,16 @@ INLINE uintptr_t OSGetCurrentThreadID(void)
 	return current->pid;
 }
 
+IMG_UINT32 OSGetCurrentCPU(void)
+{
+	return (IMG_UINT32)raw_smp_processor_id();
+}
+
+IMG_UINT32 OSGetCPUCount(void)
+{
+	return (IMG_UINT32)nr_cpu_ids;
+}
+
 IMG_PID OSGetCurrentClientProcessIDKM(void)
 {
 	return OSGetCurrentProcessID();
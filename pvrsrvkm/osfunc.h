@@ -675,6 +675,24 @@ IMG_UINT64 OSGetCurrentProcessVASpaceSize(void);
 *****************************************************************************/
 uintptr_t OSGetCurrentThreadID(void);
 
+/*************************************************************************/ /*!
+@Function       OSGetCurrentCPU
+@Description    Returns the index of the CPU the caller is running on. The
+                caller may be migrated at any point after this returns, so
+                the value must only be used as a hint (e.g. to pick a per-CPU
+                cache whose accesses are otherwise serialised).
+@Return         Index of current CPU, always < OSGetCPUCount()
+*****************************************************************************/
+IMG_UINT32 OSGetCurrentCPU(void);
+
+/*************************************************************************/ /*!
+@Function       OSGetCPUCount
+@Description    Returns the number of CPUs that may ever be brought online
+                in the system.
+@Return         Number of possible CPUs
+*****************************************************************************/
+IMG_UINT32 OSGetCPUCount(void);
+
 /*************************************************************************/ /*!
 @Function       OSGetCurrentClientProcessIDKM
 @Description    Returns ID of current client process (thread group) which
@@ -51,6 +51,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pvrsrv_device.h"
 #include "physheap.h"
 #include "physmem_osmem.h"
+#include "pvrsrv_cleanup.h"
 
 static void HostMemCpuPAddrToDevPAddr(IMG_HANDLE hPrivData,
                                       IMG_UINT32 ui32NumOfAddr,
@@ -177,7 +178,7 @@ PVRSRV_ERROR HostMemDeviceCreate(PVRSRV_DEVICE_NODE **ppsDeviceNode)
 	psDeviceNode->psMMUDevAttrs = (MMU_DEVICEATTRIBS*)(psDeviceNode + 1);
 	psDeviceNode->psMMUDevAttrs->ui32ValidPageSizeMask = OSGetPageSize();
 
-	dllist_init(&psDeviceNode->sCleanupThreadWorkList);
+	PVRSRVCleanupThreadInitDevice(psDeviceNode);
 
 	return PVRSRV_OK;
 
@@ -139,10 +139,14 @@ _CreateArenas(PHEAP_IMPL_DATA pvImplData, IMG_CHAR *pszLabel, PHYS_HEAP_POLICY u
 {
 	PHYSMEM_LMA_DATA *psLMAData = (PHYSMEM_LMA_DATA*)pvImplData;
 
+	/* Card memory arenas are long lived and fragment, index their free
+	 * segments so that large aligned allocations do not walk the buckets */
 	IMG_UINT32 ui32RAPolicy =
 	    ((uiPolicy & PHYS_HEAP_POLICY_ALLOC_ALLOW_NONCONTIG_MASK) == PHYS_HEAP_POLICY_ALLOC_ALLOW_NONCONTIG)
 	    ? RA_POLICY_ALLOC_ALLOW_NONCONTIG : RA_POLICY_DEFAULT;
 
+	ui32RAPolicy |= RA_POLICY_FREE_INDEX_TREE;
+
 	psLMAData->psRA = RA_Create_With_Span(pszLabel,
 	                             OSGetPageShift(),
 	                             psLMAData->sStartAddr.uiAddr,
@@ -64,7 +64,7 @@ static IMG_UINT32 PhysHeapOSGetPageShift(void)
 
 static const PHEAP_IMPL_FUNCS _sPHEAPImplFuncs =
 {
-	.pfnDestroyData = NULL,
+	.pfnDestroyData = PhysmemDestroyOSRamHeapData,
 	.pfnGetFactoryMemStats = PhysmemGetOSRamMemStats,
 	.pfnCreatePMR = PhysmemNewOSRamBackedPMR,
 	.pfnPagesAlloc = &OSPhyContigPagesAlloc,
@@ -85,7 +85,7 @@ PhysmemCreateHeapOSMEM(PVRSRV_DEVICE_NODE *psDevNode,
 	return PhysHeapCreate(psDevNode,
 	                      psConfig,
 	                      uiPolicy,
-	                      NULL,
+	                      psDevNode,
 	                      &_sPHEAPImplFuncs,
 	                      ppsPhysHeap);
 }
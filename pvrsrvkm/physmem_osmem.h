@@ -148,4 +148,13 @@ void PhysmemGetOSRamMemStats(PHEAP_IMPL_DATA pvImplData,
                             IMG_UINT64 *pui64TotalSize,
                             IMG_UINT64 *pui64FreeSize);
 
+/*************************************************************************/ /*!
+@Function       PhysmemDestroyOSRamHeapData
+@Description    Called when an OSMEM heap is destroyed. Frees the memory the
+                OS DDK port is still caching for the device of the heap.
+@Input          pvImplData     Physical heap private data, the device node.
+@Return         None.
+*/ /**************************************************************************/
+void PhysmemDestroyOSRamHeapData(PHEAP_IMPL_DATA pvImplData);
+
 #endif /* PHYSMEM_OSMEM_H */
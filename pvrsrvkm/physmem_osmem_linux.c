@@ -54,6 +54,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <linux/gfp.h>
 #include <linux/sched.h>
 #include <linux/atomic.h>
+#include <linux/percpu.h>
+#include <linux/spinlock.h>
+#include <linux/workqueue.h>
+#include <linux/jiffies.h>
 #if defined(SUPPORT_LINUX_OSPAGE_MIGRATION)
 #include <linux/migrate.h>
 #if (LINUX_VERSION_CODE < KERNEL_VERSION(6, 0, 0))
@@ -83,6 +87,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "devicemem_server_utils.h"
 #include "pvr_vmap.h"
 #include "physheap.h"
+#include "di_server.h"
 #if defined(PVRSRV_PHYSMEM_CPUMAP_HISTORY)
 #include "physmem_cpumap_history.h"
 #endif
@@ -286,6 +291,9 @@ static PVRSRV_ERROR
 _FreePagesFromPoolUnlocked(IMG_UINT32 uiMaxPagesToFree,
 						   IMG_UINT32 *puiPagesFreed);
 
+static IMG_UINT32
+_DrainPageMagazines(IMG_UINT32 uiMaxPagesToFree);
+
 static inline PVRSRV_ERROR
 _ApplyOSPagesAttribute(PVRSRV_DEVICE_NODE *psDevNode,
 					   struct page **ppsPage,
@@ -379,6 +387,170 @@ static DEFINE_MUTEX(g_sPagePoolMutex);
 static LIST_HEAD(g_sPagePoolList_WC);
 static LIST_HEAD(g_sPagePoolList_UC);
 
+/* Per-CPU magazines in front of the page pool lists.
+ * Small allocations and frees are served from the magazine of the current
+ * CPU without taking g_sPagePoolMutex. A magazine is refilled from the
+ * global pool in batches while the pool lock is held anyway and frees that
+ * do not fit go to the global pool as before. Pages in the magazines are
+ * still pool pages: they are accounted in the pool memory stats, count
+ * towards the pool limits and are reclaimed by the shrinker.
+ * Frees only go to the magazines when the pool does not need to zero its
+ * pages, otherwise they have to go through the deferred cleanup. */
+#define PVR_LINUX_PHYSMEM_MAGAZINE_PAGES 64
+#define PVR_LINUX_PHYSMEM_MAGAZINE_BATCH 32
+
+typedef struct
+{
+	/* Only contended by the shrinker or a task migrated off this CPU */
+	spinlock_t sLock;
+	IMG_UINT32 uiCount;
+	/* Frees fill up to PVR_LINUX_PHYSMEM_MAGAZINE_PAGES, a refill may
+	 * race with them so leave room for one batch on top */
+	struct page *apsPages[PVR_LINUX_PHYSMEM_MAGAZINE_PAGES + PVR_LINUX_PHYSMEM_MAGAZINE_BATCH];
+} LinuxPageMagazine;
+
+typedef struct
+{
+	LinuxPageMagazine asPool[PHYSMEM_OSMEM_NUM_OF_POOLS];
+} LinuxPageMagazines;
+
+static DEFINE_PER_CPU(LinuxPageMagazines, g_sPageMagazines);
+
+/* Pages currently held by all magazines */
+static ATOMIC_T g_iPagesInMagazines;
+
+/* Page pool statistics, exported through the "page_pool" DI entry */
+static struct
+{
+	/* Updated without the pool lock */
+	ATOMIC_T iMagazineGetPages;
+	ATOMIC_T iMagazinePutPages;
+	ATOMIC_T iMagazineRefills;
+
+	ATOMIC_T iZeroReserveHitPages;
+	ATOMIC_T iZeroReserveMissPages;
+
+	/* Protected by the pool lock */
+	IMG_UINT64 ui64PoolGetPages;
+	IMG_UINT64 ui64PoolLockAcquired;
+	IMG_UINT64 ui64PoolLockHeldNs;
+	IMG_UINT64 ui64PoolLockTakenNs;
+
+	/* Only written by the zeroed reserve worker */
+	IMG_UINT64 ui64ZeroReserveZeroNs;
+	IMG_UINT32 ui32ZeroReserveZeroedPages;
+} g_sPagePoolStats;
+
+/* Reserves of pool pages that are already zeroed, one per pool.
+ * Pool pages are not zeroed when they are freed so allocations asking for
+ * zeroed memory cannot take them and have to clear fresh OS pages
+ * synchronously. While no zeroed allocation is running a worker moves pages
+ * from the pool lists to the reserves, zeroing them through the same UC/WC
+ * mapping the deferred cleanup uses, and zeroed allocations take them from
+ * there. When a reserve is empty the allocation falls back to zeroing.
+ * Reserve pages are still pool pages: they are accounted in the pool memory
+ * stats, count towards the pool limits and are reclaimed by the shrinker
+ * after the pool lists and the magazines.
+ * Pages are only added to a reserve with the pool lock held, which keeps
+ * the shrinker from racing the worker. Allocations take pages under the
+ * reserve spinlock only. */
+#if !defined(PVR_PHYSMEM_ZERO_ALL_PAGES)
+#if !defined(PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES)
+#define PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES 512 /* 2 MB */
+#endif
+#if PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES > 0
+#define PHYSMEM_OSMEM_ZERO_RESERVE
+#endif
+#endif
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+/* The worker is kicked once a reserve drops below this */
+#define PVR_LINUX_PHYSMEM_ZERO_RESERVE_LOW (PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES / 2)
+/* Pages taken from the pool lists and zeroed in one go */
+#define PVR_LINUX_PHYSMEM_ZERO_RESERVE_BATCH 64
+/* Refills wait until no zeroed allocation used the reserves for this long */
+#define PVR_LINUX_PHYSMEM_ZERO_RESERVE_IDLE_MS 10
+
+typedef struct
+{
+	IMG_UINT32 uiCount;
+	struct page *apsPages[PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES];
+} LinuxZeroReserve;
+
+static DEFINE_SPINLOCK(g_sZeroReserveLock);
+static LinuxZeroReserve g_asZeroReserve[PHYSMEM_OSMEM_NUM_OF_POOLS];
+
+/* Pages currently held by all reserves */
+static ATOMIC_T g_iPagesInZeroReserves;
+
+static struct delayed_work g_sZeroReserveWork;
+/* Cleared at deinitialisation to stop the worker from being queued */
+static ATOMIC_T g_iZeroReserveEnabled;
+/* jiffies of the last zeroed allocation that used the reserves */
+static unsigned long g_ulZeroReserveLastUse;
+
+static IMG_UINT32
+_DrainZeroReserves(IMG_UINT32 uiMaxPagesToFree);
+
+static void
+_ZeroReserveWorker(struct work_struct *psWork);
+#endif /* defined(PHYSMEM_OSMEM_ZERO_RESERVE) */
+
+/* Pools of device pages larger than the OS page.
+ * Device pages larger than PAGE_SIZE are allocated as physically contiguous
+ * chunks through the DMA/CMA framework, which is slow for large orders and
+ * fails more often the more fragmented memory gets. Freed chunks of the
+ * orders below are kept here instead, one list per pool caching mode, and
+ * handed out again to allocations with the same device page size, so heaps
+ * using 64 KB and 2 MB pages keep getting contiguous memory after warm-up.
+ * Like the page pool, cached memory is not pooled and pooled chunks keep
+ * their caching attributes. They are not zeroed when they are freed.
+ * A chunk still belongs to the device that allocated it, so the chunks of a
+ * device are freed when its OSMEM heap is destroyed.
+ * All protected by the pool lock. */
+#if !defined(PVR_LINUX_PHYSMEM_ORDER4_POOL_CHUNKS)
+#define PVR_LINUX_PHYSMEM_ORDER4_POOL_CHUNKS 256 /* 16 MB with 4 KB pages */
+#endif
+#if !defined(PVR_LINUX_PHYSMEM_ORDER9_POOL_CHUNKS)
+#define PVR_LINUX_PHYSMEM_ORDER9_POOL_CHUNKS 8 /* 16 MB with 4 KB pages */
+#endif
+
+#define PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS 2
+
+typedef struct
+{
+	struct list_head sChunkPoolItem;
+	/* Arguments for _FreeOSPage_CMA */
+	struct device *psDev;
+	void *pvVirtAddr;
+	dma_addr_t sBusAddr;
+	struct page *psPage;
+} LinuxChunkPoolEntry;
+
+typedef struct
+{
+	IMG_UINT32 uiOrder;
+	/* Watermark, freed chunks above it go back to the OS */
+	IMG_UINT32 uiMaxChunks;
+	IMG_UINT32 uiChunks;
+	struct list_head asList[PHYSMEM_OSMEM_NUM_OF_POOLS];
+
+	IMG_UINT64 ui64GetChunks;
+	IMG_UINT64 ui64MissChunks;
+	IMG_UINT64 ui64PutChunks;
+	IMG_UINT64 ui64ReclaimedChunks;
+} LinuxChunkPool;
+
+static LinuxChunkPool g_asChunkPools[PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS] = {
+	{ .uiOrder = 4, .uiMaxChunks = PVR_LINUX_PHYSMEM_ORDER4_POOL_CHUNKS },
+	{ .uiOrder = 9, .uiMaxChunks = PVR_LINUX_PHYSMEM_ORDER9_POOL_CHUNKS },
+};
+
+static IMG_UINT32
+_DrainChunkPools(IMG_UINT32 uiMaxPagesToFree, struct device *psDev);
+
+static DI_ENTRY *g_psPagePoolDIEntry;
+
 
 static IMG_BOOL g_bInitialisedOnAlloc = IMG_FALSE;
 
@@ -837,24 +1009,99 @@ _PagesInPoolUnlocked(void)
 	return uiCnt;
 }
 
+static inline void
+_PagePoolLockTaken(void)
+{
+	g_sPagePoolStats.ui64PoolLockAcquired++;
+	g_sPagePoolStats.ui64PoolLockTakenNs = OSClockns64();
+}
+
 static inline void
 _PagePoolLock(void)
 {
 	mutex_lock(&g_sPagePoolMutex);
+	_PagePoolLockTaken();
 }
 
 static inline int
 _PagePoolTrylock(void)
 {
-	return mutex_trylock(&g_sPagePoolMutex);
+	int iLocked = mutex_trylock(&g_sPagePoolMutex);
+
+	if (iLocked)
+	{
+		_PagePoolLockTaken();
+	}
+
+	return iLocked;
 }
 
 static inline void
 _PagePoolUnlock(void)
 {
+	g_sPagePoolStats.ui64PoolLockHeldNs +=
+		OSClockns64() - g_sPagePoolStats.ui64PoolLockTakenNs;
 	mutex_unlock(&g_sPagePoolMutex);
 }
 
+/* Index of the pool for a caching mode in g_aui32CPUCacheFlags */
+static inline IMG_UINT32
+_GetPoolIndex(IMG_UINT32 ui32CPUCacheFlags)
+{
+#if defined(CONFIG_X86)
+	if (PVRSRV_CPU_CACHE_MODE(ui32CPUCacheFlags) == PVRSRV_MEMALLOCFLAG_CPU_UNCACHED_WC)
+	{
+		return 1;
+	}
+#else
+	PVR_UNREFERENCED_PARAMETER(ui32CPUCacheFlags);
+#endif
+	return 0;
+}
+
+/* Page protection to write to pool pages with. It has to match the caching
+ * attributes the pages were given when they were allocated. */
+static inline pgprot_t
+_GetPoolPgprot(IMG_UINT32 ui32CPUCacheFlags)
+{
+#if defined(CONFIG_X86)
+	/* For x86 we can only map with the same attributes
+	 * as in the PAT settings */
+	if (PVRSRV_CPU_CACHE_MODE(ui32CPUCacheFlags) == PVRSRV_MEMALLOCFLAG_CPU_UNCACHED)
+	{
+		return pgprot_noncached(PAGE_KERNEL);
+	}
+#else
+	PVR_UNREFERENCED_PARAMETER(ui32CPUCacheFlags);
+#endif
+	return pgprot_writecombine(PAGE_KERNEL);
+}
+
+/* Chunk pool for device pages of the given order, NULL if there is none */
+static inline LinuxChunkPool *
+_GetChunkPool(IMG_UINT32 uiOrder)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS; i++)
+	{
+		if (g_asChunkPools[i].uiOrder == uiOrder)
+		{
+			return &g_asChunkPools[i];
+		}
+	}
+
+	return NULL;
+}
+
+static inline LinuxPageMagazine *
+_GetPageMagazine(IMG_UINT32 ui32CPUCacheFlags)
+{
+	/* Preemption is not disabled, if the task migrates it only ends up
+	 * using the magazine of another CPU which is fine under its lock */
+	return &raw_cpu_ptr(&g_sPageMagazines)->asPool[_GetPoolIndex(ui32CPUCacheFlags)];
+}
+
 static inline IMG_BOOL
 _GetPoolListHead(IMG_UINT32 ui32CPUCacheFlags,
 				 struct list_head **ppsPoolHead,
@@ -900,11 +1147,34 @@ static struct shrinker *g_psShrinker = &g_sShrinker;
 static struct shrinker *g_psShrinker;
 #endif
 
-/* Returning the number of pages that still reside in the page pool. */
+/* Returning the number of pages that still reside in the page pool,
+ * including the per-CPU magazines and the zeroed reserves. */
 static unsigned long
 _GetNumberOfPagesInPoolUnlocked(void)
 {
-	return _PagesInPoolUnlocked();
+	unsigned long uiPages = _PagesInPoolUnlocked() + OSAtomicRead(&g_iPagesInMagazines);
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	uiPages += OSAtomicRead(&g_iPagesInZeroReserves);
+#endif
+
+	return uiPages;
+}
+
+/* Returning the number of OS pages held by the chunk pools. They have their
+ * own watermarks and do not count towards the page pool limits. */
+static unsigned long
+_GetNumberOfPagesInChunkPoolsUnlocked(void)
+{
+	unsigned long uiPages = 0;
+	IMG_UINT32 i;
+
+	for (i = 0; i < PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS; i++)
+	{
+		uiPages += (unsigned long)g_asChunkPools[i].uiChunks << g_asChunkPools[i].uiOrder;
+	}
+
+	return uiPages;
 }
 
 /* Linux shrinker function that informs the OS about how many pages we are caching and
@@ -921,7 +1191,7 @@ _CountObjectsInPagePool(struct shrinker *psShrinker, struct shrink_control *psSh
 	/* In order to avoid possible deadlock use mutex_trylock in place of mutex_lock */
 	if (_PagePoolTrylock() == 0)
 		return 0;
-	remain = _GetNumberOfPagesInPoolUnlocked();
+	remain = _GetNumberOfPagesInPoolUnlocked() + _GetNumberOfPagesInChunkPoolsUnlocked();
 	_PagePoolUnlock();
 
 	return remain;
@@ -945,6 +1215,26 @@ _ScanObjectsInPagePool(struct shrinker *psShrinker, struct shrink_control *psShr
 							   &uiPagesFreed);
 	uNumToScan -= uiPagesFreed;
 
+	if (uNumToScan != 0)
+	{
+		uNumToScan -= _DrainPageMagazines(uNumToScan);
+	}
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	/* Zeroed pages cost more to get back than the ones above */
+	if (uNumToScan != 0)
+	{
+		uNumToScan -= _DrainZeroReserves(uNumToScan);
+	}
+#endif
+
+	/* Contiguous chunks are the hardest to get back, free them last.
+	 * Whole chunks are freed so this may free more than asked for. */
+	if (uNumToScan != 0)
+	{
+		uNumToScan -= MIN(uNumToScan, _DrainChunkPools(uNumToScan, NULL));
+	}
+
 	/* Returning the number of pages freed during the scan */
 	_PagePoolUnlock();
 	return psShrinkControl->nr_to_scan - uNumToScan;
@@ -959,10 +1249,95 @@ static struct shrinker g_sShrinker =
 };
 #endif
 
+static int _PagePoolDIShow(OSDI_IMPL_ENTRY *psEntry, void *pvData)
+{
+	IMG_UINT32 ui32UCCount, ui32WCCount = 0;
+	IMG_UINT64 ui64PoolGetPages, ui64LockAcquired, ui64LockHeldNs;
+	LinuxChunkPool asChunkPools[PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS];
+	IMG_UINT32 i;
+
+	PVR_UNREFERENCED_PARAMETER(pvData);
+
+	_PagePoolLock();
+	/* Only the counters of the copies are used */
+	memcpy(asChunkPools, g_asChunkPools, sizeof(asChunkPools));
+	ui32UCCount = g_ui32PagePoolUCCount;
+#if defined(CONFIG_X86)
+	ui32WCCount = g_ui32PagePoolWCCount;
+#endif
+	ui64PoolGetPages = g_sPagePoolStats.ui64PoolGetPages;
+	ui64LockAcquired = g_sPagePoolStats.ui64PoolLockAcquired;
+	ui64LockHeldNs = g_sPagePoolStats.ui64PoolLockHeldNs;
+	_PagePoolUnlock();
+
+	DIPrintf(psEntry, "UC pool pages: %u\n", ui32UCCount);
+	DIPrintf(psEntry, "WC pool pages: %u\n", ui32WCCount);
+	DIPrintf(psEntry, "Magazine pages: %d\n", OSAtomicRead(&g_iPagesInMagazines));
+	DIPrintf(psEntry, "Magazine capacity per CPU: %u\n", PVR_LINUX_PHYSMEM_MAGAZINE_PAGES);
+	DIPrintf(psEntry, "Pages got from magazines: %u\n",
+	         (IMG_UINT32) OSAtomicRead(&g_sPagePoolStats.iMagazineGetPages));
+	DIPrintf(psEntry, "Pages put to magazines: %u\n",
+	         (IMG_UINT32) OSAtomicRead(&g_sPagePoolStats.iMagazinePutPages));
+	DIPrintf(psEntry, "Magazine refills: %u\n",
+	         (IMG_UINT32) OSAtomicRead(&g_sPagePoolStats.iMagazineRefills));
+	DIPrintf(psEntry, "Pages got from pool lists: %" IMG_UINT64_FMTSPEC "\n", ui64PoolGetPages);
+	DIPrintf(psEntry, "Pool lock acquired: %" IMG_UINT64_FMTSPEC "\n", ui64LockAcquired);
+	DIPrintf(psEntry, "Pool lock held (ns): %" IMG_UINT64_FMTSPEC "\n", ui64LockHeldNs);
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	{
+		IMG_UINT32 ui32Hits = OSAtomicRead(&g_sPagePoolStats.iZeroReserveHitPages);
+		IMG_UINT32 ui32Misses = OSAtomicRead(&g_sPagePoolStats.iZeroReserveMissPages);
+		IMG_UINT32 ui32ZeroedPages = READ_ONCE(g_sPagePoolStats.ui32ZeroReserveZeroedPages);
+		IMG_UINT64 ui64ZeroNs = READ_ONCE(g_sPagePoolStats.ui64ZeroReserveZeroNs);
+		IMG_UINT64 ui64NsPerPage = 0;
+		IMG_UINT32 ui32Remainder;
+
+		if (ui32ZeroedPages != 0)
+		{
+			ui64NsPerPage = OSDivide64r64(ui64ZeroNs, ui32ZeroedPages, &ui32Remainder);
+		}
+
+		DIPrintf(psEntry, "Zeroed reserve pages: %d\n", OSAtomicRead(&g_iPagesInZeroReserves));
+		DIPrintf(psEntry, "Zeroed reserve watermark per pool: %u (refill below %u)\n",
+		         PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES, PVR_LINUX_PHYSMEM_ZERO_RESERVE_LOW);
+		DIPrintf(psEntry, "Zeroed reserve hits (pages): %u\n", ui32Hits);
+		DIPrintf(psEntry, "Zeroed reserve misses (pages): %u\n", ui32Misses);
+		DIPrintf(psEntry, "Zeroed reserve hit rate: %u%%\n",
+		         (ui32Hits + ui32Misses) != 0 ?
+		         OSDivide64((IMG_UINT64)ui32Hits * 100, ui32Hits + ui32Misses, &ui32Remainder) : 0);
+		DIPrintf(psEntry, "Pages zeroed in background: %u (%" IMG_UINT64_FMTSPEC " ns)\n",
+		         ui32ZeroedPages, ui64ZeroNs);
+		/* Estimated from the background cost, the synchronous path maps
+		 * with PAGE_KERNEL and then flushes so it is usually slower */
+		DIPrintf(psEntry, "Zeroing time saved (ns, estimated): %" IMG_UINT64_FMTSPEC "\n",
+		         ui64NsPerPage * ui32Hits);
+	}
+#endif
+
+	for (i = 0; i < PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS; i++)
+	{
+		LinuxChunkPool *psPool = &asChunkPools[i];
+
+		DIPrintf(psEntry, "Order %u chunk pool: %u of %u chunks\n",
+		         psPool->uiOrder, psPool->uiChunks, psPool->uiMaxChunks);
+		DIPrintf(psEntry, "Order %u chunks got: %" IMG_UINT64_FMTSPEC
+		         ", missed: %" IMG_UINT64_FMTSPEC
+		         ", put: %" IMG_UINT64_FMTSPEC
+		         ", reclaimed: %" IMG_UINT64_FMTSPEC "\n",
+		         psPool->uiOrder, psPool->ui64GetChunks, psPool->ui64MissChunks,
+		         psPool->ui64PutChunks, psPool->ui64ReclaimedChunks);
+	}
+
+	return 0;
+}
+
 /* Register the shrinker so Linux can reclaim cached pages */
 PVRSRV_ERROR LinuxInitPhysmem(void)
 {
 	PVRSRV_ERROR eError = PVRSRV_OK;
+	unsigned int uiCPU;
+	IMG_UINT32 i, j;
 
 #if defined(SUPPORT_LINUX_OSPAGE_MIGRATION)
 	g_psLinuxPagePrivateData = kmem_cache_create("pvr-ppd", sizeof(OSMEM_PAGE_PRIVDATA), 0, 0, NULL);
@@ -1009,6 +1384,47 @@ PVRSRV_ERROR LinuxInitPhysmem(void)
 
 	OSAtomicWrite(&g_iPoolCleanTasks, 0);
 
+	for_each_possible_cpu(uiCPU)
+	{
+		LinuxPageMagazines *psMagazines = per_cpu_ptr(&g_sPageMagazines, uiCPU);
+
+		for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+		{
+			spin_lock_init(&psMagazines->asPool[j].sLock);
+			psMagazines->asPool[j].uiCount = 0;
+		}
+	}
+	OSAtomicWrite(&g_iPagesInMagazines, 0);
+
+	for (i = 0; i < PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS; i++)
+	{
+		for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+		{
+			INIT_LIST_HEAD(&g_asChunkPools[i].asList[j]);
+		}
+		g_asChunkPools[i].uiChunks = 0;
+	}
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+	{
+		g_asZeroReserve[j].uiCount = 0;
+	}
+	OSAtomicWrite(&g_iPagesInZeroReserves, 0);
+	INIT_DELAYED_WORK(&g_sZeroReserveWork, _ZeroReserveWorker);
+	OSAtomicWrite(&g_iZeroReserveEnabled, 1);
+#endif
+
+	{
+		DI_ITERATOR_CB sIterator = {.pfnShow = _PagePoolDIShow};
+
+		eError = DICreateEntry("page_pool", NULL, &sIterator, NULL,
+		                       DI_ENTRY_TYPE_GENERIC,
+		                       &g_psPagePoolDIEntry);
+		PVR_LOG_IF_ERROR(eError, "DICreateEntry");
+		eError = PVRSRV_OK;
+	}
+
 #if (LINUX_VERSION_CODE >= KERNEL_VERSION(5,3,0))
 /* Check both config and modparam setting */
 #if PVRSRV_USE_LINUX_CONFIG_INIT_ON_ALLOC == 1
@@ -1054,6 +1470,20 @@ void LinuxDeinitPhysmem(void)
 				"while deinitialising memory subsystem."));
 	}
 
+	if (g_psPagePoolDIEntry != NULL)
+	{
+		DIDestroyEntry(g_psPagePoolDIEntry);
+		g_psPagePoolDIEntry = NULL;
+	}
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	/* Stop refilling the reserves before the pool is emptied */
+	OSAtomicWrite(&g_iZeroReserveEnabled, 0);
+	cancel_delayed_work_sync(&g_sZeroReserveWork);
+#endif
+
+	/* Everything below up to the unlock, including the chunk pools, is
+	 * drained with the pool lock held */
 	_PagePoolLock();
 	if (_FreePagesFromPoolUnlocked(IMG_UINT32_MAX, &uiPagesFreed) != PVRSRV_OK)
 	{
@@ -1062,7 +1492,22 @@ void LinuxDeinitPhysmem(void)
 		PVR_ASSERT(0);
 	}
 
+	_DrainPageMagazines(IMG_UINT32_MAX);
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	_DrainZeroReserves(IMG_UINT32_MAX);
+	PVR_ASSERT(OSAtomicRead(&g_iPagesInZeroReserves) == 0);
+#endif
+
+	/* The chunks should have gone with the OSMEM heaps of their devices */
+	if (_DrainChunkPools(IMG_UINT32_MAX, NULL) != 0)
+	{
+		PVR_DPF((PVR_DBG_WARNING, "Chunk pools were not empty "
+				"while deinitialising memory subsystem."));
+	}
+
 	PVR_ASSERT(_PagesInPoolUnlocked() == 0);
+	PVR_ASSERT(OSAtomicRead(&g_iPagesInMagazines) == 0);
 
 	/* Free the page cache */
 	if (g_psLinuxPagePoolCache)
@@ -1336,18 +1781,461 @@ exit_ok:
 
 	/* Update counters */
 	*puiCounter -= *puiNumReceivedPages;
+	g_sPagePoolStats.ui64PoolGetPages += *puiNumReceivedPages;
+
+	/* The pool memory stat also covers the magazines, so it is updated
+	 * by the caller once the pages actually leave the pool */
+
+	_DumpPoolStructure();
+}
+
+/* Free up to uiMaxPagesToFree pages held in the per-CPU magazines back to
+ * the OS. Must be called with the pool lock held.
+ * Returns the number of pages freed. */
+static IMG_UINT32
+_DrainPageMagazines(IMG_UINT32 uiMaxPagesToFree)
+{
+	struct page *apsPages[PVR_LINUX_PHYSMEM_MAGAZINE_BATCH];
+	IMG_UINT32 uiPagesFreed = 0;
+	unsigned int uiCPU;
+	IMG_UINT32 i, j;
+
+	for_each_possible_cpu(uiCPU)
+	{
+		for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+		{
+			LinuxPageMagazine *psMagazine = &per_cpu_ptr(&g_sPageMagazines, uiCPU)->asPool[j];
+
+			while (uiPagesFreed < uiMaxPagesToFree)
+			{
+				IMG_UINT32 uiCount;
+
+				spin_lock(&psMagazine->sLock);
+				uiCount = MIN(psMagazine->uiCount,
+				              MIN(uiMaxPagesToFree - uiPagesFreed, PVR_LINUX_PHYSMEM_MAGAZINE_BATCH));
+				psMagazine->uiCount -= uiCount;
+				memcpy(apsPages, &psMagazine->apsPages[psMagazine->uiCount],
+				       uiCount * sizeof(apsPages[0]));
+				spin_unlock(&psMagazine->sLock);
+
+				if (uiCount == 0)
+				{
+					break;
+				}
+
+#if defined(CONFIG_X86)
+				/* Set the correct page caching attributes on x86 */
+				if (!PVRSRV_CHECK_CPU_CACHED(g_aui32CPUCacheFlags[j]) &&
+				    set_pages_array_wb(apsPages, uiCount))
+				{
+					PVR_DPF((PVR_DBG_ERROR,
+							 "%s: Failed to reset page attributes",
+							 __func__));
+
+					/* Refills are serialised by the pool lock and frees
+					 * stop one batch short of the end of the magazine,
+					 * so the pages always fit back in */
+					spin_lock(&psMagazine->sLock);
+					memcpy(&psMagazine->apsPages[psMagazine->uiCount], apsPages,
+					       uiCount * sizeof(apsPages[0]));
+					psMagazine->uiCount += uiCount;
+					spin_unlock(&psMagazine->sLock);
+					break;
+				}
+#endif
+
+				OSAtomicSubtract(&g_iPagesInMagazines, uiCount);
+
+				for (i = 0; i < uiCount; i++)
+				{
+					__free_pages(apsPages[i], 0);
+				}
+
+				uiPagesFreed += uiCount;
+			}
+		}
+	}
 
 #if defined(PVRSRV_ENABLE_PROCESS_STATS)
-	/* MemStats usually relies on having the bridge lock held, however
-	 * the page pool code may call PVRSRVStatsIncrMemAllocPoolStat and
-	 * PVRSRVStatsDecrMemAllocPoolStat without the bridge lock held, so
-	 * the page pool lock is used to ensure these calls are mutually
-	 * exclusive
-	 */
-	PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * (*puiNumReceivedPages));
+	if (uiPagesFreed != 0)
+	{
+		PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * uiPagesFreed);
+	}
 #endif
 
-	_DumpPoolStructure();
+	return uiPagesFreed;
+}
+
+/* Get pages from the magazine of the current CPU, does not need the
+ * pool lock. */
+static void
+_GetPagesFromMagazine(IMG_UINT32 ui32CPUCacheFlags,
+                      IMG_UINT32 uiMaxNumPages,
+                      struct page **ppsPageArray,
+                      IMG_UINT32 *puiNumReceivedPages)
+{
+	LinuxPageMagazine *psMagazine = _GetPageMagazine(ui32CPUCacheFlags);
+	IMG_UINT32 uiCount;
+
+	spin_lock(&psMagazine->sLock);
+	uiCount = MIN(uiMaxNumPages, psMagazine->uiCount);
+	psMagazine->uiCount -= uiCount;
+	memcpy(ppsPageArray, &psMagazine->apsPages[psMagazine->uiCount],
+	       uiCount * sizeof(*ppsPageArray));
+	spin_unlock(&psMagazine->sLock);
+
+	if (uiCount != 0)
+	{
+		OSAtomicSubtract(&g_iPagesInMagazines, uiCount);
+		OSAtomicAdd(&g_sPagePoolStats.iMagazineGetPages, uiCount);
+	}
+
+	*puiNumReceivedPages = uiCount;
+}
+
+/* Move a batch of pages from the pool lists to the magazine of the current
+ * CPU if it is running low. Must be called with the pool lock held. */
+static void
+_RefillPageMagazineUnlocked(IMG_UINT32 ui32CPUCacheFlags)
+{
+	LinuxPageMagazine *psMagazine = _GetPageMagazine(ui32CPUCacheFlags);
+	struct page *apsPages[PVR_LINUX_PHYSMEM_MAGAZINE_BATCH];
+	IMG_UINT32 uiCount;
+
+	/* Unlocked read, frees may only grow the magazine up to
+	 * PVR_LINUX_PHYSMEM_MAGAZINE_PAGES which leaves room for the batch */
+	if (READ_ONCE(psMagazine->uiCount) >= PVR_LINUX_PHYSMEM_MAGAZINE_BATCH)
+	{
+		return;
+	}
+
+	_GetPagesFromPoolUnlocked(ui32CPUCacheFlags,
+	                          PVR_LINUX_PHYSMEM_MAGAZINE_BATCH,
+	                          apsPages,
+	                          &uiCount);
+	if (uiCount == 0)
+	{
+		return;
+	}
+
+	spin_lock(&psMagazine->sLock);
+	PVR_ASSERT(psMagazine->uiCount + uiCount <= ARRAY_SIZE(psMagazine->apsPages));
+	memcpy(&psMagazine->apsPages[psMagazine->uiCount], apsPages,
+	       uiCount * sizeof(apsPages[0]));
+	psMagazine->uiCount += uiCount;
+	spin_unlock(&psMagazine->sLock);
+
+	OSAtomicAdd(&g_iPagesInMagazines, uiCount);
+	OSAtomicIncrement(&g_sPagePoolStats.iMagazineRefills);
+}
+
+#if !defined(PVR_PHYSMEM_ZERO_ALL_PAGES)
+/* Put a small page array into the magazine of the current CPU without
+ * taking the pool lock. On success the pool owns the pages and the page
+ * array is freed. */
+static IMG_BOOL
+_PutPagesToMagazine(IMG_UINT32 ui32CPUCacheFlags,
+                    struct page **ppsPageArray,
+                    IMG_UINT32 uiNumPages)
+{
+	LinuxPageMagazine *psMagazine;
+	IMG_UINT32 uiEntries;
+
+	if (uiNumPages > PVR_LINUX_PHYSMEM_MAGAZINE_PAGES)
+	{
+		return IMG_FALSE;
+	}
+
+	/* Same limits as the pool lists, read without the lock as the
+	 * magazines are small enough for the overshoot not to matter */
+	uiEntries = _GetNumberOfPagesInPoolUnlocked();
+	if ((uiEntries >= g_ui32PagePoolMaxEntries) ||
+	    ((uiEntries + uiNumPages) >=
+	     (g_ui32PagePoolMaxEntries + g_ui32PagePoolMaxExcessEntries)))
+	{
+		return IMG_FALSE;
+	}
+
+	psMagazine = _GetPageMagazine(ui32CPUCacheFlags);
+
+	spin_lock(&psMagazine->sLock);
+	if (psMagazine->uiCount + uiNumPages > PVR_LINUX_PHYSMEM_MAGAZINE_PAGES)
+	{
+		spin_unlock(&psMagazine->sLock);
+		return IMG_FALSE;
+	}
+	memcpy(&psMagazine->apsPages[psMagazine->uiCount], ppsPageArray,
+	       uiNumPages * sizeof(*ppsPageArray));
+	psMagazine->uiCount += uiNumPages;
+	spin_unlock(&psMagazine->sLock);
+
+	OSAtomicAdd(&g_iPagesInMagazines, uiNumPages);
+	OSAtomicAdd(&g_sPagePoolStats.iMagazinePutPages, uiNumPages);
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+	PVRSRVStatsIncrMemAllocPoolStat(PAGE_SIZE * uiNumPages);
+#endif
+
+	OSFreeMemNoStats(ppsPageArray);
+
+	return IMG_TRUE;
+}
+#endif /* !defined(PVR_PHYSMEM_ZERO_ALL_PAGES) */
+
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+/* Queue a refill of the zeroed reserves if one of them is running low.
+ * The refill is delayed so that it does not compete with the zeroed
+ * allocations for the pool lock. */
+static void
+_KickZeroReserves(void)
+{
+	IMG_UINT32 j;
+
+	if (OSAtomicRead(&g_iZeroReserveEnabled) == 0)
+	{
+		return;
+	}
+
+	for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+	{
+		/* Unlocked read, a stale count only delays or adds a refill */
+		if (READ_ONCE(g_asZeroReserve[j].uiCount) < PVR_LINUX_PHYSMEM_ZERO_RESERVE_LOW)
+		{
+			queue_delayed_work(system_unbound_wq, &g_sZeroReserveWork,
+			                   msecs_to_jiffies(PVR_LINUX_PHYSMEM_ZERO_RESERVE_IDLE_MS));
+			return;
+		}
+	}
+}
+
+/* Get zeroed pages from the reserve of a caching mode, does not need the
+ * pool lock. */
+static void
+_GetPagesFromZeroReserve(IMG_UINT32 ui32CPUCacheFlags,
+                         IMG_UINT32 uiMaxNumPages,
+                         struct page **ppsPageArray,
+                         IMG_UINT32 *puiNumReceivedPages)
+{
+	LinuxZeroReserve *psReserve = &g_asZeroReserve[_GetPoolIndex(ui32CPUCacheFlags)];
+	IMG_UINT32 uiCount;
+
+	spin_lock(&g_sZeroReserveLock);
+	uiCount = MIN(uiMaxNumPages, psReserve->uiCount);
+	psReserve->uiCount -= uiCount;
+	memcpy(ppsPageArray, &psReserve->apsPages[psReserve->uiCount],
+	       uiCount * sizeof(*ppsPageArray));
+	spin_unlock(&g_sZeroReserveLock);
+
+	WRITE_ONCE(g_ulZeroReserveLastUse, jiffies);
+
+	if (uiCount != 0)
+	{
+		OSAtomicSubtract(&g_iPagesInZeroReserves, uiCount);
+		OSAtomicAdd(&g_sPagePoolStats.iZeroReserveHitPages, uiCount);
+	}
+	if (uiCount != uiMaxNumPages)
+	{
+		OSAtomicAdd(&g_sPagePoolStats.iZeroReserveMissPages, uiMaxNumPages - uiCount);
+	}
+
+	*puiNumReceivedPages = uiCount;
+
+	_KickZeroReserves();
+}
+
+/* Free up to uiMaxPagesToFree pages held in the zeroed reserves back to
+ * the OS. Must be called with the pool lock held so that the worker cannot
+ * add pages at the same time.
+ * Returns the number of pages freed. */
+static IMG_UINT32
+_DrainZeroReserves(IMG_UINT32 uiMaxPagesToFree)
+{
+	struct page *apsPages[PVR_LINUX_PHYSMEM_ZERO_RESERVE_BATCH];
+	IMG_UINT32 uiPagesFreed = 0;
+	IMG_UINT32 i, j;
+
+	for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+	{
+		LinuxZeroReserve *psReserve = &g_asZeroReserve[j];
+
+		while (uiPagesFreed < uiMaxPagesToFree)
+		{
+			IMG_UINT32 uiCount;
+
+			spin_lock(&g_sZeroReserveLock);
+			uiCount = MIN(psReserve->uiCount,
+			              MIN(uiMaxPagesToFree - uiPagesFreed, PVR_LINUX_PHYSMEM_ZERO_RESERVE_BATCH));
+			psReserve->uiCount -= uiCount;
+			memcpy(apsPages, &psReserve->apsPages[psReserve->uiCount],
+			       uiCount * sizeof(apsPages[0]));
+			spin_unlock(&g_sZeroReserveLock);
+
+			if (uiCount == 0)
+			{
+				break;
+			}
+
+#if defined(CONFIG_X86)
+			/* Set the correct page caching attributes on x86 */
+			if (set_pages_array_wb(apsPages, uiCount))
+			{
+				PVR_DPF((PVR_DBG_ERROR,
+						 "%s: Failed to reset page attributes",
+						 __func__));
+
+				/* Only the worker adds pages and it needs the pool
+				 * lock for it, so the pages always fit back in */
+				spin_lock(&g_sZeroReserveLock);
+				memcpy(&psReserve->apsPages[psReserve->uiCount], apsPages,
+				       uiCount * sizeof(apsPages[0]));
+				psReserve->uiCount += uiCount;
+				spin_unlock(&g_sZeroReserveLock);
+				break;
+			}
+#endif
+
+			OSAtomicSubtract(&g_iPagesInZeroReserves, uiCount);
+
+			for (i = 0; i < uiCount; i++)
+			{
+				__free_pages(apsPages[i], 0);
+			}
+
+			uiPagesFreed += uiCount;
+		}
+	}
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+	if (uiPagesFreed != 0)
+	{
+		PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * uiPagesFreed);
+	}
+#endif
+
+	return uiPagesFreed;
+}
+#endif /* defined(PHYSMEM_OSMEM_ZERO_RESERVE) */
+
+/* Put a device page allocated by _AllocOSPage_CMA into the chunk pool of
+ * its order instead of freeing it. Handles locking.
+ * Returns IMG_TRUE if the pool took the chunk. */
+static IMG_BOOL
+_PutChunkToPoolLocked(PMR_OSPAGEARRAY_DATA *psPageArrayData,
+                      IMG_UINT32 uiOrder,
+                      void *pvVirtAddr,
+                      dma_addr_t sBusAddr,
+                      struct page *psPage)
+{
+	LinuxChunkPool *psPool = _GetChunkPool(uiOrder);
+	LinuxChunkPoolEntry *psEntry;
+
+	if (psPool == NULL ||
+	    PVRSRV_CHECK_CPU_CACHED(psPageArrayData->ui32CPUCacheFlags) ||
+	    page_count(psPage) > 1)
+	{
+		return IMG_FALSE;
+	}
+
+	/* Unlocked read, the check is repeated below */
+	if (READ_ONCE(psPool->uiChunks) >= psPool->uiMaxChunks)
+	{
+		return IMG_FALSE;
+	}
+
+	psEntry = OSAllocMemNoStats(sizeof(*psEntry));
+	if (psEntry == NULL)
+	{
+		return IMG_FALSE;
+	}
+
+	psEntry->psDev = psPageArrayData->psDevNode->psDevConfig->pvOSDevice;
+	psEntry->pvVirtAddr = pvVirtAddr;
+	psEntry->sBusAddr = sBusAddr;
+	psEntry->psPage = psPage;
+
+	_PagePoolLock();
+	if (psPool->uiChunks >= psPool->uiMaxChunks)
+	{
+		_PagePoolUnlock();
+		OSFreeMemNoStats(psEntry);
+		return IMG_FALSE;
+	}
+
+	/* Most recently freed chunks are handed out first */
+	list_add(&psEntry->sChunkPoolItem,
+	         &psPool->asList[_GetPoolIndex(psPageArrayData->ui32CPUCacheFlags)]);
+	psPool->uiChunks++;
+	psPool->ui64PutChunks++;
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+	PVRSRVStatsIncrMemAllocPoolStat(PAGE_SIZE << uiOrder);
+#endif
+	_PagePoolUnlock();
+
+	return IMG_TRUE;
+}
+
+/* Free up to uiMaxPagesToFree OS pages held in the chunk pools back to the
+ * OS, only the chunks of psDev if it is not NULL. Must be called with the
+ * pool lock held.
+ * Whole chunks are freed, returns the number of OS pages freed. */
+static IMG_UINT32
+_DrainChunkPools(IMG_UINT32 uiMaxPagesToFree, struct device *psDev)
+{
+	LinuxChunkPoolEntry *psEntry, *psTempEntry;
+	IMG_UINT32 uiPagesFreed = 0;
+	IMG_UINT32 i, j;
+
+	lockdep_assert_held(&g_sPagePoolMutex);
+
+	for (i = 0; i < PHYSMEM_OSMEM_NUM_OF_CHUNK_POOLS; i++)
+	{
+		LinuxChunkPool *psPool = &g_asChunkPools[i];
+
+		for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+		{
+			/* Oldest chunks first */
+			list_for_each_entry_safe_reverse(psEntry,
+			                                 psTempEntry,
+			                                 &psPool->asList[j],
+			                                 sChunkPoolItem)
+			{
+				if (uiPagesFreed >= uiMaxPagesToFree)
+				{
+					goto e_exit;
+				}
+
+				if (psDev != NULL && psEntry->psDev != psDev)
+				{
+					continue;
+				}
+
+				list_del(&psEntry->sChunkPoolItem);
+				psPool->uiChunks--;
+				psPool->ui64ReclaimedChunks++;
+
+				_FreeOSPage_CMA(psEntry->psDev,
+				                PAGE_SIZE << psPool->uiOrder,
+				                psPool->uiOrder,
+				                psEntry->pvVirtAddr,
+				                psEntry->sBusAddr,
+				                psEntry->psPage);
+				OSFreeMemNoStats(psEntry);
+
+				uiPagesFreed += 1 << psPool->uiOrder;
+			}
+		}
+	}
+
+e_exit:
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+	if (uiPagesFreed != 0)
+	{
+		PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * uiPagesFreed);
+	}
+#endif
+
+	return uiPagesFreed;
 }
 
 /* Same as _GetPagesFromPoolUnlocked but handles locking and
@@ -1361,32 +2249,69 @@ _GetPagesFromPoolLocked(PVRSRV_DEVICE_NODE *psDevNode,
 						struct page **ppsPageArray,
 						IMG_UINT32 *puiPagesFromPool)
 {
+	IMG_UINT32 uiPagesFromMagazine;
+	IMG_UINT32 uiPagesFromList = 0;
+
+	/* The page pool stores only order 0 pages. CMA is naturally more
+	 * commonly used for higher order pages and so we reject that also.
+	 */
+	if (uiOrder != 0 ||
+	    PVRSRV_CHECK_CPU_CACHED(ui32CPUCacheFlags) ||
+	    BIT_ISSET(ui32AllocFlags, FLAG_DMA_CMA) ||
+	    BIT_ISSET(ui32AllocFlags, FLAG_IS_MOVABLE))
+	{
+		return;
+	}
+
 #if !defined(PVR_PHYSMEM_ZERO_ALL_PAGES)
-	/* Don't get pages from pool as it doesn't provide zeroed pages */
+	/* The pool does not provide zeroed pages, only the zeroed reserves do.
+	 * Without them we directly allocate from the OS because it is faster
+	 * than doing it within the driver. */
 	if (BIT_ISSET(ui32AllocFlags, FLAG_ZERO))
 	{
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+		_GetPagesFromZeroReserve(ui32CPUCacheFlags,
+		                         uiPagesToAlloc,
+		                         ppsPageArray,
+		                         puiPagesFromPool);
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+		if (*puiPagesFromPool != 0)
+		{
+			PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * (*puiPagesFromPool));
+		}
+#endif
+#endif /* defined(PHYSMEM_OSMEM_ZERO_RESERVE) */
 		return;
 	}
-#endif
+#endif /* !defined(PVR_PHYSMEM_ZERO_ALL_PAGES) */
 
-	/* The page pool stores only order 0 pages. If we need zeroed memory we
-	 * directly allocate from the OS because it is faster than
-	 * doing it within the driver. CMA is naturally more commonly used for higher
-	 * order pages and so we reject that also.
-	 */
-	if (uiOrder == 0 &&
-	    !PVRSRV_CHECK_CPU_CACHED(ui32CPUCacheFlags) &&
-	    !BIT_ISSET(ui32AllocFlags, FLAG_DMA_CMA) &&
-	    !BIT_ISSET(ui32AllocFlags, FLAG_IS_MOVABLE))
-	{
+	_GetPagesFromMagazine(ui32CPUCacheFlags,
+	                      uiPagesToAlloc,
+	                      ppsPageArray,
+	                      &uiPagesFromMagazine);
 
+	if (uiPagesFromMagazine < uiPagesToAlloc)
+	{
 		_PagePoolLock();
 		_GetPagesFromPoolUnlocked(ui32CPUCacheFlags,
-								  uiPagesToAlloc,
-								  ppsPageArray,
-								  puiPagesFromPool);
+								  uiPagesToAlloc - uiPagesFromMagazine,
+								  &ppsPageArray[uiPagesFromMagazine],
+								  &uiPagesFromList);
+		/* Top the magazine up while we hold the lock so that the
+		 * next small allocations on this CPU do not need it */
+		_RefillPageMagazineUnlocked(ui32CPUCacheFlags);
 		_PagePoolUnlock();
 	}
+
+	*puiPagesFromPool = uiPagesFromMagazine + uiPagesFromList;
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+	if (*puiPagesFromPool != 0)
+	{
+		PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * (*puiPagesFromPool));
+	}
+#endif
 }
 
 /* Takes a page array and maps it into the kernel to write zeros */
@@ -1449,6 +2374,83 @@ _MemsetPageArray(IMG_UINT32 uiNumToClean,
 	return PVRSRV_OK;
 }
 
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+/* Refill the zeroed reserves from the pool lists while no zeroed allocation
+ * is using them. The pages already have the pool caching attributes, so
+ * zeroing them through a mapping of the same type is all that is needed. */
+static void
+_ZeroReserveWorker(struct work_struct *psWork)
+{
+	struct page *apsPages[PVR_LINUX_PHYSMEM_ZERO_RESERVE_BATCH];
+	IMG_UINT32 i, j;
+
+	PVR_UNREFERENCED_PARAMETER(psWork);
+
+	if (time_before(jiffies, READ_ONCE(g_ulZeroReserveLastUse) +
+	                msecs_to_jiffies(PVR_LINUX_PHYSMEM_ZERO_RESERVE_IDLE_MS)))
+	{
+		/* Zeroed allocations are still running, try again later */
+		_KickZeroReserves();
+		return;
+	}
+
+	for (j = 0; j < PHYSMEM_OSMEM_NUM_OF_POOLS; j++)
+	{
+		LinuxZeroReserve *psReserve = &g_asZeroReserve[j];
+		pgprot_t pgprot = _GetPoolPgprot(g_aui32CPUCacheFlags[j]);
+
+		while (OSAtomicRead(&g_iZeroReserveEnabled) != 0)
+		{
+			IMG_UINT32 uiCount;
+			IMG_UINT64 ui64StartNs;
+
+			_PagePoolLock();
+			uiCount = MIN(PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES - READ_ONCE(psReserve->uiCount),
+			              PVR_LINUX_PHYSMEM_ZERO_RESERVE_BATCH);
+			_GetPagesFromPoolUnlocked(g_aui32CPUCacheFlags[j], uiCount, apsPages, &uiCount);
+			/* Keep the pages counted towards the pool limits while
+			 * they are being zeroed */
+			OSAtomicAdd(&g_iPagesInZeroReserves, uiCount);
+			_PagePoolUnlock();
+
+			if (uiCount == 0)
+			{
+				break;
+			}
+
+			ui64StartNs = OSClockns64();
+			if (_MemsetPageArray(uiCount, apsPages, pgprot, PVRSRV_ZERO_VALUE) != PVRSRV_OK)
+			{
+				/* Give the pages back to the OS, the next pool
+				 * free will kick the worker again */
+				for (i = 0; i < uiCount; i++)
+				{
+					_FreeOSPage(0, IMG_TRUE, NULL, apsPages[i]);
+				}
+				OSAtomicSubtract(&g_iPagesInZeroReserves, uiCount);
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+				PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * uiCount);
+#endif
+				break;
+			}
+			g_sPagePoolStats.ui64ZeroReserveZeroNs += OSClockns64() - ui64StartNs;
+			g_sPagePoolStats.ui32ZeroReserveZeroedPages += uiCount;
+
+			/* Allocations only take pages away and the shrinker
+			 * needs the pool lock, so the batch still fits */
+			_PagePoolLock();
+			spin_lock(&g_sZeroReserveLock);
+			PVR_ASSERT(psReserve->uiCount + uiCount <= PVR_LINUX_PHYSMEM_ZERO_RESERVE_PAGES);
+			memcpy(&psReserve->apsPages[psReserve->uiCount], apsPages,
+			       uiCount * sizeof(apsPages[0]));
+			psReserve->uiCount += uiCount;
+			spin_unlock(&g_sZeroReserveLock);
+			_PagePoolUnlock();
+		}
+	}
+}
+#endif /* defined(PHYSMEM_OSMEM_ZERO_RESERVE) */
+
 static PVRSRV_ERROR
 _CleanupThread_CleanPages(void *pvData)
 {
@@ -1519,6 +2521,11 @@ _CleanupThread_CleanPages(void *pvData)
 
 	_PagePoolUnlock();
 
+#if defined(PHYSMEM_OSMEM_ZERO_RESERVE)
+	/* New pool pages, the zeroed reserves may be waiting for them */
+	_KickZeroReserves();
+#endif
+
 	OSFreeMem(pvData);
 	OSAtomicDecrement(&g_iPoolCleanTasks);
 
@@ -1627,9 +2634,18 @@ _PutPagesToPoolLocked(PVRSRV_DEVICE_NODE *psDevNode,
 		goto eExitFalse;
 	}
 
+#if !defined(PVR_PHYSMEM_ZERO_ALL_PAGES)
+	/* Pool pages do not need zeroing, small frees can skip the deferred
+	 * cleanup and the pool lock */
+	if (_PutPagesToMagazine(ui32CPUCacheFlags, ppsPageArray, uiNumPages))
+	{
+		PVR_DPF_RETURN_RC(IMG_TRUE);
+	}
+#endif
+
 	_PagePoolLock();
 
-	uiEntries = _PagesInPoolUnlocked();
+	uiEntries = _GetNumberOfPagesInPoolUnlocked();
 
 	/* Check for number of current page pool entries */
 	if ( (uiEntries >= g_ui32PagePoolMaxEntries) ||
@@ -1647,7 +2663,7 @@ _PutPagesToPoolLocked(PVRSRV_DEVICE_NODE *psDevNode,
 	}
 
 #if defined(SUPPORT_PHYSMEM_TEST)
-	if (!psPVRSRVData->hCleanupThread)
+	if (psPVRSRVData->ui32NumCleanupWorkers == 0)
 	{
 		goto eDecrement;
 	}
@@ -2401,6 +3417,130 @@ static inline void _ZombifyMemAllocStat_UmaPages(size_t uiSize, IMG_PID uiPid)
  * The maximum order requested is increased if all max order allocations were successful.
  * If any request fails we reduce the max order.
  */
+/* Take whole device pages from the chunk pool of their order and store
+ * them at the start of the page array the way _AllocOSPages_Fast does for
+ * new DMA/CMA allocations. Pooled chunks are zeroed here if required.
+ * Returns the number of OS pages received in puiOSPagesFromPool. */
+static PVRSRV_ERROR
+_GetChunksFromPoolLocked(PMR_OSPAGEARRAY_DATA *psPageArrayData,
+                         IMG_UINT32 uiOrder,
+                         IMG_UINT32 uiOSPagesToAlloc,
+                         IMG_UINT32 *puiOSPagesFromPool)
+{
+	LinuxChunkPool *psPool = _GetChunkPool(uiOrder);
+	struct device *psDev = psPageArrayData->psDevNode->psDevConfig->pvOSDevice;
+	struct page **ppsPageArray = psPageArrayData->pagearray;
+	dma_addr_t *psBusAddrArray = psPageArrayData->dmaphysarray;
+	LinuxChunkPoolEntry *psEntry, *psTempEntry;
+	IMG_UINT32 uiChunksToAlloc = uiOSPagesToAlloc >> uiOrder;
+	IMG_UINT32 uiChunks = 0;
+	IMG_UINT32 i, j;
+
+	*puiOSPagesFromPool = 0;
+
+	if (psPool == NULL ||
+	    PVRSRV_CHECK_CPU_CACHED(psPageArrayData->ui32CPUCacheFlags))
+	{
+		return PVRSRV_OK;
+	}
+
+	_PagePoolLock();
+	list_for_each_entry_safe(psEntry,
+	                         psTempEntry,
+	                         &psPool->asList[_GetPoolIndex(psPageArrayData->ui32CPUCacheFlags)],
+	                         sChunkPoolItem)
+	{
+		IMG_UINT32 uiIndex = uiChunks << uiOrder;
+
+		if (uiChunks == uiChunksToAlloc)
+		{
+			break;
+		}
+
+		if (psEntry->psDev != psDev)
+		{
+			continue;
+		}
+
+		ppsPageArray[uiIndex] = psEntry->psPage;
+		psPageArrayData->dmavirtarray[uiIndex] = psEntry->pvVirtAddr;
+		psBusAddrArray[uiIndex] = psEntry->sBusAddr;
+
+		list_del(&psEntry->sChunkPoolItem);
+		OSFreeMemNoStats(psEntry);
+		uiChunks++;
+	}
+	psPool->uiChunks -= uiChunks;
+	psPool->ui64GetChunks += uiChunks;
+	psPool->ui64MissChunks += uiChunksToAlloc - uiChunks;
+	_PagePoolUnlock();
+
+	if (uiChunks == 0)
+	{
+		return PVRSRV_OK;
+	}
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+	PVRSRVStatsDecrMemAllocPoolStat(PAGE_SIZE * (uiChunks << uiOrder));
+#endif
+
+	/* Generate the ghost pages of the chunks */
+	for (i = 0; i < uiChunks; i++)
+	{
+		IMG_UINT32 uiIndex = i << uiOrder;
+
+		for (j = 1; j < (1 << uiOrder); j++)
+		{
+			ppsPageArray[uiIndex + j] = ppsPageArray[uiIndex] + j;
+			psBusAddrArray[uiIndex + j] = DMA_SET_CMA_GHOST(psBusAddrArray[uiIndex]);
+		}
+	}
+
+	/* Unlike new DMA/CMA memory the chunks are not zeroed yet. They keep
+	 * the caching attributes they were allocated with so use a mapping
+	 * of the same type, which needs no cache maintenance afterwards. */
+	if (BIT_ISSET(psPageArrayData->ui32AllocFlags, FLAG_ZERO))
+	{
+		PVRSRV_ERROR eError;
+
+		eError = _MemsetPageArray(uiChunks << uiOrder, ppsPageArray,
+		                          _GetPoolPgprot(psPageArrayData->ui32CPUCacheFlags),
+		                          PVRSRV_ZERO_VALUE);
+		if (eError != PVRSRV_OK)
+		{
+			for (i = 0; i < (uiChunks << uiOrder); i++)
+			{
+				if (!DMA_IS_CMA_GHOST(psBusAddrArray[i]))
+				{
+					_FreeOSPage_CMA(psDev,
+					                PAGE_SIZE << uiOrder,
+					                uiOrder,
+					                psPageArrayData->dmavirtarray[i],
+					                psBusAddrArray[i],
+					                ppsPageArray[i]);
+				}
+				psBusAddrArray[i] = (dma_addr_t)0;
+				psPageArrayData->dmavirtarray[i] = NULL;
+				ppsPageArray[i] = NULL;
+			}
+			return eError;
+		}
+	}
+
+#if defined(PVRSRV_ENABLE_PROCESS_STATS)
+#if defined(PVRSRV_ENABLE_MEMORY_STATS)
+	for (i = 0; i < uiChunks; i++)
+	{
+		_AddMemAllocRecord_UmaPages(psPageArrayData, ppsPageArray[i << uiOrder], uiOrder);
+	}
+#endif
+#endif
+
+	*puiOSPagesFromPool = uiChunks << uiOrder;
+
+	return PVRSRV_OK;
+}
+
 static PVRSRV_ERROR
 _AllocOSPages_Fast(PMR_OSPAGEARRAY_DATA *psPageArrayData)
 {
@@ -2442,6 +3582,24 @@ _AllocOSPages_Fast(PMR_OSPAGEARRAY_DATA *psPageArrayData)
 							ppsPageArray,
 							&uiDevPagesFromPool);
 
+	/* Device pages larger than the OS page come from the chunk pools
+	 * first, they are what heaps with large pages are short of */
+	if (BIT_ISSET(psPageArrayData->ui32AllocFlags, FLAG_DMA_CMA))
+	{
+		PVR_ASSERT(uiDevPagesFromPool == 0);
+
+		eError = _GetChunksFromPoolLocked(psPageArrayData,
+		                                  ui32MinOrder,
+		                                  uiOSPagesToAlloc,
+		                                  &uiDevPagesFromPool);
+		if (eError != PVRSRV_OK)
+		{
+			/* The chunks have been freed already */
+			PVR_DPF((PVR_DBG_ERROR, "Failed to zero pooled chunks (fast)"));
+			return eError;
+		}
+	}
+
 	uiArrayIndex = uiDevPagesFromPool;
 
 	if ((uiOSPagesToAlloc - uiDevPagesFromPool) < PVR_LINUX_HIGHORDER_ALLOCATION_THRESHOLD &&
@@ -2563,15 +3721,16 @@ _AllocOSPages_Fast(PMR_OSPAGEARRAY_DATA *psPageArrayData)
 		IMG_UINT32 i;
 		dma_addr_t *psBusAddrArray = &psPageArrayData->dmaphysarray[uiDevPagesFromPool];
 
-		/* Iterate over page array generating ghost CMA pages */
-		for (i = 0; i < uiOSPagesToAlloc;)
+		/* Iterate over page array generating ghost CMA pages, the ones
+		 * from the chunk pool already have them */
+		for (i = 0; i < uiOSPagesToAlloc - uiDevPagesFromPool;)
 		{
 			IMG_UINT32 j;
 			IMG_UINT32 ui32NumPagesPerOrder = 1;
 
 			/* Iterate and populate until we find the next real page */
 			for (j = i + 1;
-			     j < uiOSPagesToAlloc &&
+			     j < uiOSPagesToAlloc - uiDevPagesFromPool &&
 			     ppsPageAttributeArray[j] == NULL;
 			     j++, ui32NumPagesPerOrder++)
 			{
@@ -2782,6 +3941,8 @@ _AllocOSPages_Sparse(PMR_OSPAGEARRAY_DATA *psPageArrayData,
 	 * - PVR_PHYSMEM_ZERO_ALL_PAGES == 1 && uiOrder == 0
 	 * - PVR_PHYSMEM_ZERO_ALL_PAGES == 0 && uiOrder == 0 &&
 	 *   !(BIT_ISSET(ui32AllocFlags, FLAG_ZERO))
+	 * - PVR_PHYSMEM_ZERO_ALL_PAGES == 0 && uiOrder == 0 &&
+	 *   BIT_ISSET(ui32AllocFlags, FLAG_ZERO), from the zeroed reserve only
 	 * - !BIT_ISSET(ui32AllocFlags, FLAG_DMA_CMA)
 	 * _ShouldInitMem() must not be used for bZero argument since it only
 	 * applies to new pages allocated from the kernel.  */
@@ -2914,9 +4075,9 @@ _AllocOSPages_Sparse(PMR_OSPAGEARRAY_DATA *psPageArrayData,
 		 * and pages allocated from the OS after that.
 		 * If there are pages from the pool here they must be zeroed already hence we don't have
 		 * to do it again. This is because if PVR_PHYSMEM_ZERO_ALL_PAGES is enabled pool pages
-		 * are zeroed in the cleanup thread. If it's disabled they aren't, and in that case we never
-		 * allocate pages with FLAG_ZERO from the pool. This is why those pages need to be zeroed
-		 * here.
+		 * are zeroed in the cleanup thread. If it's disabled they aren't, and in that case we only
+		 * allocate pages with FLAG_ZERO from the zeroed reserve, whose pages were cleared in the
+		 * background. The pages allocated from the OS need to be zeroed here.
 		 * All of the above is true for the 0 order pages. For higher order we never allocated from
 		 * the pool and those pages are allocated already zeroed from the OS.
 		 * Long story short we can always skip pages allocated from the pool because they are either
@@ -3350,12 +4511,19 @@ _FreeOSPages_Sparse(PMR_OSPAGEARRAY_DATA *psPageArrayData,
 			IMG_UINT32 uiFreeIdx = i << uiOrder;
 			/* Get the page's original index in ppsPageArray, already scaled to dev pages */
 			IMG_UINT32 idx = puiDevIndicesToFree[i];
-			_FreeOSPage_CMA(psPageArrayData->psDevNode->psDevConfig->pvOSDevice,
-			                ui64DevPageSize,
-			                uiOrder,
-			                psPageArrayData->dmavirtarray[idx],
-			                psPageArrayData->dmaphysarray[idx],
-			                ppsOSPagesToFree[uiFreeIdx]);
+			if (!_PutChunkToPoolLocked(psPageArrayData,
+			                           uiOrder,
+			                           psPageArrayData->dmavirtarray[idx],
+			                           psPageArrayData->dmaphysarray[idx],
+			                           ppsOSPagesToFree[uiFreeIdx]))
+			{
+				_FreeOSPage_CMA(psPageArrayData->psDevNode->psDevConfig->pvOSDevice,
+				                ui64DevPageSize,
+				                uiOrder,
+				                psPageArrayData->dmavirtarray[idx],
+				                psPageArrayData->dmaphysarray[idx],
+				                ppsOSPagesToFree[uiFreeIdx]);
+			}
 			for (uiSubPageInOrder = 0;
 			     uiSubPageInOrder < (1 << uiOrder);
 			     uiSubPageInOrder++)
@@ -3494,7 +4662,12 @@ _FreeOSPages_Fast(PMR_OSPAGEARRAY_DATA *psPageArrayData)
 	{
 		for (i = 0; i < uiOSNumPages; i++)
 		{
-			if (!DMA_IS_CMA_GHOST(psPageArrayData->dmaphysarray[i]))
+			if (!DMA_IS_CMA_GHOST(psPageArrayData->dmaphysarray[i]) &&
+			    !_PutChunkToPoolLocked(psPageArrayData,
+			                           uiOrder,
+			                           psPageArrayData->dmavirtarray[i],
+			                           psPageArrayData->dmaphysarray[i],
+			                           ppsPageArray[i]))
 			{
 				_FreeOSPage_CMA(psPageArrayData->psDevNode->psDevConfig->pvOSDevice,
 								uiDevPageSize,
@@ -4587,6 +5760,17 @@ void PhysmemGetOSRamMemStats(PHEAP_IMPL_DATA pvImplData,
 
 }
 
+void PhysmemDestroyOSRamHeapData(PHEAP_IMPL_DATA pvImplData)
+{
+	PVRSRV_DEVICE_NODE *psDevNode = pvImplData;
+
+	/* Chunks in the pools have to be freed with the device they were
+	 * allocated for, so do it while it is still around */
+	_PagePoolLock();
+	_DrainChunkPools(IMG_UINT32_MAX, psDevNode->psDevConfig->pvOSDevice);
+	_PagePoolUnlock();
+}
+
 PVRSRV_ERROR
 PhysmemNewOSRamBackedPMR(PHYS_HEAP *psPhysHeap,
 						 CONNECTION_DATA *psConnection,
@@ -1789,9 +1789,8 @@ PMRFinalizeLocalMem(PMR_IMPL_PRIVDATA pvPriv)
 #if defined(PVR_PHYSMEM_LMA_ZERO_ALL_PAGES)
 	CLEAR_PAGE_ARRAY_CLEANUP_ITEM *psCleanupItem;
 	PVRSRV_DEVICE_NODE *psDevNode = PhysHeapDeviceNode(psLMAllocArrayData->psPhysHeap);
-	PVRSRV_DATA *psPVRSRVData = PVRSRVGetPVRSRVData();
 
-	if (psPVRSRVData->cleanupThreadPid == OSGetCurrentProcessID())
+	if (PVRSRVCleanupThreadIsWorkerPid(OSGetCurrentProcessID()))
 	{
 		/* This is already the cleanup thread, destroy immediately. */
 		DestroyLMPageArray(psLMAllocArrayData);
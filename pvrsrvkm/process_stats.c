@@ -60,6 +60,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #if defined(__linux__)
 #include "trace_events.h"
 #endif
+#if defined(__linux__) && defined(__KERNEL__)
+#include <linux/slab.h>
+#endif
 #include <soc/google/meminfo.h>
 
 #if defined(SUPPORT_LINUX_FDINFO) && defined(PVRSRV_ENABLE_PROCESS_STATS)
@@ -129,11 +132,12 @@ int GlobalStatsPrintElements(OSDI_IMPL_ENTRY *psEntry, void *pvData);
 
 /* Note: all of the accesses to the global stats should be protected
  * by the gsGlobalStats.hGlobalStatsLock lock. This means all of the
- * invocations of macros *_GLOBAL_STAT_VALUE. */
+ * invocations of macros *_GLOBAL_STAT_VALUE. Updates are first accumulated
+ * in per-CPU deltas (see _UpdateGlobalStat) which reads fold back in. */
 
 /* Macros for fetching stat values */
 #define GET_STAT_VALUE(ptr,var) (ptr)->i64StatValue[(var)]
-#define GET_GLOBAL_STAT_VALUE(idx) gsGlobalStats.ui64StatValue[idx]
+#define GET_GLOBAL_STAT_VALUE(idx) _GetGlobalStatValue(idx)
 
 #define GET_GPUMEM_GLOBAL_STAT_VALUE() \
 	GET_GLOBAL_STAT_VALUE(PVRSRV_DRIVER_STAT_TYPE_ALLOC_GPUMEM_UMA_POOL) + \
@@ -154,14 +158,14 @@ int GlobalStatsPrintElements(OSDI_IMPL_ENTRY *psEntry, void *pvData);
  */
 #define UPDATE_MAX_VALUE(a,b)					do { if ((b) > (a)) {(a) = (b);} } while (0)
 #define INCREASE_STAT_VALUE(ptr,var,val)		do { (ptr)->i64StatValue[(var)] += (IMG_INT64)(val); if ((ptr)->i64StatValue[(var)] > (ptr)->i64StatValue[(var##_MAX)]) {(ptr)->i64StatValue[(var##_MAX)] = (ptr)->i64StatValue[(var)];} } while (0)
-#define INCREASE_GLOBAL_STAT_VALUE(var,idx,val)		do { (var).ui64StatValue[(idx)] += (IMG_UINT64)(val); if ((var).ui64StatValue[(idx)] > (var).ui64StatValue[(idx##_MAX)]) {(var).ui64StatValue[(idx##_MAX)] = (var).ui64StatValue[(idx)];} } while (0)
+#define INCREASE_GLOBAL_STAT_VALUE(var,idx,val)		_UpdateGlobalStat(idx, (IMG_INT64)(val))
 #if defined(PVRSRV_DEBUG_LINUX_MEMORY_STATS)
 /* Allow stats to go negative */
 #define DECREASE_STAT_VALUE(ptr,var,val)		do { (ptr)->i64StatValue[(var)] -= (val); } while (0)
-#define DECREASE_GLOBAL_STAT_VALUE(var,idx,val)		do { (var).ui64StatValue[(idx)] -= (val); } while (0)
+#define DECREASE_GLOBAL_STAT_VALUE(var,idx,val)		_UpdateGlobalStat(idx, -(IMG_INT64)(val))
 #else
 #define DECREASE_STAT_VALUE(ptr,var,val)		do { if ((ptr)->i64StatValue[(var)] >= (val)) { (ptr)->i64StatValue[(var)] -= (IMG_INT64)(val); } else { (ptr)->i64StatValue[(var)] = 0; } } while (0)
-#define DECREASE_GLOBAL_STAT_VALUE(var,idx,val)		do { if ((var).ui64StatValue[(idx)] >= (val)) { (var).ui64StatValue[(idx)] -= (IMG_UINT64)(val); } else { (var).ui64StatValue[(idx)] = 0; } } while (0)
+#define DECREASE_GLOBAL_STAT_VALUE(var,idx,val)		_UpdateGlobalStat(idx, -(IMG_INT64)(val))
 #endif
 #define MAX_CACHEOP_STAT 16
 #define INCREMENT_CACHEOP_STAT_IDX_WRAP(x) ((x+1) >= MAX_CACHEOP_STAT ? 0 : (x+1))
@@ -216,6 +220,10 @@ typedef struct _PVRSRV_PROCESS_STATS_ {
 	IMG_CHAR                       processName[MAX_PROC_NAME_LEN];
 	IMG_UINT32                     ui32RefCount;
 
+	/* Which of the live/dead lists sNode is on, so that a lookup through
+	 * gpsProcessStatsIndex can tell the two apart */
+	IMG_BOOL                       bDead;
+
 	/* Process memory stats */
 	IMG_INT64                      i64StatValue[PVRSRV_PROCESS_STAT_TYPE_COUNT];
 	IMG_UINT32                     ui32StatAllocFlags;
@@ -412,6 +420,13 @@ static IMG_BOOL bProcessStatsInitialised = IMG_FALSE;
 static DLLIST_NODE gsLiveList;
 static DLLIST_NODE gsDeadList;
 
+/*
+ * Index of every entry on the live and dead lists keyed by PID, so that the
+ * lookups done for each tracked allocation do not have to walk the lists.
+ * Protected by g_psLinkedListLock, as are the lists themselves.
+ */
+static HASH_TABLE *gpsProcessStatsIndex;
+
 static POS_LOCK g_psLinkedListLock;
 /* Lockdep feature in the kernel cannot differentiate between different instances of same lock type.
  * This allows it to group all such instances of the same lock type under one class
@@ -434,22 +449,152 @@ static DI_ENTRY *psProcStatsDIEntry;
 static IMG_HANDLE g_hDriverProcessStats;
 #endif
 
+/* Updates smaller than this many bytes are accumulated in a per-CPU delta
+ * and only folded into the global value (under hGlobalStatsLock) once the
+ * delta grows past it. Larger updates go straight to the global value. */
+#define GLOBAL_STAT_CPU_BATCH   (256 * 1024)
+/* Per-CPU deltas are padded to a 64 byte multiple to avoid false sharing */
+#define GLOBAL_STAT_CPU_STRIDE  PVR_ALIGN(PVRSRV_DRIVER_STAT_TYPE_COUNT, 64 / sizeof(ATOMIC_T))
+
 /* Global driver-data folders */
 typedef struct _GLOBAL_STATS_
 {
-	IMG_UINT64 ui64StatValue[PVRSRV_DRIVER_STAT_TYPE_COUNT];
+	/* Signed, as a fold of one CPU's deltas can take a stat below zero
+	 * while other CPUs still hold the matching increases. Reads clamp. */
+	IMG_INT64  i64StatValue[PVRSRV_DRIVER_STAT_TYPE_COUNT];
 	POS_LOCK   hGlobalStatsLock;
+	/* ui32NumCPUs * GLOBAL_STAT_CPU_STRIDE deltas not yet folded into
+	 * i64StatValue, NULL if all updates go to i64StatValue directly */
+	ATOMIC_T   *pasCPUDelta;
+	IMG_UINT32 ui32NumCPUs;
+#if defined(ENABLE_GPU_MEM_TRACEPOINT)
+	IMG_UINT64 ui64TracedGPUMem;
+#endif
 } GLOBAL_STATS;
 
 static DI_ENTRY *psGlobalMemDIEntry;
 static GLOBAL_STATS gsGlobalStats;
 
+/*************************************************************************/ /*!
+@Function       _GetGlobalStatValue
+@Description    Returns the value of a global stat, folding in the deltas
+                still held per-CPU. Must be called with hGlobalStatsLock held.
+@Input          ui32Stat  Stat to read.
+@Return         Stat value.
+*/ /**************************************************************************/
+static IMG_UINT64
+_GetGlobalStatValue(IMG_UINT32 ui32Stat)
+{
+	IMG_INT64 i64Value = gsGlobalStats.i64StatValue[ui32Stat];
+	IMG_UINT32 ui32CPU;
+
+	if (gsGlobalStats.pasCPUDelta != NULL)
+	{
+		for (ui32CPU = 0; ui32CPU < gsGlobalStats.ui32NumCPUs; ui32CPU++)
+		{
+			i64Value += OSAtomicRead(&gsGlobalStats.pasCPUDelta[ui32CPU * GLOBAL_STAT_CPU_STRIDE + ui32Stat]);
+		}
+	}
+
+#if !defined(PVRSRV_DEBUG_LINUX_MEMORY_STATS)
+	if (i64Value < 0)
+	{
+		i64Value = 0;
+	}
+#endif
+
+	return (IMG_UINT64)i64Value;
+}
+
+/* Must be called with hGlobalStatsLock held */
+static void
+_ApplyGlobalStatDelta(IMG_UINT32 ui32Stat, IMG_INT64 i64Delta)
+{
+	IMG_INT64 *pi64Value = &gsGlobalStats.i64StatValue[ui32Stat];
+
+	/* No clamping here, a negative value is only transient and is clamped
+	 * by _GetGlobalStatValue, clamping the accumulator would lose the
+	 * increases still held by other CPUs */
+	*pi64Value += i64Delta;
+
+	if (i64Delta > 0)
+	{
+		/* Each stat is directly followed by its _MAX watermark in
+		 * PVRSRV_DRIVER_STAT_KEY. With per-CPU deltas the watermark is only
+		 * updated when they are folded, so it can lag by up to
+		 * GLOBAL_STAT_CPU_BATCH per CPU. */
+		UPDATE_MAX_VALUE(gsGlobalStats.i64StatValue[ui32Stat + 1], *pi64Value);
+	}
+}
+
+/*************************************************************************/ /*!
+@Function       _UpdateGlobalStat
+@Description    Adds a signed delta to a global stat. Small deltas are
+                accumulated on the current CPU without taking
+                hGlobalStatsLock, and are folded into the global value once
+                they reach GLOBAL_STAT_CPU_BATCH.
+@Input          ui32Stat  Stat to update (not a _MAX watermark).
+@Input          i64Delta  Signed number of bytes to add.
+*/ /**************************************************************************/
+static void
+_UpdateGlobalStat(IMG_UINT32 ui32Stat, IMG_INT64 i64Delta)
+{
+	ATOMIC_T *psCPUDelta = NULL;
+
+	if (gsGlobalStats.pasCPUDelta != NULL &&
+	    i64Delta > -GLOBAL_STAT_CPU_BATCH && i64Delta < GLOBAL_STAT_CPU_BATCH)
+	{
+		IMG_UINT32 ui32CPU = OSGetCurrentCPU() % gsGlobalStats.ui32NumCPUs;
+		IMG_INT32 i32Pending;
+
+		psCPUDelta = &gsGlobalStats.pasCPUDelta[ui32CPU * GLOBAL_STAT_CPU_STRIDE + ui32Stat];
+		i32Pending = OSAtomicAdd(psCPUDelta, (IMG_INT32)i64Delta);
+
+		if (i32Pending > -GLOBAL_STAT_CPU_BATCH && i32Pending < GLOBAL_STAT_CPU_BATCH)
+		{
+			return;
+		}
+	}
+
+	OSLockAcquire(gsGlobalStats.hGlobalStatsLock);
+
+	if (psCPUDelta != NULL)
+	{
+		/* Take whatever has accumulated by now, including updates made by
+		 * other threads since our add */
+		i64Delta = OSAtomicExchange(psCPUDelta, 0);
+	}
+
+	_ApplyGlobalStatDelta(ui32Stat, i64Delta);
+
+#if defined(ENABLE_GPU_MEM_TRACEPOINT)
+	/* The tracepoint is only emitted when deltas are folded here, so it can
+	 * lag the real total by up to GLOBAL_STAT_CPU_BATCH per CPU for each
+	 * stat. The value it reports does include every CPU's pending deltas. */
+	{
+		IMG_UINT64 ui64Size = GET_GPUMEM_GLOBAL_STAT_VALUE();
+		if (ui64Size != gsGlobalStats.ui64TracedGPUMem)
+		{
+			gsGlobalStats.ui64TracedGPUMem = ui64Size;
+			TracepointUpdateGPUMemGlobal(0, ui64Size);
+		}
+	}
+#endif
+
+	OSLockRelease(gsGlobalStats.hGlobalStatsLock);
+}
+
 #define HASH_INITIAL_SIZE 5
 /* A hash table used to store the size of any vmalloc'd allocation
  * against its address (not needed for kmallocs as we can use ksize()) */
 static HASH_TABLE* gpsSizeTrackingHashTable;
 static POS_LOCK	 gpsSizeTrackingHashTableLock;
 
+#if defined(PVRSRV_ENABLE_MEMORY_STATS) && defined(__linux__) && defined(__KERNEL__)
+/* Slab cache for PVRSRV_MEM_ALLOC_REC, see _AllocMemAllocRec */
+static struct kmem_cache *gpsMemAllocRecCache;
+#endif
+
 static PVRSRV_ERROR _RegisterProcess(IMG_HANDLE *phProcessStats, IMG_PID ownerPid);
 
 static void _DestroyProcessStat(PVRSRV_PROCESS_STATS* psProcessStats);
@@ -458,6 +603,19 @@ static void _DecreaseProcStatValueUnlocked(PVRSRV_MEM_ALLOC_TYPE eAllocType,
                                            PVRSRV_PROCESS_STATS* psProcessStats,
                                            IMG_UINT64 uiBytes);
 
+/*************************************************************************/ /*!
+@Function       _FindProcessStats
+@Description    Searches the Live and Dead Process Lists for a statistics
+                structure that matches the PID given.
+@Input          pid  Process to search for.
+@Return         Pointer to stats structure for the process.
+*/ /**************************************************************************/
+static PVRSRV_PROCESS_STATS*
+_FindProcessStats(IMG_PID pid)
+{
+	return (PVRSRV_PROCESS_STATS*)HASH_Retrieve(gpsProcessStatsIndex, (uintptr_t)pid);
+} /* _FindProcessStats */
+
 /*************************************************************************/ /*!
 @Function       _FindProcessStatsInLiveList
 @Description    Searches the Live Process List for a statistics structure that
@@ -468,19 +626,9 @@ static void _DecreaseProcStatValueUnlocked(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 static PVRSRV_PROCESS_STATS*
 _FindProcessStatsInLiveList(IMG_PID pid)
 {
-	DLLIST_NODE *psNode, *psNext;
-
-	dllist_foreach_node(&gsLiveList, psNode, psNext)
-	{
-		PVRSRV_PROCESS_STATS* psProcessStats;
-		psProcessStats = IMG_CONTAINER_OF(psNode, PVRSRV_PROCESS_STATS, sNode);
+	PVRSRV_PROCESS_STATS* psProcessStats = _FindProcessStats(pid);
 
-		if (psProcessStats->pid == pid)
-		{
-			return psProcessStats;
-		}
-	}
-	return NULL;
+	return (psProcessStats != NULL && !psProcessStats->bDead) ? psProcessStats : NULL;
 } /* _FindProcessStatsInLiveList */
 
 /*************************************************************************/ /*!
@@ -493,40 +641,41 @@ _FindProcessStatsInLiveList(IMG_PID pid)
 static PVRSRV_PROCESS_STATS*
 _FindProcessStatsInDeadList(IMG_PID pid)
 {
-	DLLIST_NODE *psNode, *psNext;
+	PVRSRV_PROCESS_STATS* psProcessStats = _FindProcessStats(pid);
 
-	dllist_foreach_node(&gsDeadList, psNode, psNext)
-	{
-		PVRSRV_PROCESS_STATS* psProcessStats;
-		psProcessStats = IMG_CONTAINER_OF(psNode, PVRSRV_PROCESS_STATS, sNode);
-
-		if (psProcessStats->pid == pid)
-		{
-			return psProcessStats;
-		}
-	}
-	return NULL;
+	return (psProcessStats != NULL && psProcessStats->bDead) ? psProcessStats : NULL;
 } /* _FindProcessStatsInDeadList */
 
 /*************************************************************************/ /*!
-@Function       _FindProcessStats
-@Description    Searches the Live and Dead Process Lists for a statistics
-                structure that matches the PID given.
-@Input          pid  Process to search for.
-@Return         Pointer to stats structure for the process.
+@Function       _AddProcessToLiveList
+@Description    Adds a newly allocated process stats structure to the live
+                list and the PID index. Requires g_psLinkedListLock.
+@Input          psProcessStats  Process stats to add.
+@Return         PVRSRV_OK or PVRSRV_ERROR_OUT_OF_MEMORY if it could not be
+                indexed, in which case it is not added to the list either.
 */ /**************************************************************************/
-static PVRSRV_PROCESS_STATS*
-_FindProcessStats(IMG_PID pid)
+static PVRSRV_ERROR
+_AddProcessToLiveList(PVRSRV_PROCESS_STATS* psProcessStats)
 {
-	PVRSRV_PROCESS_STATS* psProcessStats = _FindProcessStatsInLiveList(pid);
-
-	if (psProcessStats == NULL)
+	if (!HASH_Insert(gpsProcessStatsIndex, (uintptr_t)psProcessStats->pid, (uintptr_t)psProcessStats))
 	{
-		psProcessStats = _FindProcessStatsInDeadList(pid);
+		return PVRSRV_ERROR_OUT_OF_MEMORY;
 	}
 
-	return psProcessStats;
-} /* _FindProcessStats */
+	psProcessStats->bDead = IMG_FALSE;
+	dllist_add_to_head(&gsLiveList, &psProcessStats->sNode);
+
+	return PVRSRV_OK;
+} /* _AddProcessToLiveList */
+
+/* Takes an entry off whichever list it is on and out of the PID index.
+ * Requires g_psLinkedListLock. */
+static void
+_RemoveProcessFromLists(PVRSRV_PROCESS_STATS* psProcessStats)
+{
+	dllist_remove_node(&psProcessStats->sNode);
+	HASH_Remove(gpsProcessStatsIndex, (uintptr_t)psProcessStats->pid);
+} /* _RemoveProcessFromLists */
 
 /*************************************************************************/ /*!
 @Function       _CompressMemoryUsage
@@ -562,6 +711,14 @@ _CompressMemoryUsage(void)
 		}
 	}
 
+	/* ...and drop the entries cut off from the index */
+	dllist_foreach_node(&sToBeFreedHead, psNode, psNext)
+	{
+		PVRSRV_PROCESS_STATS *psProcessStatsToBeFreed;
+		psProcessStatsToBeFreed = IMG_CONTAINER_OF(psNode, PVRSRV_PROCESS_STATS, sNode);
+		HASH_Remove(gpsProcessStatsIndex, (uintptr_t)psProcessStatsToBeFreed->pid);
+	}
+
 	OSLockRelease(g_psLinkedListLock);
 
 	dllist_foreach_node(&sToBeFreedHead, psNode, psNext)
@@ -588,6 +745,7 @@ _MoveProcessToDeadList(PVRSRV_PROCESS_STATS* psProcessStats)
 	PVR_ASSERT(psProcessStats != NULL);
 	dllist_remove_node(&psProcessStats->sNode);
 	dllist_add_to_head(&gsDeadList, &psProcessStats->sNode);
+	psProcessStats->bDead = IMG_TRUE;
 } /* _MoveProcessToDeadList */
 
 /* These functions move the process stats from the dead to the live list.
@@ -603,6 +761,7 @@ _MoveProcessToLiveList(PVRSRV_PROCESS_STATS* psProcessStats)
 	PVR_ASSERT(psProcessStats != NULL);
 	dllist_remove_node(&psProcessStats->sNode);
 	dllist_add_to_head(&gsLiveList, &psProcessStats->sNode);
+	psProcessStats->bDead = IMG_FALSE;
 } /* _MoveProcessToLiveList */
 
 static PVRSRV_ERROR
@@ -646,6 +805,37 @@ free_process_stats:
 }
 
 #if defined(PVRSRV_ENABLE_MEMORY_STATS)
+/*
+ * Memory records are allocated and freed with every tracked allocation, so
+ * they come from their own slab cache rather than the generic kmalloc size
+ * classes. To prevent a recursive loop neither path creates a memstat
+ * record entry itself.
+ */
+static INLINE PVRSRV_MEM_ALLOC_REC *
+_AllocMemAllocRec(void)
+{
+#if defined(__linux__) && defined(__KERNEL__)
+	if (gpsMemAllocRecCache != NULL)
+	{
+		return kmem_cache_zalloc(gpsMemAllocRecCache, GFP_KERNEL);
+	}
+#endif
+	return OSAllocZMemNoStats(sizeof(PVRSRV_MEM_ALLOC_REC));
+}
+
+static INLINE void
+_FreeMemAllocRec(PVRSRV_MEM_ALLOC_REC *psRecord)
+{
+#if defined(__linux__) && defined(__KERNEL__)
+	if (gpsMemAllocRecCache != NULL)
+	{
+		kmem_cache_free(gpsMemAllocRecCache, psRecord);
+		return;
+	}
+#endif
+	OSFreeMemNoStats(psRecord);
+}
+
 static PVRSRV_ERROR _FreeMemStatsEntry(uintptr_t k, uintptr_t v, void* pvPriv)
 {
 	PVRSRV_MEM_ALLOC_REC *psRecord = (PVRSRV_MEM_ALLOC_REC *)(uintptr_t)v;
@@ -659,7 +849,7 @@ static PVRSRV_ERROR _FreeMemStatsEntry(uintptr_t k, uintptr_t v, void* pvPriv)
 #else
 	PVR_UNREFERENCED_PARAMETER(k);
 #endif
-	OSFreeMemNoStats(psRecord);
+	_FreeMemAllocRec(psRecord);
 
 	return PVRSRV_OK;
 }
@@ -969,6 +1159,7 @@ PVRSRVStatsInitialise(void)
 
 	PVR_ASSERT(g_psLinkedListLock == NULL);
 	PVR_ASSERT(gpsSizeTrackingHashTable == NULL);
+	PVR_ASSERT(gpsProcessStatsIndex == NULL);
 	PVR_ASSERT(bProcessStatsInitialised == IMG_FALSE);
 
 	if (IS_ENABLED(CONFIG_PIXEL_STAT))
@@ -1006,6 +1197,26 @@ PVRSRVStatsInitialise(void)
 	gpsSizeTrackingHashTable = HASH_Create(HASH_INITIAL_SIZE);
 	PVR_GOTO_IF_NOMEM(gpsSizeTrackingHashTable, error, destroy_stats_lock_);
 
+	/* Entries move in and out of the index on every process (de)registration,
+	 * use the open addressed backend so that doing so does not allocate */
+	gpsProcessStatsIndex = HASH_Create_Extended_Type(HASH_INITIAL_SIZE, sizeof(uintptr_t),
+	                                                 HASH_Func_Default, HASH_Key_Comp_Default,
+	                                                 HASH_TABLE_TYPE_OPEN_ADDRESSED);
+	PVR_GOTO_IF_NOMEM(gpsProcessStatsIndex, error, destroy_size_tracking_hash_);
+
+	/* Per-CPU deltas for the global stats. These are optional, without them
+	 * every update takes hGlobalStatsLock. */
+	gsGlobalStats.ui32NumCPUs = MAX(OSGetCPUCount(), 1U);
+	gsGlobalStats.pasCPUDelta = OSAllocZMemNoStats(gsGlobalStats.ui32NumCPUs *
+	                                               GLOBAL_STAT_CPU_STRIDE * sizeof(ATOMIC_T));
+	PVR_LOG_IF_FALSE(gsGlobalStats.pasCPUDelta != NULL, "Failed to allocate per-CPU global stats");
+
+#if defined(PVRSRV_ENABLE_MEMORY_STATS) && defined(__linux__) && defined(__KERNEL__)
+	/* Likewise optional, records fall back to OSAllocZMemNoStats */
+	gpsMemAllocRecCache = kmem_cache_create("pvr-memstat-rec", sizeof(PVRSRV_MEM_ALLOC_REC), 0, 0, NULL);
+	PVR_LOG_IF_FALSE(gpsMemAllocRecCache != NULL, "kmem_cache_create() gpsMemAllocRecCache");
+#endif
+
 	dllist_init(&gsLiveList);
 	dllist_init(&gsDeadList);
 
@@ -1054,6 +1265,9 @@ PVRSRVStatsInitialise(void)
 
 	return PVRSRV_OK;
 
+destroy_size_tracking_hash_:
+	HASH_Delete(gpsSizeTrackingHashTable);
+	gpsSizeTrackingHashTable = NULL;
 destroy_stats_lock_:
 #if defined(__linux__) && defined(__KERNEL__)
 	OSLockDestroyNoStats(gsGlobalStats.hGlobalStatsLock);
@@ -1141,17 +1355,23 @@ PVRSRVStatsDestroy(void)
 	dllist_foreach_node(&gsLiveList, psNode, psNext)
 	{
 		PVRSRV_PROCESS_STATS* psProcessStats = IMG_CONTAINER_OF(psNode, PVRSRV_PROCESS_STATS, sNode);
-		dllist_remove_node(&psProcessStats->sNode);
+		_RemoveProcessFromLists(psProcessStats);
 		_DestroyProcessStat(psProcessStats);
 	}
 
 	dllist_foreach_node(&gsDeadList, psNode, psNext)
 	{
 		PVRSRV_PROCESS_STATS* psProcessStats = IMG_CONTAINER_OF(psNode, PVRSRV_PROCESS_STATS, sNode);
-		dllist_remove_node(&psProcessStats->sNode);
+		_RemoveProcessFromLists(psProcessStats);
 		_DestroyProcessStat(psProcessStats);
 	}
 
+	if (gpsProcessStatsIndex != NULL)
+	{
+		HASH_Delete(gpsProcessStatsIndex);
+		gpsProcessStatsIndex = NULL;
+	}
+
 	if (gpsSizeTrackingHashTable != NULL)
 	{
 		/* Dump all remaining entries in HASH table (list any remaining vmallocs) */
@@ -1178,6 +1398,22 @@ PVRSRVStatsDestroy(void)
 		gsGlobalStats.hGlobalStatsLock = NULL;
 	}
 
+	if (gsGlobalStats.pasCPUDelta != NULL)
+	{
+		ATOMIC_T *pasCPUDelta = gsGlobalStats.pasCPUDelta;
+
+		gsGlobalStats.pasCPUDelta = NULL;
+		OSFreeMemNoStats(pasCPUDelta);
+	}
+
+#if defined(PVRSRV_ENABLE_MEMORY_STATS) && defined(__linux__) && defined(__KERNEL__)
+	/* All records were freed with the process stats above */
+	if (gpsMemAllocRecCache != NULL)
+	{
+		kmem_cache_destroy(gpsMemAllocRecCache);
+		gpsMemAllocRecCache = NULL;
+	}
+#endif
 }
 
 void
@@ -1206,16 +1442,6 @@ PVRSRVStatsDestroyDI(void)
 static void _decrease_global_stat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 								  size_t uiBytes)
 {
-#if defined(ENABLE_GPU_MEM_TRACEPOINT)
-	IMG_UINT64 ui64InitialSize;
-#endif
-
-	OSLockAcquire(gsGlobalStats.hGlobalStatsLock);
-
-#if defined(ENABLE_GPU_MEM_TRACEPOINT)
-	ui64InitialSize = GET_GPUMEM_GLOBAL_STAT_VALUE();
-#endif
-
 	switch (eAllocType)
 	{
 		case PVRSRV_MEM_ALLOC_TYPE_KMALLOC:
@@ -1284,33 +1510,11 @@ static void _decrease_global_stat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 			PVR_ASSERT(0);
 			break;
 	}
-
-#if defined(ENABLE_GPU_MEM_TRACEPOINT)
-	{
-		IMG_UINT64 ui64Size = GET_GPUMEM_GLOBAL_STAT_VALUE();
-		if (ui64Size != ui64InitialSize)
-		{
-			TracepointUpdateGPUMemGlobal(0, ui64Size);
-		}
-	}
-#endif
-
-	OSLockRelease(gsGlobalStats.hGlobalStatsLock);
 }
 
 static void _increase_global_stat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 								  size_t uiBytes)
 {
-#if defined(ENABLE_GPU_MEM_TRACEPOINT)
-	IMG_UINT64 ui64InitialSize;
-#endif
-
-	OSLockAcquire(gsGlobalStats.hGlobalStatsLock);
-
-#if defined(ENABLE_GPU_MEM_TRACEPOINT)
-	ui64InitialSize = GET_GPUMEM_GLOBAL_STAT_VALUE();
-#endif
-
 	switch (eAllocType)
 	{
 		case PVRSRV_MEM_ALLOC_TYPE_KMALLOC:
@@ -1379,24 +1583,13 @@ static void _increase_global_stat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 			PVR_ASSERT(0);
 			break;
 	}
-
-#if defined(ENABLE_GPU_MEM_TRACEPOINT)
-	{
-		IMG_UINT64 ui64Size = GET_GPUMEM_GLOBAL_STAT_VALUE();
-		if (ui64Size != ui64InitialSize)
-		{
-			TracepointUpdateGPUMemGlobal(0, ui64Size);
-		}
-	}
-#endif
-
-	OSLockRelease(gsGlobalStats.hGlobalStatsLock);
 }
 
 static PVRSRV_ERROR
 _RegisterProcess(IMG_HANDLE *phProcessStats, IMG_PID ownerPid)
 {
 	PVRSRV_PROCESS_STATS*	psProcessStats=NULL;
+	PVRSRV_PROCESS_STATS*	psExistingStats;
 	PVRSRV_ERROR			eError;
 
 	PVR_ASSERT(phProcessStats != NULL);
@@ -1443,9 +1636,37 @@ _RegisterProcess(IMG_HANDLE *phProcessStats, IMG_PID ownerPid)
 
 	/* Add it to the live list... */
 	OSLockAcquire(g_psLinkedListLock);
-	dllist_add_to_head(&gsLiveList, &psProcessStats->sNode);
+
+	/* ...unless another thread registered the same PID while the lock was
+	 * dropped, the index only holds one entry per PID */
+	psExistingStats = _FindProcessStats(ownerPid);
+	if (psExistingStats != NULL)
+	{
+		if (psExistingStats->bDead)
+		{
+			_MoveProcessToLiveList(psExistingStats);
+		}
+
+		OSLockAcquireNested(psExistingStats->hLock, PROCESS_LOCK_SUBCLASS_CURRENT);
+		psExistingStats->ui32RefCount++;
+		OSLockRelease(psExistingStats->hLock);
+		OSLockRelease(g_psLinkedListLock);
+
+		_DestroyProcessStat(psProcessStats);
+		*phProcessStats = psExistingStats;
+
+		return PVRSRV_OK;
+	}
+
+	eError = _AddProcessToLiveList(psProcessStats);
 	OSLockRelease(g_psLinkedListLock);
 
+	if (eError != PVRSRV_OK)
+	{
+		_DestroyProcessStat(psProcessStats);
+		goto e0;
+	}
+
 	/* Done */
 	*phProcessStats = (IMG_HANDLE) psProcessStats;
 
@@ -1557,7 +1778,7 @@ void PVRSRVStatsDeviceDisconnect(PVRSRV_DEVICE_NODE *psDeviceNode)
 
 	if (psPVRSRVData)
 	{
-		if ((currentPid == psPVRSRVData->cleanupThreadPid) &&
+		if (PVRSRVCleanupThreadIsWorkerPid(currentPid) &&
 		    (currentCleanupPid != 0))
 		{
 			psProcessStats = _FindProcessStats(currentCleanupPid);
@@ -1953,14 +2174,8 @@ PVRSRVStatsAddMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 		return;
 	}
 
-	/*
-	 * To prevent a recursive loop, we make the memory allocations for our
-	 * memstat records via OSAllocMemNoStats(), which does not try to
-	 * create a memstat record entry.
-	 */
-
 	/* Allocate the memory record... */
-	psRecord = OSAllocZMemNoStats(sizeof(PVRSRV_MEM_ALLOC_REC));
+	psRecord = _AllocMemAllocRec();
 	if (psRecord == NULL)
 	{
 		return;
@@ -1982,7 +2197,7 @@ PVRSRVStatsAddMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 
 	if (psPVRSRVData)
 	{
-		if ((currentPid == psPVRSRVData->cleanupThreadPid) &&
+		if (PVRSRVCleanupThreadIsWorkerPid(currentPid) &&
 		    (currentCleanupPid != 0))
 		{
 			psProcessStats = _FindProcessStats(currentCleanupPid);
@@ -2026,7 +2241,12 @@ PVRSRVStatsAddMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 		}
 
 		/* Add it to the live list... */
-		dllist_add_to_head(&gsLiveList, &psProcessStats->sNode);
+		if (_AddProcessToLiveList(psProcessStats) != PVRSRV_OK)
+		{
+			OSLockRelease(g_psLinkedListLock);
+			_DestroyProcessStat(psProcessStats);
+			goto free_record;
+		}
 
 		OSLockRelease(g_psLinkedListLock);
 
@@ -2086,7 +2306,7 @@ PVRSRVStatsAddMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 
 free_record:
 	_decrease_global_stat(eAllocType, uiBytes);
-	OSFreeMemNoStats(psRecord);
+	_FreeMemAllocRec(psRecord);
 #else /* defined(PVRSRV_ENABLE_MEMORY_STATS) */
 	PVR_UNREFERENCED_PARAMETER(eAllocType);
 	PVR_UNREFERENCED_PARAMETER(pvCpuVAddr);
@@ -2124,7 +2344,7 @@ PVRSRVStatsRemoveMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 
 	if (psPVRSRVData)
 	{
-		if ((currentPid == psPVRSRVData->cleanupThreadPid) &&
+		if (PVRSRVCleanupThreadIsWorkerPid(currentPid) &&
 		    (currentCleanupPid != 0))
 		{
 			psProcessStats = _FindProcessStats(currentCleanupPid);
@@ -2222,7 +2442,7 @@ PVRSRVStatsRemoveMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 		 * Free the record outside the lock so we don't deadlock and so we
 		 * reduce the time the lock is held.
 		 */
-		OSFreeMemNoStats(psRecord);
+		_FreeMemAllocRec(psRecord);
 	}
 	else
 	{
@@ -2274,7 +2494,7 @@ PVRSRVStatsTransferMemAllocRecord(PVRSRV_MEM_ALLOC_TYPE eCurrentType,
 
 	if (psPVRSRVData)
 	{
-		if ((currentPid == psPVRSRVData->cleanupThreadPid) &&
+		if (PVRSRVCleanupThreadIsWorkerPid(currentPid) &&
 		    (currentCleanupPid != 0))
 		{
 			psProcessStats = _FindProcessStats(currentCleanupPid);
@@ -2438,7 +2658,7 @@ PVRSRVStatsIncrMemAllocStat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 	OSLockAcquire(g_psLinkedListLock);
 	if (psPVRSRVData)
 	{
-		if ((currentPid == psPVRSRVData->cleanupThreadPid) &&
+		if (PVRSRVCleanupThreadIsWorkerPid(currentPid) &&
 		    (currentCleanupPid != 0))
 		{
 			psProcessStats = _FindProcessStats(currentCleanupPid);
@@ -2480,7 +2700,12 @@ PVRSRVStatsIncrMemAllocStat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 				return;
 			}
 			/* Add it to the live list... */
-			dllist_add_to_head(&gsLiveList, &psProcessStats->sNode);
+			if (_AddProcessToLiveList(psProcessStats) != PVRSRV_OK)
+			{
+				OSLockRelease(g_psLinkedListLock);
+				_DestroyProcessStat(psProcessStats);
+				return;
+			}
 		}
 #else
 		OSLockRelease(g_psLinkedListLock);
@@ -2660,7 +2885,7 @@ PVRSRVStatsDecrMemAllocStat(PVRSRV_MEM_ALLOC_TYPE eAllocType,
 	OSLockAcquire(g_psLinkedListLock);
 	if (psPVRSRVData)
 	{
-		if ((currentPid == psPVRSRVData->cleanupThreadPid) &&
+		if (PVRSRVCleanupThreadIsWorkerPid(currentPid) &&
 		    (currentCleanupPid != 0))
 		{
 			psProcessStats = _FindProcessStats(currentCleanupPid);
@@ -2978,9 +3203,14 @@ ProcessStatsPrintElements(OSDI_IMPL_ENTRY *psEntry,
                           PVRSRV_PROCESS_STATS *psProcessStats)
 {
 	IMG_UINT32 ui32StatNumber;
-
 #if defined(PVRSRV_ENABLE_GPU_MEMORY_INFO)
+	IMG_INT32 i32TotalLMA, i32TotalUMA;
+
+	/* Only hold the RI lock for the totals, not for the whole output */
 	RILockAcquireKM();
+	i32TotalLMA = RITotalAllocProcessUnlocked(psProcessStats->pid, PHYS_HEAP_TYPE_LMA);
+	i32TotalUMA = RITotalAllocProcessUnlocked(psProcessStats->pid, PHYS_HEAP_TYPE_UMA);
+	RILockReleaseKM();
 #endif
 	OSLockAcquireNested(psProcessStats->hLock, PROCESS_LOCK_SUBCLASS_CURRENT);
 
@@ -3031,9 +3261,8 @@ ProcessStatsPrintElements(OSDI_IMPL_ENTRY *psEntry,
 			    (ui32StatNumber == PVRSRV_PROCESS_STAT_TYPE_ALLOC_UMA_PAGES))
 			{
 				/* get the stat from RI */
-				IMG_INT32 ui32Total = RITotalAllocProcessUnlocked(psProcessStats->pid,
-									    (ui32StatNumber == PVRSRV_PROCESS_STAT_TYPE_ALLOC_LMA_PAGES)
-									    ? PHYS_HEAP_TYPE_LMA : PHYS_HEAP_TYPE_UMA);
+				IMG_INT32 ui32Total = (ui32StatNumber == PVRSRV_PROCESS_STAT_TYPE_ALLOC_LMA_PAGES) ?
+				                      i32TotalLMA : i32TotalUMA;
 
 				DIPrintf(psEntry, "%-34s%10d %8dK\n",
 						 pszProcessStatType[ui32StatNumber], ui32Total, ui32Total>>10);
@@ -3060,9 +3289,6 @@ ProcessStatsPrintElements(OSDI_IMPL_ENTRY *psEntry,
 	}
 
 	OSLockRelease(psProcessStats->hLock);
-#if defined(PVRSRV_ENABLE_GPU_MEMORY_INFO)
-	RILockReleaseKM();
-#endif
 } /* ProcessStatsPrintElements */
 #endif
 
@@ -3360,24 +3586,24 @@ MemStatsPrintElements(OSDI_IMPL_ENTRY *psEntry,
 void RIMemStatsPrintElements(OSDI_IMPL_ENTRY *psEntry,
                              PVRSRV_PROCESS_STATS *psProcessStats)
 {
-	IMG_CHAR   *pszStatFmtText  = NULL;
-	IMG_HANDLE *pRIHandle       = NULL;
+	IMG_CHAR    *pszStatFmtText = NULL;
+	RI_SNAPSHOT *psSnapshot     = NULL;
+	PVRSRV_ERROR eError;
 
-	/* Acquire RI lock */
-	RILockAcquireKM();
+	/* Copy the RI entries of the process under the RI lock, then print
+	 * them without holding it. */
+	eError = RISnapshotProcessKM(psProcessStats->pid, &psSnapshot);
+	PVR_LOG_RETURN_VOID_IF_ERROR(eError, "RISnapshotProcessKM");
 
 	/*
-	 * Loop through the RI system to get each line of text.
+	 * Loop through the snapshot to get each line of text.
 	 */
-	while (RIGetListEntryKM(psProcessStats->pid,
-							&pRIHandle,
-							&pszStatFmtText))
+	while (RIGetSnapshotEntryKM(psSnapshot, &pszStatFmtText))
 	{
 		DIPrintf(psEntry, "%s", pszStatFmtText);
 	}
 
-	/* Release RI lock */
-	RILockReleaseKM();
+	RIFreeSnapshotKM(psSnapshot);
 
 } /* RIMemStatsPrintElements */
 #endif
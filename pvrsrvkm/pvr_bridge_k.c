@@ -52,6 +52,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "connection_server.h"
 #include "syscommon.h"
 #include "pvr_debug.h"
+#include "allocmem.h"
 #include "di_server.h"
 #include "private_data.h"
 #include "linkage.h"
@@ -71,6 +72,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "env_connection.h"
 #include <linux/sched.h>
 #include <linux/freezer.h>
+#include <linux/uaccess.h>
 
 #include "srvcore.h"
 #include "common_srvcore_bridge.h"
@@ -95,6 +97,9 @@ void DeinitDMABUFBridge(void);
  */
 static DEFINE_MUTEX(g_sMMapMutex);
 
+/* Command vectors up to this length are dispatched from arrays on the stack */
+#define PVR_SRVKM_CMD_VEC_INLINE_CMDS 4
+
 #define _SUSPENDED 1
 #define _NOT_SUSPENDED 0
 static ATOMIC_T g_iDriverSuspendCount;
@@ -155,11 +160,14 @@ static int BridgeStatsDIShow(OSDI_IMPL_ENTRY *psEntry, void *pvData)
 		BridgeGlobalStatsLock();
 		DIPrintf(psEntry,
 		         "Total ioctl call count = %u\n"
+		         "Vectored ioctl count = %u (%u bridge calls)\n"
 		         "Total number of bytes copied via copy_from_user = %u\n"
 		         "Total number of bytes copied via copy_to_user = %u\n"
 		         "Total number of bytes copied via copy_*_user = %u\n\n"
 		         "%3s: %-60s | %-48s | %10s | %20s | %20s | %20s | %20s\n",
 		         g_BridgeGlobalStats.ui32IOCTLCount,
+		         g_BridgeGlobalStats.ui32VecIOCTLCount,
+		         g_BridgeGlobalStats.ui32VecCallCount,
 		         g_BridgeGlobalStats.ui32TotalCopyFromUserBytes,
 		         g_BridgeGlobalStats.ui32TotalCopyToUserBytes,
 		         g_BridgeGlobalStats.ui32TotalCopyFromUserBytes +
@@ -213,6 +221,8 @@ static IMG_INT64 BridgeStatsWrite(const IMG_CHAR *pcBuffer,
 	BridgeGlobalStatsLock();
 
 	g_BridgeGlobalStats.ui32IOCTLCount = 0;
+	g_BridgeGlobalStats.ui32VecIOCTLCount = 0;
+	g_BridgeGlobalStats.ui32VecCallCount = 0;
 	g_BridgeGlobalStats.ui32TotalCopyFromUserBytes = 0;
 	g_BridgeGlobalStats.ui32TotalCopyToUserBytes = 0;
 
@@ -562,6 +572,103 @@ e0:
 	return OSPVRSRVToNativeError(error);
 }
 
+int
+PVRSRV_BridgeDispatchVecKM(struct drm_device __maybe_unused *dev, void *arg, struct drm_file *pDRMFile)
+{
+	struct drm_pvr_srvkm_cmd_vec *psSrvkmCmdVec = (struct drm_pvr_srvkm_cmd_vec *) arg;
+	struct drm_pvr_srvkm_cmd __user *psUserCmds;
+	PVRSRV_BRIDGE_PACKAGE asInlinePackagesKM[PVR_SRVKM_CMD_VEC_INLINE_CMDS];
+	PVRSRV_ERROR aeInlineResults[PVR_SRVKM_CMD_VEC_INLINE_CMDS];
+	PVRSRV_BRIDGE_PACKAGE *psBridgePackagesKM = asInlinePackagesKM;
+	PVRSRV_ERROR *peResults = aeInlineResults;
+	void *pvVecAlloc = NULL;
+	CONNECTION_DATA *psConnection = LinuxServicesConnectionFromFile(pDRMFile->filp);
+	IMG_UINT32 ui32NumDone = 0;
+	IMG_UINT32 i;
+	PVRSRV_ERROR error;
+
+	if (psConnection == NULL)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "Invalid connection data"));
+		return -EFAULT;
+	}
+
+	PVR_ASSERT(psSrvkmCmdVec != NULL);
+
+	if (psSrvkmCmdVec->num_cmds == 0 ||
+	    psSrvkmCmdVec->num_cmds > PVR_SRVKM_CMD_VEC_MAX_CMDS ||
+	    (psSrvkmCmdVec->flags & ~PVR_SRVKM_CMD_VEC_FLAGS_MASK) != 0)
+	{
+		return -EINVAL;
+	}
+
+	/* Short vectors are the common case and use the arrays on the stack,
+	 * longer ones get a single heap allocation holding both arrays */
+	if (psSrvkmCmdVec->num_cmds > PVR_SRVKM_CMD_VEC_INLINE_CMDS)
+	{
+		pvVecAlloc = OSAllocMem(psSrvkmCmdVec->num_cmds *
+		                        (sizeof(*psBridgePackagesKM) + sizeof(*peResults)));
+		if (pvVecAlloc == NULL)
+		{
+			return -ENOMEM;
+		}
+
+		psBridgePackagesKM = pvVecAlloc;
+		peResults = (PVRSRV_ERROR *)&psBridgePackagesKM[psSrvkmCmdVec->num_cmds];
+	}
+
+	psUserCmds = (struct drm_pvr_srvkm_cmd __user *)(uintptr_t)psSrvkmCmdVec->cmds_ptr;
+
+	for (i = 0; i < psSrvkmCmdVec->num_cmds; i++)
+	{
+		struct drm_pvr_srvkm_cmd sSrvkmCmd;
+
+		if (copy_from_user(&sSrvkmCmd, &psUserCmds[i], sizeof(sSrvkmCmd)))
+		{
+			OSFreeMem(pvVecAlloc);
+			return -EFAULT;
+		}
+
+		psBridgePackagesKM[i].ui32BridgeID = sSrvkmCmd.bridge_id;
+		psBridgePackagesKM[i].ui32FunctionID = sSrvkmCmd.bridge_func_id;
+		psBridgePackagesKM[i].ui32Size = sizeof(psBridgePackagesKM[i]);
+		psBridgePackagesKM[i].pvParamIn = (void __user *)(uintptr_t)sSrvkmCmd.in_data_ptr;
+		psBridgePackagesKM[i].ui32InBufferSize = sSrvkmCmd.in_data_size;
+		psBridgePackagesKM[i].pvParamOut = (void __user *)(uintptr_t)sSrvkmCmd.out_data_ptr;
+		psBridgePackagesKM[i].ui32OutBufferSize = sSrvkmCmd.out_data_size;
+	}
+
+	error = PVRSRVDriverThreadEnter(psConnection);
+	PVR_LOG_GOTO_IF_ERROR(error, "PVRSRVDriverThreadEnter", e0);
+
+	error = BridgedDispatchVecKM(psConnection,
+	                             psBridgePackagesKM,
+	                             psSrvkmCmdVec->num_cmds,
+	                             BITMASK_HAS(psSrvkmCmdVec->flags,
+	                                         PVR_SRVKM_CMD_VEC_FLAG_STOP_ON_ERROR),
+	                             peResults,
+	                             &ui32NumDone);
+	PVR_GOTO_IF_ERROR(error, e0);
+
+	/* The results array in the ioctl is an array of __s32 */
+	static_assert(sizeof(PVRSRV_ERROR) == sizeof(__s32), "PVRSRV_ERROR must be 32 bits");
+
+	if (copy_to_user((void __user *)(uintptr_t)psSrvkmCmdVec->results_ptr,
+	                 peResults, ui32NumDone * sizeof(peResults[0])))
+	{
+		error = PVRSRV_ERROR_BRIDGE_EFAULT;
+	}
+
+	psSrvkmCmdVec->num_done = ui32NumDone;
+
+e0:
+	PVRSRVDriverThreadExit(psConnection);
+
+	OSFreeMem(pvVecAlloc);
+
+	return OSPVRSRVToNativeError(error);
+}
+
 int
 PVRSRV_MMap(struct file *pFile, struct vm_area_struct *ps_vma)
 {
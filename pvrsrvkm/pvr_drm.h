@@ -74,6 +74,25 @@ struct drm_pvr_srvkm_cmd {
 	__u32 out_data_size;
 };
 
+/* Stop executing a command vector after the first command that fails */
+#define PVR_SRVKM_CMD_VEC_FLAG_STOP_ON_ERROR	(1U << 0)
+#define PVR_SRVKM_CMD_VEC_FLAGS_MASK		(PVR_SRVKM_CMD_VEC_FLAG_STOP_ON_ERROR)
+
+/* Maximum number of commands in a single command vector */
+#define PVR_SRVKM_CMD_VEC_MAX_CMDS		16
+
+struct drm_pvr_srvkm_cmd_vec {
+	/* Array of num_cmds struct drm_pvr_srvkm_cmd, executed in order */
+	__u64 cmds_ptr;
+	/* Array of num_cmds __s32 receiving each command's PVRSRV_ERROR */
+	__u64 results_ptr;
+	__u32 num_cmds;
+	__u32 flags;
+	/* Out: number of commands executed */
+	__u32 num_done;
+	__u32 pad;
+};
+
 struct pvr_sync_rename_ioctl_data {
 	char szName[32];
 };
@@ -129,11 +148,18 @@ struct drm_pvr_srvkm_init_data {
 #define DRM_PVR_EXP_FENCE_SYNC_FORCE_CMD	6
 #define DRM_PVR_SYNC_CREATE_EXPORT_FENCE_CMD	7
 
+/* PVR Services vectored command */
+#define DRM_PVR_SRVKM_CMD_VEC			8
+
 /* These defines must be prefixed with "DRM_IOCTL_". */
 #define	DRM_IOCTL_PVR_SRVKM_CMD	\
 	DRM_IOWR(DRM_COMMAND_BASE + DRM_PVR_SRVKM_CMD, \
 		 struct drm_pvr_srvkm_cmd)
 
+#define	DRM_IOCTL_PVR_SRVKM_CMD_VEC	\
+	DRM_IOWR(DRM_COMMAND_BASE + DRM_PVR_SRVKM_CMD_VEC, \
+		 struct drm_pvr_srvkm_cmd_vec)
+
 #define DRM_IOCTL_PVR_SYNC_RENAME_CMD \
 	DRM_IOW(DRM_COMMAND_BASE + DRM_PVR_SYNC_RENAME_CMD, \
 		struct pvr_sync_rename_ioctl_data)
@@ -107,6 +107,8 @@ void pvr_drm_unload(struct drm_device *ddev);
 
 int PVRSRV_BridgeDispatchKM(struct drm_device *dev, void *arg,
 			    struct drm_file *file);
+int PVRSRV_BridgeDispatchVecKM(struct drm_device *dev, void *arg,
+			       struct drm_file *file);
 int PVRSRV_MMap(struct file *file, struct vm_area_struct *ps_vma);
 
 #endif /* !defined(__PVR_DRV_H__) */
@@ -128,6 +128,11 @@ pvr_fence_context_fences_dump(struct pvr_fence_context *fctx,
 	pvr_context_value_str(fctx, value, sizeof(value));
 	PVR_DUMPDEBUG_LOG(pfnDumpDebugPrintf, pvDumpDebugFile,
 			 "%s: @%s", fctx->name, value);
+	PVR_DUMPDEBUG_LOG(pfnDumpDebugPrintf, pvDumpDebugFile,
+			  " signalling: %s notifies=%llu full_scans=%llu examined=%llu signalled=%llu",
+			  fctx->signal_in_order ? "in-order" : "unordered",
+			  fctx->signal_notify_count, fctx->signal_full_scans,
+			  fctx->signal_examined, fctx->signal_signalled);
 	list_for_each_entry(pvr_fence, &fctx->fence_list, fence_head) {
 		struct dma_fence *fence = pvr_fence->fence;
 		const char *timeline_value_str = "unknown timeline value";
@@ -208,6 +213,13 @@ pvr_fence_context_seqno_next(struct pvr_fence_context *fctx)
 	return atomic_inc_return(&fctx->fence_seqno) - 1;
 }
 
+/* Seqnos come from a 32-bit counter, compare them allowing for wrap */
+static inline bool
+pvr_fence_seqno_after(u64 a, u64 b)
+{
+	return (s32)((u32)a - (u32)b) > 0;
+}
+
 /* This function prepends seqno to fence name */
 static inline void
 pvr_fence_prepare_name(char *fence_name, size_t fence_name_size,
@@ -284,13 +296,19 @@ pvr_fence_context_free_deferred_callback(void *data)
 	pvr_fence_context_free_deferred(fctx);
 }
 
-static void
-pvr_fence_context_signal_fences(void *data)
+/*
+ * Signals the fences of a context whose sync checkpoints have signalled.
+ * Returns true if the scan stopped early and left fences behind unchecked.
+ */
+static bool
+pvr_fence_context_scan_signal_list(struct pvr_fence_context *fctx,
+				   bool full_scan, bool notify)
 {
-	struct pvr_fence_context *fctx = (struct pvr_fence_context *)data;
-	struct pvr_fence *pvr_fence, *tmp;
+	struct pvr_fence *pvr_fence, *tmp, *newest;
 	unsigned long flags1;
 	struct list_head signal_list;
+	bool blocked = false, out_of_order = false, stopped_early = false;
+	u64 examined = 0, signalled = 0;
 
 	INIT_LIST_HEAD(&signal_list);
 
@@ -304,12 +322,56 @@ pvr_fence_context_signal_fences(void *data)
 	 *
 	 * So extract the items we intend to signal and add them to their own
 	 * queue.
+	 *
+	 * The signal list is kept in seqno order. On an in-order context the
+	 * scan stops at the first unsignalled fence, after checking that the
+	 * newest fence has not signalled either. Seeing a fence signal out of
+	 * order drops the context back to scanning the whole list.
 	 */
 	spin_lock_irqsave(&fctx->list_lock, flags1);
+	if (notify)
+		fctx->signal_notify_count++;
+	if (!fctx->signal_in_order)
+		full_scan = true;
+
 	list_for_each_entry_safe(pvr_fence, tmp, &fctx->signal_list, signal_head) {
-		if (pvr_fence_sync_is_signaled(pvr_fence, PVRSRV_FENCE_FLAG_SUPPRESS_HWP_PKT))
+		examined++;
+		if (pvr_fence_sync_is_signaled(pvr_fence, PVRSRV_FENCE_FLAG_SUPPRESS_HWP_PKT)) {
 			list_move_tail(&pvr_fence->signal_head, &signal_list);
+			signalled++;
+			if (blocked)
+				out_of_order = true;
+			continue;
+		}
+
+		blocked = true;
+		if (full_scan)
+			continue;
+
+		newest = list_last_entry(&fctx->signal_list, struct pvr_fence,
+					 signal_head);
+		if (newest == pvr_fence)
+			break;
+
+		examined++;
+		if (!pvr_fence_sync_is_signaled(newest, PVRSRV_FENCE_FLAG_SUPPRESS_HWP_PKT)) {
+			stopped_early = true;
+			break;
+		}
+
+		/* A later fence completed first, check everything */
+		full_scan = true;
 	}
+
+	if (full_scan)
+		fctx->signal_full_scans++;
+	if (out_of_order && fctx->signal_in_order) {
+		PVR_FENCE_CTX_TRACE(fctx, "out of order signalling on context (%s)\n",
+				    fctx->name);
+		fctx->signal_in_order = false;
+	}
+	fctx->signal_examined += examined;
+	fctx->signal_signalled += signalled;
 	spin_unlock_irqrestore(&fctx->list_lock, flags1);
 
 	list_for_each_entry_safe(pvr_fence, tmp, &signal_list, signal_head) {
@@ -338,6 +400,33 @@ pvr_fence_context_signal_fences(void *data)
 	 * have deferred freeing.
 	 */
 	pvr_fence_context_free_deferred(fctx);
+
+	return stopped_early;
+}
+
+static void
+pvr_fence_context_signal_scan_work(struct work_struct *data)
+{
+	struct pvr_fence_context *fctx =
+		container_of(data, struct pvr_fence_context, signal_scan_work);
+
+	(void) pvr_fence_context_scan_signal_list(fctx, true, false);
+}
+
+static void
+pvr_fence_context_signal_fences(void *data)
+{
+	struct pvr_fence_context *fctx = (struct pvr_fence_context *)data;
+
+	/*
+	 * Fences behind the first unsignalled one may still have completed, as
+	 * a timeline can be fed from more than one CCB. Don't rely on another
+	 * notification arriving to pick them up (the GPU may go idle), finish
+	 * with a full scan from the fence workqueue. Back to back notifications
+	 * share a single pending scan.
+	 */
+	if (pvr_fence_context_scan_signal_list(fctx, false, true))
+		queue_work(fctx->fence_wq, &fctx->signal_scan_work);
 }
 
 void
@@ -355,6 +444,7 @@ pvr_fence_context_destroy_internal(struct pvr_fence_context *fctx)
 		pvr_fence_context_fences_dump(fctx, NULL, NULL);
 
 	PVRSRVUnregisterCmdCompleteNotify(fctx->cmd_complete_handle);
+	cancel_work_sync(&fctx->signal_scan_work);
 
 	/* wait for all fences to be freed before kmem_cache_destroy() is called */
 	rcu_barrier();
@@ -421,6 +511,7 @@ pvr_fence_context_create_internal(struct workqueue_struct *fence_status_wq,
 	spin_lock_init(&fctx->lock);
 	atomic_set(&fctx->fence_seqno, 0);
 	INIT_WORK(&fctx->check_status_work, pvr_fence_context_check_status);
+	INIT_WORK(&fctx->signal_scan_work, pvr_fence_context_signal_scan_work);
 	INIT_WORK(&fctx->destroy_work, destroy_callback);
 	spin_lock_init(&fctx->list_lock);
 	INIT_LIST_HEAD(&fctx->signal_list);
@@ -550,6 +641,11 @@ pvr_fence_context_create(void *dev_cookie,
 
 	fctx->dev_cookie = dev_cookie;
 
+	/* Fences on a services timeline normally complete in the order they
+	 * were created, allow the signal scan to stop early. Anything it leaves
+	 * behind is picked up by the deferred full scan. */
+	fctx->signal_in_order = true;
+
 	eError = pvr_fence_context_register_dbg(&fctx->dbg_request_handle,
 					dev_cookie,
 					fctx);
@@ -652,6 +748,8 @@ static bool
 pvr_fence_enable_signaling(struct dma_fence *fence)
 {
 	struct pvr_fence *pvr_fence = to_pvr_fence(fence);
+	struct pvr_fence *prev;
+	struct list_head *pos;
 	unsigned long flags;
 
 	if (!pvr_fence)
@@ -664,8 +762,17 @@ pvr_fence_enable_signaling(struct dma_fence *fence)
 
 	dma_fence_get(&pvr_fence->base);
 
+	/* Keep the signal list in seqno order. Signalling is usually enabled in
+	 * creation order so the walk from the tail normally stops immediately. */
 	spin_lock_irqsave(&pvr_fence->fctx->list_lock, flags);
-	list_add_tail(&pvr_fence->signal_head, &pvr_fence->fctx->signal_list);
+	pos = &pvr_fence->fctx->signal_list;
+	list_for_each_entry_reverse(prev, &pvr_fence->fctx->signal_list, signal_head) {
+		if (!pvr_fence_seqno_after(prev->base.seqno, pvr_fence->base.seqno)) {
+			pos = &prev->signal_head;
+			break;
+		}
+	}
+	list_add(&pvr_fence->signal_head, pos);
 	spin_unlock_irqrestore(&pvr_fence->fctx->list_lock, flags);
 
 	PVR_FENCE_TRACE(&pvr_fence->base, "signalling enabled (%s)\n",
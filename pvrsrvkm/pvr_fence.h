@@ -63,14 +63,24 @@ struct SYNC_CHECKPOINT_TAG;
  * @fence_wq: work queue for signalled fence work
  * @check_status_work: work item used to inform services when a foreign fence
  * has signalled
+ * @signal_scan_work: work item scanning the whole signal list after a
+ * notification scan stopped early
  * @cmd_complete_handle: handle for callback used to signal fences when fence
  * syncs are met
  * @list_lock: protects the active and active foreign lists
- * @signal_list: list of fences waiting to be signalled
+ * @signal_list: list of fences waiting to be signalled, sorted by seqno
  * @fence_list: list of fences (used for debugging)
  * @deferred_free_list: list of fences that we will free when we are no longer
  * holding spinlocks.  The frees get implemented when an update fence is
  * signalled or the context is freed.
+ * @signal_in_order: fences on this context are expected to signal in seqno
+ * order, so the signal list scan on a notification may stop at the first
+ * unsignalled fence, leaving the rest to @signal_scan_work. Cleared for good
+ * once a fence is seen to signal out of order.
+ * @signal_notify_count: number of command complete notifications handled
+ * @signal_full_scans: notifications that scanned the whole signal list
+ * @signal_examined: fences whose sync checkpoint was checked
+ * @signal_signalled: fences signalled from the signal list
  */
 struct pvr_fence_context {
 	spinlock_t lock;
@@ -81,6 +91,7 @@ struct pvr_fence_context {
 
 	struct workqueue_struct *fence_wq;
 	struct work_struct check_status_work;
+	struct work_struct signal_scan_work;
 
 	void *cmd_complete_handle;
 
@@ -89,6 +100,12 @@ struct pvr_fence_context {
 	struct list_head fence_list;
 	struct list_head deferred_free_list;
 
+	bool signal_in_order;
+	u64 signal_notify_count;
+	u64 signal_full_scans;
+	u64 signal_examined;
+	u64 signal_signalled;
+
 	struct kref kref;
 	struct work_struct destroy_work;
 	void *dev_cookie;
@@ -458,6 +458,34 @@ pvr_sync_rollback_fence_data(PVRSRV_FENCE fence_to_rollback,
 	return PVRSRV_OK;
 }
 
+#if !defined(PDUMP)
+/*
+ * Returns true if fences[idx] does not need its own checkpoint because
+ * another fence in the array is on the same dma_fence context and will
+ * signal no earlier (fences on one context signal in seqno order). Where
+ * two entries are equivalent, the first one in the array is kept.
+ */
+static bool
+pvr_sync_fence_is_superseded(struct dma_fence **fences,
+			     unsigned int num_fences, unsigned int idx)
+{
+	unsigned int i;
+
+	for (i = 0; i < num_fences; i++) {
+		if (i == idx || fences[i]->context != fences[idx]->context)
+			continue;
+
+		if (dma_fence_is_later(fences[i], fences[idx]))
+			return true;
+
+		if (i < idx && !dma_fence_is_later(fences[idx], fences[i]))
+			return true;
+	}
+
+	return false;
+}
+#endif
+
 /*
  * This is the function that kick code will call in order to obtain a list of
  * the PSYNC_CHECKPOINTs for a given PVRSRV_FENCE passed to a kick function.
@@ -525,13 +553,15 @@ pvr_sync_resolve_fence(PSYNC_CHECKPOINT_CONTEXT psSyncCheckpointContext,
 	}
 	for (i = 0; i < num_fences; i++) {
 		/*
-		 * Only return the checkpoint if the fence is still active.
+		 * Only return the checkpoint if the fence is still active and
+		 * is not superseded by a later fence on the same context.
 		 * Don't check for signalled on PDUMP drivers as we need
 		 * to make sure that all fences make it to the pdump.
 		 */
 #if !defined(PDUMP)
 		if (!test_bit(DMA_FENCE_FLAG_SIGNALED_BIT,
-			      &fences[i]->flags))
+			      &fences[i]->flags) &&
+		    !pvr_sync_fence_is_superseded(fences, num_fences, i))
 #endif
 		{
 			struct pvr_fence *pvr_fence;
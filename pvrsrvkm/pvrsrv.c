@@ -174,6 +174,17 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 /*! When unloading try a few times to free everything remaining on the list */
 #define CLEANUP_THREAD_UNLOAD_RETRY 4
 
+/*! Wait 100ms before retrying a failed clean-up item */
+#define CLEANUP_THREAD_RETRY_DELAY_MS (CLEANUP_THREAD_WAIT_RETRY_TIMEOUT / 1000)
+
+/*! Wait for the HW before retrying a failed item depending on it, unless the
+ * cleanup thread is signalled before then */
+#define CLEANUP_THREAD_RETRY_DELAY_HW_MS (MAX_HW_TIME_US / 1000)
+
+/*! Number of items a worker processes from a queue before looking for higher
+ * priority work again */
+#define CLEANUP_THREAD_BATCH_SIZE 32
+
 #define PVRSRV_TL_CTRL_STREAM_SIZE 4096
 
 static PVRSRV_DATA	*gpsPVRSRVData;
@@ -211,11 +222,55 @@ static IMG_CHAR *_ConcatCleanupString(IMG_CHAR *cleanupString)
 	return cleanupString;
 }
 
+static const IMG_CHAR *const _apszCleanupPriorityNames[] = {
+	"HIGH", "NORMAL", "LOW"
+};
+static_assert(ARRAY_SIZE(_apszCleanupPriorityNames) == PVRSRV_CLEANUP_PRIORITY_LAST,
+              "_apszCleanupPriorityNames does not match PVRSRV_CLEANUP_PRIORITY");
+
+/* Must be called with the cleanup work list lock held */
+static IMG_BOOL _CleanupThreadDeviceQueuesEmpty(PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	IMG_UINT32 ui32Queue;
+
+	for (ui32Queue = 0; ui32Queue < PVRSRV_CLEANUP_QUEUE_COUNT; ui32Queue++)
+	{
+		if (!dllist_is_empty(&psDeviceNode->asCleanupQueue[ui32Queue].sWorkList) ||
+		    !dllist_is_empty(&psDeviceNode->asCleanupQueue[ui32Queue].sRetryList))
+		{
+			return IMG_FALSE;
+		}
+	}
+
+	return IMG_TRUE;
+}
+
+/* Must be called with the cleanup work list lock held */
+static IMG_BOOL _CleanupThreadDeviceBusy(PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	IMG_UINT32 ui32Queue;
+
+	for (ui32Queue = 0; ui32Queue < PVRSRV_CLEANUP_QUEUE_COUNT; ui32Queue++)
+	{
+		if (psDeviceNode->asCleanupQueue[ui32Queue].bBusy)
+		{
+			return IMG_TRUE;
+		}
+	}
+
+	return IMG_FALSE;
+}
+
 /* Callback to dump info of cleanup thread in debug_dump */
 static void CleanupThreadDumpInfo(DUMPDEBUG_PRINTF_FUNC* pfnDumpDebugPrintf,
                                   void *pvDumpDebugFile)
 {
 	IMG_CHAR acCleanupString[CLEANUP_STRING_SUMMARY_MAX_LEN];
+	IMG_UINT32 aui32Depth[PVRSRV_CLEANUP_PRIORITY_LAST];
+	IMG_UINT32 aui32MaxDepth[PVRSRV_CLEANUP_PRIORITY_LAST];
+	PVRSRV_CLEANUP_LATENCY asLatency[PVRSRV_CLEANUP_TYPE_LAST];
+	OS_SPINLOCK_FLAGS uiFlags = 0;
+	IMG_UINT32 uiLoop;
 
 	PVRSRV_DATA *psPVRSRVData = PVRSRVGetPVRSRVData();
 
@@ -224,6 +279,41 @@ static void CleanupThreadDumpInfo(DUMPDEBUG_PRINTF_FUNC* pfnDumpDebugPrintf,
 	PVR_DUMPDEBUG_LOG("    Number of deferred cleanup items dropped after "
 					  "retry limit reached : %d",
 					  OSAtomicRead(&psPVRSRVData->i32NumCleanupItemsNotCompleted));
+
+	PVR_DUMPDEBUG_LOG("    Deferred cleanup workers: %u, items waiting to be retried: %d",
+					  psPVRSRVData->ui32NumCleanupWorkers,
+					  OSAtomicRead(&psPVRSRVData->i32NumCleanupItemsRetrying));
+
+	OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+	OSCachedMemCopy(aui32Depth, psPVRSRVData->aui32CleanupQueueDepth, sizeof(aui32Depth));
+	OSCachedMemCopy(aui32MaxDepth, psPVRSRVData->aui32CleanupQueueMaxDepth, sizeof(aui32MaxDepth));
+	OSCachedMemCopy(asLatency, psPVRSRVData->asCleanupLatency, sizeof(asLatency));
+	OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+
+	for (uiLoop = 0; uiLoop < PVRSRV_CLEANUP_PRIORITY_LAST; uiLoop++)
+	{
+		PVR_DUMPDEBUG_LOG("    Cleanup queue %-6s depth: %u (max %u)",
+						  _apszCleanupPriorityNames[uiLoop],
+						  aui32Depth[uiLoop], aui32MaxDepth[uiLoop]);
+	}
+
+	for (uiLoop = PVRSRV_CLEANUP_TYPE_CONNECTION; uiLoop < PVRSRV_CLEANUP_TYPE_LAST; uiLoop++)
+	{
+		IMG_UINT32 ui32Remainder;
+
+		if (asLatency[uiLoop].ui32Completed == 0)
+		{
+			continue;
+		}
+
+		PVR_DUMPDEBUG_LOG("    Cleanup %-10s completed: %u, latency avg: %ums max: %ums",
+						  PVRSRVGetCleanupName(uiLoop),
+						  asLatency[uiLoop].ui32Completed,
+						  OSDivide64(asLatency[uiLoop].ui64TotalMs,
+						             asLatency[uiLoop].ui32Completed,
+						             &ui32Remainder),
+						  asLatency[uiLoop].ui32MaxMs);
+	}
 }
 
 static void _CleanupThreadDecrementStats(PVRSRV_DATA *psPVRSRVData,
@@ -252,6 +342,44 @@ static void _CleanupThreadDecrementStats(PVRSRV_DATA *psPVRSRVData,
 	PVR_DPF((PVR_DBG_MESSAGE, "AFTER REMOVING ----- %s", _ConcatCleanupString(acCleanupString)));
 }
 
+/* Record the time an item spent between being queued and being completed.
+ * Must be called with the cleanup work list lock held. */
+static void _CleanupThreadRecordLatency(PVRSRV_DATA *psPVRSRVData,
+                                        PVRSRV_CLEANUP_TYPE eCleanupType,
+                                        IMG_UINT32 ui32QueuedTime)
+{
+	PVRSRV_CLEANUP_LATENCY *psLatency;
+	IMG_UINT32 ui32LatencyMs = OSClockms() - ui32QueuedTime;
+
+	if ((eCleanupType <= PVRSRV_CLEANUP_TYPE_UNDEF) || ((eCleanupType >= PVRSRV_CLEANUP_TYPE_LAST)))
+	{
+		return;
+	}
+
+	psLatency = &psPVRSRVData->asCleanupLatency[eCleanupType];
+	psLatency->ui32Completed++;
+	psLatency->ui64TotalMs += ui32LatencyMs;
+	psLatency->ui32MaxMs = MAX(psLatency->ui32MaxMs, ui32LatencyMs);
+}
+
+/* Account for an item added to (or removed from) the queues of a priority
+ * class. Must be called with the cleanup work list lock held. */
+static inline void _CleanupThreadQueueDepthInc(PVRSRV_DATA *psPVRSRVData,
+                                               PVRSRV_CLEANUP_PRIORITY ePriority)
+{
+	IMG_UINT32 ui32Depth = ++psPVRSRVData->aui32CleanupQueueDepth[ePriority];
+
+	psPVRSRVData->aui32CleanupQueueMaxDepth[ePriority] =
+		MAX(psPVRSRVData->aui32CleanupQueueMaxDepth[ePriority], ui32Depth);
+}
+
+static inline void _CleanupThreadQueueDepthDec(PVRSRV_DATA *psPVRSRVData,
+                                               PVRSRV_CLEANUP_PRIORITY ePriority)
+{
+	PVR_ASSERT(psPVRSRVData->aui32CleanupQueueDepth[ePriority] > 0);
+	psPVRSRVData->aui32CleanupQueueDepth[ePriority]--;
+}
+
 #if defined(DEBUG)
 static void _CleanupThreadWorkListDump(PVRSRV_DATA *psPVRSRVData)
 {
@@ -269,7 +397,9 @@ static void _CleanupThreadWorkListDump(PVRSRV_DATA *psPVRSRVData)
 	     psDeviceNode != NULL;
 	     psDeviceNode = psDeviceNode->psNext)
 	{
-		if (dllist_is_empty(&psDeviceNode->sCleanupThreadWorkList))
+		IMG_UINT32 ui32Queue;
+
+		if (_CleanupThreadDeviceQueuesEmpty(psDeviceNode))
 		{
 			OSSNPrintf(pszCleanupLog, 128, "Dev_%p: CLEAN", psDeviceNode);
 			PVR_LOG(("%s", pszCleanupLog));
@@ -279,28 +409,39 @@ static void _CleanupThreadWorkListDump(PVRSRV_DATA *psPVRSRVData)
 		OSSNPrintf(pszCleanupLog, 128, "Dev_%p: TASKS", psDeviceNode);
 		PVR_LOG(("%s", pszCleanupLog));
 
-		/* Iterate over all cleanup items. */
-		dllist_foreach_node(&psDeviceNode->sCleanupThreadWorkList, psNode, psNextNode)
+		for (ui32Queue = 0; ui32Queue < PVRSRV_CLEANUP_QUEUE_COUNT; ui32Queue++)
 		{
-			PVRSRV_CLEANUP_THREAD_WORK *psData;
+			PVRSRV_CLEANUP_QUEUE *psQueue = &psDeviceNode->asCleanupQueue[ui32Queue];
+			DLLIST_NODE *apsLists[] = {&psQueue->sWorkList, &psQueue->sRetryList};
+			IMG_UINT32 ui32List;
 
-			psData = IMG_CONTAINER_OF(psNode, PVRSRV_CLEANUP_THREAD_WORK, sNode);
+			for (ui32List = 0; ui32List < ARRAY_SIZE(apsLists); ui32List++)
+			{
+				/* Iterate over all cleanup items. */
+				dllist_foreach_node(apsLists[ui32List], psNode, psNextNode)
+				{
+					PVRSRV_CLEANUP_THREAD_WORK *psData;
 
-			PVR_ASSERT(psData != NULL);
+					psData = IMG_CONTAINER_OF(psNode, PVRSRV_CLEANUP_THREAD_WORK, sNode);
 
-			if ((psData->eCleanupType <= PVRSRV_CLEANUP_TYPE_UNDEF) ||
-				((psData->eCleanupType >= PVRSRV_CLEANUP_TYPE_LAST)))
-			{
-				PVR_DPF((PVR_DBG_ERROR, "Incorrect cleanup item found: %d.", psData->eCleanupType));
-				continue;
-			}
+					PVR_ASSERT(psData != NULL);
 
-			OSSNPrintf(pszCleanupLog, 128, "+ %p: type %u, depends-HW %s (%s:%d)",
-					   psData,
-					   psData->eCleanupType,
-					   (psData->bDependsOnHW) ? "Yes" : " No",
-					   psData->pszFun, psData->ui32LineNum);
-			PVR_LOG(("%s", pszCleanupLog));
+					if ((psData->eCleanupType <= PVRSRV_CLEANUP_TYPE_UNDEF) ||
+						((psData->eCleanupType >= PVRSRV_CLEANUP_TYPE_LAST)))
+					{
+						PVR_DPF((PVR_DBG_ERROR, "Incorrect cleanup item found: %d.", psData->eCleanupType));
+						continue;
+					}
+
+					OSSNPrintf(pszCleanupLog, 128, "+ %p: type %u, depends-HW %s, %s (%s:%d)",
+							   psData,
+							   psData->eCleanupType,
+							   (psData->bDependsOnHW) ? "Yes" : " No",
+							   (ui32List == 0) ? "queued" : "retry",
+							   psData->pszFun, psData->ui32LineNum);
+					PVR_LOG(("%s", pszCleanupLog));
+				}
+			}
 		}
 	}
 
@@ -320,6 +461,20 @@ static inline IMG_BOOL _CleanupThreadDeviceDisabled(PVRSRV_DEVICE_NODE *psDevice
 {
 	return psDeviceNode->bCleanupThreadDisabled;
 }
+
+void PVRSRVCleanupThreadInitDevice(PVRSRV_DEVICE_NODE *psDeviceNode)
+{
+	IMG_UINT32 ui32Queue;
+
+	for (ui32Queue = 0; ui32Queue < PVRSRV_CLEANUP_QUEUE_COUNT; ui32Queue++)
+	{
+		dllist_init(&psDeviceNode->asCleanupQueue[ui32Queue].sWorkList);
+		dllist_init(&psDeviceNode->asCleanupQueue[ui32Queue].sRetryList);
+		psDeviceNode->asCleanupQueue[ui32Queue].bBusy = IMG_FALSE;
+	}
+	OSAtomicWrite(&psDeviceNode->i32NumCleanupItems, 0);
+}
+
 /* Add work to the cleanup thread work list.
  * The work item will be executed by the cleanup thread
  */
@@ -393,6 +548,8 @@ void PVRSRVCleanupThreadAddWork_Int(PVRSRV_DEVICE_NODE *psDeviceNode, PVRSRV_CLE
 	}
 	else
 	{
+		PVRSRV_CLEANUP_PRIORITY ePriority = PVRSRVGetCleanupPriority(psData->eCleanupType);
+
 		/*
 		 * Access psData before putting it in the work list.
 		 * Cleanup thread will free psData after it is done with the cleanup.
@@ -405,11 +562,14 @@ void PVRSRVCleanupThreadAddWork_Int(PVRSRV_DEVICE_NODE *psDeviceNode, PVRSRV_CLE
 		psData->pszFun = pszFun;
 		psData->ui32LineNum = ui32LineNum;
 #endif
+		psData->ui32QueuedTime = OSClockms();
+		psData->ui32RetryTime = 0;
 
-		/* add this work item to the list */
+		/* add this work item to the queue of its priority class */
 		OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 		OSAtomicIncrement(&psDeviceNode->i32NumCleanupItems);
-		dllist_add_to_tail(&psDeviceNode->sCleanupThreadWorkList, &psData->sNode);
+		dllist_add_to_tail(&psDeviceNode->asCleanupQueue[ePriority].sWorkList, &psData->sNode);
+		_CleanupThreadQueueDepthInc(psPVRSRVData, ePriority);
 		OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 
 		/* signal the cleanup thread to ensure this item gets processed */
@@ -422,15 +582,13 @@ void PVRSRVCleanupThreadAddWork_Int(PVRSRV_DEVICE_NODE *psDeviceNode, PVRSRV_CLE
 
 void PVRSRVCleanupThreadWaitForDevice(PVRSRV_DEVICE_NODE *psDeviceNode)
 {
-#if defined(DEBUG)
 	PVRSRV_DATA *psPVRSRVData = PVRSRVGetPVRSRVData();
-#endif
 	IMG_INT32 i32NumCleanupItems;
 	IMG_UINT32 uiCurrentRetry = 1U;
 
 	PVR_ASSERT(psDeviceNode != NULL);
 
-	if (gpsPVRSRVData->hCleanupThread == NULL)
+	if (gpsPVRSRVData->ui32NumCleanupWorkers == 0)
 	{
 		return;
 	}
@@ -450,16 +608,23 @@ void PVRSRVCleanupThreadWaitForDevice(PVRSRV_DEVICE_NODE *psDeviceNode)
 
 			if (i32NumCleanupItems == 0)
 			{
-#if defined(DEBUG)
 				OS_SPINLOCK_FLAGS uiFlags = 0;
+				IMG_BOOL bIdle;
 
+				/* A worker releases its queue after it has completed the
+				 * last item, wait for that too before the device can go. */
 				OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
-				PVR_LOG_IF_FALSE(dllist_is_empty(&psDeviceNode->sCleanupThreadWorkList),
+				bIdle = !_CleanupThreadDeviceBusy(psDeviceNode);
+#if defined(DEBUG)
+				PVR_LOG_IF_FALSE(_CleanupThreadDeviceQueuesEmpty(psDeviceNode),
 								 "Cleanup thread work list is not empty");
-
-				OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 #endif
-				break;
+				OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+
+				if (bIdle)
+				{
+					break;
+				}
 			}
 
 			OSWaitus(OS_CLEANUP_THREAD_TIMEOUT_US / OS_CLEANUP_THREAD_RETRY_COUNT);
@@ -482,179 +647,188 @@ void PVRSRVCleanupThreadWaitForDevice(PVRSRV_DEVICE_NODE *psDeviceNode)
 #endif
 }
 
-static INLINE DLLIST_NODE *_CleanupThreadWorkListLast(PVRSRV_DATA *psPVRSRVData)
+/* Move the items of a queue whose retry time has come back to its work list
+ * and report whether the queue has work for a worker. Items depending on the
+ * HW are also moved back if the worker was woken by a signal, as the device
+ * may have completed what they wait for.
+ * Must be called with the cleanup work list lock held. */
+static IMG_BOOL _CleanupThreadQueueReady(PVRSRV_DATA *psPVRSRVData,
+                                         PVRSRV_CLEANUP_QUEUE *psQueue,
+                                         IMG_UINT32 ui32Now,
+                                         IMG_BOOL bSignalled)
 {
-	DLLIST_NODE *psNode = NULL;
-	PVRSRV_DEVICE_NODE *psDeviceNode;
-	OS_SPINLOCK_FLAGS uiFlags = 0;
-
-	OSWRLockAcquireRead(psPVRSRVData->hDeviceNodeListLock);
-	OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+	DLLIST_NODE *psNode, *psNext;
 
-	/* We treat the Host device node as the last node in the list. */
-	psNode = dllist_get_prev_node(&psPVRSRVData->psHostMemDeviceNode->sCleanupThreadWorkList);
-	if (psNode != NULL)
+	if (psQueue->bBusy)
 	{
-		OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
-		OSWRLockReleaseRead(psPVRSRVData->hDeviceNodeListLock);
-		return psNode;
+		return IMG_FALSE;
 	}
 
-	/* Iterate over all devices and find the last node of the last device. */
-	for (psDeviceNode = psPVRSRVData->psDeviceNodeList;
-	     psDeviceNode != NULL;
-	     psDeviceNode = psDeviceNode->psNext)
+	dllist_foreach_node(&psQueue->sRetryList, psNode, psNext)
 	{
-		DLLIST_NODE *psCurrNode = dllist_get_prev_node(&psDeviceNode->sCleanupThreadWorkList);
-		if (psCurrNode != NULL)
+		PVRSRV_CLEANUP_THREAD_WORK *psData =
+			IMG_CONTAINER_OF(psNode, PVRSRV_CLEANUP_THREAD_WORK, sNode);
+
+		if ((IMG_INT32)(ui32Now - psData->ui32RetryTime) >= 0 ||
+		    (bSignalled && psData->bDependsOnHW))
 		{
-			psNode = psCurrNode;
+			dllist_remove_node(psNode);
+			dllist_add_to_tail(&psQueue->sWorkList, psNode);
+			OSAtomicDecrement(&psPVRSRVData->i32NumCleanupItemsRetrying);
 		}
 	}
 
-	OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
-	OSWRLockReleaseRead(psPVRSRVData->hDeviceNodeListLock);
-
-	return psNode;
+	return !dllist_is_empty(&psQueue->sWorkList);
 }
 
-/* Pop an item from the head of the cleanup thread work lists.
+/* Claim the next cleanup queue to be processed by a worker.
  *
- * This pops an item in a round robin manner:
+ * Queues are searched from the highest to the lowest priority class. Within a
+ * class the devices are visited in a round robin manner:
  *
- * 1. It starts from the first device and moves to next device if no cleanup
- *    item found.
- * 2. If no items were found in the regular devices bound lists it moves to the
- *    Host device list.
- * 3. In case there was nothing in the Host device items list but there was
- *    something in the devices lists, it returns first found device bound item
+ * 1. It starts from the device after `*ppsDeviceNode` (the device last
+ *    processed by the worker), or the first device if that is NULL.
+ * 2. If no queue is ready in the following devices it moves to the Host
+ *    device.
+ * 3. If nothing is ready for the Host device either it takes the first ready
+ *    queue of the devices it skipped.
  *
- * If `*ppsDeviceNode` is not NULL the lookup of the next cleanup item will
- * start from the next devices after `*ppsDeviceNode`. This makes sure that
- * we always pop a first item from each device and move to the next device.
- * We prevent "starvation" of some devices this way.
+ * A queue is only processed by one worker at a time, so the items of a queue
+ * are processed in order and the queue of one device cannot be drained by all
+ * the workers while others wait.
  */
-static INLINE DLLIST_NODE *_CleanupThreadWorkListPop(PVRSRV_DATA *psPVRSRVData,
-                                                     PVRSRV_DEVICE_NODE **ppsDeviceNode)
+static PVRSRV_CLEANUP_QUEUE *_CleanupThreadClaimQueue(PVRSRV_DATA *psPVRSRVData,
+                                                     PVRSRV_DEVICE_NODE **ppsDeviceNode,
+                                                     PVRSRV_CLEANUP_PRIORITY *pePriority,
+                                                     IMG_BOOL bSignalled)
 {
-	PVRSRV_DEVICE_NODE *psDeviceNode = NULL, *psFirstDevice = NULL;
-	DLLIST_NODE *psNode = NULL, *psFirstNode = NULL;
+	PVRSRV_DEVICE_NODE *psHostDevice = psPVRSRVData->psHostMemDeviceNode;
+	PVRSRV_DEVICE_NODE *psLastDevice = *ppsDeviceNode;
+	PVRSRV_CLEANUP_QUEUE *psQueue = NULL;
+	IMG_UINT32 ui32Now = OSClockms();
+	IMG_UINT32 ui32Priority;
 	OS_SPINLOCK_FLAGS uiFlags = 0;
 
 	OSWRLockAcquireRead(psPVRSRVData->hDeviceNodeListLock);
 	OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 
-	/* always need to start from the beginning of the list in case some of the
-	 * devices were already destroyed */
-	for (psDeviceNode = psPVRSRVData->psDeviceNodeList;
-	     psDeviceNode != NULL;
-	     psDeviceNode = psDeviceNode->psNext)
+	for (ui32Priority = 0;
+	     ui32Priority < PVRSRV_CLEANUP_PRIORITY_LAST && psQueue == NULL;
+	     ui32Priority++)
 	{
-		/* not safe to run cleanup during deinit */
-		if (psDeviceNode->eDevState == PVRSRV_DEVICE_STATE_DESTRUCTING)
-		{
-			continue;
-		}
+		PVRSRV_DEVICE_NODE *psDeviceNode, *psFirstDevice = NULL;
+		PVRSRV_CLEANUP_QUEUE *psFirstQueue = NULL;
+		IMG_BOOL bAfterLast = (psLastDevice == NULL || psLastDevice == psHostDevice);
 
-		psNode = dllist_get_next_node(&psDeviceNode->sCleanupThreadWorkList);
-
-		/* remember first non-NULL node and device in case no items are found
-		 * on later devices */
-		if (psNode != NULL && psFirstNode == NULL)
+		for (psDeviceNode = psPVRSRVData->psDeviceNodeList;
+		     psDeviceNode != NULL;
+		     psDeviceNode = psDeviceNode->psNext)
 		{
-			psFirstNode = psNode;
-			psFirstDevice = psDeviceNode;
-		}
+			PVRSRV_CLEANUP_QUEUE *psCandidate = &psDeviceNode->asCleanupQueue[ui32Priority];
 
-		/* to ensure that further device don't get starved skip the last device
-		 * until all devices are processed and then move to non-device bound
-		 * items */
-		if (*ppsDeviceNode != NULL) {
-			if (psDeviceNode == *ppsDeviceNode)
+			/* not safe to run cleanup during deinit */
+			if (psDeviceNode->eDevState == PVRSRV_DEVICE_STATE_DESTRUCTING)
 			{
-				*ppsDeviceNode = NULL;
+				continue;
 			}
 
-			/* in case this is the last device and next iteration exits the
-			 * loop */
-			psNode = NULL;
+			if (_CleanupThreadQueueReady(psPVRSRVData, psCandidate, ui32Now, bSignalled))
+			{
+				if (bAfterLast)
+				{
+					psQueue = psCandidate;
+					*ppsDeviceNode = psDeviceNode;
+					break;
+				}
+
+				/* remember the first ready queue in case no queue is ready
+				 * on later devices */
+				if (psFirstQueue == NULL)
+				{
+					psFirstQueue = psCandidate;
+					psFirstDevice = psDeviceNode;
+				}
+			}
 
-			continue;
+			if (psDeviceNode == psLastDevice)
+			{
+				bAfterLast = IMG_TRUE;
+			}
 		}
 
-		if (psNode != NULL)
+		/* if no queue found in the regular devices check also the Host device */
+		if (psQueue == NULL &&
+		    _CleanupThreadQueueReady(psPVRSRVData, &psHostDevice->asCleanupQueue[ui32Priority],
+		                             ui32Now, bSignalled))
 		{
-			*ppsDeviceNode = psDeviceNode;
-			dllist_remove_node(psNode);
-
-			break;
+			psQueue = &psHostDevice->asCleanupQueue[ui32Priority];
+			*ppsDeviceNode = psHostDevice;
 		}
-	}
 
-	/* if no item found in the regular devices check also the Host device */
-	if (psNode == NULL)
-	{
-		psNode = dllist_get_next_node(&psPVRSRVData->psHostMemDeviceNode->sCleanupThreadWorkList);
-		if (psNode != NULL)
+		if (psQueue == NULL && psFirstQueue != NULL)
 		{
-			dllist_remove_node(psNode);
+			psQueue = psFirstQueue;
+			*ppsDeviceNode = psFirstDevice;
 		}
-		*ppsDeviceNode = psPVRSRVData->psHostMemDeviceNode;
-	}
 
-	/* if no item found for the Host device check if there was a cleanup item
-	 * in one of the previous devices, this starts processing items from the
-	 * beginning without one extra empty call to "wrap around" */
-	if (psNode == NULL && psFirstNode != NULL)
-	{
-		psNode = psFirstNode;
-		*ppsDeviceNode = psFirstDevice;
-		dllist_remove_node(psNode);
+		if (psQueue != NULL)
+		{
+			psQueue->bBusy = IMG_TRUE;
+			*pePriority = ui32Priority;
+		}
 	}
 
 	OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 	OSWRLockReleaseRead(psPVRSRVData->hDeviceNodeListLock);
 
-	return psNode;
+	return psQueue;
 }
 
-/* Process the cleanup thread work list */
-static IMG_BOOL _CleanupThreadProcessWorkList(PVRSRV_DATA *psPVRSRVData,
-                                              IMG_BOOL *pbUseHWTimeout)
+/* Process up to CLEANUP_THREAD_BATCH_SIZE items of a queue claimed with
+ * _CleanupThreadClaimQueue() and release the queue.
+ *
+ * Items which fail are put on the retry list of the queue with a retry time,
+ * so they are not attempted again before then and don't hold up the items
+ * queued behind them. Returns IMG_TRUE if an item was put on the retry list.
+ */
+static IMG_BOOL _CleanupThreadProcessQueue(PVRSRV_DATA *psPVRSRVData,
+                                           PVRSRV_DEVICE_NODE *psDeviceNode,
+                                           PVRSRV_CLEANUP_QUEUE *psQueue,
+                                           PVRSRV_CLEANUP_PRIORITY ePriority,
+                                           IMG_BOOL bStopOnUnload,
+                                           IMG_BOOL *pbUseHWTimeout)
 {
-	DLLIST_NODE *psNodeIter, *psNodeLast;
-	PVRSRV_ERROR eError;
 	IMG_BOOL bNeedRetry = IMG_FALSE;
+	IMG_UINT32 ui32Processed;
 	OS_SPINLOCK_FLAGS uiFlags = 0;
-	PVRSRV_CLEANUP_TYPE eCleanupType;
-	PVRSRV_DEVICE_NODE *psDeviceNode = NULL;
 
-	/* Reset HWTimeout Flag */
-	*pbUseHWTimeout = IMG_FALSE;
-
-	psNodeLast = _CleanupThreadWorkListLast(psPVRSRVData);
-	if (psNodeLast == NULL)
-	{
-		/* no elements to clean up */
-		return IMG_FALSE;
-	}
-
-	/* any callback functions which return error will be
-	 * moved to the back of the list, and additional items can be added
-	 * to the list at any time so we ensure we only iterate from the
-	 * head of the list to the current tail (since the tail may always
-	 * be changing)
-	 */
-	do
+	for (ui32Processed = 0; ui32Processed < CLEANUP_THREAD_BATCH_SIZE; ui32Processed++)
 	{
+		DLLIST_NODE *psNodeIter;
 		PVRSRV_CLEANUP_THREAD_WORK *psData;
+		PVRSRV_CLEANUP_TYPE eCleanupType;
 		CLEANUP_THREAD_FN pfnFree;
+		IMG_UINT32 ui32QueuedTime;
 		IMG_BOOL bRetry = IMG_FALSE;
+		PVRSRV_ERROR eError;
+
+		if (bStopOnUnload && psPVRSRVData->bUnload)
+		{
+			break;
+		}
+
+		OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+		psNodeIter = dllist_get_next_node(&psQueue->sWorkList);
+		if (psNodeIter != NULL)
+		{
+			dllist_remove_node(psNodeIter);
+			_CleanupThreadQueueDepthDec(psPVRSRVData, ePriority);
+		}
+		OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 
-		psNodeIter = _CleanupThreadWorkListPop(psPVRSRVData, &psDeviceNode);
 		if (psNodeIter == NULL)
 		{
-			return IMG_FALSE;
+			break;
 		}
 
 		psData = IMG_CONTAINER_OF(psNodeIter, PVRSRV_CLEANUP_THREAD_WORK, sNode);
@@ -665,26 +839,19 @@ static IMG_BOOL _CleanupThreadProcessWorkList(PVRSRV_DATA *psPVRSRVData,
 		 */
 		pfnFree = psData->pfnFree;
 		eCleanupType = psData->eCleanupType;
+		ui32QueuedTime = psData->ui32QueuedTime;
 		eError = pfnFree(psData->pvData);
 
 		if (eError != PVRSRV_OK)
 		{
-			/* Move to back of the list, if this item's
+			/* Move to the retry list, if this item's
 			 * retry count hasn't hit zero.
 			 */
 			if (CLEANUP_THREAD_IS_RETRY_TIMEOUT(psData))
 			{
 				if (CLEANUP_THREAD_RETRY_TIMEOUT_NOT_REACHED(psData))
 				{
-					bNeedRetry = IMG_TRUE;
 					bRetry = IMG_TRUE;
-					/* If any items require retry and are HW dependent
-					 * use the HW timeout
-					 */
-					if (psData->bDependsOnHW)
-					{
-						*pbUseHWTimeout = psData->bDependsOnHW;
-					}
 				}
 			}
 			else
@@ -692,52 +859,178 @@ static IMG_BOOL _CleanupThreadProcessWorkList(PVRSRV_DATA *psPVRSRVData,
 				if (psData->ui32RetryCount > 0)
 				{
 					psData->ui32RetryCount--;
-					bNeedRetry = IMG_TRUE;
 					bRetry = IMG_TRUE;
-					/* If any items require retry and are HW dependent
-					 * use the HW timeout
-					 */
-					if (psData->bDependsOnHW)
-					{
-						*pbUseHWTimeout = psData->bDependsOnHW;
-					}
 				}
 			}
 
-			/* If the work depends on HW then we should add it to the back of the list,
+			/* If the work depends on HW then we should keep retrying it,
 			 * the cleanup thread will sleep for longer if required and the next MISR
 			 * from the device will wake the task again in which it might be ready.
 			 */
 			if (bRetry || psData->bDependsOnHW)
 			{
-				/* If any items on the work list depend on HW
-				 * and didn't get cleaned up.
+				bNeedRetry = IMG_TRUE;
+				/* If any items require retry and are HW dependent
+				 * use the HW timeout
 				 */
+				if (psData->bDependsOnHW)
+				{
+					*pbUseHWTimeout = IMG_TRUE;
+				}
+
+				psData->ui32RetryTime = OSClockms() +
+					(psData->bDependsOnHW ? CLEANUP_THREAD_RETRY_DELAY_HW_MS :
+					                        CLEANUP_THREAD_RETRY_DELAY_MS);
+
 				OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
-				dllist_add_to_tail(&psDeviceNode->sCleanupThreadWorkList, psNodeIter);
+				dllist_add_to_tail(&psQueue->sRetryList, psNodeIter);
+				_CleanupThreadQueueDepthInc(psPVRSRVData, ePriority);
 				OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+				OSAtomicIncrement(&psPVRSRVData->i32NumCleanupItemsRetrying);
 			}
 			else
 			{
 				PVR_DPF((PVR_DBG_ERROR, "Failed to free resource (callback " IMG_PFN_FMTSPEC "). "
 				        "Retry limit reached", pfnFree));
 				OSAtomicIncrement(&psPVRSRVData->i32NumCleanupItemsNotCompleted);
-				OSAtomicDecrement(&psDeviceNode->i32NumCleanupItems);
 				/* Dropping item */
 				_CleanupThreadDecrementStats(psPVRSRVData, eCleanupType);
+				OSAtomicDecrement(&psDeviceNode->i32NumCleanupItems);
 			}
 		}
 		else
 		{
 			/* Ok returned */
-			OSAtomicDecrement(&psDeviceNode->i32NumCleanupItems);
+			OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+			_CleanupThreadRecordLatency(psPVRSRVData, eCleanupType, ui32QueuedTime);
+			OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+
 			_CleanupThreadDecrementStats(psPVRSRVData, eCleanupType);
+			OSAtomicDecrement(&psDeviceNode->i32NumCleanupItems);
 		}
-	} while (psNodeIter != NULL && psNodeIter != psNodeLast);
+	}
+
+	/* PVRSRVCleanupThreadWaitForDevice() checks the queue is not busy under
+	 * the lock, the device must not be touched after this. */
+	OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+	psQueue->bBusy = IMG_FALSE;
+	OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
 
 	return bNeedRetry;
 }
 
+/* Process the cleanup queues until no queue is ready */
+static IMG_BOOL _CleanupThreadProcessWorkList(PVRSRV_DATA *psPVRSRVData,
+                                              PVRSRV_CLEANUP_WORKER *psWorker,
+                                              IMG_BOOL bSignalled,
+                                              IMG_BOOL *pbUseHWTimeout)
+{
+	PVRSRV_DEVICE_NODE *psDeviceNode = NULL;
+	IMG_BOOL bStopOnUnload = (psWorker->ui32Index != 0);
+	IMG_BOOL bNeedRetry = IMG_FALSE;
+
+	/* Reset HWTimeout Flag */
+	*pbUseHWTimeout = IMG_FALSE;
+
+	for (;;)
+	{
+		PVRSRV_CLEANUP_PRIORITY ePriority = PVRSRV_CLEANUP_PRIORITY_LOW;
+		PVRSRV_CLEANUP_QUEUE *psQueue;
+
+		if (bStopOnUnload && psPVRSRVData->bUnload)
+		{
+			break;
+		}
+
+		psQueue = _CleanupThreadClaimQueue(psPVRSRVData, &psDeviceNode, &ePriority, bSignalled);
+		if (psQueue == NULL)
+		{
+			break;
+		}
+
+		if (_CleanupThreadProcessQueue(psPVRSRVData, psDeviceNode, psQueue, ePriority,
+		                               bStopOnUnload, pbUseHWTimeout))
+		{
+			bNeedRetry = IMG_TRUE;
+		}
+
+		/* Items depending on the HW are only retried once per signal, the
+		 * ones failing again wait for their retry time or the next signal. */
+		bSignalled = IMG_FALSE;
+	}
+
+	return bNeedRetry || (OSAtomicRead(&psPVRSRVData->i32NumCleanupItemsRetrying) > 0);
+}
+
+/* Drop all the items left in the cleanup queues, when unloading. */
+static void _CleanupThreadDropAll(PVRSRV_DATA *psPVRSRVData)
+{
+	PVRSRV_DEVICE_NODE *psDeviceNode;
+	PVRSRV_DEVICE_NODE *psHostDevice = psPVRSRVData->psHostMemDeviceNode;
+	OS_SPINLOCK_FLAGS uiFlags = 0;
+	IMG_INT32 i32Dropped = 0;
+
+	OSWRLockAcquireRead(psPVRSRVData->hDeviceNodeListLock);
+	OSSpinLockAcquire(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+
+	for (psDeviceNode = psPVRSRVData->psDeviceNodeList;
+	     ;
+	     psDeviceNode = psDeviceNode->psNext)
+	{
+		IMG_UINT32 ui32Queue;
+
+		/* We treat the Host device node as the last node in the list. */
+		if (psDeviceNode == NULL)
+		{
+			psDeviceNode = psHostDevice;
+		}
+
+		for (ui32Queue = 0; ui32Queue < PVRSRV_CLEANUP_QUEUE_COUNT; ui32Queue++)
+		{
+			PVRSRV_CLEANUP_QUEUE *psQueue = &psDeviceNode->asCleanupQueue[ui32Queue];
+			DLLIST_NODE *apsLists[] = {&psQueue->sWorkList, &psQueue->sRetryList};
+			IMG_UINT32 ui32List;
+
+			for (ui32List = 0; ui32List < ARRAY_SIZE(apsLists); ui32List++)
+			{
+				DLLIST_NODE *psNode, *psNext;
+
+				dllist_foreach_node(apsLists[ui32List], psNode, psNext)
+				{
+					PVRSRV_CLEANUP_THREAD_WORK *psData =
+						IMG_CONTAINER_OF(psNode, PVRSRV_CLEANUP_THREAD_WORK, sNode);
+
+					dllist_remove_node(psNode);
+					_CleanupThreadQueueDepthDec(psPVRSRVData, ui32Queue);
+					if (ui32List == 1)
+					{
+						OSAtomicDecrement(&psPVRSRVData->i32NumCleanupItemsRetrying);
+					}
+
+					OSAtomicIncrement(&psPVRSRVData->i32NumCleanupItemsNotCompleted);
+					OSAtomicDecrement(&psDeviceNode->i32NumCleanupItems);
+					/* Dropping item */
+					_CleanupThreadDecrementStats(psPVRSRVData, psData->eCleanupType);
+					i32Dropped++;
+				}
+			}
+		}
+
+		if (psDeviceNode == psHostDevice)
+		{
+			break;
+		}
+	}
+
+	OSSpinLockRelease(psPVRSRVData->hCleanupThreadWorkListLock, uiFlags);
+	OSWRLockReleaseRead(psPVRSRVData->hDeviceNodeListLock);
+
+	if (i32Dropped > 0)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "Cleanup Thread Failed to free %d resources", OSAtomicRead(&psPVRSRVData->i32NumCleanupItemsNotCompleted)));
+	}
+}
+
 // #define CLEANUP_DPFL PVR_DBG_WARNING
 #define CLEANUP_DPFL    PVR_DBG_MESSAGE
 
@@ -764,19 +1057,20 @@ Exit:
 
 static void CleanupThread(void *pvData)
 {
-	PVRSRV_DATA *psPVRSRVData = pvData;
+	PVRSRV_CLEANUP_WORKER *psWorker = pvData;
+	PVRSRV_DATA *psPVRSRVData = gpsPVRSRVData;
 	IMG_BOOL     bRetryWorkList = IMG_FALSE;
 	IMG_BOOL     bUseHWTimeout = IMG_FALSE;
+	IMG_BOOL     bSignalled;
 	IMG_HANDLE	 hOSEvent;
 	PVRSRV_ERROR eRc;
 	IMG_UINT32 uiUnloadRetry = 0;
-	DLLIST_NODE *psNodeIter, *psNodeLast;
 
 	/* Store the process id (pid) of the clean-up thread */
-	psPVRSRVData->cleanupThreadPid = OSGetCurrentProcessID();
-	psPVRSRVData->cleanupThreadTid = OSGetCurrentThreadID();
+	psWorker->pid = OSGetCurrentProcessID();
+	psWorker->tid = OSGetCurrentThreadID();
 
-	PVR_DPF((CLEANUP_DPFL, "CleanupThread: thread starting... "));
+	PVR_DPF((CLEANUP_DPFL, "CleanupThread %u: thread starting... ", psWorker->ui32Index));
 
 	/* Open an event on the clean up event object so we can listen on it,
 	 * abort the clean up thread and driver if this fails.
@@ -792,7 +1086,9 @@ static void CleanupThread(void *pvData)
 		IMG_UINT64 ui64Timeoutus;
 		if (psPVRSRVData->bUnload)
 		{
-			if (dllist_is_empty(&psPVRSRVData->psHostMemDeviceNode->sCleanupThreadWorkList) ||
+			/* Only the first worker keeps going to free what it can */
+			if (psWorker->ui32Index != 0 ||
+			    OSAtomicRead(&psPVRSRVData->psHostMemDeviceNode->i32NumCleanupItems) == 0 ||
 			    uiUnloadRetry > CLEANUP_THREAD_UNLOAD_RETRY)
 			{
 				break;
@@ -829,61 +1125,84 @@ static void CleanupThread(void *pvData)
 				CLEANUP_THREAD_WAIT_SLEEP_TIMEOUT);
 		if (eRc == PVRSRV_ERROR_TIMEOUT)
 		{
-			PVR_DPF((CLEANUP_DPFL, "CleanupThread: wait timeout"));
+			PVR_DPF((CLEANUP_DPFL, "CleanupThread %u: wait timeout", psWorker->ui32Index));
 		}
 		else if (eRc == PVRSRV_OK)
 		{
-			PVR_DPF((CLEANUP_DPFL, "CleanupThread: wait OK, signal received"));
+			PVR_DPF((CLEANUP_DPFL, "CleanupThread %u: wait OK, signal received", psWorker->ui32Index));
 		}
 		else
 		{
 			PVR_LOG_ERROR(eRc, "OSEventObjectWaitKernel");
 		}
+		bSignalled = (eRc == PVRSRV_OK);
 
 		bRetryWorkList = _CleanupThreadProcessWorkList(psPVRSRVData,
+		                                               psWorker,
+		                                               bSignalled,
 		                                               &bUseHWTimeout);
 	}
 
-	psNodeLast = _CleanupThreadWorkListLast(psPVRSRVData);
-	if (psNodeLast != NULL)
+	if (psWorker->ui32Index == 0)
 	{
-		do
-		{
-			PVRSRV_DEVICE_NODE *psDeviceNode = NULL;
-			PVRSRV_CLEANUP_THREAD_WORK *psData;
-			psNodeIter = _CleanupThreadWorkListPop(psPVRSRVData, &psDeviceNode);
-			if (psNodeIter == NULL)
-			{
-				break;
-			}
+		_CleanupThreadDropAll(psPVRSRVData);
+	}
 
-			psData = IMG_CONTAINER_OF(psNodeIter, PVRSRV_CLEANUP_THREAD_WORK, sNode);
-			OSAtomicIncrement(&psPVRSRVData->i32NumCleanupItemsNotCompleted);
-			OSAtomicDecrement(&psDeviceNode->i32NumCleanupItems);
-			/* Dropping item */
-			_CleanupThreadDecrementStats(psPVRSRVData, psData->eCleanupType);
-		}
-		while (psNodeIter != NULL && psNodeIter != psNodeLast);
+	eRc = OSEventObjectClose(hOSEvent);
+	PVR_LOG_IF_ERROR(eRc, "OSEventObjectClose");
 
-		PVR_DPF((PVR_DBG_ERROR, "Cleanup Thread Failed to free %d resources", OSAtomicRead(&psPVRSRVData->i32NumCleanupItemsNotCompleted)));
+	PVR_DPF((CLEANUP_DPFL, "CleanupThread %u: thread ending... ", psWorker->ui32Index));
+}
+
+IMG_BOOL PVRSRVCleanupThreadIsWorkerPid(IMG_PID pid)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < gpsPVRSRVData->ui32NumCleanupWorkers; i++)
+	{
+		if (gpsPVRSRVData->asCleanupWorkers[i].pid == pid)
+		{
+			return IMG_TRUE;
+		}
 	}
 
-	OSSpinLockDestroy(psPVRSRVData->hCleanupThreadWorkListLock);
+	return IMG_FALSE;
+}
 
-	eRc = OSEventObjectClose(hOSEvent);
-	PVR_LOG_IF_ERROR(eRc, "OSEventObjectClose");
+/* Returns the worker running on the calling thread, NULL if the caller is
+ * not a cleanup worker */
+static PVRSRV_CLEANUP_WORKER *_CleanupThreadCurrentWorker(void)
+{
+	uintptr_t tid = OSGetCurrentThreadID();
+	IMG_UINT32 i;
+
+	for (i = 0; i < gpsPVRSRVData->ui32NumCleanupWorkers; i++)
+	{
+		if (gpsPVRSRVData->asCleanupWorkers[i].tid == tid)
+		{
+			return &gpsPVRSRVData->asCleanupWorkers[i];
+		}
+	}
 
-	PVR_DPF((CLEANUP_DPFL, "CleanupThread: thread ending... "));
+	return NULL;
 }
 
-IMG_PID PVRSRVCleanupThreadGetPid(void)
+void PVRSRVCleanupThreadSetPurgePid(IMG_PID pid)
 {
-	return gpsPVRSRVData->cleanupThreadPid;
+	PVRSRV_CLEANUP_WORKER *psWorker = _CleanupThreadCurrentWorker();
+
+	/* Only the worker itself reads or writes its purge PID */
+	if (psWorker != NULL)
+	{
+		psWorker->purgePid = pid;
+	}
 }
 
-uintptr_t PVRSRVCleanupThreadGetTid(void)
+IMG_PID PVRSRVCleanupThreadGetPurgePid(void)
 {
-	return gpsPVRSRVData->cleanupThreadTid;
+	PVRSRV_CLEANUP_WORKER *psWorker = _CleanupThreadCurrentWorker();
+
+	return (psWorker != NULL) ? psWorker->purgePid : 0;
 }
 
 #if defined(SUPPORT_FW_HOST_SIDE_RECOVERY)
@@ -1636,6 +1955,7 @@ PVRSRVCommonDriverInit(void)
 	PVRSRV_DATA	*psPVRSRVData = NULL;
 
 	IMG_UINT32 ui32AppHintCleanupThreadPriority;
+	IMG_UINT32 ui32AppHintCleanupThreadWorkers;
 	IMG_UINT32 ui32AppHintWatchdogThreadPriority;
 	IMG_BOOL bEnablePageFaultDebug;
 	IMG_BOOL bEnableFullSyncTracking;
@@ -1767,6 +2087,10 @@ PVRSRVCommonDriverInit(void)
 	OSGetAppHintUINT32(APPHINT_NO_DEVICE, pvAppHintState, CleanupThreadPriority,
 	                     &ui32AppHintDefault, &ui32AppHintCleanupThreadPriority);
 
+	ui32AppHintDefault = PVRSRV_APPHINT_CLEANUPTHREADWORKERS;
+	OSGetAppHintUINT32(APPHINT_NO_DEVICE, pvAppHintState, CleanupThreadWorkers,
+	                     &ui32AppHintDefault, &ui32AppHintCleanupThreadWorkers);
+
 	ui32AppHintDefault = PVRSRV_APPHINT_WATCHDOGTHREADPRIORITY;
 	OSGetAppHintUINT32(APPHINT_NO_DEVICE, pvAppHintState, WatchdogThreadPriority,
 	                     &ui32AppHintDefault, &ui32AppHintWatchdogThreadPriority);
@@ -1787,15 +2111,45 @@ PVRSRVCommonDriverInit(void)
 	eError = _CleanupThreadPrepare(gpsPVRSRVData);
 	PVR_LOG_GOTO_IF_ERROR(eError, "_CleanupThreadPrepare", Error);
 
-	/* Create a thread which is used to do the deferred cleanup */
-	eError = OSThreadCreatePriority(&gpsPVRSRVData->hCleanupThread,
-	                                "pvr_defer_free",
-	                                CleanupThread,
-	                                CleanupThreadDumpInfo,
-	                                IMG_TRUE,
-	                                gpsPVRSRVData,
-	                                ui32AppHintCleanupThreadPriority);
-	PVR_LOG_GOTO_IF_ERROR(eError, "OSThreadCreatePriority:1", Error);
+	/* Create the threads which are used to do the deferred cleanup. The
+	 * first one is required, if further ones can't be created the cleanup
+	 * carries on with fewer workers. */
+	ui32AppHintCleanupThreadWorkers = MAX(1U, MIN(ui32AppHintCleanupThreadWorkers,
+	                                              PVRSRV_CLEANUP_THREAD_MAX_WORKERS));
+	while (gpsPVRSRVData->ui32NumCleanupWorkers < ui32AppHintCleanupThreadWorkers)
+	{
+		IMG_UINT32 ui32Index = gpsPVRSRVData->ui32NumCleanupWorkers;
+		PVRSRV_CLEANUP_WORKER *psWorker = &gpsPVRSRVData->asCleanupWorkers[ui32Index];
+
+		psWorker->ui32Index = ui32Index;
+		if (ui32Index == 0)
+		{
+			OSStringSafeCopy(psWorker->szName, "pvr_defer_free", sizeof(psWorker->szName));
+		}
+		else
+		{
+			OSSNPrintf(psWorker->szName, sizeof(psWorker->szName), "pvr_defer_free%u", ui32Index);
+		}
+
+		eError = OSThreadCreatePriority(&psWorker->hThread,
+		                                psWorker->szName,
+		                                CleanupThread,
+		                                (ui32Index == 0) ? CleanupThreadDumpInfo : NULL,
+		                                IMG_TRUE,
+		                                psWorker,
+		                                ui32AppHintCleanupThreadPriority);
+		if (ui32Index == 0)
+		{
+			PVR_LOG_GOTO_IF_ERROR(eError, "OSThreadCreatePriority:1", Error);
+		}
+		else if (eError != PVRSRV_OK)
+		{
+			PVR_LOG_ERROR(eError, "OSThreadCreatePriority");
+			eError = PVRSRV_OK;
+			break;
+		}
+		gpsPVRSRVData->ui32NumCleanupWorkers++;
+	}
 
 	/* Create the devices watchdog event object */
 	eError = OSEventObjectCreate("PVRSRV_DEVICESWATCHDOG_EVENTOBJECT", &gpsPVRSRVData->hDevicesWatchdogEvObj);
@@ -2044,11 +2398,15 @@ PVRSRVCommonDriverDeInit(void)
 		PVR_LOG_IF_ERROR(eError, "OSEventObjectDestroy");
 	}
 
-	/* Stop and cleanup the deferred clean up thread, event object and
-	 * deferred context list.
+	/* Stop and cleanup the deferred clean up threads, event object and
+	 * deferred context list. The first worker is stopped last as it frees
+	 * or drops whatever is left in the queues.
 	 */
-	if (gpsPVRSRVData->hCleanupThread)
+	while (gpsPVRSRVData->ui32NumCleanupWorkers > 0)
 	{
+		PVRSRV_CLEANUP_WORKER *psWorker =
+			&gpsPVRSRVData->asCleanupWorkers[gpsPVRSRVData->ui32NumCleanupWorkers - 1];
+
 		LOOP_UNTIL_TIMEOUT_US(OS_THREAD_DESTROY_TIMEOUT_US)
 		{
 			if (gpsPVRSRVData->hCleanupEventObject)
@@ -2057,15 +2415,29 @@ PVRSRVCommonDriverDeInit(void)
 				PVR_LOG_IF_ERROR(eError, "OSEventObjectSignal");
 			}
 
-			eError = OSThreadDestroy(gpsPVRSRVData->hCleanupThread);
+			eError = OSThreadDestroy(psWorker->hThread);
 			if (PVRSRV_OK == eError)
 			{
-				gpsPVRSRVData->hCleanupThread = NULL;
+				psWorker->hThread = NULL;
 				break;
 			}
 			OSWaitus(OS_THREAD_DESTROY_TIMEOUT_US/OS_THREAD_DESTROY_RETRY_COUNT);
 		} END_LOOP_UNTIL_TIMEOUT_US();
 		PVR_LOG_IF_ERROR(eError, "OSThreadDestroy");
+
+		if (psWorker->hThread != NULL)
+		{
+			break;
+		}
+		gpsPVRSRVData->ui32NumCleanupWorkers--;
+	}
+
+	/* The work list lock is used until the last worker has stopped */
+	if (gpsPVRSRVData->ui32NumCleanupWorkers == 0 &&
+	    gpsPVRSRVData->hCleanupThreadWorkListLock != NULL)
+	{
+		OSSpinLockDestroy(gpsPVRSRVData->hCleanupThreadWorkListLock);
+		gpsPVRSRVData->hCleanupThreadWorkListLock = NULL;
 	}
 
 	if (gpsPVRSRVData->hCleanupEventObject)
@@ -2323,8 +2695,7 @@ PVRSRV_ERROR PVRSRVCommonDeviceCreate(void *pvOSDevice,
 	PVR_LOG_GOTO_IF_ERROR(eError, "PVRSRVStatsRegisterProcess", ErrorFreeDeviceNode);
 #endif
 
-	dllist_init(&psDeviceNode->sCleanupThreadWorkList);
-	OSAtomicWrite(&psDeviceNode->i32NumCleanupItems, 0);
+	PVRSRVCleanupThreadInitDevice(psDeviceNode);
 
 	/* Record setting of EnablePageFaultDebug in device-node */
 	psDeviceNode->bEnablePFDebug = bEnablePageFaultDebug;
@@ -139,6 +139,26 @@ typedef struct _PVRSRV_PVZ_CONFIG_
 
 } PVRSRV_PVZ_CONFIG;
 
+/*! Maximum number of cleanup thread workers */
+#define PVRSRV_CLEANUP_THREAD_MAX_WORKERS 8
+
+typedef struct _PVRSRV_CLEANUP_WORKER_
+{
+	IMG_HANDLE            hThread;                        /*!< Worker thread */
+	IMG_PID               pid;                            /*!< Worker process id */
+	uintptr_t             tid;                            /*!< Worker thread id */
+	IMG_UINT32            ui32Index;                      /*!< Index of the worker, worker 0 drains the queues on unload */
+	IMG_PID               purgePid;                       /*!< PID of the connection the worker is purging, 0 if none */
+	IMG_CHAR              szName[16];                     /*!< Name of the worker thread */
+} PVRSRV_CLEANUP_WORKER;
+
+typedef struct _PVRSRV_CLEANUP_LATENCY_
+{
+	IMG_UINT32            ui32Completed;                  /*!< Number of items completed */
+	IMG_UINT32            ui32MaxMs;                      /*!< Maximum time from queueing to completion */
+	IMG_UINT64            ui64TotalMs;                    /*!< Sum of the times from queueing to completion */
+} PVRSRV_CLEANUP_LATENCY;
+
 typedef struct PVRSRV_DATA_TAG
 {
 	DRIVER_INFO           sDriverInfo;
@@ -155,15 +175,18 @@ typedef struct PVRSRV_DATA_TAG
 	IMG_HANDLE            hGlobalEventObject;             /*!< OS Global Event Object */
 	IMG_UINT32            ui32GEOConsecutiveTimeouts;     /*!< OS Global Event Object Timeouts */
 
-	IMG_HANDLE            hCleanupThread;                 /*!< Cleanup thread */
+	PVRSRV_CLEANUP_WORKER asCleanupWorkers[PVRSRV_CLEANUP_THREAD_MAX_WORKERS]; /*!< Cleanup thread workers */
+	IMG_UINT32            ui32NumCleanupWorkers;          /*!< Number of cleanup thread workers started */
 	IMG_HANDLE            hCleanupEventObject;            /*!< Event object to drive cleanup thread */
-	POS_SPINLOCK          hCleanupThreadWorkListLock;     /*!< Lock protecting the cleanup thread work list */
-	IMG_PID               cleanupThreadPid;               /*!< Cleanup thread process id */
-	uintptr_t             cleanupThreadTid;               /*!< Cleanup thread id */
+	POS_SPINLOCK          hCleanupThreadWorkListLock;     /*!< Lock protecting the cleanup queues and their statistics */
 	ATOMIC_T              i32NumCleanupItemsQueued;       /*!< Number of items in cleanup thread work list */
 	ATOMIC_T              i32NumCleanupItemsNotCompleted; /*!< Number of items dropped from cleanup thread work list
 	                                                           after retry limit reached */
+	ATOMIC_T              i32NumCleanupItemsRetrying;     /*!< Number of items waiting on a retry list */
 	ATOMIC_T              i32CleanupItemTypes[PVRSRV_CLEANUP_TYPE_LAST];         /*!< Array containing the counts for different cleanup item types. */
+	IMG_UINT32            aui32CleanupQueueDepth[PVRSRV_CLEANUP_PRIORITY_LAST];    /*!< Items waiting in the queues of each priority class */
+	IMG_UINT32            aui32CleanupQueueMaxDepth[PVRSRV_CLEANUP_PRIORITY_LAST]; /*!< High watermark of aui32CleanupQueueDepth */
+	PVRSRV_CLEANUP_LATENCY asCleanupLatency[PVRSRV_CLEANUP_TYPE_LAST];             /*!< Queue to completion latency of each cleanup item type */
 
 	IMG_HANDLE            hDevicesWatchdogThread;         /*!< Devices watchdog thread */
 	IMG_HANDLE            hDevicesWatchdogEvObj;          /*! Event object to drive devices watchdog thread */
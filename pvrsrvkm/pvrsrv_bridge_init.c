@@ -77,6 +77,7 @@ void DeinitDMABridge(void);
 #if defined(SUPPORT_RGX)
 PVRSRV_ERROR InitRGXTA3DBridge(void);
 void DeinitRGXTA3DBridge(void);
+PVRSRV_ERROR InitRGXTA3DKickBridge(void);
 #if defined(SUPPORT_RGXTQ_BRIDGE)
 PVRSRV_ERROR InitRGXTQBridge(void);
 void DeinitRGXTQBridge(void);
@@ -223,6 +224,9 @@ ServerBridgeInit(void)
 	eError = InitRGXTA3DBridge();
 	PVR_LOG_IF_ERROR(eError, "InitRGXTA3DBridge");
 
+	eError = InitRGXTA3DKickBridge();
+	PVR_LOG_IF_ERROR(eError, "InitRGXTA3DKickBridge");
+
 	#if defined(SUPPORT_USC_BREAKPOINT)
 	eError = InitRGXBREAKPOINTBridge();
 	PVR_LOG_IF_ERROR(eError, "InitRGXBREAKPOINTBridge");
@@ -121,14 +121,17 @@ typedef PVRSRV_ERROR (*CLEANUP_THREAD_FN)(void *pvParam);
 #define CLEANUP_THREAD_IS_RETRY_TIMEOUT(_item) \
 	((_item)->ui32TimeStart != (_item->ui32TimeEnd))
 
+/* Cleanup item types, with the priority class of the queue their items are
+ * processed from (see PVRSRV_CLEANUP_PRIORITY).
+ */
 #define CLEANUP_TYPE_LIST \
-	X(UNDEF)      /**/ \
-	X(CONNECTION)     /**/ \
-	X(MMU)     /**/ \
-	X(OSMEM)   /**/ \
-	X(PMR)       /**/ \
-	X(RAMEM)       /**/ \
-	X(LAST)      /**/ \
+	X(UNDEF,      LOW)      /**/ \
+	X(CONNECTION, LOW)      /**/ \
+	X(MMU,        HIGH)     /**/ \
+	X(OSMEM,      NORMAL)   /**/ \
+	X(PMR,        HIGH)     /**/ \
+	X(RAMEM,      NORMAL)   /**/ \
+	X(LAST,       LOW)      /**/ \
 
 #define CLEANUP_TYPE_ITEM_LABEL_MAX_SIZE 11     /* CONNECTION\0 */
 #define CLEANUP_TYPE_ITEM_DPF " %1.11s : %1.5d"
@@ -136,16 +139,59 @@ typedef PVRSRV_ERROR (*CLEANUP_THREAD_FN)(void *pvParam);
 
 typedef enum _PVRSRV_CLEANUP_TYPE_
 {
-#define X(_name) PVRSRV_CLEANUP_TYPE_ ## _name,
+#define X(_name, _priority) PVRSRV_CLEANUP_TYPE_ ## _name,
 	CLEANUP_TYPE_LIST
 #undef X
 
 } PVRSRV_CLEANUP_TYPE;
 
+/* Priority classes of the cleanup queues. Every device has one queue per
+ * class and the cleanup workers always look for work in the higher priority
+ * queues first:
+ *  HIGH   - cheap items returning device memory (MMU mappings, zombie PMRs)
+ *  NORMAL - bulk CPU work on pages (page pool cleaning, page zeroing)
+ *  LOW    - items which often have to wait for the firmware and be retried
+ *           (connection and FW context cleanup)
+ */
+typedef enum _PVRSRV_CLEANUP_PRIORITY_
+{
+	PVRSRV_CLEANUP_PRIORITY_HIGH,
+	PVRSRV_CLEANUP_PRIORITY_NORMAL,
+	PVRSRV_CLEANUP_PRIORITY_LOW,
+	PVRSRV_CLEANUP_PRIORITY_LAST
+} PVRSRV_CLEANUP_PRIORITY;
+
+static_assert(PVRSRV_CLEANUP_PRIORITY_LAST == PVRSRV_CLEANUP_QUEUE_COUNT,
+              "PVRSRV_CLEANUP_QUEUE_COUNT does not match the priority classes");
+
+/*************************************************************************/ /*!
+@Function       PVRSRVGetCleanupPriority
+@Description    Returns the priority class of a Cleanup Type.
+
+@Input          eCleanupType   The enum value of the cleanup type.
+
+@Return         PVRSRV_CLEANUP_PRIORITY of the queue for items of the type.
+*/ /**************************************************************************/
+static inline PVRSRV_CLEANUP_PRIORITY PVRSRVGetCleanupPriority(PVRSRV_CLEANUP_TYPE eCleanupType)
+{
+	static const PVRSRV_CLEANUP_PRIORITY aePriorities[] = {
+#define X(_name, _priority) PVRSRV_CLEANUP_PRIORITY_ ## _priority,
+		CLEANUP_TYPE_LIST
+#undef X
+	};
+
+	if (eCleanupType < 0 || eCleanupType > PVRSRV_CLEANUP_TYPE_LAST)
+	{
+		return PVRSRV_CLEANUP_PRIORITY_LOW;
+	}
+
+	return aePriorities[eCleanupType];
+}
+
 #if defined(CLEANUP_TYPE_STRINGS)
 
 static const char *const _pszCleanupStrings[] = {
-#define X(_name) #_name,
+#define X(_name, _priority) #_name,
 	CLEANUP_TYPE_LIST
 #undef X
 };
@@ -196,6 +242,12 @@ typedef struct _PVRSRV_CLEANUP_THREAD_WORK_
 	                                      is reached, we could depend on event from
 	                                      device to continue. */
 	PVRSRV_CLEANUP_TYPE eCleanupType;/*!< Type of work item added to queue */
+	IMG_UINT32 ui32QueuedTime;       /*!< Timestamp in ms of the moment the item
+	                                    was added to the queue, used for the
+	                                    latency statistics. */
+	IMG_UINT32 ui32RetryTime;        /*!< Timestamp in ms after which the item
+	                                    is retried, when waiting on the retry
+	                                    list of its queue. */
 #if defined(DEBUG)
 	const char *pszFun;
 	unsigned int ui32LineNum;
@@ -237,21 +289,49 @@ void PVRSRVCleanupThreadAddWork_Int(PVRSRV_DEVICE_NODE *psDevNode,
 void PVRSRVCleanupThreadWaitForDevice(PVRSRV_DEVICE_NODE *psDevNode);
 
 /**************************************************************************/ /*!
-@Function       PVRSRVCleanupThreadGetPid
+@Function       PVRSRVCleanupThreadInitDevice
+
+@Description    Initialises the cleanup queues of a device node.
+
+@Input          psDevNode : Pointer to the device node
+
+@Return         None
+*/ /***************************************************************************/
+void PVRSRVCleanupThreadInitDevice(PVRSRV_DEVICE_NODE *psDevNode);
+
+/**************************************************************************/ /*!
+@Function       PVRSRVCleanupThreadIsWorkerPid
 
-@Description    Returns Cleanup Thread's PID.
+@Description    Checks whether a PID belongs to one of the cleanup workers.
 
-@Return         PID of the Cleanup Thread
+@Input          pid : PID to check
+
+@Return         IMG_TRUE if the PID is that of a cleanup worker
+*/ /***************************************************************************/
+IMG_BOOL PVRSRVCleanupThreadIsWorkerPid(IMG_PID pid);
+
+/**************************************************************************/ /*!
+@Function       PVRSRVCleanupThreadSetPurgePid
+
+@Description    Records the PID of the connection being purged by the calling
+                Cleanup Thread worker. Does nothing if the caller is not a
+                worker.
+
+@Input          pid : PID of the connection, 0 once the purge is done
+
+@Return         None
 */ /***************************************************************************/
-IMG_PID PVRSRVCleanupThreadGetPid(void);
+void PVRSRVCleanupThreadSetPurgePid(IMG_PID pid);
 
 /**************************************************************************/ /*!
-@Function       PVRSRVCleanupThreadGetTid
+@Function       PVRSRVCleanupThreadGetPurgePid
 
-@Description    Returns Cleanup Thread's TID.
+@Description    Returns the PID of the connection being purged by the calling
+                Cleanup Thread worker.
 
-@Return         TID of the Cleanup Thread
+@Return         PID of the connection, 0 if the caller is not a worker or
+                is not purging a connection
 */ /***************************************************************************/
-uintptr_t PVRSRVCleanupThreadGetTid(void);
+IMG_PID PVRSRVCleanupThreadGetPurgePid(void);
 
 #endif /* PVRSRV_CLEANUP_H */
@@ -47,6 +47,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "lock.h"
 #include "dllist.h"
 #include "allocmem.h"
+#include "osfunc.h"
 
 struct _PVRSRV_POOL_
 {
@@ -79,6 +80,37 @@ typedef struct _PVRSRV_POOL_ENTRY_
 	void *pvData;
 } PVRSRV_POOL_ENTRY;
 
+/* Magazine of pool entries owned by one CPU. The magazine is claimed by
+ * atomically setting iBusy so the fast path never waits: a thread that finds
+ * the magazine busy (because it was preempted or migrated while another
+ * thread on the same CPU holds it) just goes to the shared pool instead.
+ * Magazines are allocated separately, each padded to a whole number of CPU
+ * cache lines. The allocator hands out such sizes line aligned, so the hot
+ * fields of two CPUs' magazines do not end up in the same cache line.
+ */
+typedef struct _PVRSRV_POOL_MAGAZINE_
+{
+	ATOMIC_T iBusy;
+	IMG_UINT32 ui32NumEntries;
+
+	IMG_UINT64 ui64GetHits;
+	IMG_UINT64 ui64GetMisses;
+	IMG_UINT64 ui64PutHits;
+	IMG_UINT64 ui64PutMisses;
+
+	/* Must be last, sized by ui32EntriesPerCPU */
+	PVRSRV_POOL_ENTRY *apsEntries[IMG_FLEX_ARRAY_MEMBER];
+} PVRSRV_POOL_MAGAZINE;
+
+struct _PVRSRV_POOL_CACHE_
+{
+	PVRSRV_POOL *psPool;
+	IMG_UINT32 ui32NumCPUs;
+	IMG_UINT32 ui32EntriesPerCPU;
+	ATOMIC_T iContended;
+	PVRSRV_POOL_MAGAZINE **ppsMagazines;
+};
+
 PVRSRV_ERROR PVRSRVPoolCreate(PVRSRV_POOL_ALLOC_FUNC *pfnAlloc,
 					PVRSRV_POOL_FREE_FUNC *pfnFree,
 					IMG_UINT32 ui32MaxEntries,
@@ -197,6 +229,19 @@ err_allocmem:
 	return eError;
 }
 
+static INLINE void _PoisonPoolEntry(PVRSRV_POOL_ENTRY *psEntry)
+{
+#if defined(DEBUG)
+	/* Don't poison the IN buffer as that is copied from client and would be
+	 * waste of cycles.
+	 */
+	OSCachedMemSet(((IMG_PBYTE)psEntry->pvData)+PVRSRV_MAX_BRIDGE_IN_SIZE,
+			PVRSRV_POISON_ON_ALLOC_VALUE, PVRSRV_MAX_BRIDGE_OUT_SIZE);
+#else
+	PVR_UNREFERENCED_PARAMETER(psEntry);
+#endif
+}
+
 PVRSRV_ERROR PVRSRVPoolGet(PVRSRV_POOL *psPool,
 					PVRSRV_POOL_TOKEN *hToken,
 					void **ppvDataOut)
@@ -229,13 +274,7 @@ PVRSRV_ERROR PVRSRVPoolGet(PVRSRV_POOL *psPool,
 		psPool->uiNumFree--;
 	}
 
-#if defined(DEBUG)
-	/* Don't poison the IN buffer as that is copied from client and would be
-	 * waste of cycles.
-	 */
-	OSCachedMemSet(((IMG_PBYTE)psEntry->pvData)+PVRSRV_MAX_BRIDGE_IN_SIZE,
-			PVRSRV_POISON_ON_ALLOC_VALUE, PVRSRV_MAX_BRIDGE_OUT_SIZE);
-#endif
+	_PoisonPoolEntry(psEntry);
 
 	psPool->uiNumBusy++;
 	*hToken = psEntry;
@@ -286,3 +325,189 @@ PVRSRV_ERROR PVRSRVPoolPut(PVRSRV_POOL *psPool, PVRSRV_POOL_TOKEN hToken)
 
 	return eError;
 }
+
+static INLINE PVRSRV_POOL_MAGAZINE *_PoolCacheClaimMagazine(PVRSRV_POOL_CACHE *psCache)
+{
+	PVRSRV_POOL_MAGAZINE *psMag;
+
+	psMag = psCache->ppsMagazines[OSGetCurrentCPU() % psCache->ui32NumCPUs];
+
+	if (OSAtomicCompareExchange(&psMag->iBusy, 0, 1) != 0)
+	{
+		OSAtomicIncrement(&psCache->iContended);
+		return NULL;
+	}
+
+	return psMag;
+}
+
+static INLINE void _PoolCacheReleaseMagazine(PVRSRV_POOL_MAGAZINE *psMag)
+{
+	/* Make the magazine updates visible before it can be claimed again */
+	OSMemoryBarrier(NULL);
+	OSAtomicWrite(&psMag->iBusy, 0);
+}
+
+PVRSRV_ERROR PVRSRVPoolCacheCreate(PVRSRV_POOL *psPool,
+					IMG_UINT32 ui32EntriesPerCPU,
+					PVRSRV_POOL_CACHE **ppsCache)
+{
+	PVRSRV_POOL_CACHE *psCache;
+	IMG_UINT32 ui32CacheLineSize = OSCPUCacheAttributeSize(OS_CPU_CACHE_ATTRIBUTE_LINE_SIZE);
+	size_t uiMagazineSize;
+	PVRSRV_ERROR eError;
+	IMG_UINT32 i;
+
+	PVR_LOG_RETURN_IF_INVALID_PARAM(psPool != NULL, "psPool");
+	PVR_LOG_RETURN_IF_INVALID_PARAM(ui32EntriesPerCPU != 0, "ui32EntriesPerCPU");
+	PVR_LOG_RETURN_IF_INVALID_PARAM(ppsCache != NULL, "ppsCache");
+
+	psCache = OSAllocZMem(sizeof(*psCache));
+	PVR_GOTO_IF_NOMEM(psCache, eError, err_alloc);
+
+	psCache->psPool = psPool;
+	psCache->ui32NumCPUs = OSGetCPUCount();
+	psCache->ui32EntriesPerCPU = ui32EntriesPerCPU;
+	OSAtomicWrite(&psCache->iContended, 0);
+
+	psCache->ppsMagazines = OSAllocZMem(sizeof(*psCache->ppsMagazines) *
+	                                    psCache->ui32NumCPUs);
+	PVR_GOTO_IF_NOMEM(psCache->ppsMagazines, eError, err_alloc_magazines);
+
+	uiMagazineSize = sizeof(PVRSRV_POOL_MAGAZINE) +
+	                 IMG_FLEX_ARRAY_SIZE(sizeof(PVRSRV_POOL_ENTRY *), ui32EntriesPerCPU);
+	if (ui32CacheLineSize != 0)
+	{
+		uiMagazineSize = PVR_ALIGN(uiMagazineSize, (size_t)ui32CacheLineSize);
+	}
+
+	for (i = 0; i < psCache->ui32NumCPUs; i++)
+	{
+		psCache->ppsMagazines[i] = OSAllocZMem(uiMagazineSize);
+		PVR_GOTO_IF_NOMEM(psCache->ppsMagazines[i], eError, err_alloc_magazine);
+
+		OSAtomicWrite(&psCache->ppsMagazines[i]->iBusy, 0);
+	}
+
+	*ppsCache = psCache;
+
+	return PVRSRV_OK;
+
+err_alloc_magazine:
+	while (i--)
+	{
+		OSFreeMem(psCache->ppsMagazines[i]);
+	}
+	OSFreeMem(psCache->ppsMagazines);
+err_alloc_magazines:
+	OSFreeMem(psCache);
+err_alloc:
+	return eError;
+}
+
+void PVRSRVPoolCacheDestroy(PVRSRV_POOL_CACHE *psCache)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < psCache->ui32NumCPUs; i++)
+	{
+		PVRSRV_POOL_MAGAZINE *psMag = psCache->ppsMagazines[i];
+
+		PVR_ASSERT(OSAtomicRead(&psMag->iBusy) == 0);
+
+		while (psMag->ui32NumEntries > 0)
+		{
+			PVRSRV_ERROR eError;
+
+			psMag->ui32NumEntries--;
+			eError = PVRSRVPoolPut(psCache->psPool,
+			                       psMag->apsEntries[psMag->ui32NumEntries]);
+			PVR_LOG_IF_ERROR(eError, "PVRSRVPoolPut");
+		}
+
+		OSFreeMem(psMag);
+	}
+
+	OSFreeMem(psCache->ppsMagazines);
+	OSFreeMem(psCache);
+}
+
+PVRSRV_ERROR PVRSRVPoolCacheGet(PVRSRV_POOL_CACHE *psCache,
+					PVRSRV_POOL_TOKEN *hToken,
+					void **ppvDataOut)
+{
+	PVRSRV_POOL_MAGAZINE *psMag = _PoolCacheClaimMagazine(psCache);
+
+	if (likely(psMag != NULL))
+	{
+		if (likely(psMag->ui32NumEntries > 0))
+		{
+			PVRSRV_POOL_ENTRY *psEntry;
+
+			psMag->ui32NumEntries--;
+			psEntry = psMag->apsEntries[psMag->ui32NumEntries];
+			psMag->ui64GetHits++;
+
+			_PoolCacheReleaseMagazine(psMag);
+
+			_PoisonPoolEntry(psEntry);
+
+			*hToken = psEntry;
+			*ppvDataOut = psEntry->pvData;
+
+			return PVRSRV_OK;
+		}
+
+		psMag->ui64GetMisses++;
+		_PoolCacheReleaseMagazine(psMag);
+	}
+
+	return PVRSRVPoolGet(psCache->psPool, hToken, ppvDataOut);
+}
+
+PVRSRV_ERROR PVRSRVPoolCachePut(PVRSRV_POOL_CACHE *psCache,
+					PVRSRV_POOL_TOKEN hToken)
+{
+	PVRSRV_POOL_MAGAZINE *psMag = _PoolCacheClaimMagazine(psCache);
+
+	if (likely(psMag != NULL))
+	{
+		if (likely(psMag->ui32NumEntries < psCache->ui32EntriesPerCPU))
+		{
+			psMag->apsEntries[psMag->ui32NumEntries] = hToken;
+			psMag->ui32NumEntries++;
+			psMag->ui64PutHits++;
+
+			_PoolCacheReleaseMagazine(psMag);
+
+			return PVRSRV_OK;
+		}
+
+		psMag->ui64PutMisses++;
+		_PoolCacheReleaseMagazine(psMag);
+	}
+
+	return PVRSRVPoolPut(psCache->psPool, hToken);
+}
+
+void PVRSRVPoolCacheGetStats(PVRSRV_POOL_CACHE *psCache,
+					PVRSRV_POOL_CACHE_STATS *psStats)
+{
+	IMG_UINT32 i;
+
+	OSCachedMemSet(psStats, 0, sizeof(*psStats));
+
+	for (i = 0; i < psCache->ui32NumCPUs; i++)
+	{
+		PVRSRV_POOL_MAGAZINE *psMag = psCache->ppsMagazines[i];
+
+		psStats->ui64GetHits += psMag->ui64GetHits;
+		psStats->ui64GetMisses += psMag->ui64GetMisses;
+		psStats->ui64PutHits += psMag->ui64PutHits;
+		psStats->ui64PutMisses += psMag->ui64PutMisses;
+	}
+
+	psStats->ui64Contended = (IMG_UINT32)OSAtomicRead(&psCache->iContended);
+	psStats->ui32NumCPUs = psCache->ui32NumCPUs;
+	psStats->ui32EntriesPerCPU = psCache->ui32EntriesPerCPU;
+}
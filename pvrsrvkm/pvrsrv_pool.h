@@ -132,4 +132,84 @@ PVRSRV_ERROR PVRSRVPoolGet(PVRSRV_POOL *psPool,
 PVRSRV_ERROR PVRSRVPoolPut(PVRSRV_POOL *psPool,
 						PVRSRV_POOL_TOKEN hToken);
 
+/*
+ * Per-CPU pool cache
+ *
+ * A pool cache keeps a small magazine of entries per CPU in front of a
+ * PVRSRV_POOL. Entries are taken from and returned to the magazine of the
+ * CPU the caller is running on without taking the pool lock. The shared
+ * pool is only used when the local magazine is empty (on Get), full (on Put)
+ * or is momentarily being used by another thread that was scheduled on the
+ * same CPU.
+ */
+typedef struct _PVRSRV_POOL_CACHE_ PVRSRV_POOL_CACHE;
+
+/*! Pool cache counters, summed over all CPUs */
+typedef struct _PVRSRV_POOL_CACHE_STATS_
+{
+	IMG_UINT64 ui64GetHits;      /*!< Get satisfied from a per-CPU magazine */
+	IMG_UINT64 ui64GetMisses;    /*!< Get that fell back to the shared pool */
+	IMG_UINT64 ui64PutHits;      /*!< Put absorbed by a per-CPU magazine */
+	IMG_UINT64 ui64PutMisses;    /*!< Put that fell back to the shared pool */
+	IMG_UINT64 ui64Contended;    /*!< Get/Put that found the magazine busy */
+	IMG_UINT32 ui32NumCPUs;      /*!< Number of per-CPU magazines */
+	IMG_UINT32 ui32EntriesPerCPU;/*!< Capacity of each magazine */
+} PVRSRV_POOL_CACHE_STATS;
+
+/**************************************************************************/ /*!
+ @Function     PVRSRVPoolCacheCreate
+ @Description  Creates a per-CPU cache layered over an existing pool.
+ @Input        psPool             Pool backing the cache. Must outlive the
+                                  cache.
+ @Input        ui32EntriesPerCPU  Maximum number of entries held per CPU.
+ @Output       ppsCache           New pool cache object.
+ @Return       PVRSRV_ERROR       PVRSRV_OK on success and an error otherwise
+*/ /***************************************************************************/
+PVRSRV_ERROR PVRSRVPoolCacheCreate(PVRSRV_POOL *psPool,
+					IMG_UINT32 ui32EntriesPerCPU,
+					PVRSRV_POOL_CACHE **ppsCache);
+
+/**************************************************************************/ /*!
+ @Function     PVRSRVPoolCacheDestroy
+ @Description  Returns all cached entries to the backing pool and destroys
+               the cache. No Get/Put may be in progress.
+ @Input        psCache         Pool cache object meant to be destroyed.
+*/ /***************************************************************************/
+void PVRSRVPoolCacheDestroy(PVRSRV_POOL_CACHE *psCache);
+
+/**************************************************************************/ /*!
+ @Function     PVRSRVPoolCacheGet
+ @Description  Retrieves an entry from the current CPU's magazine, falling
+               back to PVRSRVPoolGet on the backing pool on a miss.
+ @Input        psCache         Pointer to the pool cache.
+ @Output       hToken          Pointer to the entry handle.
+ @Output       ppvDataOut      Pointer to data stored in the entry.
+ @Return       PVRSRV_ERROR    PVRSRV_OK on success and an error otherwise
+*/ /***************************************************************************/
+PVRSRV_ERROR PVRSRVPoolCacheGet(PVRSRV_POOL_CACHE *psCache,
+						PVRSRV_POOL_TOKEN *hToken,
+						void **ppvDataOut);
+
+/**************************************************************************/ /*!
+ @Function     PVRSRVPoolCachePut
+ @Description  Returns an entry to the current CPU's magazine, falling back
+               to PVRSRVPoolPut on the backing pool if the magazine is full.
+               The entry may have been obtained on any CPU.
+ @Input        psCache         Pointer to the pool cache.
+ @Input        hToken          Entry handle.
+ @Return       PVRSRV_ERROR    PVRSRV_OK on success and an error otherwise
+*/ /***************************************************************************/
+PVRSRV_ERROR PVRSRVPoolCachePut(PVRSRV_POOL_CACHE *psCache,
+						PVRSRV_POOL_TOKEN hToken);
+
+/**************************************************************************/ /*!
+ @Function     PVRSRVPoolCacheGetStats
+ @Description  Samples the cache counters. The counters are updated without
+               synchronisation so the values are approximate.
+ @Input        psCache         Pointer to the pool cache.
+ @Output       psStats         Counters summed over all CPUs.
+*/ /***************************************************************************/
+void PVRSRVPoolCacheGetStats(PVRSRV_POOL_CACHE *psCache,
+						PVRSRV_POOL_CACHE_STATS *psStats);
+
 #endif /* PVRSRVPOOL_H */
@@ -147,6 +147,12 @@ struct _BT_
 	struct _BT_ *next_free;
 	struct _BT_ *prev_free;
 
+	/* (size, base) ordered AVL tree of free segments with the same flags,
+	 * only used by arenas created with RA_POLICY_FREE_INDEX_TREE */
+	struct _BT_ *pFreeIdxLeft;
+	struct _BT_ *pFreeIdxRight;
+	IMG_INT32 iFreeIdxHeight;
+
 	/* A user reference associated with this span, user references are
 	 * currently only provided in the callback mechanism
 	 */
@@ -214,6 +220,12 @@ struct _RA_ARENA_
 	/* Size available for allocation in the arena */
 	IMG_UINT64	ui64FreeArenaSize;
 
+	/* Number of free segment searches made by allocations and the number of
+	 * free segments visited by them, reported by RA_BlockDump() to compare
+	 * the cost of the different free segment policies */
+	IMG_UINT64	ui64FreeSearchCount;
+	IMG_UINT64	ui64FreeSearchVisited;
+
 };
 
 static_assert(sizeof(void*) == sizeof(PFN_RA_IMPORT_ALLOC_SINGLE), "pImportAlloc == pImportAllocSingle. Import callbacks must be pointers of the same size.");
@@ -609,6 +621,277 @@ _SegmentSplit(BT *pBT, RA_LENGTH_T uSize)
 	return pNeighbour;
 }
 
+/*************************************************************************/ /*!
+@Function       _FreeIdxLess
+@Description    Ordering of the free segment index, by size then base.
+                Bases are unique within an arena so the order is total.
+@Input          pBTA      First boundary tag.
+@Input          pBTB      Second boundary tag.
+@Return         IMG_TRUE if pBTA sorts before pBTB
+*/ /**************************************************************************/
+static INLINE IMG_BOOL
+_FreeIdxLess(const BT *pBTA, const BT *pBTB)
+{
+	return (pBTA->uSize < pBTB->uSize) ||
+	       ((pBTA->uSize == pBTB->uSize) && (pBTA->base < pBTB->base));
+}
+
+static INLINE IMG_INT32
+_FreeIdxHeight(const BT *pBT)
+{
+	return (pBT != NULL) ? pBT->iFreeIdxHeight : 0;
+}
+
+static INLINE void
+_FreeIdxUpdateHeight(BT *pBT)
+{
+	IMG_INT32 iLeft = _FreeIdxHeight(pBT->pFreeIdxLeft);
+	IMG_INT32 iRight = _FreeIdxHeight(pBT->pFreeIdxRight);
+
+	pBT->iFreeIdxHeight = ((iLeft > iRight) ? iLeft : iRight) + 1;
+}
+
+static BT *
+_FreeIdxRotateRight(BT *pBT)
+{
+	BT *pPivot = pBT->pFreeIdxLeft;
+
+	pBT->pFreeIdxLeft = pPivot->pFreeIdxRight;
+	pPivot->pFreeIdxRight = pBT;
+	_FreeIdxUpdateHeight(pBT);
+	_FreeIdxUpdateHeight(pPivot);
+
+	return pPivot;
+}
+
+static BT *
+_FreeIdxRotateLeft(BT *pBT)
+{
+	BT *pPivot = pBT->pFreeIdxRight;
+
+	pBT->pFreeIdxRight = pPivot->pFreeIdxLeft;
+	pPivot->pFreeIdxLeft = pBT;
+	_FreeIdxUpdateHeight(pBT);
+	_FreeIdxUpdateHeight(pPivot);
+
+	return pPivot;
+}
+
+/*************************************************************************/ /*!
+@Function       _FreeIdxBalance
+@Description    Restore the AVL invariant of a subtree whose children are
+                balanced but may differ in height by two.
+@Input          pBT       Root of the subtree.
+@Return         New root of the subtree.
+*/ /**************************************************************************/
+static BT *
+_FreeIdxBalance(BT *pBT)
+{
+	IMG_INT32 iBalance;
+
+	_FreeIdxUpdateHeight(pBT);
+	iBalance = _FreeIdxHeight(pBT->pFreeIdxLeft) - _FreeIdxHeight(pBT->pFreeIdxRight);
+
+	if (iBalance > 1)
+	{
+		if (_FreeIdxHeight(pBT->pFreeIdxLeft->pFreeIdxLeft) <
+		    _FreeIdxHeight(pBT->pFreeIdxLeft->pFreeIdxRight))
+		{
+			pBT->pFreeIdxLeft = _FreeIdxRotateLeft(pBT->pFreeIdxLeft);
+		}
+		return _FreeIdxRotateRight(pBT);
+	}
+
+	if (iBalance < -1)
+	{
+		if (_FreeIdxHeight(pBT->pFreeIdxRight->pFreeIdxRight) <
+		    _FreeIdxHeight(pBT->pFreeIdxRight->pFreeIdxLeft))
+		{
+			pBT->pFreeIdxRight = _FreeIdxRotateRight(pBT->pFreeIdxRight);
+		}
+		return _FreeIdxRotateLeft(pBT);
+	}
+
+	return pBT;
+}
+
+/*************************************************************************/ /*!
+@Function       _FreeIdxInsert
+@Description    Insert a boundary tag into a free segment index.
+@Input          pRoot     Root of the index.
+@Input          pBT       The boundary tag, not yet in the index.
+@Return         New root of the index.
+*/ /**************************************************************************/
+static BT *
+_FreeIdxInsert(BT *pRoot, BT *pBT)
+{
+	if (pRoot == NULL)
+	{
+		pBT->pFreeIdxLeft = NULL;
+		pBT->pFreeIdxRight = NULL;
+		pBT->iFreeIdxHeight = 1;
+		return pBT;
+	}
+
+	if (_FreeIdxLess(pBT, pRoot))
+	{
+		pRoot->pFreeIdxLeft = _FreeIdxInsert(pRoot->pFreeIdxLeft, pBT);
+	}
+	else
+	{
+		pRoot->pFreeIdxRight = _FreeIdxInsert(pRoot->pFreeIdxRight, pBT);
+	}
+
+	return _FreeIdxBalance(pRoot);
+}
+
+static BT *
+_FreeIdxRemoveMin(BT *pRoot, BT **ppsMin)
+{
+	if (pRoot->pFreeIdxLeft == NULL)
+	{
+		*ppsMin = pRoot;
+		return pRoot->pFreeIdxRight;
+	}
+
+	pRoot->pFreeIdxLeft = _FreeIdxRemoveMin(pRoot->pFreeIdxLeft, ppsMin);
+
+	return _FreeIdxBalance(pRoot);
+}
+
+/*************************************************************************/ /*!
+@Function       _FreeIdxRemove
+@Description    Remove a boundary tag from a free segment index. The size and
+                base of the boundary tag must not have changed since it was
+                inserted.
+@Input          pRoot     Root of the index.
+@Input          pBT       The boundary tag, in the index.
+@Return         New root of the index.
+*/ /**************************************************************************/
+static BT *
+_FreeIdxRemove(BT *pRoot, BT *pBT)
+{
+	PVR_ASSERT(pRoot != NULL);
+
+	if (unlikely(pRoot == NULL))
+	{
+		return NULL;
+	}
+
+	if (pRoot == pBT)
+	{
+		BT *pLeft = pBT->pFreeIdxLeft;
+		BT *pRight = pBT->pFreeIdxRight;
+		BT *pMin;
+
+		if (pRight == NULL)
+		{
+			return pLeft;
+		}
+
+		pRight = _FreeIdxRemoveMin(pRight, &pMin);
+		pMin->pFreeIdxLeft = pLeft;
+		pMin->pFreeIdxRight = pRight;
+
+		return _FreeIdxBalance(pMin);
+	}
+
+	if (_FreeIdxLess(pBT, pRoot))
+	{
+		pRoot->pFreeIdxLeft = _FreeIdxRemove(pRoot->pFreeIdxLeft, pBT);
+	}
+	else
+	{
+		pRoot->pFreeIdxRight = _FreeIdxRemove(pRoot->pFreeIdxRight, pBT);
+	}
+
+	return _FreeIdxBalance(pRoot);
+}
+
+/*************************************************************************/ /*!
+@Function       _FreeIdxLowerBound
+@Description    Find the first boundary tag of a free segment index that does
+                not sort before (uSize, base).
+@Input          pArena    The arena, for search statistics.
+@Input          pRoot     Root of the index.
+@Input          uSize     Size key.
+@Input          base      Base key.
+@Return         The boundary tag or NULL.
+*/ /**************************************************************************/
+static BT *
+_FreeIdxLowerBound(RA_ARENA *pArena, BT *pRoot, RA_LENGTH_T uSize, RA_BASE_T base)
+{
+	BT *pFound = NULL;
+
+	while (pRoot != NULL)
+	{
+		pArena->ui64FreeSearchVisited++;
+
+		if ((pRoot->uSize > uSize) ||
+		    ((pRoot->uSize == uSize) && (pRoot->base >= base)))
+		{
+			pFound = pRoot;
+			pRoot = pRoot->pFreeIdxLeft;
+		}
+		else
+		{
+			pRoot = pRoot->pFreeIdxRight;
+		}
+	}
+
+	return pFound;
+}
+
+/*************************************************************************/ /*!
+@Function       _FreeIdxFindFit
+@Description    Find a free segment able to hold an aligned allocation.
+                Any segment of at least uSize + uAlignment - 1 is guaranteed
+                to fit, so that one is a single logarithmic lookup. Smaller
+                segments only fit if their base happens to be suitably
+                aligned, those are walked in size order from uSize.
+@Input          pArena       The arena.
+@Input          pRoot        Root of the index.
+@Input          uSize        The requested allocation size.
+@Input          uAlignment   Required alignment, or 0.
+@Input          bBestFit     Look at the segments that may fit before the
+                             ones that are guaranteed to fit.
+@Return         The boundary tag or NULL.
+*/ /**************************************************************************/
+static BT *
+_FreeIdxFindFit(RA_ARENA *pArena,
+                BT *pRoot,
+                RA_LENGTH_T uSize,
+                RA_LENGTH_T uAlignment,
+                IMG_BOOL bBestFit)
+{
+	RA_LENGTH_T uAssuredSize = (uAlignment > 1) ? uSize + uAlignment - 1 : uSize;
+	BT *pBT;
+
+	if (!bBestFit)
+	{
+		pBT = _FreeIdxLowerBound(pArena, pRoot, uAssuredSize, 0);
+		if (pBT != NULL)
+		{
+			return pBT;
+		}
+	}
+
+	for (pBT = _FreeIdxLowerBound(pArena, pRoot, uSize, 0);
+	     (pBT != NULL) && (pBT->uSize < uAssuredSize);
+	     pBT = _FreeIdxLowerBound(pArena, pRoot, pBT->uSize, pBT->base + 1))
+	{
+		const RA_BASE_T aligned_base = PVR_ALIGN(pBT->base, uAlignment);
+
+		if (pBT->base + pBT->uSize >= aligned_base + uSize)
+		{
+			return pBT;
+		}
+	}
+
+	/* Either a guaranteed fit or nothing left to look at */
+	return pBT;
+}
+
 /*************************************************************************/ /*!
 @Function       _FreeListInsert
 @Description    Insert a boundary tag into an arena free table.
@@ -642,7 +925,15 @@ _FreeListInsert(RA_ARENA *pArena, BT *pBT)
 	/* Get the first node in the bucket */
 	pBTTemp = pArena->per_flags_buckets->buckets[uIndex];
 
-	if (unlikely((pArena->ui32PolicyFlags & RA_POLICY_ALLOC_NODE_SELECT_MASK) == RA_POLICY_ALLOC_OPTIMAL))
+	if ((pArena->ui32PolicyFlags & RA_POLICY_FREE_INDEX_TREE_MASK) == RA_POLICY_FREE_INDEX_TREE)
+	{
+		pArena->per_flags_buckets->psFreeIndex =
+			_FreeIdxInsert(pArena->per_flags_buckets->psFreeIndex, pBT);
+	}
+
+	/* The free index already orders the segments by size, keep the bucket
+	 * insertion O(1) when it is in use */
+	if (unlikely((pArena->ui32PolicyFlags & (RA_POLICY_ALLOC_NODE_SELECT_MASK | RA_POLICY_FREE_INDEX_TREE_MASK)) == RA_POLICY_ALLOC_OPTIMAL))
 	{
 		/* Add the node to the start if the bucket is empty */
 		if (NULL == pBTTemp)
@@ -720,6 +1011,18 @@ _FreeListRemove(RA_ARENA *pArena, BT *pBT)
 
 	PVR_ASSERT(_IsInFreeList(pArena, pBT));
 
+	if ((pArena->ui32PolicyFlags & RA_POLICY_FREE_INDEX_TREE_MASK) == RA_POLICY_FREE_INDEX_TREE)
+	{
+		pArena->per_flags_buckets = PVRSRVSplay(pBT->uFlags, pArena->per_flags_buckets);
+		PVR_ASSERT(pArena->per_flags_buckets != NULL);
+
+		if (likely(pArena->per_flags_buckets != NULL))
+		{
+			pArena->per_flags_buckets->psFreeIndex =
+				_FreeIdxRemove(pArena->per_flags_buckets->psFreeIndex, pBT);
+		}
+	}
+
 	if (pBT->next_free != NULL)
 	{
 		pBT->next_free->prev_free = pBT->prev_free;
@@ -918,7 +1221,8 @@ _FreeBT(RA_ARENA *pArena, BT *pBT)
   all elements in the free list
  */
 static INLINE
-struct _BT_ *find_chunk_in_bucket(struct _BT_ * first_elt,
+struct _BT_ *find_chunk_in_bucket(RA_ARENA *pArena,
+                                  struct _BT_ * first_elt,
                                   RA_LENGTH_T uSize,
                                   RA_LENGTH_T uAlignment,
                                   unsigned int nb_max_try)
@@ -931,6 +1235,8 @@ struct _BT_ *find_chunk_in_bucket(struct _BT_ * first_elt,
 			PVR_ALIGN(walker->base, uAlignment)
 			: walker->base;
 
+		pArena->ui64FreeSearchVisited++;
+
 		if (walker->base + walker->uSize >= aligned_base + uSize)
 		{
 			return walker;
@@ -1524,6 +1830,23 @@ _AttemptAllocAligned(RA_ARENA *pArena,
 		return IMG_FALSE;
 	}
 
+	pArena->ui64FreeSearchCount++;
+
+	if ((pArena->ui32PolicyFlags & RA_POLICY_FREE_INDEX_TREE_MASK) == RA_POLICY_FREE_INDEX_TREE)
+	{
+		pBT = _FreeIdxFindFit(pArena,
+		                      pArena->per_flags_buckets->psFreeIndex,
+		                      uSize,
+		                      uAlignment,
+		                      (pArena->ui32PolicyFlags & RA_POLICY_BUCKET_MASK) == RA_POLICY_BUCKET_BEST_FIT);
+		if (pBT == NULL)
+		{
+			return IMG_FALSE;
+		}
+
+		return _AllocAlignSplit(pArena, pBT, uSize, uAlignment, base, phPriv);
+	}
+
 	index_low = pvr_log2(uSize);
 	if (uAlignment)
 	{
@@ -1552,7 +1875,7 @@ _AttemptAllocAligned(RA_ARENA *pArena,
 		{
 			if (pArena->per_flags_buckets->buckets[i])
 			{
-				pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[i], uSize, uAlignment, (unsigned int) ~0);
+				pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[i], uSize, uAlignment, (unsigned int) ~0);
 			}
 		}
 	}
@@ -1570,13 +1893,13 @@ _AttemptAllocAligned(RA_ARENA *pArena,
 		if (i != FREE_TABLE_LIMIT)
 		{
 			/* since we start at index_high + 1, we are guaranteed to exit */
-			pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[i], uSize, uAlignment, 1);
+			pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[i], uSize, uAlignment, 1);
 		}
 		else
 		{
 			for (i = index_high; (i != index_low - 1) && (pBT == NULL); --i)
 			{
-				pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[i], uSize, uAlignment, (unsigned int) ~0);
+				pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[i], uSize, uAlignment, (unsigned int) ~0);
 			}
 		}
 	}
@@ -1666,6 +1989,20 @@ _AttemptAllocAlignedAssured(RA_ARENA *pArena,
 	PVR_ASSERT(index_high < FREE_TABLE_LIMIT);
 	PVR_ASSERT(index_low <= index_high);
 
+	pArena->ui64FreeSearchCount++;
+
+	if ((pArena->ui32PolicyFlags & RA_POLICY_FREE_INDEX_TREE_MASK) == RA_POLICY_FREE_INDEX_TREE)
+	{
+		/* The index finds a contiguous fit if there is one, only fall back
+		 * to the buckets below to scoop non-contiguous memory */
+		pBT = _FreeIdxFindFit(pArena,
+		                      pArena->per_flags_buckets->psFreeIndex,
+		                      uSize,
+		                      uAlignment,
+		                      IMG_FALSE);
+		goto contig_found;
+	}
+
 	/* Start at index_high + 1 as then we can check all buckets larger than the desired alloc
 	 * If we don't find one larger then we could still find one of requested size in index_high and
 	 * shortcut the non-contiguous allocation path. We check index_high + 1 first as it is
@@ -1688,7 +2025,7 @@ _AttemptAllocAlignedAssured(RA_ARENA *pArena,
 
 	if (i != FREE_TABLE_LIMIT)
 	{
-		pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[i], uSize, uAlignment, 1);
+		pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[i], uSize, uAlignment, 1);
 	}
 	else
 	{
@@ -1699,9 +2036,10 @@ _AttemptAllocAlignedAssured(RA_ARENA *pArena,
 		 * containing the largest free chunks in the RA Arena. i.e All buckets > index_high == NULL.
 		 * We do a final search in that bucket here before we attempt to scoop memory or return NULL.
 		 */
-		pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[index_high], uSize, uAlignment, 1);
+		pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[index_high], uSize, uAlignment, 1);
 	}
 
+contig_found:
 	/* We managed to find a contiguous allocation block of sufficient size */
 	if (pBT != NULL)
 	{
@@ -1744,9 +2082,9 @@ _AttemptAllocAlignedAssured(RA_ARENA *pArena,
 	{
 		/* While we have chunks of at least our contig size in the bucket to use */
 		for (
-		pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[i], 1ULL << uLog2MinContigSize, uAlignment,(unsigned int) ~0);
+		pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[i], 1ULL << uLog2MinContigSize, uAlignment,(unsigned int) ~0);
 		pBT != NULL && uiRemaining != 0;
-		pBT = find_chunk_in_bucket(pArena->per_flags_buckets->buckets[i], 1ULL << uLog2MinContigSize, uAlignment,(unsigned int) ~0))//~0 Try all elements in bucket
+		pBT = find_chunk_in_bucket(pArena, pArena->per_flags_buckets->buckets[i], 1ULL << uLog2MinContigSize, uAlignment,(unsigned int) ~0))//~0 Try all elements in bucket
 		{
 			/* Grab largest chunk possible that is a multiple of our min contiguity size
 			 * N.B: C always rounds towards 0 so this effectively floors for us */
@@ -2143,7 +2481,11 @@ RA_CreateCommon(IMG_CHAR *name,
 		goto lock_fail;
 	}
 
-	pArena->pSegmentHash = HASH_Create_Extended(MINIMUM_HASH_SIZE, sizeof(RA_BASE_T), HASH_Func_Default, HASH_Key_Comp_Default);
+	/* Segments are inserted and removed on every alloc/free, use the open
+	 * addressed backend so that doing so does not allocate */
+	pArena->pSegmentHash = HASH_Create_Extended_Type(MINIMUM_HASH_SIZE, sizeof(RA_BASE_T),
+	                                                 HASH_Func_Default, HASH_Key_Comp_Default,
+	                                                 HASH_TABLE_TYPE_OPEN_ADDRESSED);
 
 	if (pArena->pSegmentHash==NULL)
 	{
@@ -2167,6 +2509,8 @@ RA_CreateCommon(IMG_CHAR *name,
 	pArena->ui32PolicyFlags = ui32PolicyFlags;
 	pArena->ui64TotalArenaSize = 0;
 	pArena->ui64FreeArenaSize = 0;
+	pArena->ui64FreeSearchCount = 0;
+	pArena->ui64FreeSearchVisited = 0;
 
 	PVR_ASSERT(is_arena_valid(pArena));
 	return pArena;
@@ -3967,6 +4311,14 @@ RA_BlockDump(RA_ARENA *pArena, void (*pfnLogDump)(void*, IMG_CHAR*, ...), void *
 	           pArena->ui64FreeArenaSize,
 	           uiLargestFreeSegmentSize,
 	           uiFragPercentage);
+	pfnLogDump(pPrivData,
+	           "    Free Segment Policy: %s"
+	           "    Free Segment Searches: %"IMG_UINT64_FMTSPEC
+	           "    Free Segments Visited: %"IMG_UINT64_FMTSPEC,
+	           ((pArena->ui32PolicyFlags & RA_POLICY_FREE_INDEX_TREE_MASK) == RA_POLICY_FREE_INDEX_TREE) ?
+	               "index tree" : "buckets",
+	           pArena->ui64FreeSearchCount,
+	           pArena->ui64FreeSearchVisited);
 	pfnLogDump(pPrivData,
 	           "===============================================================================");
 
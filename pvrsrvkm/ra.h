@@ -155,8 +155,8 @@ typedef struct _RA_MULTIBASE_ITERATOR_ RA_MULTIBASE_ITERATOR;
  * */
 
 /* --- Resource allocation policy definitions ---
-* | 31.........5|.......4....|......3....|........2.............|1...................0|
-* | Reserved    | Non-Contig | No split  | Area bucket selection| Alloc node selection|
+* | 31.........6|......5.....|.......4....|......3....|........2.............|1...................0|
+* | Reserved    | Free index | Non-Contig | No split  | Area bucket selection| Alloc node selection|
 */
 
 /*
@@ -212,6 +212,17 @@ typedef struct _RA_MULTIBASE_ITERATOR_ RA_MULTIBASE_ITERATOR;
 #define RA_POLICY_ALLOC_ALLOW_NONCONTIG      (16U)
 #define RA_POLICY_ALLOC_ALLOW_NONCONTIG_MASK (16U)
 
+/* This flag makes the arena additionally index its free segments in a
+ * balanced tree ordered by (size, base). Aligned allocations are then
+ * resolved with a logarithmic lookup instead of walking the free buckets,
+ * which matters for large, heavily fragmented arenas.
+ * The bucket selection policy still applies: assured fit picks the smallest
+ * segment guaranteed to satisfy the alignment, best fit first considers the
+ * smaller segments that may satisfy it.
+ * */
+#define RA_POLICY_FREE_INDEX_TREE        (32U)
+#define RA_POLICY_FREE_INDEX_TREE_MASK   (32U)
+
 /*
  * Default Arena Policy
  * */
@@ -91,6 +91,74 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define UPDATE_CCB_OFFSET(Off, PacketSize, CCBSize) \
 	(Off) = (((Off) + (PacketSize)) & ((CCBSize) - 1))
 
+#if defined(PVRSRV_ENABLE_CCCB_GROW)
+/* Grow at the next wrap once usage since the last resize has reached this
+ * percentage of the CCB, rather than waiting for it to be half full at the
+ * wrap point itself. */
+#define RGX_CCB_GROW_HIGH_WATERMARK_PERCENT  (75)
+
+/* A grown CCB is halved again once its usage has stayed at or below a
+ * quarter of its size for the quiet period and the FW has drained it. */
+#define RGX_CCB_SHRINK_USAGE_DIVISOR         (4)
+#define RGX_CCB_SHRINK_QUIET_PERIOD_MS       (2000)
+#endif
+
+/* Commands per acquire whose layout is kept, by position in the acquire.
+ * The largest acquire is a 3D kick with a partial render fence, a partial
+ * render and a render. */
+#define RGX_CCB_CMD_LAYOUT_CACHE_SIZE  (3)
+
+/* Headers in a command: fence, FBSC invalidate, pre timestamp, DM, post
+ * timestamp, RMW update and update */
+#define RGX_CCB_CMD_LAYOUT_MAX_HEADERS (7)
+
+/* Largest command image without its DM command data */
+#define RGX_CCB_CMD_LAYOUT_MAX_SIZE \
+	(RGX_CCB_CMD_LAYOUT_MAX_HEADERS * sizeof(RGXFWIF_CCB_CMD_HEADER) + \
+	 2 * RGX_CCB_FWALLOC_ALIGN(RGXFWIF_CCB_CMD_MAX_UFOS * sizeof(RGXFWIF_UFO)) + \
+	 RGX_CCB_FWALLOC_ALIGN(sizeof(IMG_UINT64)) + \
+	 2 * PVR_ALIGN(sizeof(RGXFWIF_DEV_VIRTADDR), RGXFWIF_FWALLOC_ALIGN) + \
+	 sizeof(RGXFWIF_UFO))
+
+/* The fence, update and other command headers built for the last command
+ * of a given shape, laid out as they are written to the CCB but without
+ * the DM command data. A repeat kick of the same shape patches the UFOs,
+ * the job references and the workload estimation data in place and copies
+ * the image out around the DM command data. */
+typedef struct _RGX_CCB_CMD_LAYOUT_
+{
+	/* Shape the image was built for, none until bValid is set */
+	IMG_BOOL				bValid;
+	RGXFWIF_CCB_CMD_TYPE	eType;
+	IMG_UINT32				ui32CmdSize;
+	IMG_UINT32				ui32DMCmdSize;
+	IMG_UINT32				ui32ClientFenceCount;
+	IMG_UINT32				ui32ClientUpdateCount;
+	IMG_UINT32				ui32FBSCInvalCmdSize;
+	IMG_UINT64				ui64FBSCEntryMask;
+	IMG_UINT32				ui32PreTimeStampCmdSize;
+	IMG_UINT32				ui32PreTimestampAddr;
+	IMG_UINT32				ui32PostTimeStampCmdSize;
+	IMG_UINT32				ui32PostTimestampAddr;
+	IMG_UINT32				ui32RMWUFOCmdSize;
+	IMG_UINT32				ui32RMWUFOAddr;
+
+	/* Where the variable fields are in the image */
+	IMG_UINT32				ui32HeaderCount;
+	IMG_UINT32				aui32HeaderOffset[RGX_CCB_CMD_LAYOUT_MAX_HEADERS];
+	IMG_UINT32				ui32DMHeaderOffset;
+	IMG_UINT32				ui32FenceUFOOffset;
+	IMG_UINT32				ui32UpdateUFOOffset;
+
+	/* Bytes of the image before the DM command data and in total */
+	IMG_UINT32				ui32PreDMSize;
+	IMG_UINT32				ui32ImageSize;
+	IMG_UINT64				aui64Image[RGX_CCB_CMD_LAYOUT_MAX_SIZE / sizeof(IMG_UINT64)];
+} RGX_CCB_CMD_LAYOUT;
+
+static_assert((RGX_CCB_CMD_LAYOUT_MAX_SIZE % sizeof(IMG_UINT64)) == 0,
+              "Command layout image is not a whole number of words");
+
 #if defined(PVRSRV_ENABLE_CCCB_UTILISATION_INFO)
 
 #define PVRSRV_CLIENT_CCCB_UTILISATION_WARNING_THRESHOLD 0x1
@@ -136,6 +204,22 @@ struct _RGX_CLIENT_CCB_ {
 	IMG_UINT32					ui32VirtualAllocSize;			/*!< Virtual size of the CCB */
 	IMG_UINT32					ui32ChunkSize;					/*!< CCB Sparse allocation chunk size */
 	IMG_PUINT32					pui32MappingTable;				/*!< Mapping table for sparse allocation of the CCB */
+	IMG_UINT32					ui32MinSize;					/*!< Size a grown CCB is shrunk back towards */
+	IMG_UINT32					ui32WindowHighWaterMark;		/*!< Maximum usage since the last resize */
+	IMG_UINT32					ui32WindowFullCount;			/*!< Acquire retries since the last resize */
+	IMG_UINT32					ui32LastBusyTimeMs;				/*!< Last time usage was above the shrink threshold */
+	IMG_UINT32					ui32GrowCount;					/*!< Number of times the CCB has grown */
+	IMG_UINT32					ui32ShrinkCount;				/*!< Number of times the CCB has shrunk */
+#endif
+	IMG_UINT32					ui32HighWaterMark;				/*!< Maximum usage over the lifetime of the CCB */
+	IMG_UINT32					ui32FullCount;					/*!< Number of times RGXAcquireCCB() asked for a retry */
+	RGX_CCB_CMD_LAYOUT			*apsCmdLayout[RGX_CCB_CMD_LAYOUT_CACHE_SIZE]; /*!< Layouts of the last commands, by position in the acquire */
+	IMG_UINT32					ui32CmdLayoutHits;				/*!< Commands written from a cached layout */
+	IMG_UINT32					ui32CmdLayoutMisses;			/*!< Commands whose layout had to be built */
+#if defined(NO_HARDWARE)
+	IMG_UINT64					ui64KickStartNs;				/*!< Start of the command build in progress, 0 if none */
+	IMG_UINT64					ui64KickTimeNs;					/*!< Total CPU time spent building commands */
+	IMG_UINT32					ui32KickCount;					/*!< Number of command builds in ui64KickTimeNs */
 #endif
 	DLLIST_NODE					sNode;							/*!< Node used to store this CCB on the per connection list */
 	PDUMP_CONNECTION_DATA		*psPDumpConnectionData;			/*!< Pointer to the per connection data in which we reside */
@@ -504,7 +588,19 @@ static INLINE void _RGXCheckCCBUtilisation(RGX_CLIENT_CCB *psClientCCB)
 	}
 }
 
-/* Update the cCCB high watermark level if necessary */
+#endif /* PVRSRV_ENABLE_CCCB_UTILISATION_INFO */
+
+#if defined(PVRSRV_ENABLE_CCCB_GROW)
+/* Start a new sizing window, called after every grow or shrink attempt */
+static INLINE void _RGXResetCCBSizingWindow(RGX_CLIENT_CCB *psClientCCB)
+{
+	psClientCCB->ui32WindowHighWaterMark = 0;
+	psClientCCB->ui32WindowFullCount = 0;
+	psClientCCB->ui32LastBusyTimeMs = OSClockms();
+}
+#endif
+
+/* Update the cCCB high watermark levels if necessary */
 static void _RGXUpdateCCBUtilisation(RGX_CLIENT_CCB *psClientCCB)
 {
 	IMG_UINT32 ui32FreeSpace, ui32MemCurrentUsage;
@@ -517,6 +613,24 @@ static void _RGXUpdateCCBUtilisation(RGX_CLIENT_CCB *psClientCCB)
 									  psClientCCB->ui32Size);
 	ui32MemCurrentUsage = psClientCCB->ui32Size - ui32FreeSpace;
 
+	if (ui32MemCurrentUsage > psClientCCB->ui32HighWaterMark)
+	{
+		psClientCCB->ui32HighWaterMark = ui32MemCurrentUsage;
+	}
+
+#if defined(PVRSRV_ENABLE_CCCB_GROW)
+	if (ui32MemCurrentUsage > psClientCCB->ui32WindowHighWaterMark)
+	{
+		psClientCCB->ui32WindowHighWaterMark = ui32MemCurrentUsage;
+	}
+
+	if (ui32MemCurrentUsage > psClientCCB->ui32Size / RGX_CCB_SHRINK_USAGE_DIVISOR)
+	{
+		psClientCCB->ui32LastBusyTimeMs = OSClockms();
+	}
+#endif
+
+#if defined(PVRSRV_ENABLE_CCCB_UTILISATION_INFO)
 	if (ui32MemCurrentUsage > psClientCCB->sUtilisation.ui32HighWaterMark)
 	{
 		psClientCCB->sUtilisation.ui32HighWaterMark = ui32MemCurrentUsage;
@@ -526,10 +640,9 @@ static void _RGXUpdateCCBUtilisation(RGX_CLIENT_CCB *psClientCCB)
 		 */
 		_RGXCheckCCBUtilisation(psClientCCB);
 	}
+#endif
 }
 
-#endif /* PVRSRV_ENABLE_CCCB_UTILISATION_INFO */
-
 PVRSRV_ERROR RGXCreateCCB(PVRSRV_RGXDEV_INFO	*psDevInfo,
 						  IMG_UINT32			ui32CCBSizeLog2,
 						  IMG_UINT32			ui32CCBMaxSizeLog2,
@@ -800,9 +913,24 @@ PVRSRV_ERROR RGXCreateCCB(PVRSRV_RGXDEV_INFO	*psDevInfo,
 	psClientCCB->ui32LastROff = ui32AllocSize - 1;
 	psClientCCB->ui32ByteCount = 0;
 	psClientCCB->ui32LastByteCount = 0;
+	psClientCCB->ui32HighWaterMark = 0;
+	psClientCCB->ui32FullCount = 0;
+	OSCachedMemSet(psClientCCB->apsCmdLayout, 0, sizeof(psClientCCB->apsCmdLayout));
+	psClientCCB->ui32CmdLayoutHits = 0;
+	psClientCCB->ui32CmdLayoutMisses = 0;
+#if defined(NO_HARDWARE)
+	psClientCCB->ui64KickStartNs = 0;
+	psClientCCB->ui64KickTimeNs = 0;
+	psClientCCB->ui32KickCount = 0;
+#endif
 	BIT_UNSET(psClientCCB->ui32CCBFlags, CCB_FLAGS_CCB_STATE_OPEN);
 
 #if defined(PVRSRV_ENABLE_CCCB_GROW)
+	psClientCCB->ui32MinSize = ui32AllocSize;
+	psClientCCB->ui32GrowCount = 0;
+	psClientCCB->ui32ShrinkCount = 0;
+	_RGXResetCCBSizingWindow(psClientCCB);
+
 	eError = OSLockCreate(&psClientCCB->hCCBGrowLock);
 	if (eError != PVRSRV_OK)
 	{
@@ -877,6 +1005,8 @@ fail_alloc:
 
 void RGXDestroyCCB(PVRSRV_RGXDEV_INFO *psDevInfo, RGX_CLIENT_CCB *psClientCCB)
 {
+	IMG_UINT32 i;
+
 #if defined(PVRSRV_ENABLE_CCCB_UTILISATION_INFO)
 	if (psClientCCB->sUtilisation.ui32CCBFull)
 	{
@@ -901,6 +1031,10 @@ void RGXDestroyCCB(PVRSRV_RGXDEV_INFO *psDevInfo, RGX_CLIENT_CCB *psClientCCB)
 		OSFreeMem(psClientCCB->pui32MappingTable);
 	}
 #endif
+	for (i = 0; i < ARRAY_SIZE(psClientCCB->apsCmdLayout); i++)
+	{
+		OSFreeMem(psClientCCB->apsCmdLayout[i]);
+	}
 	OSFreeMem(psClientCCB);
 }
 
@@ -936,35 +1070,41 @@ static INLINE void _RGXWaitForCCBSpaceInPDump(PVRSRV_DEVICE_NODE *psDeviceNode,
 
 
 #if defined(PVRSRV_ENABLE_CCCB_GROW)
+/* Allocate (SPARSE_RESIZE_ALLOC) or free (SPARSE_RESIZE_FREE) ui32PageCount
+ * chunks of the CCB starting at chunk ui32FirstPage. The CCB must be POT so
+ * callers always double or halve it. */
 static PVRSRV_ERROR _RGXCCBMemChangeSparse(RGX_CLIENT_CCB *psClientCCB,
-										  IMG_UINT32 ui32AllocPageCount)
+										  IMG_UINT32 ui32FirstPage,
+										  IMG_UINT32 ui32PageCount,
+										  IMG_UINT32 ui32SparseFlags)
 {
 	PVRSRV_ERROR eError;
 	IMG_UINT32	 i;
+	IMG_BOOL	 bAlloc = (ui32SparseFlags == SPARSE_RESIZE_ALLOC);
 
 	DevmemReleaseCpuVirtAddr(psClientCCB->psClientCCBMemDesc);
 
-	for (i = 0; i < ui32AllocPageCount; i++)
+	for (i = 0; i < ui32PageCount; i++)
 	{
-		psClientCCB->pui32MappingTable[i] = ui32AllocPageCount + i;
+		psClientCCB->pui32MappingTable[i] = ui32FirstPage + i;
 	}
 
-	/* Double the CCB size (CCB must be POT) by adding ui32AllocPageCount new pages */
 	eError = DeviceMemChangeSparse(psClientCCB->psClientCCBMemDesc,
-									ui32AllocPageCount,
-									psClientCCB->pui32MappingTable,
-									0,
-									NULL,
-									SPARSE_RESIZE_ALLOC);
+									bAlloc ? ui32PageCount : 0,
+									bAlloc ? psClientCCB->pui32MappingTable : NULL,
+									bAlloc ? 0 : ui32PageCount,
+									bAlloc ? NULL : psClientCCB->pui32MappingTable,
+									ui32SparseFlags);
 	if (eError != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "RGXAcquireCCB: Failed to grow RGX client CCB (%s)",
+		PVR_DPF((PVR_DBG_ERROR, "%s: Failed to %s RGX client CCB (%s)",
+				__func__, bAlloc ? "grow" : "shrink",
 				PVRSRVGetErrorString(eError)));
 
 		if (DevmemAcquireCpuVirtAddr(psClientCCB->psClientCCBMemDesc,
 									&psClientCCB->pvClientCCB) != PVRSRV_OK)
 		{
-			PVR_DPF((PVR_DBG_ERROR, "RGXAcquireCCB: Failed to reacquire CCB mapping"));
+			PVR_DPF((PVR_DBG_ERROR, "%s: Failed to reacquire CCB mapping", __func__));
 			psClientCCB->pvClientCCB = NULL;
 		}
 
@@ -975,13 +1115,68 @@ static PVRSRV_ERROR _RGXCCBMemChangeSparse(RGX_CLIENT_CCB *psClientCCB,
 									&psClientCCB->pvClientCCB);
 	if (eError != PVRSRV_OK)
 	{
-		PVR_DPF((PVR_DBG_ERROR, "RGXAcquireCCB: Failed to map RGX client CCB (%s)",
-				PVRSRVGetErrorString(eError)));
+		PVR_DPF((PVR_DBG_ERROR, "%s: Failed to map RGX client CCB (%s)",
+				__func__, PVRSRVGetErrorString(eError)));
 		return eError;
 	}
 
 	return PVRSRV_OK;
 }
+
+#if !defined(PDUMP)
+/* Halve a grown CCB once it has been quiet for RGX_CCB_SHRINK_QUIET_PERIOD_MS.
+ * Only done while the FW has consumed everything written so far and the write
+ * offset is inside the smaller CCB, so nothing the FW may still read is freed.
+ * The FW picks up the new wrap mask with the next kick (ui32CWrapMaskUpdate).
+ * Not done in PDump builds as the capture only ever describes growth.
+ */
+static void _RGXCCBTryShrink(RGX_CLIENT_CCB *psClientCCB, IMG_UINT32 ui32CmdSize)
+{
+	IMG_UINT32 ui32NewSize = psClientCCB->ui32Size >> 1;
+	PVRSRV_ERROR eError;
+
+	/* Only sparse CCBs give memory back when they shrink */
+	if ((psClientCCB->pui32MappingTable == NULL) ||
+	    (ui32NewSize < psClientCCB->ui32MinSize) ||
+	    ((ui32CmdSize + PADDING_COMMAND_SIZE + 1) > ui32NewSize) ||
+	    (psClientCCB->ui32HostWriteOffset >= ui32NewSize) ||
+	    ((OSClockms() - psClientCCB->ui32LastBusyTimeMs) < RGX_CCB_SHRINK_QUIET_PERIOD_MS))
+	{
+		return;
+	}
+
+	RGXFwSharedMemCacheOpValue(psClientCCB->psClientCCBCtrl->ui32ReadOffset,
+	                           INVALIDATE);
+	RGXFwSharedMemCacheOpValue(psClientCCB->psClientCCBCtrl->ui32DepOffset,
+	                           INVALIDATE);
+	if ((psClientCCB->psClientCCBCtrl->ui32ReadOffset != psClientCCB->ui32HostWriteOffset) ||
+	    (psClientCCB->psClientCCBCtrl->ui32DepOffset != psClientCCB->ui32HostWriteOffset))
+	{
+		return;
+	}
+
+	OSLockAcquire(psClientCCB->hCCBGrowLock);
+
+	eError = _RGXCCBMemChangeSparse(psClientCCB,
+	                                ui32NewSize / psClientCCB->ui32ChunkSize,
+	                                (psClientCCB->ui32Size - ui32NewSize) / psClientCCB->ui32ChunkSize,
+	                                SPARSE_RESIZE_FREE);
+	if (eError == PVRSRV_OK)
+	{
+		psClientCCB->ui32Size = ui32NewSize;
+		psClientCCB->ui32ShrinkCount++;
+#if defined(PVRSRV_ENABLE_CCCB_UTILISATION_INFO)
+		PVR_LOG(("%s: Client CCB (%s) shrank to %u", __func__, psClientCCB->szName, psClientCCB->ui32Size));
+		_RGXInitCCBUtilisation(psClientCCB);
+#endif
+	}
+
+	/* Either way don't look again until another quiet period has passed */
+	_RGXResetCCBSizingWindow(psClientCCB);
+
+	OSLockRelease(psClientCCB->hCCBGrowLock);
+}
+#endif /* !defined(PDUMP) */
 #endif /* defined(PVRSRV_ENABLE_CCCB_GROW) */
 
 PVRSRV_ERROR RGXCheckSpaceCCB(RGX_CLIENT_CCB *psClientCCB, IMG_UINT32 ui32CmdSize)
@@ -1105,6 +1300,13 @@ PVRSRV_ERROR RGXAcquireCCB(RGX_CLIENT_CCB *psClientCCB,
 	PVR_UNREFERENCED_PARAMETER(ui32PDumpFlags);
 #endif
 
+#if defined(PVRSRV_ENABLE_CCCB_GROW) && !defined(PDUMP)
+	if (psClientCCB->ui32Size > psClientCCB->ui32MinSize)
+	{
+		_RGXCCBTryShrink(psClientCCB, ui32CmdSize);
+	}
+#endif
+
 	/* Check that the CCB can hold this command + padding */
 	if ((ui32CmdSize + PADDING_COMMAND_SIZE + 1) > psClientCCB->ui32Size)
 	{
@@ -1175,15 +1377,26 @@ PVRSRV_ERROR RGXAcquireCCB(RGX_CLIENT_CCB *psClientCCB,
 			{
 				PVRSRV_RGXDEV_INFO *psDevInfo = FWCommonContextGetRGXDevInfo(psClientCCB->psServerCommonContext);
 
+				IMG_BOOL bGrow;
+
 				ui32FreeSpace = GET_CCB_SPACE(psClientCCB->ui32HostWriteOffset,
 											psClientCCB->psClientCCBCtrl->ui32ReadOffset,
 											psClientCCB->ui32Size);
 				/*
 				 * Check if CCB should grow or be wrapped.
-				 * Wrap CCB if there is no need for grow (CCB is half empty) or CCB can't grow,
+				 * Grow if the CCB is at least half full, or if since the last resize
+				 * it came close to full or producers had to retry. Doing it here at
+				 * the wrap point is the only time the new space is contiguous with
+				 * the commands still to be read.
+				 * Wrap CCB if there is no need for grow or CCB can't grow,
 				 * and when is free space for command and padding.
 				 */
-				if (((ui32FreeSpace > psClientCCB->ui32Size/2) || (psClientCCB->ui32Size == psClientCCB->ui32VirtualAllocSize)) &&
+				bGrow = (ui32FreeSpace <= psClientCCB->ui32Size/2) ||
+				        (psClientCCB->ui32WindowHighWaterMark >=
+				         (psClientCCB->ui32Size / 100U) * RGX_CCB_GROW_HIGH_WATERMARK_PERCENT) ||
+				        (psClientCCB->ui32WindowFullCount != 0);
+
+				if ((!bGrow || (psClientCCB->ui32Size == psClientCCB->ui32VirtualAllocSize)) &&
 					(ui32FreeSpace > ui32Remain + ui32CmdSize))
 				{
 #if defined(PDUMP)
@@ -1233,18 +1446,31 @@ PVRSRV_ERROR RGXAcquireCCB(RGX_CLIENT_CCB *psClientCCB,
 					{
 						IMG_UINT32 ui32AllocChunkCount = psClientCCB->ui32Size / psClientCCB->ui32ChunkSize;
 
-						eErr = _RGXCCBMemChangeSparse(psClientCCB, ui32AllocChunkCount);
+						eErr = _RGXCCBMemChangeSparse(psClientCCB, ui32AllocChunkCount,
+						                              ui32AllocChunkCount, SPARSE_RESIZE_ALLOC);
 					}
 
 					/* Setup new CCB size */
 					if (eErr == PVRSRV_OK)
 					{
 						psClientCCB->ui32Size += psClientCCB->ui32Size;
+						psClientCCB->ui32GrowCount++;
+						_RGXResetCCBSizingWindow(psClientCCB);
 					}
 					else
 					{
 						PVR_LOG(("%s: Client CCB (%s) grow failed (%s)", __func__, psClientCCB->szName, PVRSRVGetErrorString(eErr)));
+						_RGXResetCCBSizingWindow(psClientCCB);
 						OSLockRelease(psClientCCB->hCCBGrowLock);
+
+						/* If the grow was only wanted because of earlier usage,
+						 * go round again and wrap instead of failing the acquire.
+						 */
+						if ((ui32FreeSpace > psClientCCB->ui32Size/2) &&
+						    (ui32FreeSpace > ui32Remain + ui32CmdSize))
+						{
+							continue;
+						}
 						goto e_retry;
 					}
 
@@ -1324,6 +1550,10 @@ PVRSRV_ERROR RGXAcquireCCB(RGX_CLIENT_CCB *psClientCCB,
 		}
 	}
 e_retry:
+	psClientCCB->ui32FullCount++;
+#if defined(PVRSRV_ENABLE_CCCB_GROW)
+	psClientCCB->ui32WindowFullCount++;
+#endif
 #if defined(PVRSRV_ENABLE_CCCB_UTILISATION_INFO)
 	psClientCCB->sUtilisation.ui32CCBFull++;
 	_RGXCCBUtilisationEvent(psClientCCB,
@@ -1517,17 +1747,16 @@ void RGXReleaseCCB(RGX_CLIENT_CCB *psClientCCB,
 	                  psClientCCB->ui32Size);
 	psClientCCB->ui32ByteCount += ui32CmdSize;
 
-	/* Flush the CCB data */
+	/* Flush the CCB data. The control's wrap mask only follows a resize
+	 * once the FW has seen it, so use the host's size of the CCB. */
 	RGXFwSharedMemFlushCCB(psClientCCB->pvClientCCB,
 	                       psClientCCB->ui32HostWriteOffset,
 	                       ui32NewWriteOffset,
-	                       psClientCCB->psClientCCBCtrl->ui32WrapMask + 1);
+	                       psClientCCB->ui32Size);
 
 	psClientCCB->ui32HostWriteOffset = ui32NewWriteOffset;
 
-#if defined(PVRSRV_ENABLE_CCCB_UTILISATION_INFO)
 	_RGXUpdateCCBUtilisation(psClientCCB);
-#endif
 	/*
 		PDumpSetFrame will detect as we Transition out of capture range for
 		frame based data but if we are PDumping continuous data then we
@@ -1857,6 +2086,27 @@ FORCE_INLINE IMG_BOOL RGXIsValidWorkloadEstCCBCommand(RGXFWIF_CCB_CMD_TYPE eType
 }
 #endif
 
+static inline void RGXSetCmdHeaderWorkEst(RGXFWIF_CCB_CMD_HEADER *psCmdHeader,
+										  RGXFWIF_WORKEST_KICK_DATA *psWorkEstKickData)
+{
+#if defined(SUPPORT_WORKLOAD_ESTIMATION)
+	if (psWorkEstKickData != NULL &&
+		RGXIsValidWorkloadEstCCBCommand(psCmdHeader->eCmdType))
+	{
+		psCmdHeader->sWorkEstKickData = *psWorkEstKickData;
+	}
+	else
+	{
+		psCmdHeader->sWorkEstKickData.ui16ReturnDataIndex = 0;
+		psCmdHeader->sWorkEstKickData.ui64Deadline = 0;
+		psCmdHeader->sWorkEstKickData.ui32CyclesPrediction = 0;
+	}
+#else
+	PVR_UNREFERENCED_PARAMETER(psCmdHeader);
+	PVR_UNREFERENCED_PARAMETER(psWorkEstKickData);
+#endif
+}
+
 static inline void RGXWriteCmdHeader(void *pvCCB, IMG_UINT32 eCmdType, IMG_UINT32 ui32TotalSize,
 									 IMG_UINT32 ui32ExtJobRef, IMG_UINT32 ui32IntJobRef,
 									 RGXFWIF_WORKEST_KICK_DATA *psWorkEstKickData)
@@ -1867,25 +2117,262 @@ static inline void RGXWriteCmdHeader(void *pvCCB, IMG_UINT32 eCmdType, IMG_UINT3
 	sCmdHeader.ui32CmdSize = ui32TotalSize - sizeof(RGXFWIF_CCB_CMD_HEADER);
 	sCmdHeader.ui32ExtJobRef = ui32ExtJobRef;
 	sCmdHeader.ui32IntJobRef = ui32IntJobRef;
+	RGXSetCmdHeaderWorkEst(&sCmdHeader, psWorkEstKickData);
 
-#if defined(SUPPORT_WORKLOAD_ESTIMATION)
-	if (psWorkEstKickData != NULL &&
-		RGXIsValidWorkloadEstCCBCommand(eCmdType))
+	OSCachedMemCopy(pvCCB, &sCmdHeader, sizeof(RGXFWIF_CCB_CMD_HEADER));
+
+}
+
+static IMG_BOOL _CmdLayoutMatches(const RGX_CCB_CMD_LAYOUT *psLayout,
+								  const RGX_CCB_CMD_HELPER_DATA *psCmdHelperData)
+{
+	return psLayout->bValid &&
+		psLayout->eType == psCmdHelperData->eType &&
+		psLayout->ui32CmdSize == psCmdHelperData->ui32CmdSize &&
+		psLayout->ui32DMCmdSize == psCmdHelperData->ui32DMCmdSize &&
+		psLayout->ui32ClientFenceCount == psCmdHelperData->ui32ClientFenceCount &&
+		psLayout->ui32ClientUpdateCount == psCmdHelperData->ui32ClientUpdateCount &&
+		psLayout->ui32FBSCInvalCmdSize == psCmdHelperData->ui32FBSCInvalCmdSize &&
+		psLayout->ui64FBSCEntryMask == psCmdHelperData->ui64FBSCEntryMask &&
+		psLayout->ui32PreTimeStampCmdSize == psCmdHelperData->ui32PreTimeStampCmdSize &&
+		(psLayout->ui32PreTimeStampCmdSize == 0 ||
+		 psLayout->ui32PreTimestampAddr == psCmdHelperData->pPreTimestampAddr.ui32Addr) &&
+		psLayout->ui32PostTimeStampCmdSize == psCmdHelperData->ui32PostTimeStampCmdSize &&
+		(psLayout->ui32PostTimeStampCmdSize == 0 ||
+		 psLayout->ui32PostTimestampAddr == psCmdHelperData->pPostTimestampAddr.ui32Addr) &&
+		psLayout->ui32RMWUFOCmdSize == psCmdHelperData->ui32RMWUFOCmdSize &&
+		(psLayout->ui32RMWUFOCmdSize == 0 ||
+		 psLayout->ui32RMWUFOAddr == psCmdHelperData->pRMWUFOAddr.ui32Addr);
+}
+
+/* Append a command header to the image being built and return a pointer
+ * to the command data that follows it. ui32ImageSpan is the part of the
+ * command kept in the image, which is the header alone for the DM command. */
+static void *_CmdLayoutAddHeader(RGX_CCB_CMD_LAYOUT *psLayout, IMG_UINT32 eCmdType,
+								 IMG_UINT32 ui32TotalSize, IMG_UINT32 ui32ImageSpan)
+{
+	void *pvHeader = IMG_OFFSET_ADDR(psLayout->aui64Image, psLayout->ui32ImageSize);
+
+	PVR_ASSERT(psLayout->ui32HeaderCount < RGX_CCB_CMD_LAYOUT_MAX_HEADERS);
+	PVR_ASSERT(psLayout->ui32ImageSize + ui32ImageSpan <= sizeof(psLayout->aui64Image));
+
+	psLayout->aui32HeaderOffset[psLayout->ui32HeaderCount++] = psLayout->ui32ImageSize;
+	psLayout->ui32ImageSize += ui32ImageSpan;
+
+	/* Job references and workload estimation data are set per kick */
+	RGXWriteCmdHeader(pvHeader, eCmdType, ui32TotalSize, 0, 0, NULL);
+
+	return IMG_OFFSET_ADDR(pvHeader, sizeof(RGXFWIF_CCB_CMD_HEADER));
+}
+
+/*
+	Build the command image for the shape of psCmdHelperData. Everything but
+	the UFOs, job references and workload estimation data is final.
+*/
+static void _CmdLayoutBuild(RGX_CCB_CMD_LAYOUT *psLayout,
+							const RGX_CCB_CMD_HELPER_DATA *psCmdHelperData)
+{
+	void *pvData;
+
+	psLayout->bValid = IMG_TRUE;
+	psLayout->eType = psCmdHelperData->eType;
+	psLayout->ui32CmdSize = psCmdHelperData->ui32CmdSize;
+	psLayout->ui32DMCmdSize = psCmdHelperData->ui32DMCmdSize;
+	psLayout->ui32ClientFenceCount = psCmdHelperData->ui32ClientFenceCount;
+	psLayout->ui32ClientUpdateCount = psCmdHelperData->ui32ClientUpdateCount;
+	psLayout->ui32FBSCInvalCmdSize = psCmdHelperData->ui32FBSCInvalCmdSize;
+	psLayout->ui64FBSCEntryMask = psCmdHelperData->ui64FBSCEntryMask;
+	psLayout->ui32PreTimeStampCmdSize = psCmdHelperData->ui32PreTimeStampCmdSize;
+	psLayout->ui32PreTimestampAddr = psCmdHelperData->pPreTimestampAddr.ui32Addr;
+	psLayout->ui32PostTimeStampCmdSize = psCmdHelperData->ui32PostTimeStampCmdSize;
+	psLayout->ui32PostTimestampAddr = psCmdHelperData->pPostTimestampAddr.ui32Addr;
+	psLayout->ui32RMWUFOCmdSize = psCmdHelperData->ui32RMWUFOCmdSize;
+	psLayout->ui32RMWUFOAddr = psCmdHelperData->pRMWUFOAddr.ui32Addr;
+
+	psLayout->ui32HeaderCount = 0;
+	psLayout->ui32ImageSize = 0;
+	psLayout->ui32DMHeaderOffset = 0;
+	psLayout->ui32FenceUFOOffset = 0;
+	psLayout->ui32UpdateUFOOffset = 0;
+
+	if (psCmdHelperData->ui32ClientFenceCount > 0)
 	{
-		sCmdHeader.sWorkEstKickData = *psWorkEstKickData;
+		IMG_UINT32 ui32FenceCmdSize =
+			RGX_CCB_FWALLOC_ALIGN(psCmdHelperData->ui32ClientFenceCount * sizeof(RGXFWIF_UFO) +
+								  sizeof(RGXFWIF_CCB_CMD_HEADER));
+
+		psLayout->ui32FenceUFOOffset = psLayout->ui32ImageSize + sizeof(RGXFWIF_CCB_CMD_HEADER);
+		_CmdLayoutAddHeader(psLayout, RGXFWIF_CCB_CMD_TYPE_FENCE,
+							ui32FenceCmdSize, ui32FenceCmdSize);
 	}
-	else
+
+	if (psCmdHelperData->ui32FBSCInvalCmdSize)
 	{
-		sCmdHeader.sWorkEstKickData.ui16ReturnDataIndex = 0;
-		sCmdHeader.sWorkEstKickData.ui64Deadline = 0;
-		sCmdHeader.sWorkEstKickData.ui32CyclesPrediction = 0;
+		pvData = _CmdLayoutAddHeader(psLayout, RGXFWIF_CCB_CMD_TYPE_FBSC_INVALIDATE,
+									 psCmdHelperData->ui32FBSCInvalCmdSize,
+									 psCmdHelperData->ui32FBSCInvalCmdSize);
+		OSCachedMemCopy(pvData, &psCmdHelperData->ui64FBSCEntryMask,
+						sizeof(psCmdHelperData->ui64FBSCEntryMask));
 	}
-#else
-	PVR_UNREFERENCED_PARAMETER(psWorkEstKickData);
+
+	/*
+	  Pre and Post timestamp commands are supposed to sandwich the DM cmd. The padding
+	  code with the CCB wrap upsets the FW if we don't have the task type bit cleared for
+	  POST_TIMESTAMPs. That's why we have 2 different cmd types.
+	*/
+	if (psCmdHelperData->ui32PreTimeStampCmdSize != 0)
+	{
+		pvData = _CmdLayoutAddHeader(psLayout, RGXFWIF_CCB_CMD_TYPE_PRE_TIMESTAMP,
+									 psCmdHelperData->ui32PreTimeStampCmdSize,
+									 psCmdHelperData->ui32PreTimeStampCmdSize);
+		OSCachedMemCopy(pvData, &psCmdHelperData->pPreTimestampAddr.ui32Addr,
+						sizeof(psCmdHelperData->pPreTimestampAddr.ui32Addr));
+	}
+
+	/* The DM command data itself is not part of the image */
+	if (psCmdHelperData->ui32DMCmdSize)
+	{
+		PVR_ASSERT(psCmdHelperData->ui32DMCmdSize == sizeof(RGXFWIF_CCB_CMD_HEADER) + psCmdHelperData->ui32CmdSize);
+
+		psLayout->ui32DMHeaderOffset = psLayout->ui32ImageSize;
+		_CmdLayoutAddHeader(psLayout, psCmdHelperData->eType, psCmdHelperData->ui32DMCmdSize,
+							sizeof(RGXFWIF_CCB_CMD_HEADER));
+	}
+	psLayout->ui32PreDMSize = psLayout->ui32ImageSize;
+
+	if (psCmdHelperData->ui32PostTimeStampCmdSize != 0)
+	{
+		pvData = _CmdLayoutAddHeader(psLayout, RGXFWIF_CCB_CMD_TYPE_POST_TIMESTAMP,
+									 psCmdHelperData->ui32PostTimeStampCmdSize,
+									 psCmdHelperData->ui32PostTimeStampCmdSize);
+		OSCachedMemCopy(pvData, &psCmdHelperData->pPostTimestampAddr.ui32Addr,
+						sizeof(psCmdHelperData->pPostTimestampAddr.ui32Addr));
+	}
+
+	if (psCmdHelperData->ui32RMWUFOCmdSize != 0)
+	{
+		RGXFWIF_UFO sUFO;
+
+		sUFO.puiAddrUFO = psCmdHelperData->pRMWUFOAddr;
+		sUFO.ui32Value = 0;
+
+		pvData = _CmdLayoutAddHeader(psLayout, RGXFWIF_CCB_CMD_TYPE_RMW_UPDATE,
+									 psCmdHelperData->ui32RMWUFOCmdSize,
+									 psCmdHelperData->ui32RMWUFOCmdSize);
+		OSCachedMemCopy(pvData, &sUFO, sizeof(sUFO));
+	}
+
+	if (psCmdHelperData->ui32ClientUpdateCount > 0)
+	{
+		IMG_UINT32 ui32UpdateCmdSize =
+			RGX_CCB_FWALLOC_ALIGN(psCmdHelperData->ui32ClientUpdateCount * sizeof(RGXFWIF_UFO) +
+								  sizeof(RGXFWIF_CCB_CMD_HEADER));
+
+		psLayout->ui32UpdateUFOOffset = psLayout->ui32ImageSize + sizeof(RGXFWIF_CCB_CMD_HEADER);
+		_CmdLayoutAddHeader(psLayout, RGXFWIF_CCB_CMD_TYPE_UPDATE,
+							ui32UpdateCmdSize, ui32UpdateCmdSize);
+	}
+
+	PVR_ASSERT(psLayout->ui32ImageSize + psCmdHelperData->ui32DMCmdSize - sizeof(RGXFWIF_CCB_CMD_HEADER) ==
+	           psCmdHelperData->ui32TotalSize);
+}
+
+/*
+	Fill in client fence or update UFOs. Sync checkpoints are always
+	checked for and set to the signalled state, so pui32Value only holds
+	values for sync prims.
+*/
+static void _CmdLayoutWriteUFOs(PVRSRV_RGXDEV_INFO *psDevInfo,
+								const RGX_CCB_CMD_HELPER_DATA *psCmdHelperData,
+								RGXFWIF_UFO *psUFOs,
+								IMG_UINT32 ui32Count,
+								const PRGXFWIF_UFO_ADDR *pauiUFOAddress,
+								const IMG_UINT32 *paui32Value,
+								const IMG_CHAR *pszKind)
+{
+	IMG_UINT k, uiNextValueIndex = 0;
+
+	PVR_UNREFERENCED_PARAMETER(psDevInfo);
+	PVR_UNREFERENCED_PARAMETER(psCmdHelperData);
+	PVR_UNREFERENCED_PARAMETER(pszKind);
+
+	for (k = 0; k < ui32Count; k++)
+	{
+		PVR_ASSERT(k < RGXFWIF_CCB_CMD_MAX_UFOS);
+
+		psUFOs[k].puiAddrUFO = pauiUFOAddress[k];
+
+		if (PVRSRV_UFO_IS_SYNC_CHECKPOINT_FWADDR(pauiUFOAddress[k].ui32Addr))
+		{
+			psUFOs[k].ui32Value = PVRSRV_SYNC_CHECKPOINT_SIGNALLED;
+		}
+		else
+		{
+			psUFOs[k].ui32Value = paui32Value[uiNextValueIndex++];
+		}
+
+#if defined(SYNC_COMMAND_DEBUG)
+		PVR_DPF((PVR_DBG_ERROR, "%s client sync %s - 0x%x -> 0x%x",
+				psCmdHelperData->psClientCCB->szName, pszKind,
+				psUFOs[k].puiAddrUFO.ui32Addr, psUFOs[k].ui32Value));
 #endif
+		PDUMPCOMMENT(psDevInfo->psDeviceNode,
+					 ".. %s client sync %s - 0x%x -> 0x%x",
+					 psCmdHelperData->psClientCCB->szName, pszKind,
+					 psUFOs[k].puiAddrUFO.ui32Addr, psUFOs[k].ui32Value);
+	}
+}
 
-	OSCachedMemCopy(pvCCB, &sCmdHeader, sizeof(RGXFWIF_CCB_CMD_HEADER));
+/*
+	Patch the per kick fields of the command image and write it to the CCB
+	around the DM command data.
+*/
+static void _CmdLayoutWrite(PVRSRV_RGXDEV_INFO *psDevInfo,
+							RGX_CCB_CMD_LAYOUT *psLayout,
+							const RGX_CCB_CMD_HELPER_DATA *psCmdHelperData,
+							void *pvCmdPtr)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < psLayout->ui32HeaderCount; i++)
+	{
+		RGXFWIF_CCB_CMD_HEADER *psCmdHeader =
+			IMG_OFFSET_ADDR(psLayout->aui64Image, psLayout->aui32HeaderOffset[i]);
 
+		psCmdHeader->ui32ExtJobRef = psCmdHelperData->ui32ExtJobRef;
+		psCmdHeader->ui32IntJobRef = psCmdHelperData->ui32IntJobRef;
+	}
+
+	if (psCmdHelperData->ui32DMCmdSize)
+	{
+		RGXSetCmdHeaderWorkEst(IMG_OFFSET_ADDR(psLayout->aui64Image, psLayout->ui32DMHeaderOffset),
+							   (PVRSRV_VZ_MODE_IS(GUEST, DEVINFO, psDevInfo)) ? NULL : psCmdHelperData->psWorkEstKickData);
+	}
+
+	_CmdLayoutWriteUFOs(psDevInfo, psCmdHelperData,
+						IMG_OFFSET_ADDR(psLayout->aui64Image, psLayout->ui32FenceUFOOffset),
+						psCmdHelperData->ui32ClientFenceCount,
+						psCmdHelperData->pauiFenceUFOAddress,
+						psCmdHelperData->paui32FenceValue,
+						"fence");
+	_CmdLayoutWriteUFOs(psDevInfo, psCmdHelperData,
+						IMG_OFFSET_ADDR(psLayout->aui64Image, psLayout->ui32UpdateUFOOffset),
+						psCmdHelperData->ui32ClientUpdateCount,
+						psCmdHelperData->pauiUpdateUFOAddress,
+						psCmdHelperData->paui32UpdateValue,
+						"update");
+
+	OSCachedMemCopy(pvCmdPtr, psLayout->aui64Image, psLayout->ui32PreDMSize);
+	pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psLayout->ui32PreDMSize);
+
+	if (psCmdHelperData->ui32DMCmdSize)
+	{
+		OSCachedMemCopy(pvCmdPtr, psCmdHelperData->pui8DMCmd, psCmdHelperData->ui32CmdSize);
+		pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psCmdHelperData->ui32DMCmdSize - sizeof(RGXFWIF_CCB_CMD_HEADER));
+	}
+
+	OSCachedMemCopy(pvCmdPtr, IMG_OFFSET_ADDR(psLayout->aui64Image, psLayout->ui32PreDMSize),
+					psLayout->ui32ImageSize - psLayout->ui32PreDMSize);
 }
 
 /*
@@ -1899,7 +2386,7 @@ PVRSRV_ERROR RGXCmdHelperAcquireCmdCCB(IMG_UINT32 ui32CmdCount,
 	void *pvStartPtr;
 	PVRSRV_ERROR eError;
 	PVRSRV_RGXDEV_INFO *psDevInfo = FWCommonContextGetRGXDevInfo(asCmdHelperData->psClientCCB->psServerCommonContext);
-	RGXFWIF_UFO asUFOs[RGXFWIF_CCB_CMD_MAX_UFOS];
+	RGX_CLIENT_CCB *psClientCCB = asCmdHelperData[0].psClientCCB;
 
 	/*
 		Check the number of fences & updates are valid.
@@ -1915,6 +2402,19 @@ PVRSRV_ERROR RGXCmdHelperAcquireCmdCCB(IMG_UINT32 ui32CmdCount,
 		}
 	}
 
+	/*
+		Layouts are kept per position in the acquire. Anything beyond the
+		cache shares the last layout, which is rebuilt whenever it differs.
+	*/
+	for (i = 0; i < MIN(ui32CmdCount, RGX_CCB_CMD_LAYOUT_CACHE_SIZE); i++)
+	{
+		if (psClientCCB->apsCmdLayout[i] == NULL)
+		{
+			psClientCCB->apsCmdLayout[i] = OSAllocZMem(sizeof(RGX_CCB_CMD_LAYOUT));
+			PVR_RETURN_IF_NOMEM(psClientCCB->apsCmdLayout[i]);
+		}
+	}
+
 	/*
 		Work out how much space we need for all the command(s)
 	*/
@@ -1947,6 +2447,13 @@ PVRSRV_ERROR RGXCmdHelperAcquireCmdCCB(IMG_UINT32 ui32CmdCount,
 		return eError;
 	}
 
+#if defined(NO_HARDWARE)
+	/* The build ends in RGXCmdHelperReleaseCmdCCB. Retries for space are
+	 * not counted, and a build abandoned after this point is replaced by
+	 * the next one. */
+	asCmdHelperData[0].psClientCCB->ui64KickStartNs = OSClockns64();
+#endif
+
 	/*
 		For each command fill in the fence, DM, and update command
 
@@ -1954,7 +2461,7 @@ PVRSRV_ERROR RGXCmdHelperAcquireCmdCCB(IMG_UINT32 ui32CmdCount,
 	for (i = 0; i < ui32CmdCount; i++)
 	{
 		RGX_CCB_CMD_HELPER_DATA *psCmdHelperData = & asCmdHelperData[i];
-		void *pvCmdPtr;
+		RGX_CCB_CMD_LAYOUT *psLayout;
 #if defined(PDUMP)
 		IMG_UINT32 ui32CtxAddr = FWCommonContextGetFWAddress(asCmdHelperData->psClientCCB->psServerCommonContext).ui32Addr;
 		IMG_UINT32 ui32CcbWoff = RGXGetHostWriteOffsetCCB(FWCommonContextGetClientCCB(asCmdHelperData->psClientCCB->psServerCommonContext));
@@ -1967,207 +2474,21 @@ PVRSRV_ERROR RGXCmdHelperAcquireCmdCCB(IMG_UINT32 ui32CmdCount,
 						 psCmdHelperData->psClientCCB->szName, i, ui32CtxAddr, ui32CcbWoff);
 		}
 
-		pvCmdPtr = pvStartPtr;
-
-		/*
-			Create the fence command.
-		*/
-		if (psCmdHelperData->ui32ClientFenceCount > 0)
-		{
-			IMG_UINT k, uiNextValueIndex;
-			IMG_UINT32 ui32FenceCmdSize =
-				RGX_CCB_FWALLOC_ALIGN(psCmdHelperData->ui32ClientFenceCount * sizeof(RGXFWIF_UFO) +
-									  sizeof(RGXFWIF_CCB_CMD_HEADER));
-
-			RGXWriteCmdHeader(pvCmdPtr,
-							  RGXFWIF_CCB_CMD_TYPE_FENCE,
-							  ui32FenceCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  NULL);
-
-			/* Fill in the client fences */
-			uiNextValueIndex = 0;
-			for (k = 0; k < psCmdHelperData->ui32ClientFenceCount; k++)
-			{
-				PVR_ASSERT(k < RGXFWIF_CCB_CMD_MAX_UFOS);
-
-				asUFOs[k].puiAddrUFO = psCmdHelperData->pauiFenceUFOAddress[k];
-
-				if (PVRSRV_UFO_IS_SYNC_CHECKPOINT_FWADDR(psCmdHelperData->pauiFenceUFOAddress[k].ui32Addr))
-				{
-					asUFOs[k].ui32Value = PVRSRV_SYNC_CHECKPOINT_SIGNALLED;
-				}
-				else
-				{
-					/* Only increment uiNextValueIndex for non sync checkpoints
-					 * (as paui32FenceValue only contains values for sync prims)
-					 */
-					asUFOs[k].ui32Value = psCmdHelperData->paui32FenceValue[uiNextValueIndex++];
-				}
-
-#if defined(SYNC_COMMAND_DEBUG)
-				PVR_DPF((PVR_DBG_ERROR, "%s client sync fence - 0x%x -> 0x%x",
-						psCmdHelperData->psClientCCB->szName, asUFOs[k].puiAddrUFO.ui32Addr, asUFOs[k].ui32Value));
-#endif
-				PDUMPCOMMENT(psDevInfo->psDeviceNode,
-							 ".. %s client sync fence - 0x%x -> 0x%x",
-							 psCmdHelperData->psClientCCB->szName,
-							 asUFOs[k].puiAddrUFO.ui32Addr, asUFOs[k].ui32Value);
-
-
-			}
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							&asUFOs, psCmdHelperData->ui32ClientFenceCount * sizeof(RGXFWIF_UFO));
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, ui32FenceCmdSize);
-		}
-
-		/*
-			Create the FBSC invalidate command.
-		*/
-		if (psCmdHelperData->ui32FBSCInvalCmdSize)
-		{
-
-			RGXWriteCmdHeader(pvCmdPtr,
-							  RGXFWIF_CCB_CMD_TYPE_FBSC_INVALIDATE,
-							  psCmdHelperData->ui32FBSCInvalCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  NULL);
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							&psCmdHelperData->ui64FBSCEntryMask,
-							sizeof(psCmdHelperData->ui64FBSCEntryMask));
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psCmdHelperData->ui32FBSCInvalCmdSize);
-		}
-
-		/*
-		  Create the pre DM timestamp commands. Pre and Post timestamp commands are supposed to
-		  sandwich the DM cmd. The padding code with the CCB wrap upsets the FW if we don't have
-		  the task type bit cleared for POST_TIMESTAMPs. That's why we have 2 different cmd types.
-		*/
-		if (psCmdHelperData->ui32PreTimeStampCmdSize != 0)
-		{
-			RGXWriteCmdHeader(pvCmdPtr,
-							  RGXFWIF_CCB_CMD_TYPE_PRE_TIMESTAMP,
-							  psCmdHelperData->ui32PreTimeStampCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  NULL);
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							&psCmdHelperData->pPreTimestampAddr.ui32Addr,
-							sizeof(psCmdHelperData->pPreTimestampAddr.ui32Addr));
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psCmdHelperData->ui32PreTimeStampCmdSize);
-
-		}
-
-		/*
-			Create the DM command
-		*/
-		if (psCmdHelperData->ui32DMCmdSize)
-		{
-			PVR_ASSERT(psCmdHelperData->ui32DMCmdSize == sizeof(RGXFWIF_CCB_CMD_HEADER) + psCmdHelperData->ui32CmdSize);
-
-			RGXWriteCmdHeader(pvCmdPtr,
-							  psCmdHelperData->eType,
-							  psCmdHelperData->ui32DMCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  (PVRSRV_VZ_MODE_IS(GUEST, DEVINFO, psDevInfo)) ? NULL : psCmdHelperData->psWorkEstKickData);
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							psCmdHelperData->pui8DMCmd,
-							psCmdHelperData->ui32CmdSize);
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psCmdHelperData->ui32DMCmdSize);
-		}
-
-
-		if (psCmdHelperData->ui32PostTimeStampCmdSize != 0)
+		psLayout = psClientCCB->apsCmdLayout[MIN(i, RGX_CCB_CMD_LAYOUT_CACHE_SIZE - 1)];
+		if (_CmdLayoutMatches(psLayout, psCmdHelperData))
 		{
-			RGXWriteCmdHeader(pvCmdPtr,
-							  RGXFWIF_CCB_CMD_TYPE_POST_TIMESTAMP,
-							  psCmdHelperData->ui32PostTimeStampCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  NULL);
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							&psCmdHelperData->pPostTimestampAddr.ui32Addr,
-							sizeof(psCmdHelperData->pPostTimestampAddr.ui32Addr));
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psCmdHelperData->ui32PostTimeStampCmdSize);
-
+			psClientCCB->ui32CmdLayoutHits++;
 		}
-
-
-		if (psCmdHelperData->ui32RMWUFOCmdSize != 0)
+		else
 		{
-			RGXWriteCmdHeader(pvCmdPtr,
-							  RGXFWIF_CCB_CMD_TYPE_RMW_UPDATE,
-							  psCmdHelperData->ui32RMWUFOCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  NULL);
-
-			asUFOs[0].puiAddrUFO = psCmdHelperData->pRMWUFOAddr;
-			asUFOs[0].ui32Value = 0;
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							asUFOs, sizeof(RGXFWIF_UFO));
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, psCmdHelperData->ui32RMWUFOCmdSize);
+			_CmdLayoutBuild(psLayout, psCmdHelperData);
+			psClientCCB->ui32CmdLayoutMisses++;
 		}
 
 		/*
-			Create the update command.
+			Write the fence, DM, and update commands from the layout
 		*/
-		if (psCmdHelperData->ui32ClientUpdateCount > 0)
-		{
-			IMG_UINT k, uiNextValueIndex;
-			IMG_UINT32 ui32UpdateCmdSize =
-				RGX_CCB_FWALLOC_ALIGN(psCmdHelperData->ui32ClientUpdateCount * sizeof(RGXFWIF_UFO) +
-									  sizeof(RGXFWIF_CCB_CMD_HEADER));
-			RGXWriteCmdHeader(pvCmdPtr,
-							  RGXFWIF_CCB_CMD_TYPE_UPDATE,
-							  ui32UpdateCmdSize,
-							  psCmdHelperData->ui32ExtJobRef,
-							  psCmdHelperData->ui32IntJobRef,
-							  NULL);
-
-			/* Fill in the client updates */
-			uiNextValueIndex = 0;
-			for (k = 0; k < psCmdHelperData->ui32ClientUpdateCount; k++)
-			{
-				PVR_ASSERT(k < RGXFWIF_CCB_CMD_MAX_UFOS);
-
-				asUFOs[k].puiAddrUFO = psCmdHelperData->pauiUpdateUFOAddress[k];
-				if (PVRSRV_UFO_IS_SYNC_CHECKPOINT_FWADDR(psCmdHelperData->pauiUpdateUFOAddress[k].ui32Addr))
-				{
-					asUFOs[k].ui32Value = PVRSRV_SYNC_CHECKPOINT_SIGNALLED;
-				}
-				else
-				{
-					/* Only increment uiNextValueIndex for non sync checkpoints
-					 * (as paui32UpdateValue only contains values for sync prims)
-					 */
-					asUFOs[k].ui32Value = psCmdHelperData->paui32UpdateValue[uiNextValueIndex++];
-				}
-
-#if defined(SYNC_COMMAND_DEBUG)
-				PVR_DPF((PVR_DBG_ERROR, "%s client sync update - 0x%x -> 0x%x",
-						psCmdHelperData->psClientCCB->szName, asUFOs[k].puiAddrUFO.ui32Addr, asUFOs[k].ui32Value));
-#endif
-				PDUMPCOMMENT(psDevInfo->psDeviceNode,
-							 ".. %s client sync update - 0x%x -> 0x%x",
-							 psCmdHelperData->psClientCCB->szName,
-							 asUFOs[k].puiAddrUFO.ui32Addr, asUFOs[k].ui32Value);
-
-			}
-
-			OSCachedMemCopy(IMG_OFFSET_ADDR(pvCmdPtr, sizeof(RGXFWIF_CCB_CMD_HEADER)),
-							&asUFOs, psCmdHelperData->ui32ClientUpdateCount * sizeof(RGXFWIF_UFO));
-			pvCmdPtr = IMG_OFFSET_ADDR(pvCmdPtr, ui32UpdateCmdSize);
-		}
+		_CmdLayoutWrite(psDevInfo, psLayout, psCmdHelperData, pvStartPtr);
 
 		/* Set the start pointer for the next iteration around the loop */
 		pvStartPtr = IMG_OFFSET_ADDR(pvStartPtr, psCmdHelperData->ui32TotalSize);
@@ -2266,6 +2587,19 @@ void RGXCmdHelperReleaseCmdCCB(IMG_UINT32 ui32CmdCount,
 				  asCmdHelperData[0].ui32PDumpFlags);
 
 	BIT_UNSET(asCmdHelperData[0].psClientCCB->ui32CCBFlags, CCB_FLAGS_CCB_STATE_OPEN);
+
+#if defined(NO_HARDWARE)
+	{
+		RGX_CLIENT_CCB *psClientCCB = asCmdHelperData[0].psClientCCB;
+
+		if (psClientCCB->ui64KickStartNs != 0)
+		{
+			psClientCCB->ui64KickTimeNs += OSClockns64() - psClientCCB->ui64KickStartNs;
+			psClientCCB->ui32KickCount++;
+			psClientCCB->ui64KickStartNs = 0;
+		}
+	}
+#endif
 }
 
 IMG_UINT32 RGXCmdHelperGetCommandSize(IMG_UINT32              ui32CmdCount,
@@ -2461,6 +2795,35 @@ PVRSRV_ERROR CheckForStalledCCB(PVRSRV_DEVICE_NODE *psDevNode, RGX_CLIENT_CCB *p
 	return eError;
 }
 
+#define CCB_SYNC_INFO_LEN 80
+
+/* Resolves the sync checkpoint records for a command's UFOs with a single
+ * acquisition of the record lock. String i of pszSyncInfos describes UFO i,
+ * entries for UFOs that are not sync checkpoints are left unused. */
+static void _DumpCCBLookupCheckpoints(PVRSRV_DEVICE_NODE *psDeviceNode,
+                                      void *pvClientCCBBuff,
+                                      IMG_UINT32 ui32WrapMask,
+                                      RGXFWIF_UFO *psUFOPtr,
+                                      IMG_UINT32 ui32NoOfUFOs,
+                                      IMG_UINT32 *pui32FwAddrs,
+                                      IMG_CHAR *pszSyncInfos)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; (i < ui32NoOfUFOs) && (i < RGXFWIF_CCB_CMD_MAX_UFOS); i++, psUFOPtr++)
+	{
+		if (((uintptr_t)psUFOPtr - (uintptr_t)pvClientCCBBuff + sizeof(RGXFWIF_UFO)) > ui32WrapMask+1)
+		{
+			break;
+		}
+
+		pui32FwAddrs[i] = PVRSRV_UFO_IS_SYNC_CHECKPOINT(psUFOPtr) ? psUFOPtr->puiAddrUFO.ui32Addr : 0;
+	}
+
+	SyncCheckpointRecordLookupBatch(psDeviceNode, i, pui32FwAddrs,
+	                                pszSyncInfos, CCB_SYNC_INFO_LEN);
+}
+
 void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 			PRGXFWIF_FWCOMMONCONTEXT sFWCommonContext,
 			RGX_CLIENT_CCB *psCurrentClientCCB,
@@ -2478,6 +2841,8 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 	IMG_CHAR * pszState = "Ready";
 	IMG_BOOL bFullSyncTracking =
 	    GetInfoPageDebugFlagsKM() & DEBUG_FEATURE_FULL_SYNC_TRACKING_ENABLED;
+	IMG_CHAR *pszSyncInfos = NULL;
+	IMG_UINT32 *pui32UFOFwAddrs = NULL;
 
 	/* Ensure hCCBGrowLock is acquired before reading
 	 * psCurrentClientCCB->pvClientCCB as a CCB grow
@@ -2504,6 +2869,30 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 	ui32WrapMask = RGXGetWrapMaskCCB(psCurrentClientCCB);
 
 	PVR_DUMPDEBUG_LOG("FWCtx 0x%08X (%s)", sFWCommonContext.ui32Addr, psCurrentClientCCB->szName);
+#if defined(PVRSRV_ENABLE_CCCB_GROW)
+	PVR_DUMPDEBUG_LOG("  Size %u (min %u, max %u), high watermark %u, full %u times, grown %u, shrunk %u",
+	                  psCurrentClientCCB->ui32Size, psCurrentClientCCB->ui32MinSize,
+	                  MAX(psCurrentClientCCB->ui32VirtualAllocSize, psCurrentClientCCB->ui32Size),
+	                  psCurrentClientCCB->ui32HighWaterMark, psCurrentClientCCB->ui32FullCount,
+	                  psCurrentClientCCB->ui32GrowCount, psCurrentClientCCB->ui32ShrinkCount);
+#else
+	PVR_DUMPDEBUG_LOG("  Size %u, high watermark %u, full %u times",
+	                  psCurrentClientCCB->ui32Size, psCurrentClientCCB->ui32HighWaterMark,
+	                  psCurrentClientCCB->ui32FullCount);
+#endif
+	PVR_DUMPDEBUG_LOG("  Command layouts reused %u times, built %u times",
+	                  psCurrentClientCCB->ui32CmdLayoutHits,
+	                  psCurrentClientCCB->ui32CmdLayoutMisses);
+#if defined(NO_HARDWARE)
+	if (psCurrentClientCCB->ui32KickCount != 0)
+	{
+		IMG_UINT32 ui32Remainder;
+
+		PVR_DUMPDEBUG_LOG("  Command build %" IMG_UINT64_FMTSPEC "ns over %u kicks (%" IMG_UINT64_FMTSPEC "ns per kick)",
+		                  psCurrentClientCCB->ui64KickTimeNs, psCurrentClientCCB->ui32KickCount,
+		                  OSDivide64r64(psCurrentClientCCB->ui64KickTimeNs, psCurrentClientCCB->ui32KickCount, &ui32Remainder));
+	}
+#endif
 
 	if (((ui32WrapMask & (ui32WrapMask+1)) != 0) ||
 	    (ui32WrapMask > ((1U<<MAX_SAFE_CCB_SIZE_LOG2)-1)))
@@ -2539,6 +2928,18 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 	{
 		PVR_DUMPDEBUG_LOG("  `--<Empty>");
 	}
+	else if (bFullSyncTracking)
+	{
+		/* Scratch space to resolve each command's checkpoints in one go,
+		 * falls back to per-UFO lookups if it cannot be allocated. */
+		pszSyncInfos = OSAllocMem(RGXFWIF_CCB_CMD_MAX_UFOS *
+		                          (CCB_SYNC_INFO_LEN + sizeof(IMG_UINT32)));
+		if (pszSyncInfos != NULL)
+		{
+			pui32UFOFwAddrs = IMG_OFFSET_ADDR(pszSyncInfos,
+			                                  RGXFWIF_CCB_CMD_MAX_UFOS * CCB_SYNC_INFO_LEN);
+		}
+	}
 
 	while (ui32Offset != ui32EndOffset)
 	{
@@ -2547,7 +2948,6 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 		IMG_UINT32 ui32NextOffset = (ui32Offset + ui32CmdSize + sizeof(RGXFWIF_CCB_CMD_HEADER)) & ui32WrapMask;
 		IMG_BOOL bLastCommand = (ui32NextOffset == ui32EndOffset)? IMG_TRUE: IMG_FALSE;
 		IMG_BOOL bLastUFO;
-		#define CCB_SYNC_INFO_LEN 80
 		IMG_CHAR pszSyncInfo[CCB_SYNC_INFO_LEN] = "";
 		IMG_UINT32 ui32NoOfUpdates, i;
 		RGXFWIF_UFO *psUFOPtr;
@@ -2580,6 +2980,13 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 			case RGXFWIF_CCB_CMD_TYPE_FENCE:
 			case RGXFWIF_CCB_CMD_TYPE_FENCE_PR:
 			{
+				if (bFullSyncTracking && pszSyncInfos != NULL)
+				{
+					_DumpCCBLookupCheckpoints(psDeviceNode, pvClientCCBBuff, ui32WrapMask,
+					                          psUFOPtr, ui32NoOfUpdates,
+					                          pui32UFOFwAddrs, pszSyncInfos);
+				}
+
 				for (i = 0; i < ui32NoOfUpdates; i++, psUFOPtr++)
 				{
 					if ((((uintptr_t)psUFOPtr - (uintptr_t)pvClientCCBBuff + sizeof(RGXFWIF_UFO)) > ui32WrapMask+1) ||
@@ -2595,8 +3002,16 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 					{
 						if (PVRSRV_UFO_IS_SYNC_CHECKPOINT(psUFOPtr))
 						{
-							SyncCheckpointRecordLookup(psDeviceNode, psUFOPtr->puiAddrUFO.ui32Addr,
-										pszSyncInfo, CCB_SYNC_INFO_LEN);
+							if (pszSyncInfos != NULL)
+							{
+								OSStringSafeCopy(pszSyncInfo, &pszSyncInfos[i * CCB_SYNC_INFO_LEN],
+								                 CCB_SYNC_INFO_LEN);
+							}
+							else
+							{
+								SyncCheckpointRecordLookup(psDeviceNode, psUFOPtr->puiAddrUFO.ui32Addr,
+											pszSyncInfo, CCB_SYNC_INFO_LEN);
+							}
 						}
 						else
 						{
@@ -2619,6 +3034,13 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 			}
 			case RGXFWIF_CCB_CMD_TYPE_RMW_UPDATE:
 			{
+				if (bFullSyncTracking && pszSyncInfos != NULL)
+				{
+					_DumpCCBLookupCheckpoints(psDeviceNode, pvClientCCBBuff, ui32WrapMask,
+					                          psUFOPtr, ui32NoOfUpdates,
+					                          pui32UFOFwAddrs, pszSyncInfos);
+				}
+
 				for (i = 0; i < ui32NoOfUpdates; i++, psUFOPtr++)
 				{
 					if ((((uintptr_t)psUFOPtr - (uintptr_t)pvClientCCBBuff + sizeof(RGXFWIF_UFO)) > ui32WrapMask+1) ||
@@ -2634,8 +3056,16 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 					{
 						if (PVRSRV_UFO_IS_SYNC_CHECKPOINT(psUFOPtr))
 						{
-							SyncCheckpointRecordLookup(psDeviceNode, psUFOPtr->puiAddrUFO.ui32Addr,
-										pszSyncInfo, CCB_SYNC_INFO_LEN);
+							if (pszSyncInfos != NULL)
+							{
+								OSStringSafeCopy(pszSyncInfo, &pszSyncInfos[i * CCB_SYNC_INFO_LEN],
+								                 CCB_SYNC_INFO_LEN);
+							}
+							else
+							{
+								SyncCheckpointRecordLookup(psDeviceNode, psUFOPtr->puiAddrUFO.ui32Addr,
+											pszSyncInfo, CCB_SYNC_INFO_LEN);
+							}
 						}
 						else
 						{
@@ -2682,6 +3112,11 @@ void DumpCCB(PVRSRV_RGXDEV_INFO *psDevInfo,
 		ui32Offset = ui32NextOffset;
 	}
 
+	if (pszSyncInfos != NULL)
+	{
+		OSFreeMem(pszSyncInfos);
+	}
+
 #if defined(PVRSRV_ENABLE_CCCB_GROW)
 	OSLockRelease(psCurrentClientCCB->hCCBGrowLock);
 #endif
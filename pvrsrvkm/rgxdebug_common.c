@@ -56,6 +56,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "rgxmmudefs_km.h"
 #include "rgxinit.h"
 #include "rgxfwutils.h"
+#include "rgxta3d.h"
 #include "rgxfwriscv.h"
 #include "rgxfwimageutils.h"
 #include "fwload.h"
@@ -67,6 +68,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #if defined(SUPPORT_SOC_TIMER)
 #include "rgxtimecorr.h"
 #endif
+#if defined(SUPPORT_WORKLOAD_ESTIMATION)
+#include "rgxworkest.h"
+#endif
 
 #define MAX_FW_DESCRIPTION_LENGTH	(600U)
 
@@ -1710,6 +1714,17 @@ static void _PrintFaultInfo(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
 		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_PRECEDING].ui64SearchCount,
 		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_FAULTED].ui64SearchCount,
 		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_NEXT].ui64SearchCount);
+		PVR_DUMPDEBUG_LOG("%s  Search Time (ns) -"
+		                  " PP:%"IMG_UINT64_FMTSPEC"%s"
+		                  " FP:%"IMG_UINT64_FMTSPEC"%s"
+		                  " NP:%"IMG_UINT64_FMTSPEC"%s",
+		                  pszIndent,
+		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_PRECEDING].ui64SearchTimeNs,
+		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_PRECEDING].bIndexed ? "(idx)" : "",
+		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_FAULTED].ui64SearchTimeNs,
+		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_FAULTED].bIndexed ? "(idx)" : "",
+		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_NEXT].ui64SearchTimeNs,
+		                  psInfo->asQueryOut[DEVICEMEM_HISTORY_QUERY_INDEX_NEXT].bIndexed ? "(idx)" : "");
 	}
 }
 
@@ -2970,6 +2985,15 @@ void RGXDebugRequestProcess(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
 			PVR_DUMPDEBUG_LOG("RGX Kernel CCB WO:0x%X RO:0x%X",
 							  psKCCBCtlLocal->ui32WriteOffset,
 							  psKCCBCtl->ui32ReadOffset);
+			PVR_DUMPDEBUG_LOG("RGX Kernel CCB cmds:%" IMG_UINT64_FMTSPEC
+							  " MTS kicks:%" IMG_UINT64_FMTSPEC
+							  " max cmds/kick:%u pending:%" IMG_UINT64_FMTSPEC
+							  "ns (max %" IMG_UINT64_FMTSPEC "ns)",
+							  psDevInfo->ui64KCCBCmdsSubmitted,
+							  psDevInfo->ui64KCCBDoorbells,
+							  psDevInfo->ui32KCCBMaxCmdsPerDoorbell,
+							  psDevInfo->ui64KCCBPendingTimeNs,
+							  psDevInfo->ui64KCCBMaxPendingTimeNs);
 		}
 	}
 
@@ -2987,6 +3011,11 @@ void RGXDebugRequestProcess(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
 		}
 	}
 
+	if (DD_VERB_LVL_ENABLED(ui32VerbLevel, DEBUG_REQUEST_VERBOSITY_MEDIUM))
+	{
+		RGXZSBufferWarmPoolStatsPrint(psDevInfo, pfnDumpDebugPrintf, pvDumpDebugFile);
+	}
+
 #if defined(SUPPORT_WORKLOAD_ESTIMATION)
 	if (!PVRSRV_VZ_MODE_IS(GUEST, DEVNODE, psDeviceNode))
 	{
@@ -3001,6 +3030,11 @@ void RGXDebugRequestProcess(DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
 							  psWorkEstCCBCtl->ui32WriteOffset,
 							  psWorkEstCCBCtlLocal->ui32ReadOffset);
 		}
+
+		if (DD_VERB_LVL_ENABLED(ui32VerbLevel, DEBUG_REQUEST_VERBOSITY_MEDIUM))
+		{
+			WorkEstStatsPrint(psDevInfo, pfnDumpDebugPrintf, pvDumpDebugFile);
+		}
 	}
 #endif
 
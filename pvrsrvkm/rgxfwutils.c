@@ -3638,6 +3638,97 @@ PVRSRV_ERROR RGXWaitForKCCBSlotUpdate(PVRSRV_RGXDEV_INFO *psDevInfo,
 	return eError;
 }
 
+/******************************************************************************
+ FUNCTION	: _RGXPublishKCCBWriteOffset
+
+ PURPOSE	: Make the commands written up to the local KCCB write offset
+		  visible to the firmware
+
+ PARAMETERS	: psDevInfo	RGX device info
+
+ RETURNS	: None
+******************************************************************************/
+static void _RGXPublishKCCBWriteOffset(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	RGXFWIF_CCB_CTL *psKCCBCtl = psDevInfo->psKernelCCBCtl;
+
+	psKCCBCtl->ui32WriteOffset = psDevInfo->psKernelCCBCtlLocal->ui32WriteOffset;
+	/* Read-back of memory before Kick MTS */
+	OSWriteMemoryBarrier(&psKCCBCtl->ui32WriteOffset);
+	RGXFwSharedMemCacheOpValue(psKCCBCtl->ui32WriteOffset, FLUSH);
+}
+
+/******************************************************************************
+ FUNCTION	: _RGXKickKCCB
+
+ PURPOSE	: Kick the MTS once for all the published but not yet kicked
+		  KCCB commands and account for them
+
+ PARAMETERS	: psDevInfo		RGX device info
+			: uiPDumpFlags	PDump flags
+
+ RETURNS	: None
+******************************************************************************/
+static void _RGXKickKCCB(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_UINT32 uiPDumpFlags)
+{
+	IMG_UINT64 ui64PendingNs;
+
+	PDUMPCOMMENTWITHFLAGS(psDevInfo->psDeviceNode, uiPDumpFlags, "MTS kick for kernel CCB");
+	/*
+	 * Kick the MTS to schedule the firmware.
+	 */
+#ifndef __CHECKER__
+	__MTSScheduleWrite(psDevInfo, RGXFWIF_DM_GP & ~RGX_CR_MTS_SCHEDULE_DM_CLRMSK);
+#else /* __CHECKER__ */
+	/* Because RGXFWIF_DM_GP is 0 Smatch reports that it's not needed to mask
+	 * it so for that situation make sure that it's indeed 0 and don't mask. */
+	static_assert(RGXFWIF_DM_GP == 0, "RGXFWIF_DM_GP not equal 0");
+	__MTSScheduleWrite(psDevInfo, RGXFWIF_DM_GP);
+#endif /* __CHECKER__ */
+
+	PDUMPREG32(psDevInfo->psDeviceNode, RGX_PDUMPREG_NAME, RGX_CR_MTS_SCHEDULE,
+	           RGXFWIF_DM_GP & ~RGX_CR_MTS_SCHEDULE_DM_CLRMSK, uiPDumpFlags);
+
+#if defined(SUPPORT_AUTOVZ)
+	RGXUpdateAutoVzWdgToken(psDevInfo);
+#endif
+
+#if defined(NO_HARDWARE)
+	/* keep the roff updated because fw isn't there to update it */
+	psDevInfo->psKernelCCBCtl->ui32ReadOffset = psDevInfo->psKernelCCBCtlLocal->ui32WriteOffset;
+#endif
+
+	ui64PendingNs = OSClockns64() - psDevInfo->ui64KCCBPendingSinceNs;
+	psDevInfo->ui64KCCBCmdsSubmitted += psDevInfo->ui32KCCBPendingCmds;
+	psDevInfo->ui64KCCBDoorbells++;
+	psDevInfo->ui64KCCBPendingTimeNs += ui64PendingNs;
+	psDevInfo->ui32KCCBMaxCmdsPerDoorbell = MAX(psDevInfo->ui32KCCBMaxCmdsPerDoorbell,
+	                                            psDevInfo->ui32KCCBPendingCmds);
+	psDevInfo->ui64KCCBMaxPendingTimeNs = MAX(psDevInfo->ui64KCCBMaxPendingTimeNs,
+	                                          ui64PendingNs);
+	psDevInfo->ui32KCCBPendingCmds = 0;
+}
+
+void RGXKCCBBatchBegin(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	PVR_ASSERT(PVRSRVPwrLockIsLockedByMe(psDevInfo->psDeviceNode));
+
+	psDevInfo->ui32KCCBBatchDepth++;
+}
+
+void RGXKCCBBatchEnd(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	PVR_ASSERT(PVRSRVPwrLockIsLockedByMe(psDevInfo->psDeviceNode));
+	PVR_ASSERT(psDevInfo->ui32KCCBBatchDepth != 0);
+
+	if ((--psDevInfo->ui32KCCBBatchDepth == 0) &&
+	    (psDevInfo->ui32KCCBPendingCmds != 0))
+	{
+		_RGXPublishKCCBWriteOffset(psDevInfo);
+		_RGXKickKCCB(psDevInfo, PDUMP_FLAGS_CONTINUOUS);
+	}
+}
+
 static PVRSRV_ERROR RGXSendCommandRaw(PVRSRV_RGXDEV_INFO  *psDevInfo,
 									  RGXFWIF_KCCB_CMD    *psKCCBCmd,
 									  IMG_UINT32          uiPDumpFlags,
@@ -3739,6 +3830,13 @@ static PVRSRV_ERROR RGXSendCommandRaw(PVRSRV_RGXDEV_INFO  *psDevInfo,
 	{
 		PVR_DPF((PVR_DBG_WARNING, "%s: Waiting on FW to catch up, ROff: %u, WOff: %u", __func__,
 		         psKCCBCtl->ui32ReadOffset, ui32OldWriteOffset));
+
+		/* The FW can only make space once it has seen what is batched up */
+		if (psDevInfo->ui32KCCBPendingCmds != 0)
+		{
+			_RGXPublishKCCBWriteOffset(psDevInfo);
+			_RGXKickKCCB(psDevInfo, uiPDumpFlags);
+		}
 		goto _RGXSendCommandRaw_Exit;
 	}
 
@@ -3780,10 +3878,24 @@ static PVRSRV_ERROR RGXSendCommandRaw(PVRSRV_RGXDEV_INFO  *psDevInfo,
 
 	/* Move past the current command */
 	psKCCBCtlLocal->ui32WriteOffset = ui32NewWriteOffset;
-	psKCCBCtl->ui32WriteOffset = ui32NewWriteOffset;
-	/* Read-back of memory before Kick MTS */
-	OSWriteMemoryBarrier(&psKCCBCtl->ui32WriteOffset);
-	RGXFwSharedMemCacheOpValue(psKCCBCtl->ui32WriteOffset, FLUSH);
+	if (psDevInfo->ui32KCCBPendingCmds++ == 0)
+	{
+		psDevInfo->ui64KCCBPendingSinceNs = OSClockns64();
+	}
+
+#if !defined(PDUMP)
+	/* Inside a batch leave the command for RGXKCCBBatchEnd() to publish,
+	 * unless the caller is about to wait on its slot or the batch is full.
+	 * PDump builds always publish so the capture matches the commands. */
+	if ((psDevInfo->ui32KCCBBatchDepth != 0) &&
+	    (pui32CmdKCCBSlot == NULL) &&
+	    (psDevInfo->ui32KCCBPendingCmds < RGX_KCCB_BATCH_MAX_CMDS))
+	{
+		goto _RGXSendCommandRaw_Exit;
+	}
+#endif
+
+	_RGXPublishKCCBWriteOffset(psDevInfo);
 
 #if defined(PDUMP)
 	if (bContCaptureOn)
@@ -3827,33 +3939,7 @@ static PVRSRV_ERROR RGXSendCommandRaw(PVRSRV_RGXDEV_INFO  *psDevInfo,
 #endif
 
 
-	PDUMPCOMMENTWITHFLAGS(psDeviceNode, uiPDumpFlags, "MTS kick for kernel CCB");
-	/*
-	 * Kick the MTS to schedule the firmware.
-	 */
-#ifndef __CHECKER__
-	__MTSScheduleWrite(psDevInfo, RGXFWIF_DM_GP & ~RGX_CR_MTS_SCHEDULE_DM_CLRMSK);
-#else /* __CHECKER__ */
-	/* Because RGXFWIF_DM_GP is 0 Smatch reports that it's not needed to mask
-	 * it so for that situation make sure that it's indeed 0 and don't mask. */
-	static_assert(RGXFWIF_DM_GP == 0, "RGXFWIF_DM_GP not equal 0");
-	__MTSScheduleWrite(psDevInfo, RGXFWIF_DM_GP);
-#endif /* __CHECKER__ */
-
-	PDUMPREG32(psDeviceNode, RGX_PDUMPREG_NAME, RGX_CR_MTS_SCHEDULE,
-	           RGXFWIF_DM_GP & ~RGX_CR_MTS_SCHEDULE_DM_CLRMSK, uiPDumpFlags);
-
-#if defined(SUPPORT_AUTOVZ)
-	RGXUpdateAutoVzWdgToken(psDevInfo);
-#endif
-
-#if defined(NO_HARDWARE)
-	/* keep the roff updated because fw isn't there to update it */
-	psKCCBCtl->ui32ReadOffset = psKCCBCtlLocal->ui32WriteOffset;
-#endif
-
-#if defined(RGX_FEATURE_SAFETY_IRQ_BIT_MASK) && defined(PVR_ARCH_VOLCANIC)
-#endif
+	_RGXKickKCCB(psDevInfo, uiPDumpFlags);
 
 _RGXSendCommandRaw_Exit:
 	return eError;
@@ -3928,7 +4014,7 @@ static void _FreeDeferredCommand(DLLIST_NODE *psNode, RGX_DEFERRED_KCCB_CMD *psD
  RETURNS	: PVRSRV_OK	If all commands in deferred list are sent to KCCB,
 			  PVRSRV_ERROR_KERNEL_CCB_FULL otherwise.
 ******************************************************************************/
-PVRSRV_ERROR RGXSendCommandsFromDeferredList(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_BOOL bPoll)
+static PVRSRV_ERROR _SendCommandsFromDeferredList(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_BOOL bPoll)
 {
 	PVRSRV_ERROR eError = PVRSRV_OK;
 	DLLIST_NODE *psNode, *psNext;
@@ -4014,6 +4100,18 @@ cleanup_:
 	return eError;
 }
 
+PVRSRV_ERROR RGXSendCommandsFromDeferredList(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_BOOL bPoll)
+{
+	PVRSRV_ERROR eError;
+
+	/* Publish the whole deferred list with a single MTS kick */
+	RGXKCCBBatchBegin(psDevInfo);
+	eError = _SendCommandsFromDeferredList(psDevInfo, bPoll);
+	RGXKCCBBatchEnd(psDevInfo);
+
+	return eError;
+}
+
 PVRSRV_ERROR RGXSendCommandAndGetKCCBSlot(PVRSRV_RGXDEV_INFO  *psDevInfo,
 										  RGXFWIF_KCCB_CMD    *psKCCBCmd,
 										  IMG_UINT32          uiPDumpFlags,
@@ -4030,6 +4128,7 @@ PVRSRV_ERROR RGXSendCommandAndGetKCCBSlot(PVRSRV_RGXDEV_INFO  *psDevInfo,
 	 * response from the FW just after the command is enqueued, so we must
 	 * poll for space to be available.
 	 */
+	RGXKCCBBatchBegin(psDevInfo);
 	eError = RGXSendCommandsFromDeferredList(psDevInfo, bPoll);
 	if (eError == PVRSRV_OK)
 	{
@@ -4038,6 +4137,7 @@ PVRSRV_ERROR RGXSendCommandAndGetKCCBSlot(PVRSRV_RGXDEV_INFO  *psDevInfo,
 								   uiPDumpFlags,
 								   pui32CmdKCCBSlot);
 	}
+	RGXKCCBBatchEnd(psDevInfo);
 
 	/*
 	 * If we don't manage to enqueue one of the deferred commands or the command
@@ -4304,11 +4404,14 @@ PVRSRV_ERROR _RGXScheduleCommandAndGetKCCBSlot(PVRSRV_RGXDEV_INFO  *psDevInfo,
 
 
 
+	/* The MMU cache command, if any, and the kick share one MTS kick */
+	RGXKCCBBatchBegin(psDevInfo);
 	eError = RGXPreKickCacheCommand(psDevInfo, eKCCBType, &uiMMUSyncUpdate);
-	if (unlikely(eError != PVRSRV_OK)) goto _PVRSRVSetDevicePowerStateKM_Exit;
-
-	eError = RGXSendCommandAndGetKCCBSlot(psDevInfo, psKCCBCmd, ui32PDumpFlags, pui32CmdKCCBSlot);
-	if (unlikely(eError != PVRSRV_OK)) goto _PVRSRVSetDevicePowerStateKM_Exit;
+	if (likely(eError == PVRSRV_OK))
+	{
+		eError = RGXSendCommandAndGetKCCBSlot(psDevInfo, psKCCBCmd, ui32PDumpFlags, pui32CmdKCCBSlot);
+	}
+	RGXKCCBBatchEnd(psDevInfo);
 
 _PVRSRVSetDevicePowerStateKM_Exit:
 _PVRSRVInvalidDeviceError_Exit:
@@ -5646,6 +5749,12 @@ PVRSRV_ERROR RGXUpdateHealthStatus(PVRSRV_DEVICE_NODE* psDevNode,
 		psDevInfo->ui32SLRHoldoffCounter--;
 	}
 
+	/* Release ZS buffer mappings that have not been reused in time (takes the power lock to invalidate) */
+	if (bCheckAfterTimePassed)
+	{
+		RGXZSBufferWarmPoolTrim(psDevInfo);
+	}
+
 	/* Take power lock, retry if it's in use in another task. */
 	eError = PVRSRVPowerTryLockWaitForTimeout(psDevNode);
 	if (eError == PVRSRV_ERROR_TIMEOUT)
@@ -709,6 +709,36 @@ PVRSRV_ERROR RGXSendCommandAndGetKCCBSlot(PVRSRV_RGXDEV_INFO *psDevInfo,
 #define RGXSendCommand(psDevInfo, psKCCBCmd, ui32PDumpFlags) \
   RGXSendCommandAndGetKCCBSlot(psDevInfo, psKCCBCmd, ui32PDumpFlags, NULL)
 
+/* Maximum number of KCCB commands published with a single MTS kick. Bounds
+ * how long the first command of a batch can wait for the FW to be woken. */
+#if !defined(RGX_KCCB_BATCH_MAX_CMDS)
+#define RGX_KCCB_BATCH_MAX_CMDS 8U
+#endif
+
+/*************************************************************************/ /*!
+@Function       RGXKCCBBatchBegin
+
+@Description    Opens a KCCB submission batch. Until the matching
+                RGXKCCBBatchEnd() the KCCB write offset is only published,
+                and the MTS kicked, every RGX_KCCB_BATCH_MAX_CMDS commands
+                or when a command needs its kCCB slot. Batches nest and
+                must be closed before the power lock is released.
+
+@Input          psDevInfo       Device Info
+*/ /**************************************************************************/
+void RGXKCCBBatchBegin(PVRSRV_RGXDEV_INFO *psDevInfo);
+
+/*************************************************************************/ /*!
+@Function       RGXKCCBBatchEnd
+
+@Description    Closes a KCCB submission batch. Closing the outermost batch
+                publishes the write offset for any pending commands and
+                kicks the MTS once for all of them.
+
+@Input          psDevInfo       Device Info
+*/ /**************************************************************************/
+void RGXKCCBBatchEnd(PVRSRV_RGXDEV_INFO *psDevInfo);
+
 /*************************************************************************/ /*!
 @Function       _RGXScheduleCommandAndGetKCCBSlot
 
@@ -1803,7 +1803,7 @@ PVRSRV_ERROR RGXHWPerfHostInitOnDemandResources(PVRSRV_RGXDEV_INFO *psRgxDevInfo
 
 	eError = TLStreamCreate(&psRgxDevInfo->hHWPerfHostStream,
 	                        pszHWPerfHostStreamName, psRgxDevInfo->ui32HWPerfHostBufSize,
-	                        TL_OPMODE_DROP_NEWER,
+	                        TL_OPMODE_DROP_NEWER | TL_FLAG_MULTI_PRODUCER,
 	                        _HWPerfHostOnConnectCB, psRgxDevInfo,
 	                        NULL, NULL, NULL, NULL);
 	PVR_LOG_RETURN_IF_ERROR(eError, "TLStreamCreate");
@@ -2010,12 +2010,22 @@ static inline void _PostFunctionEpilogue(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	OSLockRelease(psRgxDevInfo->hLockHWPerfHostStream);
 }
 
-static inline IMG_UINT8 *_ReserveHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo, IMG_UINT32 ui32Size)
+/* Reserves space for the packet with the given ordinal and ends the ordered
+ * section started by _PostFunctionPrologue. The host stream is a
+ * multi-producer stream, so reservation order (and therefore ordinal order)
+ * is fixed here while the packet itself is filled in and committed without
+ * holding hLockHWPerfHostStream. */
+static inline IMG_UINT8 *_ReserveHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
+                                              IMG_UINT32 ui32Size,
+                                              IMG_UINT32 ui32Ordinal)
 {
 	IMG_UINT8 *pui8Dest;
 
-	PVRSRV_ERROR eError = TLStreamReserve(psRgxDevInfo->hHWPerfHostStream,
-	                                      &pui8Dest, ui32Size);
+	PVRSRV_ERROR eError = TLStreamReserveMP(psRgxDevInfo->hHWPerfHostStream,
+	                                        &pui8Dest, ui32Size);
+
+	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+
 	if (eError != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_MESSAGE, "%s: Could not reserve space in %s buffer"
@@ -2028,10 +2038,12 @@ static inline IMG_UINT8 *_ReserveHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	return pui8Dest;
 }
 
-static inline void _CommitHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo, IMG_UINT32 ui32Size)
+static inline void _CommitHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
+                                       IMG_UINT8 *pui8Dest,
+                                       IMG_UINT32 ui32Size)
 {
-	PVRSRV_ERROR eError = TLStreamCommit(psRgxDevInfo->hHWPerfHostStream,
-	                                     ui32Size);
+	PVRSRV_ERROR eError = TLStreamCommitMP(psRgxDevInfo->hHWPerfHostStream,
+	                                       pui8Dest, ui32Size);
 	if (eError != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_MESSAGE, "%s: Could not commit data to %s"
@@ -2043,8 +2055,15 @@ static inline void _CommitHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo, IMG_UIN
 static inline IMG_BOOL _WriteHWPerfStream(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
                                           RGX_HWPERF_V2_PACKET_HDR *psHeader)
 {
-	PVRSRV_ERROR eError = TLStreamWrite(psRgxDevInfo->hHWPerfHostStream,
-	                                    IMG_OFFSET_ADDR(psHeader, 0), psHeader->ui32Size);
+	IMG_UINT8 *pui8Dest;
+	PVRSRV_ERROR eError = TLStreamReserveMP(psRgxDevInfo->hHWPerfHostStream,
+	                                        &pui8Dest, psHeader->ui32Size);
+	if (eError == PVRSRV_OK)
+	{
+		OSDeviceMemCopy(pui8Dest, psHeader, psHeader->ui32Size);
+		eError = TLStreamCommitMP(psRgxDevInfo->hHWPerfHostStream,
+		                          pui8Dest, psHeader->ui32Size);
+	}
 	if (eError != PVRSRV_OK)
 	{
 		PVR_DPF((PVR_DBG_MESSAGE, "%s: Could not write packet in %s buffer"
@@ -2319,19 +2338,16 @@ void RGXHWPerfHostPostRaw(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
 	ui32PktSize = RGX_HWPERF_MAKE_SIZE_VARIABLE(ui32PayloadSize);
-	pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32PktSize);
+	pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32PktSize, ui32Ordinal);
 
 	if (pui8Dest == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, eEvType, ui32PktSize, ui32Ordinal, ui64Timestamp);
 	OSDeviceMemCopy((IMG_UINT8*)IMG_OFFSET_ADDR(pui8Dest, sizeof(RGX_HWPERF_V2_PACKET_HDR)), pbPayload, ui32PayloadSize);
-	_CommitHWPerfStream(psRgxDevInfo, ui32PktSize);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32PktSize);
 }
 
 void RGXHWPerfHostPostEnqEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
@@ -2358,9 +2374,9 @@ void RGXHWPerfHostPostEnqEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_ENQ, ui32Size,
@@ -2379,10 +2395,7 @@ void RGXHWPerfHostPostEnqEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	                        ui64DeadlineInus,
 	                        ui32CycleEstimate);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 static inline IMG_UINT32 _CalculateHostUfoPacketSize(RGX_HWPERF_UFO_EV eUfoType)
@@ -2483,9 +2496,9 @@ void RGXHWPerfHostPostUfoEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	{
 		_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
-		if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+		if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 		{
-			goto cleanup;
+			return;
 		}
 	}
 	else
@@ -2493,7 +2506,7 @@ void RGXHWPerfHostPostUfoEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 		if (pui8Dest == NULL)
 		{
 			// Give-up if we couldn't get a place in deferred events buffer
-			goto cleanup;
+			return;
 		}
 		pbPacketWritten = GET_DE_EVENT_WRITE_STATUS(pui8Dest);
 		pui8Dest = GET_DE_EVENT_DATA(pui8Dest);
@@ -2505,19 +2518,13 @@ void RGXHWPerfHostPostUfoEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 
 	if (bSleepAllowed)
 	{
-		_CommitHWPerfStream(psRgxDevInfo, ui32Size);
+		_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 	}
 	else
 	{
 		*pbPacketWritten = IMG_TRUE;
 		OSScheduleMISR(psRgxDevInfo->pvHostHWPerfMISR);
 	}
-
-cleanup:
-	if (bSleepAllowed)
-	{
-		_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
-	}
 }
 
 #define UNKNOWN_SYNC_NAME "UnknownSync"
@@ -2657,9 +2664,9 @@ void RGXHWPerfHostPostAllocEvent(PVRSRV_RGXDEV_INFO* psRgxDevInfo,
 
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_ALLOC, ui32Size,
@@ -2671,10 +2678,7 @@ void RGXHWPerfHostPostAllocEvent(PVRSRV_RGXDEV_INFO* psRgxDevInfo,
 	                          psName,
 	                          ui32NameSize);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 static inline void _SetupHostFreePacketData(IMG_UINT8 *pui8Dest,
@@ -2723,9 +2727,9 @@ void RGXHWPerfHostPostFreeEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	                              NULL, IMG_TRUE);
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_FREE, ui32Size,
@@ -2735,10 +2739,7 @@ void RGXHWPerfHostPostFreeEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	                         ui64UID,
 	                         ui32FWAddr);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 static inline IMG_UINT32 _FixNameAndCalculateHostModifyPacketSize(
@@ -2847,9 +2848,9 @@ void RGXHWPerfHostPostModifyEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	                              NULL, IMG_TRUE);
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_MODIFY, ui32Size,
@@ -2862,10 +2863,7 @@ void RGXHWPerfHostPostModifyEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	                           psName,
 	                           ui32NameSize);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 static inline void _SetupHostClkSyncPacketData(PVRSRV_RGXDEV_INFO *psRgxDevInfo, IMG_UINT8 *pui8Dest)
@@ -2907,19 +2905,16 @@ void RGXHWPerfHostPostClkSyncEvent(PVRSRV_RGXDEV_INFO *psRgxDevInfo)
 	                              NULL, IMG_TRUE);
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_CLK_SYNC, ui32Size,
 	                       ui32Ordinal, ui64Timestamp);
 	_SetupHostClkSyncPacketData(psRgxDevInfo, pui8Dest);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 static inline void _SetupHostDeviceInfoPacketData(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
@@ -3007,14 +3002,12 @@ void RGXHWPerfHostPostDeviceInfo(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 		_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 		ui32Size = _CalculateHostDeviceInfoPacketSize(eEvType);
 
-		if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) != NULL)
+		if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) != NULL)
 		{
 			_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_DEV_INFO, ui32Size, ui32Ordinal, ui64Timestamp);
 			_SetupHostDeviceInfoPacketData(psRgxDevInfo, eEvType, puData, pui8Dest);
-			_CommitHWPerfStream(psRgxDevInfo, ui32Size);
+			_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 		}
-
-		_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
 	}
 
 	OSLockRelease(psRgxDevInfo->hHWPerfLock);
@@ -3102,15 +3095,13 @@ void RGXHWPerfHostPostInfo(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 
 		ui32Size = _CalculateHostInfoPacketSize(eEvType, &ui64TotalMemoryUsage, &ui32LivePids, &psPerProcessMemUsage);
 
-		if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) != NULL)
+		if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) != NULL)
 		{
 			_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_INFO, ui32Size, ui32Ordinal, ui64Timestamp);
 			_SetupHostInfoPacketData(eEvType, ui64TotalMemoryUsage, ui32LivePids, psPerProcessMemUsage, pui8Dest);
-			_CommitHWPerfStream(psRgxDevInfo, ui32Size);
+			_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 		}
 
-		_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
-
 		if (psPerProcessMemUsage)
 			OSFreeMemNoStats(psPerProcessMemUsage); // psPerProcessMemUsage was allocated with OSAllocZMemNoStats
 	}
@@ -3190,19 +3181,16 @@ void RGXHWPerfHostPostFenceWait(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
 	ui32Size = _CalculateHostFenceWaitPacketSize(eType);
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_SYNC_FENCE_WAIT,
 	                       ui32Size, ui32Ordinal, ui64Timestamp);
 	_SetupHostFenceWaitPacketData(pui8Dest, eType, uiPID, hFence, ui32Data);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 static inline IMG_UINT32 _CalculateHostSWTimelineAdvPacketSize(void)
@@ -3242,20 +3230,16 @@ void RGXHWPerfHostPostSWTimelineAdv(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	_PostFunctionPrologue(psRgxDevInfo, ui32Ordinal);
 
 	ui32Size = _CalculateHostSWTimelineAdvPacketSize();
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_SYNC_SW_TL_ADVANCE,
 	                       ui32Size, ui32Ordinal, ui64Timestamp);
 	_SetupHostSWTimelineAdvPacketData(pui8Dest, uiPID, hSWTimeline, ui64SyncPtIndex);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
-
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 void RGXHWPerfHostPostClientInfoProcName(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
@@ -3276,9 +3260,9 @@ void RGXHWPerfHostPostClientInfoProcName(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	ui32Size = RGX_HWPERF_MAKE_SIZE_VARIABLE(RGX_HWPERF_HOST_CLIENT_INFO_PROC_NAME_BASE_SIZE
 		+ RGX_HWPERF_HOST_CLIENT_PROC_NAME_SIZE(ui32NameLen));
 
-	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size)) == NULL)
+	if ((pui8Dest = _ReserveHWPerfStream(psRgxDevInfo, ui32Size, ui32Ordinal)) == NULL)
 	{
-		goto cleanup;
+		return;
 	}
 
 	_SetupHostPacketHeader(pui8Dest, RGX_HWPERF_HOST_CLIENT_INFO,
@@ -3291,10 +3275,7 @@ void RGXHWPerfHostPostClientInfoProcName(PVRSRV_RGXDEV_INFO *psRgxDevInfo,
 	psPkt->uDetail.sProcName.asProcNames[0].ui32Length = ui32NameLen;
 	(void)OSCachedMemCopy(psPkt->uDetail.sProcName.asProcNames[0].acName, psName, ui32NameLen);
 
-	_CommitHWPerfStream(psRgxDevInfo, ui32Size);
-
-cleanup:
-	_PostFunctionEpilogue(psRgxDevInfo, ui32Ordinal);
+	_CommitHWPerfStream(psRgxDevInfo, pui8Dest, ui32Size);
 }
 
 /******************************************************************************
@@ -68,6 +68,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "sync.h"
 #endif
 
+/* Age after which a pending batch of deferred MMU cache invalidations is
+ * flushed by the next deferrable kick rather than waiting for a GPU kick */
+#define RGX_MMU_CACHE_INVAL_BATCH_DEADLINE_NS (1000ULL * 1000ULL)
+
 typedef struct _CACHE_INVAL_WAITCOND_DATA_
 {
 	IMG_UINT32 uiSyncValExpected;
@@ -241,6 +245,19 @@ PVRSRV_ERROR _PrepareAndSubmitCacheCommand(PVRSRV_DEVICE_NODE *psDeviceNode,
 					 __func__, eDM, eError));
 			psDeviceNode->ui32NextMMUInvalidateUpdate--;
 		}
+		else
+		{
+			/* Whatever was batched up has now been sent */
+			psDeviceNode->sMMUCacheInvalStats.ui64BatchStartNs = 0;
+			if (bInterrupt)
+			{
+				psDeviceNode->sMMUCacheInvalStats.ui64Issued++;
+			}
+			else
+			{
+				psDeviceNode->sMMUCacheInvalStats.ui64Piggybacked++;
+			}
+		}
 
 		if (!PVRSRVIsRetryError(eError))
 		{
@@ -255,11 +272,13 @@ PVRSRV_ERROR _PrepareAndSubmitCacheCommand(PVRSRV_DEVICE_NODE *psDeviceNode,
 
 static
 PVRSRV_ERROR _CacheInvalidateKick(PVRSRV_DEVICE_NODE *psDeviceNode,
+                                  IMG_BOOL bDeferrable,
                                   IMG_UINT32 *pui32MMUInvalidateUpdate)
 {
 	PVRSRV_ERROR eError;
 	IMG_UINT32 ui32FWCacheFlags;
 	PVRSRV_RGXDEV_INFO *psDevInfo = (PVRSRV_RGXDEV_INFO *)psDeviceNode->pvDevice;
+	MMU_CACHE_INVAL_STATS *psStats = &psDeviceNode->sMMUCacheInvalStats;
 	eError = PVRSRVPowerLock(psDeviceNode);
 	if (eError != PVRSRV_OK)
 	{
@@ -268,6 +287,8 @@ PVRSRV_ERROR _CacheInvalidateKick(PVRSRV_DEVICE_NODE *psDeviceNode,
 		goto RGXMMUCacheInvalidateKick_exit;
 	}
 
+	psStats->ui64Requested++;
+
 	/*
 	 * Atomically clear flags to ensure we never accidentally read state
 	 * inconsistently or overwrite valid cache flags with 0.
@@ -285,6 +306,28 @@ PVRSRV_ERROR _CacheInvalidateKick(PVRSRV_DEVICE_NODE *psDeviceNode,
 		goto _PowerUnlockAndReturnErr;
 	}
 
+	if (bDeferrable)
+	{
+		IMG_UINT64 ui64Now = OSClockns64();
+
+		if (psStats->ui64BatchStartNs == 0)
+		{
+			psStats->ui64BatchStartNs = ui64Now;
+		}
+
+		if (ui64Now - psStats->ui64BatchStartNs < RGX_MMU_CACHE_INVAL_BATCH_DEADLINE_NS)
+		{
+			/* Leave the flags pending. Whichever command flushes them,
+			 * a GPU kick or a later kick past the deadline, is the next
+			 * one queued so it will carry the current next update value. */
+			MMU_AppendCacheFlags(psDevInfo->psKernelMMUCtx, ui32FWCacheFlags);
+			*pui32MMUInvalidateUpdate = psDeviceNode->ui32NextMMUInvalidateUpdate;
+			psStats->ui64Coalesced++;
+			eError = PVRSRV_ERROR_CMD_NOT_PROCESSED;
+			goto _PowerUnlockAndReturnErr;
+		}
+	}
+
 	/* Ensure device is powered up before sending cache command */
 	PDUMPPOWCMDSTART(psDeviceNode);
 	eError = PVRSRVSetDevicePowerStateKM(psDeviceNode,
@@ -306,6 +349,10 @@ PVRSRV_ERROR _CacheInvalidateKick(PVRSRV_DEVICE_NODE *psDeviceNode,
 		goto _PutCacheFlags;
 	}
 
+	PVRSRVPowerUnlock(psDeviceNode);
+
+	return PVRSRV_OK;
+
 _PutCacheFlags:
 	MMU_AppendCacheFlags(psDevInfo->psKernelMMUCtx, ui32FWCacheFlags);
 _PowerUnlockAndReturnErr:
@@ -318,7 +365,14 @@ RGXMMUCacheInvalidateKick_exit:
 PVRSRV_ERROR RGXMMUCacheInvalidateKick(PVRSRV_DEVICE_NODE *psDeviceNode,
                                        IMG_UINT32 *pui32MMUInvalidateUpdate)
 {
-	PVRSRV_ERROR eError = _CacheInvalidateKick(psDeviceNode, pui32MMUInvalidateUpdate);
+	PVRSRV_ERROR eError = _CacheInvalidateKick(psDeviceNode, IMG_FALSE, pui32MMUInvalidateUpdate);
+	return eError == PVRSRV_ERROR_CMD_NOT_PROCESSED ? PVRSRV_OK : eError;
+}
+
+PVRSRV_ERROR RGXMMUCacheInvalidateKickDeferred(PVRSRV_DEVICE_NODE *psDeviceNode,
+                                               IMG_UINT32 *pui32MMUInvalidateUpdate)
+{
+	PVRSRV_ERROR eError = _CacheInvalidateKick(psDeviceNode, IMG_TRUE, pui32MMUInvalidateUpdate);
 	return eError == PVRSRV_ERROR_CMD_NOT_PROCESSED ? PVRSRV_OK : eError;
 }
 
@@ -139,6 +139,24 @@ void RGXMMUCacheInvalidate(PVRSRV_DEVICE_NODE *psDevNode,
 PVRSRV_ERROR RGXMMUCacheInvalidateKick(PVRSRV_DEVICE_NODE *psDevNode,
                                        IMG_UINT32 *pui32NextMMUInvalidateUpdate);
 
+/*************************************************************************/ /*!
+@Function       RGXMMUCacheInvalidateKickDeferred
+
+@Description    As RGXMMUCacheInvalidateKick() but, for callers that poll
+                the returned update value anyway, allows the flush to be
+                folded into a pending batch. The batch is sent ahead of the
+                next GPU kick, or by the first deferred kick made after the
+                batch deadline has expired.
+
+@Input          psDevNode   Device Node pointer
+@Output         pui32NextMMUInvalidateUpdate  Value the MMU cache sync prim
+                                              reaches once the flush is done
+
+@Return			PVRSRV_ERROR
+*/ /**************************************************************************/
+PVRSRV_ERROR RGXMMUCacheInvalidateKickDeferred(PVRSRV_DEVICE_NODE *psDevNode,
+                                               IMG_UINT32 *pui32NextMMUInvalidateUpdate);
+
 /*************************************************************************/ /*!
 @Function       RGXMMUCacheInvalidateKickAndWait
 
@@ -50,6 +50,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "device.h"
 #include "hash.h"
 #include "pvr_debug.h"
+#include "pvr_notifier.h"
 #if defined(SUPPORT_SOC_TIMER)
 #include "rgxtimecorr.h"
 #endif
@@ -228,6 +229,220 @@ IMG_UINT32 WorkEstHashFuncTDM(size_t uKeySize, void *pKey, IMG_UINT32 uHashTabLe
 	return ui32HashKey;
 }
 
+/*! Model features for TA/3D workload estimation */
+static IMG_UINT32 WorkEstFeaturesTA3D(const RGX_WORKLOAD *psWorkload, IMG_UINT32 *aui32Features)
+{
+	aui32Features[0] = _WorkEstClampFeature(psWorkload->sTA3D.ui32RenderTargetSize >> 10);
+	aui32Features[1] = _WorkEstClampFeature(psWorkload->sTA3D.ui32NumberOfDrawCalls);
+	aui32Features[2] = _WorkEstClampFeature(psWorkload->sTA3D.ui32NumberOfIndices >> 8);
+	aui32Features[3] = _WorkEstClampFeature(psWorkload->sTA3D.ui32NumberOfMRTs);
+	aui32Features[4] = WORKLOAD_MODEL_BIAS_FEATURE;
+
+	return 5;
+}
+
+/*! Model features for compute workload estimation */
+static IMG_UINT32 WorkEstFeaturesCompute(const RGX_WORKLOAD *psWorkload, IMG_UINT32 *aui32Features)
+{
+	aui32Features[0] = _WorkEstClampFeature(psWorkload->sCompute.ui32NumberOfWorkgroups >> 4);
+	aui32Features[1] = _WorkEstClampFeature(psWorkload->sCompute.ui32NumberOfWorkitems);
+	aui32Features[2] = WORKLOAD_MODEL_BIAS_FEATURE;
+
+	return 3;
+}
+
+/*! Model features for TDM/transfer workload estimation. The second
+ *  characteristic is a pixel format ID, which has no linear relation to
+ *  the cycle count, so only the destination size is used. */
+static IMG_UINT32 WorkEstFeaturesTDM(const RGX_WORKLOAD *psWorkload, IMG_UINT32 *aui32Features)
+{
+	aui32Features[0] = _WorkEstClampFeature(psWorkload->sTransfer.ui32Characteristic1 >> 10);
+	aui32Features[1] = WORKLOAD_MODEL_BIAS_FEATURE;
+
+	return 2;
+}
+
+/* Bounds keep every weight/feature product and their sum within 63 bits */
+#define WORKLOAD_MODEL_MAX_WEIGHT	(IMG_INT64_C(1) << 44)
+#define WORKLOAD_MODEL_MAX_ERROR	(IMG_INT64_C(1) << 31)
+/* NLMS step size of 1/4 */
+#define WORKLOAD_MODEL_STEP_SHIFT	(WORKLOAD_MODEL_FRAC_BITS - 2)
+
+static IMG_UINT64 _WorkEstModelPredict(const WORKLOAD_MODEL *psModel,
+                                       const IMG_UINT32 *aui32Features,
+                                       IMG_UINT32 ui32NumFeatures)
+{
+	IMG_INT64 i64Prediction = 0;
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32NumFeatures; i++)
+	{
+		i64Prediction += psModel->ai64Weights[i] * (IMG_INT64)aui32Features[i];
+	}
+
+	return (i64Prediction > 0) ? (IMG_UINT64)i64Prediction >> WORKLOAD_MODEL_FRAC_BITS : 0;
+}
+
+/*************************************************************************/ /*!
+@Function       _WorkEstModelEstimate
+@Description    Predicts the cycles of a workload with no exact match.
+                Must be called with the matching data hash lock held.
+@Return         Predicted cycles, or 0 if the model is not yet trained.
+*/ /**************************************************************************/
+static IMG_UINT64 _WorkEstModelEstimate(const WORKLOAD_MODEL *psModel,
+                                        const RGX_WORKLOAD *psWorkload)
+{
+	IMG_UINT32 aui32Features[WORKLOAD_MODEL_MAX_FEATURES];
+	IMG_UINT32 ui32NumFeatures;
+
+	if (psModel->pfnFeatures == NULL ||
+	    psModel->ui32Samples < WORKLOAD_MODEL_MIN_SAMPLES)
+	{
+		return 0;
+	}
+
+	ui32NumFeatures = psModel->pfnFeatures(psWorkload, aui32Features);
+
+	return _WorkEstModelPredict(psModel, aui32Features, ui32NumFeatures);
+}
+
+/*************************************************************************/ /*!
+@Function       _WorkEstModelTrain
+@Description    Normalised LMS update of the model with a completed workload:
+                w += mu * err * x / |x|^2. Integer only, as the update runs in
+                the firmware CCB processing path.
+                Must be called with the matching data hash lock held.
+*/ /**************************************************************************/
+static void _WorkEstModelTrain(WORKLOAD_MODEL *psModel,
+                               const RGX_WORKLOAD *psWorkload,
+                               IMG_UINT64 ui64ActualCycles)
+{
+	IMG_UINT32 aui32Features[WORKLOAD_MODEL_MAX_FEATURES];
+	IMG_UINT32 ui32NumFeatures;
+	IMG_UINT64 ui64SumSquares = 0;
+	IMG_INT64 i64Error;
+	IMG_UINT64 ui64AbsError;
+	IMG_UINT32 ui32Remainder;
+	IMG_UINT32 i;
+
+	if (psModel->pfnFeatures == NULL)
+	{
+		return;
+	}
+
+	ui32NumFeatures = psModel->pfnFeatures(psWorkload, aui32Features);
+	PVR_ASSERT(ui32NumFeatures <= WORKLOAD_MODEL_MAX_FEATURES);
+
+	for (i = 0; i < ui32NumFeatures; i++)
+	{
+		ui64SumSquares += (IMG_UINT64)aui32Features[i] * aui32Features[i];
+	}
+
+	/* Features are clamped to 14 bits so the sum of squares fits the
+	 * 32-bit divisor of OSDivide64r64; the bias keeps it non-zero. */
+	PVR_ASSERT(ui64SumSquares > 0 && ui64SumSquares <= IMG_UINT32_MAX);
+
+	i64Error = (IMG_INT64)MIN(ui64ActualCycles, (IMG_UINT64)WORKLOAD_MODEL_MAX_ERROR) -
+	           (IMG_INT64)_WorkEstModelPredict(psModel, aui32Features, ui32NumFeatures);
+	i64Error = MAX(MIN(i64Error, WORKLOAD_MODEL_MAX_ERROR), -WORKLOAD_MODEL_MAX_ERROR);
+	ui64AbsError = (i64Error < 0) ? (IMG_UINT64)-i64Error : (IMG_UINT64)i64Error;
+
+	for (i = 0; i < ui32NumFeatures; i++)
+	{
+		IMG_INT64 i64Delta = (IMG_INT64)OSDivide64r64((ui64AbsError * aui32Features[i]) << WORKLOAD_MODEL_STEP_SHIFT,
+		                                              (IMG_UINT32)ui64SumSquares,
+		                                              &ui32Remainder);
+		IMG_INT64 i64Weight = psModel->ai64Weights[i] + ((i64Error < 0) ? -i64Delta : i64Delta);
+
+		psModel->ai64Weights[i] = MAX(MIN(i64Weight, WORKLOAD_MODEL_MAX_WEIGHT), -WORKLOAD_MODEL_MAX_WEIGHT);
+	}
+
+	if (psModel->ui32Samples < IMG_UINT32_MAX)
+	{
+		psModel->ui32Samples++;
+	}
+}
+
+static void _WorkEstUpdateErrorStats(PVRSRV_RGXDEV_INFO *psDevInfo,
+                                     const WORKEST_RETURN_DATA *psReturnData,
+                                     IMG_UINT64 ui64ActualCycles)
+{
+	WORKEST_ERROR_STATS *psStats;
+	RGXFWIF_DM eDM;
+
+	switch (psReturnData->eCmdType)
+	{
+		case RGXFWIF_CCB_CMD_TYPE_GEOM: eDM = RGXFWIF_DM_GEOM; break;
+		case RGXFWIF_CCB_CMD_TYPE_3D:   eDM = RGXFWIF_DM_3D;   break;
+		case RGXFWIF_CCB_CMD_TYPE_CDM:  eDM = RGXFWIF_DM_CDM;  break;
+		case RGXFWIF_CCB_CMD_TYPE_TQ_TDM: eDM = RGXFWIF_DM_TDM; break;
+#if defined(RGX_FEATURE_RAY_TRACING_ARCH_MAX_VALUE_IDX)
+		case RGXFWIF_CCB_CMD_TYPE_RAY:  eDM = RGXFWIF_DM_RAY;  break;
+#endif
+		default:
+			return;
+	}
+
+	psStats = &psDevInfo->aasWorkEstStats[eDM][psReturnData->ePredictionSource];
+	psStats->ui64Samples++;
+	psStats->ui64ActualCycles += ui64ActualCycles;
+
+	if (psReturnData->ePredictionSource == WORKEST_PREDICTION_NONE)
+	{
+		return;
+	}
+
+	if (psReturnData->ui64CyclesPredicted < ui64ActualCycles)
+	{
+		psStats->ui64AbsErrorCycles += ui64ActualCycles - psReturnData->ui64CyclesPredicted;
+		psStats->ui64Underestimates++;
+	}
+	else
+	{
+		psStats->ui64AbsErrorCycles += psReturnData->ui64CyclesPredicted - ui64ActualCycles;
+	}
+}
+
+void WorkEstStatsPrint(PVRSRV_RGXDEV_INFO *psDevInfo,
+                       DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
+                       void *pvDumpDebugFile)
+{
+	static const IMG_CHAR *const apszSourceNames[WORKEST_PREDICTION_SOURCE_COUNT] = {"none", "hash", "model"};
+	static const IMG_CHAR *const apszDMNames[RGXFWIF_DM_MAX] = {"GP", "TDM", "GEOM", "3D", "CDM", "RAY", "GEOM2", "GEOM3", "GEOM4"};
+	WORKEST_ERROR_STATS aasStats[RGXFWIF_DM_MAX][WORKEST_PREDICTION_SOURCE_COUNT];
+	IMG_UINT32 ui32DM, ui32Source;
+
+	if (psDevInfo->hWorkEstLock == NULL)
+	{
+		return;
+	}
+
+	OSLockAcquire(psDevInfo->hWorkEstLock);
+	memcpy(aasStats, psDevInfo->aasWorkEstStats, sizeof(aasStats));
+	OSLockRelease(psDevInfo->hWorkEstLock);
+
+	PVR_DUMPDEBUG_LOG("Workload estimation (samples / actual cycles / abs error cycles / underestimates):");
+
+	for (ui32DM = 0; ui32DM < RGXFWIF_DM_MAX; ui32DM++)
+	{
+		for (ui32Source = 0; ui32Source < WORKEST_PREDICTION_SOURCE_COUNT; ui32Source++)
+		{
+			WORKEST_ERROR_STATS *psStats = &aasStats[ui32DM][ui32Source];
+
+			if (psStats->ui64Samples == 0)
+			{
+				continue;
+			}
+
+			PVR_DUMPDEBUG_LOG("  %5s %-5s: %" IMG_UINT64_FMTSPEC " / %" IMG_UINT64_FMTSPEC
+			                  " / %" IMG_UINT64_FMTSPEC " / %" IMG_UINT64_FMTSPEC,
+			                  apszDMNames[ui32DM], apszSourceNames[ui32Source],
+			                  psStats->ui64Samples, psStats->ui64ActualCycles,
+			                  psStats->ui64AbsErrorCycles, psStats->ui64Underestimates);
+		}
+	}
+}
+
 void WorkEstHashLockCreate(POS_LOCK *ppsHashLock)
 {
 	if (*ppsHashLock == NULL)
@@ -280,6 +495,8 @@ PVRSRV_ERROR WorkEstPrepare(PVRSRV_RGXDEV_INFO        *psDevInfo,
 {
 	RGX_WORKLOAD          *psWorkloadCharacteristics;
 	IMG_UINT64            *pui64CyclePrediction;
+	IMG_UINT64            ui64CyclesPredicted;
+	WORKEST_PREDICTION_SOURCE ePredictionSource;
 	IMG_UINT64            ui64CurrentTime;
 	WORKEST_RETURN_DATA   *psReturnData;
 	IMG_UINT32            ui32ReturnDataWO;
@@ -371,11 +588,13 @@ PVRSRV_ERROR WorkEstPrepare(PVRSRV_RGXDEV_INFO        *psDevInfo,
 	psReturnData = &psDevInfo->asReturnData[ui32ReturnDataWO];
 	psReturnData->psWorkloadMatchingData = psWorkloadMatchingData;
 	psReturnData->psWorkEstHostData = psWorkEstHostData;
+	psReturnData->eCmdType = eDMCmdType;
+	psReturnData->ui64CyclesPredicted = 0;
+	psReturnData->ePredictionSource = WORKEST_PREDICTION_NONE;
 #if defined(PVRSRV_ANDROID_TRACK_WORKLOAD_ESTIMATES)
 	psReturnData->ui32Uid = OSGetCurrentClientProcessIDKM();
 	psReturnData->ui64SubmitTime = ui64CurrentTime;
 	psReturnData->ui64Deadline = ui64DeadlineInus;
-	psReturnData->eCmdType = eDMCmdType;
 #endif
 
 	/* The workload characteristic is needed in the return data for the matching
@@ -391,20 +610,38 @@ PVRSRV_ERROR WorkEstPrepare(PVRSRV_RGXDEV_INFO        *psDevInfo,
 	/* Check if there is a prediction for this workload */
 	pui64CyclePrediction = (IMG_UINT64*) HASH_Retrieve(psWorkloadMatchingData->psHashTable,
 													   (uintptr_t)psWorkloadCharacteristics);
+	if (pui64CyclePrediction != NULL)
+	{
+		ui64CyclesPredicted = *pui64CyclePrediction;
+		ePredictionSource = WORKEST_PREDICTION_HASH;
+	}
+	else
+	{
+		/* No exact match, fall back to the model for this DM */
+		ui64CyclesPredicted = _WorkEstModelEstimate(&psWorkloadMatchingData->sModel,
+		                                            psWorkloadCharacteristics);
+		ePredictionSource = (ui64CyclesPredicted > 0) ?
+		                    WORKEST_PREDICTION_MODEL : WORKEST_PREDICTION_NONE;
+	}
 
 	/* Release lock */
 	OSLockRelease(psWorkloadMatchingData->psHashLock);
 
-	if (pui64CyclePrediction != NULL)
+	/* The return data entry is owned by this kick until the firmware
+	 * returns it, so it can be updated without the work estimation lock */
+	psReturnData->ui64CyclesPredicted = ui64CyclesPredicted;
+	psReturnData->ePredictionSource = ePredictionSource;
+
+	if (ePredictionSource != WORKEST_PREDICTION_NONE)
 	{
 		/* Cycle prediction is available, store this prediction */
-		psWorkEstKickData->ui32CyclesPrediction = *pui64CyclePrediction;
+		psWorkEstKickData->ui32CyclesPrediction = (IMG_UINT32)MIN(ui64CyclesPredicted, (IMG_UINT64)IMG_UINT32_MAX);
 
 #if defined(PVRSRV_NEED_PVR_DPF)
-		if (*pui64CyclePrediction >= IMG_UINT32_MAX)
+		if (ui64CyclesPredicted >= IMG_UINT32_MAX)
 		{
 			PVR_DPF((PVR_DBG_WARNING, "Workload estimate overflow:"
-					" %" IMG_UINT64_FMTSPEC, *pui64CyclePrediction));
+					" %" IMG_UINT64_FMTSPEC, ui64CyclesPredicted));
 		}
 
 		switch (eDMCmdType)
@@ -416,21 +653,21 @@ PVRSRV_ERROR WorkEstPrepare(PVRSRV_RGXDEV_INFO        *psDevInfo,
 					 psWorkloadCharacteristics->sTA3D.ui32RenderTargetSize,
 					 psWorkloadCharacteristics->sTA3D.ui32NumberOfDrawCalls,
 					 psWorkloadCharacteristics->sTA3D.ui32NumberOfIndices,
-					 *pui64CyclePrediction));
+					 ui64CyclesPredicted));
 				break;
 			case RGXFWIF_CCB_CMD_TYPE_CDM:
 			PVR_DPF((PVR_DBG_MESSAGE, "%s: Number of workgroups = %u, max workgroup size = %u, prediction = " IMG_DEVMEM_SIZE_FMTSPEC,
 					 __func__,
 					 psWorkloadCharacteristics->sCompute.ui32NumberOfWorkgroups,
 					 psWorkloadCharacteristics->sCompute.ui32NumberOfWorkitems,
-					 *pui64CyclePrediction));
+					 ui64CyclesPredicted));
 				break;
 			case RGXFWIF_CCB_CMD_TYPE_TQ_TDM:
 			PVR_DPF((PVR_DBG_MESSAGE, "%s: Dest size = %u, Pixel format ID = %u, prediction = " IMG_DEVMEM_SIZE_FMTSPEC,
 					 __func__,
 					 psWorkloadCharacteristics->sTransfer.ui32Characteristic1,
 					 psWorkloadCharacteristics->sTransfer.ui32Characteristic2,
-					 *pui64CyclePrediction));
+					 ui64CyclesPredicted));
 				break;
 
 			default:
@@ -519,6 +756,14 @@ PVRSRV_ERROR WorkEstRetire(PVRSRV_RGXDEV_INFO *psDevInfo,
 	pasWorkloadHashKeys = psWorkloadMatchingData->asHashKeys;
 	ui32HashArrayWO = psWorkloadMatchingData->ui32HashArrayWO;
 
+	ui64ActualCyclesTaken = (IMG_UINT64)psReturnCmd->ui16CyclesTakenHigh << 32U;
+	ui64ActualCyclesTaken += psReturnCmd->ui32CyclesTaken;
+
+	_WorkEstUpdateErrorStats(psDevInfo, psReturnData, ui64ActualCyclesTaken);
+#if defined(PVRSRV_ANDROID_TRACK_WORKLOAD_ESTIMATES)
+	ui64CyclesPredicted = psReturnData->ui64CyclesPredicted;
+#endif
+
 	OSLockRelease(psDevInfo->hWorkEstLock);
 
 	OSLockAcquire(psWorkloadMatchingData->psHashLock);
@@ -536,8 +781,9 @@ PVRSRV_ERROR WorkEstRetire(PVRSRV_RGXDEV_INFO *psDevInfo,
 		(void) HASH_Remove(psWorkloadMatchingData->psHashTable, (uintptr_t)psWorkloadHashKey);
 	}
 
-	ui64ActualCyclesTaken = (IMG_UINT64)psReturnCmd->ui16CyclesTakenHigh << 32U;
-	ui64ActualCyclesTaken += psReturnCmd->ui32CyclesTaken;
+	_WorkEstModelTrain(&psWorkloadMatchingData->sModel,
+	                   psWorkloadCharacteristics,
+	                   ui64ActualCyclesTaken);
 
 	if (pui64CyclesTaken == NULL)
 	{
@@ -547,20 +793,16 @@ PVRSRV_ERROR WorkEstRetire(PVRSRV_RGXDEV_INFO *psDevInfo,
 		paui64WorkloadHashData[ui32HashArrayWO].ui16KbytesRead = psReturnCmd->ui16KbytesRead;
 		paui64WorkloadHashData[ui32HashArrayWO].ui16KbytesWritten = psReturnCmd->ui16KbytesWritten;
 		pasWorkloadHashKeys[ui32HashArrayWO] = *psWorkloadCharacteristics;
-#if defined(PVRSRV_ANDROID_TRACK_WORKLOAD_ESTIMATES)
-		ui64CyclesPredicted = 0;
-#endif
 	}
 	else
 	{
-		/* Found prior entry for workload characteristics, average with
-		 * completed; also reset the old value to 0 so it is known to be
-		 * invalid */
-#if defined(PVRSRV_ANDROID_TRACK_WORKLOAD_ESTIMATES)
-		ui64CyclesPredicted = *pui64CyclesTaken;
-#endif
-		paui64WorkloadHashData[ui32HashArrayWO].ui64Cycles = (*pui64CyclesTaken + ui64ActualCyclesTaken)/2;
-		/* TODO come up with a better averaging mechanism */
+		/* Found prior entry for workload characteristics, blend the
+		 * completed workload into the moving average so a single noisy
+		 * frame does not replace the history; also reset the old value
+		 * to 0 so it is known to be invalid */
+		paui64WorkloadHashData[ui32HashArrayWO].ui64Cycles = *pui64CyclesTaken -
+			(*pui64CyclesTaken >> WORKLOAD_EWMA_SHIFT) +
+			(ui64ActualCyclesTaken >> WORKLOAD_EWMA_SHIFT);
 		paui64WorkloadHashData[ui32HashArrayWO].ui16KbytesRead = psReturnCmd->ui16KbytesRead;
 		paui64WorkloadHashData[ui32HashArrayWO].ui16KbytesWritten = psReturnCmd->ui16KbytesWritten;
 		pasWorkloadHashKeys[ui32HashArrayWO] = *psWorkloadCharacteristics;
@@ -685,11 +927,16 @@ unlock_workest:
 void _WorkEstInit(PVRSRV_RGXDEV_INFO *psDevInfo,
 						 WORKLOAD_MATCHING_DATA *psWorkloadMatchingData,
 						 HASH_FUNC *pfnWorkEstHashFunc,
-						 HASH_KEY_COMP *pfnWorkEstHashCompare)
+						 HASH_KEY_COMP *pfnWorkEstHashCompare,
+						 WORKEST_FEATURE_FUNC *pfnWorkEstFeatures)
 {
 	HASH_TABLE *psWorkloadHashTable;
 	PVR_UNREFERENCED_PARAMETER(psDevInfo);
 
+	/* Untrained model, only used once it has seen enough workloads */
+	memset(&psWorkloadMatchingData->sModel, 0, sizeof(psWorkloadMatchingData->sModel));
+	psWorkloadMatchingData->sModel.pfnFeatures = pfnWorkEstFeatures;
+
 	/* Create a lock to protect the per-DM hash table */
 	WorkEstHashLockCreate(&psWorkloadMatchingData->psHashLock);
 
@@ -738,11 +985,13 @@ void WorkEstInitTA3D(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEst
 	_WorkEstInit(psDevInfo,
 		&psWorkEstData->uWorkloadMatchingData.sTA3D.sDataTA,
 		(HASH_FUNC *)WorkEstHashFuncTA3D,
-		(HASH_KEY_COMP *)WorkEstHashCompareTA3D);
+		(HASH_KEY_COMP *)WorkEstHashCompareTA3D,
+		WorkEstFeaturesTA3D);
 	_WorkEstInit(psDevInfo,
 		&psWorkEstData->uWorkloadMatchingData.sTA3D.sData3D,
 		(HASH_FUNC *)WorkEstHashFuncTA3D,
-		(HASH_KEY_COMP *)WorkEstHashCompareTA3D);
+		(HASH_KEY_COMP *)WorkEstHashCompareTA3D,
+		WorkEstFeaturesTA3D);
 }
 
 void WorkEstDeInitTA3D(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEstData)
@@ -756,7 +1005,8 @@ void WorkEstInitCompute(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWork
 	_WorkEstInit(psDevInfo,
 		&psWorkEstData->uWorkloadMatchingData.sCompute.sDataCDM,
 		(HASH_FUNC *)WorkEstHashFuncCompute,
-		(HASH_KEY_COMP *)WorkEstHashCompareCompute);
+		(HASH_KEY_COMP *)WorkEstHashCompareCompute,
+		WorkEstFeaturesCompute);
 }
 
 void WorkEstDeInitCompute(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEstData)
@@ -769,7 +1019,8 @@ void WorkEstInitTDM(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEstD
 	_WorkEstInit(psDevInfo,
 		&psWorkEstData->uWorkloadMatchingData.sTransfer.sDataTDM,
 		(HASH_FUNC *)WorkEstHashFuncTDM,
-		(HASH_KEY_COMP *)WorkEstHashCompareTDM);
+		(HASH_KEY_COMP *)WorkEstHashCompareTDM,
+		WorkEstFeaturesTDM);
 }
 
 void WorkEstDeInitTDM(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEstData)
@@ -78,14 +78,30 @@ void WorkEstHashLockDestroy(POS_LOCK psHashLock);
 
 void WorkEstCheckFirmwareCCB(PVRSRV_RGXDEV_INFO *psDevInfo);
 
+/*************************************************************************/ /*!
+@Function       WorkEstStatsPrint
+@Description    Prints the per-DM prediction error statistics of the hash
+                and model estimators.
+*/ /**************************************************************************/
+void WorkEstStatsPrint(PVRSRV_RGXDEV_INFO *psDevInfo,
+                       DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
+                       void *pvDumpDebugFile);
+
 void _WorkEstInit(PVRSRV_RGXDEV_INFO *psDevInfo,
 						 WORKLOAD_MATCHING_DATA *psWorkloadMatchingData,
 						 HASH_FUNC *pfnWorkEstHashFunc,
-						 HASH_KEY_COMP *pfnWorkEstHashCompare);
+						 HASH_KEY_COMP *pfnWorkEstHashCompare,
+						 WORKEST_FEATURE_FUNC *pfnWorkEstFeatures);
 
 void _WorkEstDeInit(PVRSRV_RGXDEV_INFO *psDevInfo,
 						 WORKLOAD_MATCHING_DATA *psWorkloadMatchingData);
 
 inline IMG_UINT32 _WorkEstDoHash(IMG_UINT32 ui32Input);
 
+/* Clamps a workload characteristic to the range of a model feature */
+static INLINE IMG_UINT32 _WorkEstClampFeature(IMG_UINT32 ui32Value)
+{
+	return MIN(ui32Value, WORKLOAD_MODEL_FEATURE_MAX);
+}
+
 #endif /* RGXWORKEST_H */
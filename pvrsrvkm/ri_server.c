@@ -313,7 +313,8 @@ static void _GenerateMEMDESCEntryString(RI_SUBLIST_ENTRY *psRISubEntry, IMG_BOOL
 /* Function used to produce string containing info for PMR RI entries (used for both debugfs and kernel log output) */
 static void _GeneratePMREntryString(RI_LIST_ENTRY *psRIEntry, IMG_BOOL bDebugFs, IMG_UINT16 ui16MaxStrLen, IMG_CHAR *pszEntryString);
 
-static PVRSRV_ERROR _DumpAllEntries (uintptr_t k, uintptr_t v, void* pvPriv);
+static PVRSRV_ERROR _CountAllEntries (uintptr_t k, uintptr_t v, void* pvPriv);
+static PVRSRV_ERROR _SnapshotAllEntries (uintptr_t k, uintptr_t v, void* pvPriv);
 static PVRSRV_ERROR _DeleteAllEntries (uintptr_t k, uintptr_t v, void* pvPriv);
 static PVRSRV_ERROR _DeleteAllProcEntries (uintptr_t k, uintptr_t v, void* pvPriv);
 static PVRSRV_ERROR _DumpList(PMR *psPMR, IMG_PID pid);
@@ -1490,291 +1491,501 @@ PVRSRV_ERROR RIDumpListKM(PMR *psPMR)
 	return eError;
 }
 
+/*
+ * Snapshots of RI entries.
+ *
+ * Readers which format a lot of entries (the per-process gpu_mem_area
+ * debugfs file and RIDumpAllKM) copy what they need into a snapshot while
+ * holding the RI lock, and format the copies after releasing it, so that
+ * RIWriteMEMDESCEntryKM/RIDeleteMEMDESCEntryKM from other processes are
+ * not held up by the output.
+ *
+ * The copies are regular RI_LIST_ENTRY/RI_SUBLIST_ENTRY structures so the
+ * existing string generators can be used on them. PMR copies always carry
+ * an RI_PMR_INFO (HAS_PMR_INFO) pointing at storage inside the snapshot and
+ * MEMDESC copies point at the copy of their parent PMR entry. None of the
+ * list nodes of a copy may be followed.
+ */
+typedef struct _RI_SNAPSHOT_PMR_
+{
+	RI_LIST_ENTRY sEntry;
+	RI_PMR_INFO   sPmrInfo;
+	IMG_CHAR      szAnnotation[DEVMEM_ANNOTATION_MAX_LEN];
+	/* MEMDESCs of this PMR, used when dumping every PMR */
+	IMG_UINT32    ui32FirstMemdesc;
+	IMG_UINT32    ui32NumMemdescs;
+} RI_SNAPSHOT_PMR;
+
+typedef struct _RI_SNAPSHOT_MEMDESC_
+{
+	RI_SUBLIST_ENTRY sEntry;
+	/* Annotation+(NUL)+ProcName+(NUL), plus a spare NUL for GET_PROC() */
+	IMG_CHAR         szTextB[RI_ANNO_BUF_SIZE + RI_PROC_BUF_SIZE + 1];
+} RI_SNAPSHOT_MEMDESC;
+
+typedef enum _RI_SNAPSHOT_STATE_
+{
+	RI_SNAPSHOT_STATE_MEMDESCS,
+	RI_SNAPSHOT_STATE_MEMDESCS_SUMMARY,
+	RI_SNAPSHOT_STATE_PMRS,
+	RI_SNAPSHOT_STATE_PMRS_SUMMARY,
+	RI_SNAPSHOT_STATE_END
+} RI_SNAPSHOT_STATE;
+
+struct _RI_SNAPSHOT_
+{
+	IMG_PID              pid;
+
+	/* The first ui32NumPMRs entries are listed, any after that are only
+	 * there as parents of MEMDESCs */
+	RI_SNAPSHOT_PMR      *pasPMRs;
+	IMG_UINT32           ui32NumPMRs;
+	IMG_UINT32           ui32NumParentPMRs;
+	IMG_UINT32           ui32MaxPMRs;
+
+	RI_SNAPSHOT_MEMDESC  *pasMemdescs;
+	IMG_UINT32           ui32NumMemdescs;
+	IMG_UINT32           ui32MaxMemdescs;
+
+	IMG_UINT64           ui64TotalMemdescAlloc;
+	IMG_UINT64           ui64TotalImport;
+	IMG_UINT64           ui64TotalPMRAlloc;
+	IMG_UINT64           ui64TotalPMRBacked;
+	IMG_CHAR             szMemdescProcName[RI_PROC_BUF_SIZE];
+	IMG_CHAR             szPMRProcName[RI_PROC_BUF_SIZE];
+
+	/* Iteration state for RIGetSnapshotEntryKM */
+	RI_SNAPSHOT_STATE    eState;
+	IMG_UINT32           ui32Next;
+	IMG_CHAR             acStringBuffer[RI_FRMT_SIZE_MAX];
+};
+
+/* Copies a PMR entry into psDst. Requires the RI lock. */
+static void _SnapshotPMREntry(RI_SNAPSHOT_PMR *psDst, RI_LIST_ENTRY *psSrc)
+{
+	RI_PMR_INFO *psPmrInfo = &psDst->sPmrInfo;
+
+	psDst->sEntry = *psSrc;
+
+	psPmrInfo->uiAddr = (uintptr_t)GET_ADDR(psSrc);
+	psPmrInfo->uiSerialNum = GET_SERIALNUM(psSrc);
+	psPmrInfo->psHeap = GET_HEAP(psSrc);
+	psPmrInfo->psDeviceNode = GET_DEVNODE(psSrc);
+	psPmrInfo->uiLogicalSize = GET_LOGICAL_SIZE(psSrc);
+	psPmrInfo->uiPhysicalSize = GET_PHYSICAL_SIZE(psSrc);
+#if defined(PVRSRV_ENABLE_XD_MEM)
+	psPmrInfo->uiXDevices = GET_XDEVICES(psSrc);
+#endif
+	OSStringSafeCopy(psDst->szAnnotation, GET_NAME(psSrc), sizeof(psDst->szAnnotation));
+	psPmrInfo->pszAnnotation = psDst->szAnnotation;
+
+	psDst->sEntry.pmr_info.psPmrInfo = psPmrInfo;
+	BIT_SET(psDst->sEntry.ui16Flags, RI_HAS_PMR_INFO);
+
+	psDst->ui32FirstMemdesc = 0;
+	psDst->ui32NumMemdescs = 0;
+}
+
+/* Copies a MEMDESC entry into psDst, psParent being the copy of its PMR
+ * entry (if any). Requires the RI lock. */
+static void _SnapshotMemdescEntry(RI_SNAPSHOT_MEMDESC *psDst,
+                                  RI_SUBLIST_ENTRY *psSrc,
+                                  RI_SNAPSHOT_PMR *psParent)
+{
+	IMG_UINT32 ui32TextBLength = MIN((IMG_UINT32)psSrc->ui16TextBLength,
+	                                 (IMG_UINT32)sizeof(psDst->szTextB) - 2);
+
+	psDst->sEntry = *psSrc;
+
+	/* pszTextB holds two NUL terminated strings, copy both. The last two
+	 * bytes are always left NUL so GET_PROC() stays within the copy. */
+	OSCachedMemSet(psDst->szTextB, 0, sizeof(psDst->szTextB));
+	OSCachedMemCopy(psDst->szTextB, psSrc->pszTextB, ui32TextBLength);
+	psDst->sEntry.pszTextB = psDst->szTextB;
+	psDst->sEntry.ui16TextBLength = ui32TextBLength;
+
+	psDst->sEntry.psRI = (psParent != NULL) ? &psParent->sEntry : NULL;
+}
+
+static RI_SNAPSHOT *_SnapshotAlloc(IMG_PID pid, IMG_UINT32 ui32MaxPMRs, IMG_UINT32 ui32MaxMemdescs)
+{
+	RI_SNAPSHOT *psSnapshot = OSAllocZMemNoStats(sizeof(*psSnapshot));
+
+	if (psSnapshot == NULL)
+	{
+		return NULL;
+	}
+
+	psSnapshot->pid = pid;
+	psSnapshot->ui32MaxPMRs = ui32MaxPMRs;
+	psSnapshot->ui32MaxMemdescs = ui32MaxMemdescs;
+
+	if (ui32MaxPMRs > 0)
+	{
+		psSnapshot->pasPMRs = OSAllocMemNoStats(ui32MaxPMRs * sizeof(*psSnapshot->pasPMRs));
+		if (psSnapshot->pasPMRs == NULL)
+		{
+			goto ErrFree;
+		}
+	}
+	if (ui32MaxMemdescs > 0)
+	{
+		psSnapshot->pasMemdescs = OSAllocMemNoStats(ui32MaxMemdescs * sizeof(*psSnapshot->pasMemdescs));
+		if (psSnapshot->pasMemdescs == NULL)
+		{
+			goto ErrFree;
+		}
+	}
+
+	return psSnapshot;
+
+ErrFree:
+	RIFreeSnapshotKM(psSnapshot);
+	return NULL;
+}
+
+static void _RISnapshotProcessLock(IMG_BOOL bSysAllocPid)
+{
+	_RILock();
+	if (bSysAllocPid)
+	{
+		OSLockAcquire(g_hSysAllocPidListLock);
+	}
+}
+
+static void _RISnapshotProcessUnlock(IMG_BOOL bSysAllocPid)
+{
+	if (bSysAllocPid)
+	{
+		OSLockRelease(g_hSysAllocPidListLock);
+	}
+	_RIUnlock();
+}
+
+/* Counts the entries RISnapshotProcessKM() copies for a process and returns
+ * the start of its MEMDESC list. Requires the locks taken by
+ * _RISnapshotProcessLock(). */
+static void _SnapshotCountProcess(IMG_PID pid,
+                                  IMG_BOOL bSysAllocPid,
+                                  DLLIST_NODE **ppsListStart,
+                                  IMG_UINT32 *pui32NumMemdescs,
+                                  IMG_UINT32 *pui32NumParents,
+                                  IMG_UINT32 *pui32NumPMRs)
+{
+	DLLIST_NODE *psListStart = NULL;
+	DLLIST_NODE *psNode;
+	IMG_UINT32 ui32NumMemdescs = 0;
+	IMG_UINT32 ui32NumParents = 0;
+	IMG_UINT32 ui32NumPMRs = 0;
+
+	/* The MEMDESC list of a process has no head node, the hash table points
+	 * at its first entry. */
+	if (g_PID2RISublistHashTable != NULL)
+	{
+		IMG_PID hashKey = pid;
+		psListStart = (DLLIST_NODE *)HASH_Retrieve_Extended(g_PID2RISublistHashTable, (void *)&hashKey);
+	}
+
+	psNode = psListStart;
+	while (psNode != NULL)
+	{
+		RI_SUBLIST_ENTRY *psRISubEntry = IMG_CONTAINER_OF(psNode, RI_SUBLIST_ENTRY, sProcListNode);
+
+		ui32NumMemdescs++;
+		if (psRISubEntry->psRI != NULL)
+		{
+			ui32NumParents++;
+		}
+
+		psNode = dllist_get_next_node(psNode);
+		if (psNode == psListStart)
+		{
+			break;
+		}
+	}
+
+	{
+		DLLIST_NODE *psHead = bSysAllocPid ? &g_sSysAllocPidListHead : &g_sClientsListHead;
+
+		for (psNode = dllist_get_next_node(psHead);
+		     psNode != NULL && psNode != psHead;
+		     psNode = dllist_get_next_node(psNode))
+		{
+			RI_LIST_ENTRY *psRIEntry = IMG_CONTAINER_OF(psNode, RI_LIST_ENTRY, sListNode);
+
+			if (bSysAllocPid || psRIEntry->pid == pid)
+			{
+				ui32NumPMRs++;
+			}
+		}
+	}
+
+	*ppsListStart = psListStart;
+	*pui32NumMemdescs = ui32NumMemdescs;
+	*pui32NumParents = ui32NumParents;
+	*pui32NumPMRs = ui32NumPMRs;
+}
+
 /*!
 *******************************************************************************
 
- @Function	RIGetListEntryKM
+ @Function	RISnapshotProcessKM
 
  @Description
-            Returns pointer to a formatted string with details of the specified
-            list entry. If no entry exists (e.g. it may have been deleted
-            since the previous call), NULL is returned.
+            Takes a snapshot of the MEMDESC and PMR RI entries of a process,
+            for output with RIGetSnapshotEntryKM(). The RI lock is only held
+            while the entries are counted and copied, the snapshot is
+            allocated without it. It must not be held by the caller.
 
  @input     pid - pid for which RI entry details are to be output
- @input     ppHandle - handle to the entry, if NULL, the first entry will be
-                     returned.
- @output    pszEntryString - string to be output for the entry
- @output    hEntry - hEntry will be returned pointing to the next entry
-                     (or NULL if there is no next entry)
+ @output    ppsSnapshot - the snapshot, to be freed with RIFreeSnapshotKM()
 
  @Return	PVRSRV_ERROR
 
 ******************************************************************************/
-IMG_BOOL RIGetListEntryKM(IMG_PID pid,
-						  IMG_HANDLE **ppHandle,
-						  IMG_CHAR **ppszEntryString)
+PVRSRV_ERROR RISnapshotProcessKM(IMG_PID pid, RI_SNAPSHOT **ppsSnapshot)
 {
-	RI_SUBLIST_ENTRY  *psRISubEntry = NULL;
-	RI_LIST_ENTRY  *psRIEntry = NULL;
-	uintptr_t     hashData = 0;
-	IMG_PID       hashKey  = pid;
-
-	static IMG_CHAR acStringBuffer[RI_FRMT_SIZE_MAX];
-
-	static IMG_UINT64 ui64TotalMemdescAlloc;
-	static IMG_UINT64 ui64TotalImport;
-	static IMG_UINT64 ui64TotalPMRAlloc;
-	static IMG_UINT64 ui64TotalPMRBacked;
-	static enum {
-		RI_GET_STATE_MEMDESCS_LIST_START,
-		RI_GET_STATE_MEMDESCS_SUMMARY,
-		RI_GET_STATE_PMR_LIST,
-		RI_GET_STATE_PMR_SUMMARY,
-		RI_GET_STATE_END,
-		RI_GET_STATE_LAST
-	} g_bNextGetState = RI_GET_STATE_MEMDESCS_LIST_START;
-
-	static DLLIST_NODE *psNode;
-	static DLLIST_NODE *psSysAllocNode;
-	static IMG_CHAR szProcName[RI_PROC_BUF_SIZE];
-	static IMG_UINT32 ui32ProcessedSysAllocPMRCount;
+	RI_SNAPSHOT *psSnapshot = NULL;
+	DLLIST_NODE *psListStart;
+	DLLIST_NODE *psNode;
+	IMG_UINT32 ui32NumMemdescs;
+	IMG_UINT32 ui32NumParents;
+	IMG_UINT32 ui32NumPMRs;
+	IMG_BOOL bSysAllocPid = (pid == PVR_SYS_ALLOC_PID);
 
-	acStringBuffer[0] = '\0';
+	PVR_LOG_RETURN_IF_INVALID_PARAM(ppsSnapshot, "ppsSnapshot");
 
-	switch (g_bNextGetState)
+	/* Size the snapshot and allocate it without holding the locks, then
+	 * take them again to fill it in. Entries may have been added in the
+	 * meantime, in which case the snapshot is sized again. */
+	for (;;)
 	{
-	case RI_GET_STATE_MEMDESCS_LIST_START:
-		/* look-up pid in Hash Table, to obtain first entry for pid */
-		hashData = HASH_Retrieve_Extended(g_PID2RISublistHashTable, (void *)&hashKey);
-		if (hashData)
-		{
-			if (*ppHandle)
-			{
-				psRISubEntry = (RI_SUBLIST_ENTRY *)*ppHandle;
-				if (!IS_VALID(psRISubEntry))
-				{
-					psRISubEntry = NULL;
-				}
-			}
-			else
-			{
-				psRISubEntry = IMG_CONTAINER_OF((PDLLIST_NODE)hashData, RI_SUBLIST_ENTRY, sProcListNode);
-				if (!IS_VALID(psRISubEntry))
-				{
-					psRISubEntry = NULL;
-				}
-			}
-		}
+		_RISnapshotProcessLock(bSysAllocPid);
+		_SnapshotCountProcess(pid, bSysAllocPid, &psListStart,
+		                      &ui32NumMemdescs, &ui32NumParents, &ui32NumPMRs);
 
-		if (psRISubEntry)
+		if (psSnapshot != NULL &&
+		    ui32NumPMRs + ui32NumParents <= psSnapshot->ui32MaxPMRs &&
+		    ui32NumMemdescs <= psSnapshot->ui32MaxMemdescs)
 		{
-			PDLLIST_NODE psNextProcListNode = dllist_get_next_node(&psRISubEntry->sProcListNode);
-
-			if (IS_IMPORT(psRISubEntry))
-			{
-				ui64TotalImport += psRISubEntry->ui64Size;
-			}
-			else
-			{
-				ui64TotalMemdescAlloc += psRISubEntry->ui64Size;
-			}
+			break;
+		}
 
-			_GenerateMEMDESCEntryString(psRISubEntry,
-										IMG_TRUE,
-										RI_MEMDESC_ENTRY_BUF_SIZE,
-										acStringBuffer);
+		_RISnapshotProcessUnlock(bSysAllocPid);
 
-			if (szProcName[0] == '\0')
-			{
-				OSStringSafeCopy(szProcName, (pid == PVR_SYS_ALLOC_PID) ?
-						PVRSRV_MODNAME : GET_PROC(psRISubEntry), RI_PROC_BUF_SIZE);
-			}
+		RIFreeSnapshotKM(psSnapshot);
+		psSnapshot = _SnapshotAlloc(pid, ui32NumPMRs + ui32NumParents, ui32NumMemdescs);
+		PVR_RETURN_IF_NOMEM(psSnapshot);
+	}
 
+	/* Copy the MEMDESCs, each with a copy of its parent PMR entry after the
+	 * PMRs listed for the process */
+	psNode = psListStart;
+	while (psNode != NULL && psSnapshot->ui32NumMemdescs < ui32NumMemdescs)
+	{
+		RI_SUBLIST_ENTRY *psRISubEntry = IMG_CONTAINER_OF(psNode, RI_SUBLIST_ENTRY, sProcListNode);
+		RI_SNAPSHOT_PMR *psParent = NULL;
 
-			*ppszEntryString = acStringBuffer;
-			*ppHandle        = (IMG_HANDLE)IMG_CONTAINER_OF(psNextProcListNode, RI_SUBLIST_ENTRY, sProcListNode);
+		if (psRISubEntry->psRI != NULL)
+		{
+			psParent = &psSnapshot->pasPMRs[ui32NumPMRs + psSnapshot->ui32NumParentPMRs++];
+			_SnapshotPMREntry(psParent, psRISubEntry->psRI);
+		}
+		_SnapshotMemdescEntry(&psSnapshot->pasMemdescs[psSnapshot->ui32NumMemdescs++],
+		                      psRISubEntry, psParent);
 
-			if (psNextProcListNode == NULL ||
-				psNextProcListNode == (PDLLIST_NODE)hashData)
-			{
-				g_bNextGetState = RI_GET_STATE_MEMDESCS_SUMMARY;
-			}
-			/* else continue to list MEMDESCs */
+		if (IS_IMPORT(psRISubEntry))
+		{
+			psSnapshot->ui64TotalImport += psRISubEntry->ui64Size;
 		}
 		else
 		{
-			if (ui64TotalMemdescAlloc == 0)
-			{
-				acStringBuffer[0] = '\0';
-				*ppszEntryString = acStringBuffer;
-				g_bNextGetState = RI_GET_STATE_MEMDESCS_SUMMARY;
-			}
-			/* else continue to list MEMDESCs */
+			psSnapshot->ui64TotalMemdescAlloc += psRISubEntry->ui64Size;
 		}
-		break;
 
-	case RI_GET_STATE_MEMDESCS_SUMMARY:
-		OSSNPrintf(acStringBuffer,
-		           RI_MEMDESC_SUM_BUF_SIZE,
-		           RI_MEMDESC_SUM_FRMT,
-		           pid,
-		           szProcName,
-		           ui64TotalMemdescAlloc,
-		           ui64TotalMemdescAlloc >> 10,
-		           ui64TotalImport,
-		           ui64TotalImport >> 10,
-		           (ui64TotalMemdescAlloc + ui64TotalImport),
-		           (ui64TotalMemdescAlloc + ui64TotalImport) >> 10);
-
-		*ppszEntryString = acStringBuffer;
-		ui64TotalMemdescAlloc = 0;
-		ui64TotalImport = 0;
-		szProcName[0] = '\0';
-
-		g_bNextGetState = RI_GET_STATE_PMR_LIST;
-		break;
+		if (psSnapshot->szMemdescProcName[0] == '\0')
+		{
+			OSStringSafeCopy(psSnapshot->szMemdescProcName,
+			                 bSysAllocPid ? PVRSRV_MODNAME : GET_PROC(psRISubEntry),
+			                 RI_PROC_BUF_SIZE);
+		}
 
-	case RI_GET_STATE_PMR_LIST:
-		if (pid == PVR_SYS_ALLOC_PID)
+		psNode = dllist_get_next_node(psNode);
+		if (psNode == psListStart)
 		{
-			OSLockAcquire(g_hSysAllocPidListLock);
-			acStringBuffer[0] = '\0';
-			if (!psSysAllocNode)
-			{
-				psSysAllocNode = &g_sSysAllocPidListHead;
-				ui32ProcessedSysAllocPMRCount = 0;
-			}
-			psSysAllocNode = dllist_get_next_node(psSysAllocNode);
+			break;
+		}
+	}
 
-			if (szProcName[0] == '\0')
-			{
-				OSStringSafeCopy(szProcName, PVRSRV_MODNAME, RI_PROC_BUF_SIZE);
-			}
-			if (psSysAllocNode != NULL && psSysAllocNode != &g_sSysAllocPidListHead)
-			{
-				psRIEntry = IMG_CONTAINER_OF((PDLLIST_NODE)psSysAllocNode, RI_LIST_ENTRY, sListNode);
-				_GeneratePMREntryString(psRIEntry,
-										IMG_TRUE,
-										RI_PMR_ENTRY_BUF_SIZE,
-										acStringBuffer);
-				ui64TotalPMRAlloc += GET_LOGICAL_SIZE(psRIEntry);
-				ui64TotalPMRBacked += GET_PHYSICAL_SIZE(psRIEntry);
-
-				ui32ProcessedSysAllocPMRCount++;
-				if (ui32ProcessedSysAllocPMRCount > g_ui32SysAllocPMRCount+1)
-				{
-					g_bNextGetState = RI_GET_STATE_PMR_SUMMARY;
-				}
-				/* else continue to list PMRs */
-			}
-			else
-			{
-				g_bNextGetState = RI_GET_STATE_PMR_SUMMARY;
-			}
-			*ppszEntryString = (IMG_CHAR *)acStringBuffer;
-			OSLockRelease(g_hSysAllocPidListLock);
+	/* Copy the PMRs attributed to the process */
+	{
+		DLLIST_NODE *psHead = bSysAllocPid ? &g_sSysAllocPidListHead : &g_sClientsListHead;
+
+		if (bSysAllocPid)
+		{
+			OSStringSafeCopy(psSnapshot->szPMRProcName, PVRSRV_MODNAME, RI_PROC_BUF_SIZE);
 		}
-		else
+
+		for (psNode = dllist_get_next_node(psHead);
+		     psNode != NULL && psNode != psHead && psSnapshot->ui32NumPMRs < ui32NumPMRs;
+		     psNode = dllist_get_next_node(psNode))
 		{
-			IMG_BOOL bPMRToDisplay = IMG_FALSE;
+			RI_LIST_ENTRY *psRIEntry = IMG_CONTAINER_OF(psNode, RI_LIST_ENTRY, sListNode);
 
-			/* Iterate through the 'touched' PMRs and display details */
-			if (!psNode)
+			if (!bSysAllocPid && psRIEntry->pid != pid)
 			{
-				psNode = dllist_get_next_node(&g_sClientsListHead);
-			}
-			else
-			{
-				psNode = dllist_get_next_node(psNode);
+				continue;
 			}
 
-			while ((psNode != NULL && psNode != &g_sClientsListHead) &&
-					!bPMRToDisplay)
-			{
-				psRIEntry =	IMG_CONTAINER_OF(psNode, RI_LIST_ENTRY, sListNode);
-				if (psRIEntry->pid == pid)
-				{
-					/* This PMR was 'touched', so display details and unflag it*/
-					_GeneratePMREntryString(psRIEntry,
-											IMG_TRUE,
-											RI_PMR_ENTRY_BUF_SIZE,
-											acStringBuffer);
-					ui64TotalPMRAlloc += GET_LOGICAL_SIZE(psRIEntry);
-					ui64TotalPMRBacked += GET_PHYSICAL_SIZE(psRIEntry);
-
-					/* Remember the name of the process for 1 PMR for the summary */
-					if (szProcName[0] == '\0')
-					{
-						psRISubEntry = IMG_CONTAINER_OF(dllist_get_next_node(&(psRIEntry->sSubListFirst)), RI_SUBLIST_ENTRY, sListNode);
+			_SnapshotPMREntry(&psSnapshot->pasPMRs[psSnapshot->ui32NumPMRs++], psRIEntry);
+			psSnapshot->ui64TotalPMRAlloc += GET_LOGICAL_SIZE(psRIEntry);
+			psSnapshot->ui64TotalPMRBacked += GET_PHYSICAL_SIZE(psRIEntry);
 
-						if (psRISubEntry != NULL)
-						{
-							OSStringSafeCopy(szProcName, GET_PROC(psRISubEntry), RI_PROC_BUF_SIZE);
-						}
-						else
-						{
-							PVR_DPF((PVR_DBG_MESSAGE, "%s: No sub-list entry for RI entry "IMG_KM_PTR_FMTSPEC", PMR "IMG_KM_PTR_FMTSPEC" (%s)",
-							 __func__, psRIEntry,
-							GET_ADDR(psRIEntry), GET_NAME(psRIEntry)));
+			/* Remember the name of the process for 1 PMR for the summary */
+			if (psSnapshot->szPMRProcName[0] == '\0')
+			{
+				DLLIST_NODE *psSubNode = dllist_get_next_node(&psRIEntry->sSubListFirst);
 
-							OSStringSafeCopy(szProcName, "(proc n/a)", RI_PROC_BUF_SIZE);
-						}
-					}
-					bPMRToDisplay = IMG_TRUE;
+				if (psSubNode != NULL)
+				{
+					RI_SUBLIST_ENTRY *psRISubEntry = IMG_CONTAINER_OF(psSubNode, RI_SUBLIST_ENTRY, sListNode);
+					OSStringSafeCopy(psSnapshot->szPMRProcName, GET_PROC(psRISubEntry), RI_PROC_BUF_SIZE);
 				}
 				else
 				{
-					psNode = dllist_get_next_node(psNode);
+					OSStringSafeCopy(psSnapshot->szPMRProcName, "(proc n/a)", RI_PROC_BUF_SIZE);
 				}
 			}
+		}
+	}
 
-			if (psNode == NULL || (psNode == &g_sClientsListHead))
-			{
-				g_bNextGetState = RI_GET_STATE_PMR_SUMMARY;
-			}
-			/* else continue listing PMRs */
+	_RISnapshotProcessUnlock(bSysAllocPid);
+
+	psSnapshot->eState = RI_SNAPSHOT_STATE_MEMDESCS;
+	*ppsSnapshot = psSnapshot;
+
+	return PVRSRV_OK;
+}
+
+/*!
+*******************************************************************************
+
+ @Function	RIGetSnapshotEntryKM
+
+ @Description
+            Returns a pointer to a formatted string for the next line of a
+            snapshot taken with RISnapshotProcessKM(): the MEMDESC entries of
+            the process, their summary, the PMR entries and their summary.
+            The string is valid until the next call. Does not take the RI
+            lock.
+
+ @input     psSnapshot - snapshot to output
+ @output    ppszEntryString - string to be output for the entry
+
+ @Return	IMG_FALSE once all entries have been returned
+
+******************************************************************************/
+IMG_BOOL RIGetSnapshotEntryKM(RI_SNAPSHOT *psSnapshot,
+                              IMG_CHAR **ppszEntryString)
+{
+	IMG_CHAR *acStringBuffer = psSnapshot->acStringBuffer;
+
+	acStringBuffer[0] = '\0';
+	*ppszEntryString = acStringBuffer;
+
+	switch (psSnapshot->eState)
+	{
+	case RI_SNAPSHOT_STATE_MEMDESCS:
+		if (psSnapshot->ui32Next < psSnapshot->ui32NumMemdescs)
+		{
+			_GenerateMEMDESCEntryString(&psSnapshot->pasMemdescs[psSnapshot->ui32Next++].sEntry,
+			                            IMG_TRUE,
+			                            RI_MEMDESC_ENTRY_BUF_SIZE,
+			                            acStringBuffer);
+			break;
 		}
+		__fallthrough;
+
+	case RI_SNAPSHOT_STATE_MEMDESCS_SUMMARY:
+		OSSNPrintf(acStringBuffer,
+		           RI_MEMDESC_SUM_BUF_SIZE,
+		           RI_MEMDESC_SUM_FRMT,
+		           psSnapshot->pid,
+		           psSnapshot->szMemdescProcName,
+		           psSnapshot->ui64TotalMemdescAlloc,
+		           psSnapshot->ui64TotalMemdescAlloc >> 10,
+		           psSnapshot->ui64TotalImport,
+		           psSnapshot->ui64TotalImport >> 10,
+		           (psSnapshot->ui64TotalMemdescAlloc + psSnapshot->ui64TotalImport),
+		           (psSnapshot->ui64TotalMemdescAlloc + psSnapshot->ui64TotalImport) >> 10);
+
+		psSnapshot->eState = RI_SNAPSHOT_STATE_PMRS;
+		psSnapshot->ui32Next = 0;
 		break;
 
-	case RI_GET_STATE_PMR_SUMMARY:
+	case RI_SNAPSHOT_STATE_PMRS:
+		if (psSnapshot->ui32Next < psSnapshot->ui32NumPMRs)
+		{
+			_GeneratePMREntryString(&psSnapshot->pasPMRs[psSnapshot->ui32Next++].sEntry,
+			                        IMG_TRUE,
+			                        RI_PMR_ENTRY_BUF_SIZE,
+			                        acStringBuffer);
+			break;
+		}
+		__fallthrough;
+
+	case RI_SNAPSHOT_STATE_PMRS_SUMMARY:
 		OSSNPrintf(acStringBuffer,
 		           RI_PMR_SUM_BUF_SIZE,
 		           RI_PMR_SUM_FRMT,
-		           pid,
-		           szProcName,
-		           ui64TotalPMRAlloc,
-		           ui64TotalPMRAlloc >> 10,
-		           ui64TotalPMRBacked,
-		           ui64TotalPMRBacked >> 10);
-
-		*ppszEntryString = acStringBuffer;
-		ui64TotalPMRAlloc = 0;
-		ui64TotalPMRBacked = 0;
-		szProcName[0] = '\0';
-		psSysAllocNode = NULL;
-
-		g_bNextGetState = RI_GET_STATE_END;
+		           psSnapshot->pid,
+		           psSnapshot->szPMRProcName,
+		           psSnapshot->ui64TotalPMRAlloc,
+		           psSnapshot->ui64TotalPMRAlloc >> 10,
+		           psSnapshot->ui64TotalPMRBacked,
+		           psSnapshot->ui64TotalPMRBacked >> 10);
+
+		psSnapshot->eState = RI_SNAPSHOT_STATE_END;
 		break;
 
+	case RI_SNAPSHOT_STATE_END:
 	default:
-		PVR_DPF((PVR_DBG_ERROR, "%s: Bad %d)",__func__, g_bNextGetState));
-
-		__fallthrough;
-	case RI_GET_STATE_END:
-		/* Reset state ready for the next gpu_mem_area file to display */
 		*ppszEntryString = NULL;
-		*ppHandle        = NULL;
-		psNode = NULL;
-		szProcName[0] = '\0';
-
-		g_bNextGetState = RI_GET_STATE_MEMDESCS_LIST_START;
 		return IMG_FALSE;
-		break;
 	}
 
 	return IMG_TRUE;
 }
 
+/*!
+*******************************************************************************
+
+ @Function	RIFreeSnapshotKM
+
+ @Description
+            Frees a snapshot taken with RISnapshotProcessKM().
+
+ @input     psSnapshot - snapshot to free
+
+ @Return	None
+
+******************************************************************************/
+void RIFreeSnapshotKM(RI_SNAPSHOT *psSnapshot)
+{
+	if (psSnapshot != NULL)
+	{
+		if (psSnapshot->pasPMRs != NULL)
+		{
+			OSFreeMemNoStats(psSnapshot->pasPMRs);
+		}
+		if (psSnapshot->pasMemdescs != NULL)
+		{
+			OSFreeMemNoStats(psSnapshot->pasMemdescs);
+		}
+		OSFreeMemNoStats(psSnapshot);
+	}
+}
+
 /* Function used to produce string containing info for MEMDESC RI entries (used for both debugfs and kernel log output) */
 static void _GenerateMEMDESCEntryString(RI_SUBLIST_ENTRY *psRISubEntry,
                                         IMG_BOOL bDebugFs,
@@ -2146,11 +2357,91 @@ static PVRSRV_ERROR _DumpList(PMR *psPMR, IMG_PID pid)
 ******************************************************************************/
 PVRSRV_ERROR RIDumpAllKM(void)
 {
-	if (g_pPMR2RIListHashTable)
+	RI_SNAPSHOT *psSnapshot = NULL;
+	IMG_UINT32 ui32NumPMRs;
+	IMG_UINT32 ui32NumMemdescs;
+	IMG_UINT32 i, j;
+	PVRSRV_ERROR eError;
+
+	/* Copy every PMR and its MEMDESCs under the RI lock, then output the
+	 * copies without holding it, as logging them all is slow. The copy is
+	 * allocated without the lock and sized again if the database grew. */
+	for (;;)
+	{
+		_RILock();
+
+		if (g_pPMR2RIListHashTable == NULL)
+		{
+			_RIUnlock();
+			RIFreeSnapshotKM(psSnapshot);
+			return PVRSRV_OK;
+		}
+
+		ui32NumMemdescs = 0;
+		eError = HASH_Iterate(g_pPMR2RIListHashTable, (HASH_pfnCallback)_CountAllEntries, &ui32NumMemdescs);
+		PVR_LOG_GOTO_IF_ERROR(eError, "HASH_Iterate", ErrUnlock);
+		ui32NumPMRs = HASH_Count(g_pPMR2RIListHashTable);
+
+		if (psSnapshot != NULL &&
+		    ui32NumPMRs <= psSnapshot->ui32MaxPMRs &&
+		    ui32NumMemdescs <= psSnapshot->ui32MaxMemdescs)
+		{
+			break;
+		}
+
+		_RIUnlock();
+
+		RIFreeSnapshotKM(psSnapshot);
+		psSnapshot = _SnapshotAlloc(0, ui32NumPMRs, ui32NumMemdescs);
+		PVR_RETURN_IF_NOMEM(psSnapshot);
+	}
+
+	eError = HASH_Iterate(g_pPMR2RIListHashTable, (HASH_pfnCallback)_SnapshotAllEntries, psSnapshot);
+	PVR_LOG_GOTO_IF_ERROR(eError, "HASH_Iterate", ErrUnlock);
+
+	_RIUnlock();
+
+	for (i = 0; i < psSnapshot->ui32NumPMRs; i++)
 	{
-		return HASH_Iterate(g_pPMR2RIListHashTable, (HASH_pfnCallback)_DumpAllEntries, NULL);
+		RI_SNAPSHOT_PMR *psPMR = &psSnapshot->pasPMRs[i];
+		RI_LIST_ENTRY *psRIEntry = &psPMR->sEntry;
+
+		_RIOutput (("%s <%p> suballocs:%d size:0x%010" IMG_UINT64_FMTSPECx,
+		            GET_NAME(psRIEntry),
+		            GET_ADDR(psRIEntry),
+		            (IMG_UINT)psRIEntry->ui16SubListCount,
+		            GET_LOGICAL_SIZE(psRIEntry)));
+
+		for (j = 0; j < psPMR->ui32NumMemdescs; j++)
+		{
+			IMG_CHAR szEntryString[RI_MEMDESC_ENTRY_BUF_SIZE];
+
+			_GenerateMEMDESCEntryString(&psSnapshot->pasMemdescs[psPMR->ui32FirstMemdesc + j].sEntry,
+			                            IMG_FALSE,
+			                            RI_MEMDESC_ENTRY_BUF_SIZE,
+			                            szEntryString);
+			_RIOutput (("%s",szEntryString));
+		}
+
+		if (psPMR->ui32NumMemdescs != psRIEntry->ui16SubListCount)
+		{
+			/*
+			 * Output error message as sublist does not contain the
+			 * number of entries indicated by sublist count
+			 */
+			_RIOutput (("RI ERROR: RI sublist contains %d entries, not %d entries\n",
+			            psPMR->ui32NumMemdescs, psRIEntry->ui16SubListCount));
+		}
 	}
+
+	RIFreeSnapshotKM(psSnapshot);
+
 	return PVRSRV_OK;
+
+ErrUnlock:
+	_RIUnlock();
+	RIFreeSnapshotKM(psSnapshot);
+	return eError;
 }
 
 /*!
@@ -2616,14 +2907,48 @@ ExitUnlockAndReturn:
 	return eError;
 }
 
-static PVRSRV_ERROR _DumpAllEntries (uintptr_t k, uintptr_t v, void* pvPriv)
+static PVRSRV_ERROR _CountAllEntries (uintptr_t k, uintptr_t v, void* pvPriv)
 {
 	RI_LIST_ENTRY *psRIEntry = (RI_LIST_ENTRY *)v;
+	IMG_UINT32 *pui32NumMemdescs = (IMG_UINT32 *)pvPriv;
 
 	PVR_UNREFERENCED_PARAMETER (k);
-	PVR_UNREFERENCED_PARAMETER (pvPriv);
 
-	return RIDumpListKM(GET_ADDR(psRIEntry));
+	*pui32NumMemdescs += psRIEntry->ui16SubListCount;
+
+	return PVRSRV_OK;
+}
+
+static PVRSRV_ERROR _SnapshotAllEntries (uintptr_t k, uintptr_t v, void* pvPriv)
+{
+	RI_LIST_ENTRY *psRIEntry = (RI_LIST_ENTRY *)v;
+	RI_SNAPSHOT *psSnapshot = (RI_SNAPSHOT *)pvPriv;
+	RI_SNAPSHOT_PMR *psPMR;
+	DLLIST_NODE *psNode;
+
+	PVR_UNREFERENCED_PARAMETER (k);
+
+	if (psSnapshot->ui32NumPMRs >= psSnapshot->ui32MaxPMRs)
+	{
+		return PVRSRV_OK;
+	}
+
+	psPMR = &psSnapshot->pasPMRs[psSnapshot->ui32NumPMRs++];
+	_SnapshotPMREntry(psPMR, psRIEntry);
+	psPMR->ui32FirstMemdesc = psSnapshot->ui32NumMemdescs;
+
+	for (psNode = dllist_get_next_node(&psRIEntry->sSubListFirst);
+	     psNode != NULL && psSnapshot->ui32NumMemdescs < psSnapshot->ui32MaxMemdescs;
+	     psNode = dllist_get_next_node(psNode))
+	{
+		RI_SUBLIST_ENTRY *psRISubEntry = IMG_CONTAINER_OF(psNode, RI_SUBLIST_ENTRY, sListNode);
+
+		_SnapshotMemdescEntry(&psSnapshot->pasMemdescs[psSnapshot->ui32NumMemdescs++],
+		                      psRISubEntry, psPMR);
+		psPMR->ui32NumMemdescs++;
+	}
+
+	return PVRSRV_OK;
 }
 
 static PVRSRV_ERROR _DeleteAllEntries (uintptr_t k, uintptr_t v, void* pvPriv)
@@ -106,9 +106,12 @@ void RIConnectionClosed(void* psConnection);
 
 PVRSRV_ERROR RIDeleteEntriesForPID(IMG_PID pid);
 
-IMG_BOOL RIGetListEntryKM(IMG_PID pid,
-                          IMG_HANDLE **ppHandle,
-                          IMG_CHAR **ppszEntryString);
+typedef struct _RI_SNAPSHOT_ RI_SNAPSHOT;
+
+PVRSRV_ERROR RISnapshotProcessKM(IMG_PID pid, RI_SNAPSHOT **ppsSnapshot);
+IMG_BOOL RIGetSnapshotEntryKM(RI_SNAPSHOT *psSnapshot,
+                              IMG_CHAR **ppszEntryString);
+void RIFreeSnapshotKM(RI_SNAPSHOT *psSnapshot);
 
 IMG_INT32 RITotalAllocProcessUnlocked(IMG_PID pid, PHYS_HEAP_TYPE ePhysHeapType);
 
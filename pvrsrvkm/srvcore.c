@@ -76,6 +76,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "device_connection.h"
 #include "process_stats.h"
 #include "pvrsrv_pool.h"
+#include "di_server.h"
 
 #if defined(SUPPORT_GPUVIRT_VALIDATION)
 #include "physmem_lma.h"
@@ -108,8 +109,11 @@ static IMG_UINT16 g_BridgeDispatchTableStartOffsets[BRIDGE_DISPATCH_TABLE_START_
 
 
 #define PVRSRV_MAX_POOLED_BRIDGE_BUFFERS 8	/*!< Initial number of pooled bridge buffers */
+#define PVRSRV_BRIDGE_BUFFERS_PER_CPU 2	/*!< Bridge buffers cached per CPU */
 
 static PVRSRV_POOL *g_psBridgeBufferPool;	/*! Pool of bridge buffers */
+static PVRSRV_POOL_CACHE *g_psBridgeBufferCache;	/*! Per-CPU cache over g_psBridgeBufferPool */
+static DI_ENTRY *g_psBridgeBufferCacheDIEntry;
 
 
 #if defined(DEBUG_BRIDGE_KM)
@@ -1287,6 +1291,25 @@ static void _BridgeBufferFree(void *pvPrivData, void *pvFreeData)
 	OSFreeMem(pvFreeData);
 }
 
+static int _BridgeBufferCacheDIShow(OSDI_IMPL_ENTRY *psEntry, void *pvData)
+{
+	PVRSRV_POOL_CACHE_STATS sStats;
+
+	PVR_UNREFERENCED_PARAMETER(pvData);
+
+	PVRSRVPoolCacheGetStats(g_psBridgeBufferCache, &sStats);
+
+	DIPrintf(psEntry, "CPUs: %u\n", sStats.ui32NumCPUs);
+	DIPrintf(psEntry, "Buffers per CPU: %u\n", sStats.ui32EntriesPerCPU);
+	DIPrintf(psEntry, "Get hits: %" IMG_UINT64_FMTSPEC "\n", sStats.ui64GetHits);
+	DIPrintf(psEntry, "Get misses: %" IMG_UINT64_FMTSPEC "\n", sStats.ui64GetMisses);
+	DIPrintf(psEntry, "Put hits: %" IMG_UINT64_FMTSPEC "\n", sStats.ui64PutHits);
+	DIPrintf(psEntry, "Put misses: %" IMG_UINT64_FMTSPEC "\n", sStats.ui64PutMisses);
+	DIPrintf(psEntry, "Contended: %" IMG_UINT64_FMTSPEC "\n", sStats.ui64Contended);
+
+	return 0;
+}
+
 PVRSRV_ERROR BridgeDispatcherInit(void)
 {
 	PVRSRV_ERROR eError;
@@ -1304,8 +1327,25 @@ PVRSRV_ERROR BridgeDispatcherInit(void)
 	                          &g_psBridgeBufferPool);
 	PVR_LOG_GOTO_IF_ERROR(eError, "PVRSRVPoolCreate", erroPoolCreateFailed);
 
+	eError = PVRSRVPoolCacheCreate(g_psBridgeBufferPool,
+	                               PVRSRV_BRIDGE_BUFFERS_PER_CPU,
+	                               &g_psBridgeBufferCache);
+	PVR_LOG_GOTO_IF_ERROR(eError, "PVRSRVPoolCacheCreate", errorPoolCacheCreateFailed);
+
+	{
+		DI_ITERATOR_CB sIterator = {.pfnShow = _BridgeBufferCacheDIShow};
+
+		eError = DICreateEntry("bridge_buffer_cache", NULL, &sIterator, NULL,
+		                       DI_ENTRY_TYPE_GENERIC,
+		                       &g_psBridgeBufferCacheDIEntry);
+		PVR_LOG_IF_ERROR(eError, "DICreateEntry");
+	}
+
 	return PVRSRV_OK;
 
+errorPoolCacheCreateFailed:
+	PVRSRVPoolDestroy(g_psBridgeBufferPool);
+	g_psBridgeBufferPool = NULL;
 erroPoolCreateFailed:
 #if defined(DEBUG_BRIDGE_KM)
 	OSLockDestroy(g_hStatsLock);
@@ -1317,6 +1357,18 @@ errorLockCreateFailed:
 
 void BridgeDispatcherDeinit(void)
 {
+	if (g_psBridgeBufferCacheDIEntry)
+	{
+		DIDestroyEntry(g_psBridgeBufferCacheDIEntry);
+		g_psBridgeBufferCacheDIEntry = NULL;
+	}
+
+	if (g_psBridgeBufferCache)
+	{
+		PVRSRVPoolCacheDestroy(g_psBridgeBufferCache);
+		g_psBridgeBufferCache = NULL;
+	}
+
 	if (g_psBridgeBufferPool)
 	{
 		PVRSRVPoolDestroy(g_psBridgeBufferPool);
@@ -1332,8 +1384,16 @@ void BridgeDispatcherDeinit(void)
 #endif
 }
 
-PVRSRV_ERROR BridgedDispatchKM(CONNECTION_DATA * psConnection,
-                          PVRSRV_BRIDGE_PACKAGE   * psBridgePackageKM)
+/*
+ * Dispatch a single bridge call using the given bridge buffer (ignored on
+ * INTEGRITY, where the user buffers are used directly). If peHandlerError is
+ * not NULL it receives the error code returned by the bridge function itself,
+ * as opposed to the dispatch error which is the return value.
+ */
+static PVRSRV_ERROR _BridgedDispatch(CONNECTION_DATA *psConnection,
+                                     PVRSRV_BRIDGE_PACKAGE *psBridgePackageKM,
+                                     void *pvBridgeBuffer,
+                                     PVRSRV_ERROR *peHandlerError)
 {
 
 	void       * psBridgeIn=NULL;
@@ -1342,9 +1402,6 @@ PVRSRV_ERROR BridgedDispatchKM(CONNECTION_DATA * psConnection,
 	IMG_UINT32   ui32DispatchTableEntry, ui32GroupBoundary;
 	PVRSRV_ERROR err = PVRSRV_OK;
 	__maybe_unused size_t uiOutErrorOffset;
-#if !defined(INTEGRITY_OS)
-	PVRSRV_POOL_TOKEN hBridgeBufferPoolToken = NULL;
-#endif
 	IMG_UINT32 ui32Timestamp = OSClockus();
 #if defined(DEBUG_BRIDGE_KM)
 	IMG_UINT64	ui64TimeStart;
@@ -1360,6 +1417,14 @@ PVRSRV_ERROR BridgedDispatchKM(CONNECTION_DATA * psConnection,
 #if !defined(PVRSRV_ENABLE_HTB)
 	PVR_UNREFERENCED_PARAMETER(ui32Timestamp);
 #endif
+#if defined(INTEGRITY_OS)
+	PVR_UNREFERENCED_PARAMETER(pvBridgeBuffer);
+#endif
+
+	if (peHandlerError != NULL)
+	{
+		*peHandlerError = PVRSRV_OK;
+	}
 
 	if (psBridgePackageKM->ui32BridgeID >= BRIDGE_DISPATCH_TABLE_START_ENTRY_COUNT)
 	{
@@ -1436,13 +1501,7 @@ PVRSRV_ERROR BridgedDispatchKM(CONNECTION_DATA * psConnection,
 		OSLockAcquire(g_BridgeDispatchTable[ui32DispatchTableEntryIndex].hBridgeLock);
 	}
 #if !defined(INTEGRITY_OS)
-	/* try to acquire a bridge buffer from the pool */
-
-	err = PVRSRVPoolGet(g_psBridgeBufferPool,
-			&hBridgeBufferPoolToken,
-			&psBridgeIn);
-	PVR_LOG_GOTO_IF_ERROR(err, "PVRSRVPoolGet", unlock_and_return_error);
-
+	psBridgeIn = pvBridgeBuffer;
 	psBridgeOut = ((IMG_BYTE *) psBridgeIn) + PVRSRV_MAX_BRIDGE_IN_SIZE;
 #endif
 
@@ -1502,14 +1561,20 @@ PVRSRV_ERROR BridgedDispatchKM(CONNECTION_DATA * psConnection,
 	*/
 	if (psBridgePackageKM->ui32OutBufferSize > 0)
 	{
-		PVRSRV_ERROR * peHandlerError = (PVRSRV_ERROR *) IMG_OFFSET_ADDR(psBridgeOut, uiOutErrorOffset);
-		if (*peHandlerError != PVRSRV_OK)
+		PVRSRV_ERROR * peOutError = (PVRSRV_ERROR *) IMG_OFFSET_ADDR(psBridgeOut, uiOutErrorOffset);
+
+		if (peHandlerError != NULL)
+		{
+			*peHandlerError = *peOutError;
+		}
+
+		if (*peOutError != PVRSRV_OK)
 		{
 			/* Only copy error code to user when pfBridgeHandler fails */
 			if (CopyToUserWrapper (psConnection,
 							ui32DispatchTableEntryIndex,
 							IMG_OFFSET_ADDR_USER(psBridgePackageKM->pvParamOut, uiOutErrorOffset),
-							peHandlerError,
+							peOutError,
 							sizeof(PVRSRV_ERROR)) != PVRSRV_OK)
 			{
 				PVR_GOTO_WITH_ERROR(err, PVRSRV_ERROR_BRIDGE_EFAULT, unlock_and_return_error);
@@ -1554,15 +1619,6 @@ unlock_and_return_error:
 		OSLockRelease(g_BridgeDispatchTable[ui32DispatchTableEntryIndex].hBridgeLock);
 	}
 
-#if !defined(INTEGRITY_OS)
-	if (hBridgeBufferPoolToken != NULL)
-	{
-		err = PVRSRVPoolPut(g_psBridgeBufferPool,
-				hBridgeBufferPoolToken);
-		PVR_LOG_IF_ERROR(err, "PVRSRVPoolPut");
-	}
-#endif
-
 return_error:
 	if (err)
 	{
@@ -1588,6 +1644,96 @@ return_error:
 	return err;
 }
 
+PVRSRV_ERROR BridgedDispatchKM(CONNECTION_DATA * psConnection,
+                          PVRSRV_BRIDGE_PACKAGE   * psBridgePackageKM)
+{
+	void *pvBridgeBuffer = NULL;
+	PVRSRV_ERROR eError;
+#if !defined(INTEGRITY_OS)
+	PVRSRV_POOL_TOKEN hBridgeBufferPoolToken = NULL;
+	PVRSRV_ERROR eErrorPut;
+
+	/* try to acquire a bridge buffer from this CPU's cache or the pool */
+	eError = PVRSRVPoolCacheGet(g_psBridgeBufferCache,
+	                            &hBridgeBufferPoolToken,
+	                            &pvBridgeBuffer);
+	PVR_LOG_RETURN_IF_ERROR(eError, "PVRSRVPoolCacheGet");
+#endif
+
+	eError = _BridgedDispatch(psConnection, psBridgePackageKM, pvBridgeBuffer, NULL);
+
+#if !defined(INTEGRITY_OS)
+	eErrorPut = PVRSRVPoolCachePut(g_psBridgeBufferCache, hBridgeBufferPoolToken);
+	PVR_LOG_IF_ERROR(eErrorPut, "PVRSRVPoolCachePut");
+#endif
+
+	return eError;
+}
+
+PVRSRV_ERROR BridgedDispatchVecKM(CONNECTION_DATA *psConnection,
+                                  PVRSRV_BRIDGE_PACKAGE *psBridgePackagesKM,
+                                  IMG_UINT32 ui32NumPackages,
+                                  IMG_BOOL bStopOnError,
+                                  PVRSRV_ERROR *peResults,
+                                  IMG_UINT32 *pui32NumDone)
+{
+	void *pvBridgeBuffer = NULL;
+	IMG_UINT32 i;
+	PVRSRV_ERROR eError;
+#if !defined(INTEGRITY_OS)
+	PVRSRV_POOL_TOKEN hBridgeBufferPoolToken = NULL;
+#endif
+
+	PVR_LOG_RETURN_IF_INVALID_PARAM(psBridgePackagesKM != NULL, "psBridgePackagesKM");
+	PVR_LOG_RETURN_IF_INVALID_PARAM(peResults != NULL, "peResults");
+	PVR_LOG_RETURN_IF_INVALID_PARAM(pui32NumDone != NULL, "pui32NumDone");
+
+	*pui32NumDone = 0;
+
+#if !defined(INTEGRITY_OS)
+	/* One bridge buffer serves every call in the vector, the calls run
+	 * strictly one after the other */
+	eError = PVRSRVPoolCacheGet(g_psBridgeBufferCache,
+	                            &hBridgeBufferPoolToken,
+	                            &pvBridgeBuffer);
+	PVR_LOG_RETURN_IF_ERROR(eError, "PVRSRVPoolCacheGet");
+#endif
+
+	for (i = 0; i < ui32NumPackages; i++)
+	{
+		PVRSRV_ERROR eHandlerError;
+
+		eError = _BridgedDispatch(psConnection, &psBridgePackagesKM[i],
+		                          pvBridgeBuffer, &eHandlerError);
+
+		/* A dispatch failure takes precedence over the bridge function's
+		 * own result, which is also in the call's output buffer */
+		peResults[i] = (eError != PVRSRV_OK) ? eError : eHandlerError;
+
+		if (bStopOnError && peResults[i] != PVRSRV_OK)
+		{
+			i++;
+			break;
+		}
+	}
+
+	*pui32NumDone = i;
+
+#if defined(DEBUG_BRIDGE_KM)
+	BridgeGlobalStatsLock();
+	g_BridgeGlobalStats.ui32VecIOCTLCount++;
+	g_BridgeGlobalStats.ui32VecCallCount += i;
+	BridgeGlobalStatsUnlock();
+#endif
+
+#if !defined(INTEGRITY_OS)
+	eError = PVRSRVPoolCachePut(g_psBridgeBufferCache, hBridgeBufferPoolToken);
+	PVR_LOG_IF_ERROR(eError, "PVRSRVPoolCachePut");
+#endif
+
+	return PVRSRV_OK;
+}
+
 PVRSRV_ERROR PVRSRVFindProcessMemStatsKM(IMG_PID pid, IMG_UINT32 ui32ArrSize, IMG_BOOL bAllProcessStats, IMG_UINT64 *pui64MemStatArray)
 {
 #if !defined(__QNXNTO__)
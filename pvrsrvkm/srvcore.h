@@ -165,6 +165,8 @@ UnsetDispatchTableEntry(IMG_UINT32 ui32BridgeGroup,
 typedef struct _PVRSRV_BRIDGE_GLOBAL_STATS
 {
 	IMG_UINT32 ui32IOCTLCount;
+	IMG_UINT32 ui32VecIOCTLCount;	/*!< Vectored dispatches */
+	IMG_UINT32 ui32VecCallCount;	/*!< Bridge calls made by vectored dispatches */
 	IMG_UINT32 ui32TotalCopyFromUserBytes;
 	IMG_UINT32 ui32TotalCopyToUserBytes;
 } PVRSRV_BRIDGE_GLOBAL_STATS;
@@ -185,6 +187,29 @@ PVRSRV_ERROR
 BridgedDispatchKM(CONNECTION_DATA * psConnection,
                   PVRSRV_BRIDGE_PACKAGE   * psBridgePackageKM);
 
+/*************************************************************************/ /*!
+@Function       BridgedDispatchVecKM
+@Description    Execute a number of bridge calls in order, sharing a single
+                bridge buffer between them. Each call is dispatched exactly
+                as by BridgedDispatchKM().
+@Input          psConnection         Connection the calls are made on
+@Input          psBridgePackagesKM   Array of bridge packages
+@Input          ui32NumPackages      Number of entries in psBridgePackagesKM
+@Input          bStopOnError         Stop after the first call that fails
+@Output         peResults            Per call result: the dispatch error, or
+                                     the bridge function's error if the
+                                     dispatch succeeded
+@Output         pui32NumDone         Number of calls executed
+@Return         PVRSRV_OK, or an error if the calls could not be started
+*/ /**************************************************************************/
+PVRSRV_ERROR
+BridgedDispatchVecKM(CONNECTION_DATA *psConnection,
+                     PVRSRV_BRIDGE_PACKAGE *psBridgePackagesKM,
+                     IMG_UINT32 ui32NumPackages,
+                     IMG_BOOL bStopOnError,
+                     PVRSRV_ERROR *peResults,
+                     IMG_UINT32 *pui32NumDone);
+
 PVRSRV_ERROR
 PVRSRVConnectKM(CONNECTION_DATA *psConnection,
                 PVRSRV_DEVICE_NODE * psDeviceNode,
@@ -50,6 +50,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "pvr_notifier.h"
 #include "osfunc.h"
 #include "dllist.h"
+#include "hash.h"
 #include "sync.h"
 #include "sync_checkpoint_external.h"
 #include "sync_checkpoint.h"
@@ -170,6 +171,12 @@ struct _SYNC_CHECKPOINT_CONTEXT_CTL_
 	IMG_UINT32                              ui32MaxInUseSyncCheckpoints;
 	IMG_UINT32                              ui32CurrentInUseMirroringSyncCPs;
 	IMG_UINT32                              ui32MaxInUseMirroringSyncCPs;
+	/* Counters to provide stats for fence checkpoint pruning at resolve time */
+	IMG_UINT64                              ui64NumFenceResolves;
+	IMG_UINT64                              ui64NumFenceUFOsResolved;
+	IMG_UINT64                              ui64NumFenceUFOsKept;
+	IMG_UINT64                              ui64NumFenceUFOsSignalled;
+	IMG_UINT64                              ui64NumFenceUFOsDuplicate;
 	/* Lock to protect the checkpoint stats */
 	POS_SPINLOCK							hSyncCheckpointStatsLock;
 #if (SYNC_CHECKPOINT_POOL_LIMIT > 0)
@@ -207,6 +214,9 @@ struct SYNC_CHECKPOINT_CONTEXT_TAG
  */
 #define SYNC_CHECKPOINT_RECORD_LIMIT 20000
 
+/* Initial size of the record index, it grows with the number of records */
+#define SYNC_CHECKPOINT_RECORD_HASH_SIZE 64
+
 #define DECREMENT_WITH_WRAP(value, sz) ((value) ? ((value) - 1) : ((sz) - 1))
 
 struct SYNC_CHECKPOINT_RECORD
@@ -218,6 +228,7 @@ struct SYNC_CHECKPOINT_RECORD
 	IMG_UINT32				ui32UID;
 	IMG_UINT64				ui64OSTime;
 	DLLIST_NODE				sNode;
+	struct SYNC_CHECKPOINT_RECORD	*psAddrNext;	/*!< older live record at the same FW address */
 	IMG_CHAR				szClassName[PVRSRV_SYNC_NAME_LENGTH];
 	PSYNC_CHECKPOINT		pSyncCheckpt;
 };
@@ -598,6 +609,85 @@ SyncCheckpointRegisterFunctions(PFN_SYNC_CHECKPOINT_STRUCT *psSyncCheckpointPfns
 	return PVRSRV_OK;
 }
 
+/*
+ * Remove the checkpoints from a resolved fence which would only become FW
+ * UFO checks that are already satisfied (checkpoint signalled) or repeated
+ * (same checkpoint already in the list), dropping the resolve reference on
+ * each one removed. Errored checkpoints are kept so the error still reaches
+ * the kick. Collapsing of fences from the same timeline is done by the OS
+ * native sync resolve, which knows the fence context ordering.
+ */
+static void
+_SyncCheckpointPruneResolvedFence(_SYNC_CHECKPOINT_CONTEXT *psContext,
+                                  IMG_UINT32 *pui32NumSyncCheckpoints,
+                                  PSYNC_CHECKPOINT **papsSyncCheckpoints)
+{
+	_PSYNC_CHECKPOINT_CONTEXT_CTL psContextCtl = psContext->psContextCtl;
+	IMG_UINT32 ui32NumIn = *pui32NumSyncCheckpoints;
+	IMG_UINT32 ui32NumOut = 0;
+	IMG_UINT32 ui32NumSignalled = 0;
+	IMG_UINT32 ui32NumDuplicate = 0;
+	OS_SPINLOCK_FLAGS uiFlags = 0;
+
+#if !defined(PDUMP)
+	PSYNC_CHECKPOINT *apsSyncCheckpoints = *papsSyncCheckpoints;
+	IMG_UINT32 i, j;
+
+	for (i = 0; i < ui32NumIn; i++)
+	{
+		SYNC_CHECKPOINT *psSyncCheckpoint = (SYNC_CHECKPOINT *)apsSyncCheckpoints[i];
+		IMG_BOOL bDrop = IMG_FALSE;
+
+		if (psSyncCheckpoint->psSyncCheckpointFwObj->ui32State == PVRSRV_SYNC_CHECKPOINT_SIGNALLED)
+		{
+			ui32NumSignalled++;
+			bDrop = IMG_TRUE;
+		}
+		else
+		{
+			for (j = 0; j < ui32NumOut; j++)
+			{
+				if (apsSyncCheckpoints[j] == apsSyncCheckpoints[i])
+				{
+					ui32NumDuplicate++;
+					bDrop = IMG_TRUE;
+					break;
+				}
+			}
+		}
+
+		if (bDrop)
+		{
+			SyncCheckpointDropRef(apsSyncCheckpoints[i]);
+		}
+		else
+		{
+			apsSyncCheckpoints[ui32NumOut++] = apsSyncCheckpoints[i];
+		}
+	}
+
+	if ((ui32NumOut == 0) && (apsSyncCheckpoints != NULL))
+	{
+		/* Callers only free a non-empty list */
+		SyncCheckpointFreeCheckpointListMem(apsSyncCheckpoints);
+		*papsSyncCheckpoints = NULL;
+	}
+	*pui32NumSyncCheckpoints = ui32NumOut;
+#else
+	/* All fence checkpoints need to make it to the pdump */
+	PVR_UNREFERENCED_PARAMETER(papsSyncCheckpoints);
+	ui32NumOut = ui32NumIn;
+#endif
+
+	OSSpinLockAcquire(psContextCtl->hSyncCheckpointStatsLock, uiFlags);
+	psContextCtl->ui64NumFenceResolves++;
+	psContextCtl->ui64NumFenceUFOsResolved += ui32NumIn;
+	psContextCtl->ui64NumFenceUFOsKept += ui32NumOut;
+	psContextCtl->ui64NumFenceUFOsSignalled += ui32NumSignalled;
+	psContextCtl->ui64NumFenceUFOsDuplicate += ui32NumDuplicate;
+	OSSpinLockRelease(psContextCtl->hSyncCheckpointStatsLock, uiFlags);
+}
+
 PVRSRV_ERROR
 SyncCheckpointResolveFence(PSYNC_CHECKPOINT_CONTEXT psSyncCheckpointContext,
                            PVRSRV_FENCE hFence, IMG_UINT32 *pui32NumSyncCheckpoints,
@@ -683,6 +773,10 @@ SyncCheckpointResolveFence(PSYNC_CHECKPOINT_CONTEXT psSyncCheckpointContext,
 		return PVRSRV_ERROR_INVALID_PARAMS;
 	}
 
+	_SyncCheckpointPruneResolvedFence(psSyncCheckpointContext,
+	                                  pui32NumSyncCheckpoints,
+	                                  papsSyncCheckpoints);
+
 #if (ENABLE_SYNC_CHECKPOINT_FENCE_DEBUG == 1)
 	{
 		IMG_UINT32 ii;
@@ -1289,6 +1383,11 @@ SyncCheckpointContextCreate(PPVRSRV_DEVICE_NODE psDevNode,
 	psContextCtl->ui32MaxInUseSyncCheckpoints = 0;
 	psContextCtl->ui32CurrentInUseMirroringSyncCPs = 0;
 	psContextCtl->ui32MaxInUseMirroringSyncCPs = 0;
+	psContextCtl->ui64NumFenceResolves = 0;
+	psContextCtl->ui64NumFenceUFOsResolved = 0;
+	psContextCtl->ui64NumFenceUFOsKept = 0;
+	psContextCtl->ui64NumFenceUFOsSignalled = 0;
+	psContextCtl->ui64NumFenceUFOsDuplicate = 0;
 	eError = OSSpinLockCreate(&psContextCtl->hSyncCheckpointStatsLock);
 	PVR_GOTO_IF_ERROR(eError, fail_span_stat);
 
@@ -2474,6 +2573,13 @@ static void _SyncCheckpointDebugRequest(PVRSRV_DBGREQ_HANDLE hDebugRequestHandle
 		PVR_DUMPDEBUG_LOG("(SyncCP Mirroring Counts: InUse:%d Max:%d)",
 		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui32CurrentInUseMirroringSyncCPs,
 		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui32MaxInUseMirroringSyncCPs);
+		PVR_DUMPDEBUG_LOG("(SyncCP Fence Resolves: %" IMG_UINT64_FMTSPEC " UFOs In:%" IMG_UINT64_FMTSPEC
+		                  " Out:%" IMG_UINT64_FMTSPEC " Signalled:%" IMG_UINT64_FMTSPEC " Duplicate:%" IMG_UINT64_FMTSPEC ")",
+		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui64NumFenceResolves,
+		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui64NumFenceUFOsResolved,
+		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui64NumFenceUFOsKept,
+		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui64NumFenceUFOsSignalled,
+		                  psDevNode->hSyncCheckpointContext->psContextCtl->ui64NumFenceUFOsDuplicate);
 		OSSpinLockRelease(psDevNode->hSyncCheckpointContext->psContextCtl->hSyncCheckpointStatsLock, uiFlags);
 
 		OSSpinLockAcquire(psDevNode->hSyncCheckpointListLock, uiFlags);
@@ -2633,58 +2739,146 @@ void SyncCheckpointDeinit(PPVRSRV_DEVICE_NODE psDevNode)
 	}
 }
 
-void SyncCheckpointRecordLookup(PPVRSRV_DEVICE_NODE psDevNode, IMG_UINT32 ui32FwAddr,
-                                IMG_CHAR * pszSyncInfo, size_t len)
+#define SYNC_CHECKPOINT_RECORD_KEY(psRec) \
+	((uintptr_t)((psRec)->ui32FwBlockAddr + (psRec)->ui32SyncOffset))
+
+/* Adds a record to the FW address index. Records sharing an address are
+ * chained newest first. Called with hSyncCheckpointRecordLock held. */
+static IMG_BOOL _SyncCheckpointRecordIndex(PVRSRV_DEVICE_NODE *psDevNode,
+                                           struct SYNC_CHECKPOINT_RECORD *psSyncRec)
 {
-	DLLIST_NODE *psNode, *psNext;
-	IMG_BOOL bFound = IMG_FALSE;
+	uintptr_t *puiHead = HASH_Retrieve_Handle(psDevNode->psSyncCheckpointRecordHash,
+	                                          SYNC_CHECKPOINT_RECORD_KEY(psSyncRec));
 
-	if (!pszSyncInfo)
+	if (puiHead != NULL)
+	{
+		psSyncRec->psAddrNext = (struct SYNC_CHECKPOINT_RECORD *)*puiHead;
+		*puiHead = (uintptr_t)psSyncRec;
+		return IMG_TRUE;
+	}
+
+	psSyncRec->psAddrNext = NULL;
+	return HASH_Insert(psDevNode->psSyncCheckpointRecordHash,
+	                   SYNC_CHECKPOINT_RECORD_KEY(psSyncRec),
+	                   (uintptr_t)psSyncRec);
+}
+
+/* Removes a record from the FW address index.
+ * Called with hSyncCheckpointRecordLock held. */
+static void _SyncCheckpointRecordUnindex(PVRSRV_DEVICE_NODE *psDevNode,
+                                         struct SYNC_CHECKPOINT_RECORD *psSyncRec)
+{
+	uintptr_t *puiHead = HASH_Retrieve_Handle(psDevNode->psSyncCheckpointRecordHash,
+	                                          SYNC_CHECKPOINT_RECORD_KEY(psSyncRec));
+	struct SYNC_CHECKPOINT_RECORD *psIter;
+
+	if (puiHead == NULL)
 	{
 		return;
 	}
 
+	psIter = (struct SYNC_CHECKPOINT_RECORD *)*puiHead;
+	if (psIter == psSyncRec)
+	{
+		if (psSyncRec->psAddrNext != NULL)
+		{
+			*puiHead = (uintptr_t)psSyncRec->psAddrNext;
+		}
+		else
+		{
+			HASH_Remove(psDevNode->psSyncCheckpointRecordHash,
+			            SYNC_CHECKPOINT_RECORD_KEY(psSyncRec));
+		}
+	}
+	else
+	{
+		while (psIter != NULL && psIter->psAddrNext != psSyncRec)
+		{
+			psIter = psIter->psAddrNext;
+		}
+		if (psIter != NULL)
+		{
+			psIter->psAddrNext = psSyncRec->psAddrNext;
+		}
+	}
+
+	psSyncRec->psAddrNext = NULL;
+}
+
+/* Formats the record for a single UFO address.
+ * Called with hSyncCheckpointRecordLock held. */
+static void _SyncCheckpointRecordLookupLocked(PVRSRV_DEVICE_NODE *psDevNode,
+                                              IMG_UINT32 ui32FwAddr,
+                                              IMG_CHAR *pszSyncInfo, size_t len)
+{
+	struct SYNC_CHECKPOINT_RECORD *psSyncCheckpointRec;
+
 	pszSyncInfo[0] = '\0';
 
-	OSLockAcquire(psDevNode->hSyncCheckpointRecordLock);
-	dllist_foreach_node(&psDevNode->sSyncCheckpointRecordList, psNode, psNext)
+	psSyncCheckpointRec = (struct SYNC_CHECKPOINT_RECORD *)
+		HASH_Retrieve(psDevNode->psSyncCheckpointRecordHash,
+		              (uintptr_t)PVRSRV_UFO_GET_FWADDR(ui32FwAddr));
+	if (psSyncCheckpointRec != NULL)
 	{
-		struct SYNC_CHECKPOINT_RECORD *psSyncCheckpointRec =
-				IMG_CONTAINER_OF(psNode, struct SYNC_CHECKPOINT_RECORD, sNode);
-		if ((psSyncCheckpointRec->ui32FwBlockAddr + psSyncCheckpointRec->ui32SyncOffset) ==
-		    PVRSRV_UFO_GET_FWADDR(ui32FwAddr))
+		SYNC_CHECKPOINT_BLOCK *psSyncCheckpointBlock = psSyncCheckpointRec->psSyncCheckpointBlock;
+		if (psSyncCheckpointBlock && psSyncCheckpointBlock->pui32LinAddr)
 		{
-			SYNC_CHECKPOINT_BLOCK *psSyncCheckpointBlock = psSyncCheckpointRec->psSyncCheckpointBlock;
-			if (psSyncCheckpointBlock && psSyncCheckpointBlock->pui32LinAddr)
-			{
-				void *pSyncCheckpointAddr = IMG_OFFSET_ADDR(psSyncCheckpointBlock->pui32LinAddr,
-													psSyncCheckpointRec->ui32SyncOffset);
-				OSSNPrintf(pszSyncInfo, len, "%s Checkpoint:%05u %s(%s)",
-				           (*(IMG_UINT32*)pSyncCheckpointAddr == PVRSRV_SYNC_CHECKPOINT_SIGNALLED) ?
-				                   "SIGNALLED" :
-				                   ((*(IMG_UINT32*)pSyncCheckpointAddr == PVRSRV_SYNC_CHECKPOINT_ERRORED) ?
-				                           "ERRORED" : "ACTIVE"),
-				           psSyncCheckpointRec->uiPID,
-				           PVRSRV_UFO_IS_MIRROR_FWADDR(ui32FwAddr) ? "(M) " : "",
-				           psSyncCheckpointRec->szClassName);
-			}
-			else
-			{
-				OSSNPrintf(pszSyncInfo, len, " Checkpoint:%05u (%s)",
-				           psSyncCheckpointRec->uiPID,
-				           psSyncCheckpointRec->szClassName);
-			}
-
-			bFound = IMG_TRUE;
-			break;
+			void *pSyncCheckpointAddr = IMG_OFFSET_ADDR(psSyncCheckpointBlock->pui32LinAddr,
+												psSyncCheckpointRec->ui32SyncOffset);
+			OSSNPrintf(pszSyncInfo, len, "%s Checkpoint:%05u %s(%s)",
+			           (*(IMG_UINT32*)pSyncCheckpointAddr == PVRSRV_SYNC_CHECKPOINT_SIGNALLED) ?
+			                   "SIGNALLED" :
+			                   ((*(IMG_UINT32*)pSyncCheckpointAddr == PVRSRV_SYNC_CHECKPOINT_ERRORED) ?
+			                           "ERRORED" : "ACTIVE"),
+			           psSyncCheckpointRec->uiPID,
+			           PVRSRV_UFO_IS_MIRROR_FWADDR(ui32FwAddr) ? "(M) " : "",
+			           psSyncCheckpointRec->szClassName);
+		}
+		else
+		{
+			OSSNPrintf(pszSyncInfo, len, " Checkpoint:%05u (%s)",
+			           psSyncCheckpointRec->uiPID,
+			           psSyncCheckpointRec->szClassName);
 		}
 	}
+	else if (psDevNode->ui32SyncCheckpointRecordCountHighWatermark == SYNC_CHECKPOINT_RECORD_LIMIT)
+	{
+		OSSNPrintf(pszSyncInfo, len, "(Record may be lost)");
+	}
+}
+
+void SyncCheckpointRecordLookup(PPVRSRV_DEVICE_NODE psDevNode, IMG_UINT32 ui32FwAddr,
+                                IMG_CHAR * pszSyncInfo, size_t len)
+{
+	if (!pszSyncInfo)
+	{
+		return;
+	}
+
+	OSLockAcquire(psDevNode->hSyncCheckpointRecordLock);
+	_SyncCheckpointRecordLookupLocked(psDevNode, ui32FwAddr, pszSyncInfo, len);
 	OSLockRelease(psDevNode->hSyncCheckpointRecordLock);
+}
 
-	if (!bFound && (psDevNode->ui32SyncCheckpointRecordCountHighWatermark == SYNC_CHECKPOINT_RECORD_LIMIT))
+void SyncCheckpointRecordLookupBatch(PPVRSRV_DEVICE_NODE psDevNode,
+                                     IMG_UINT32 ui32NumFwAddrs,
+                                     const IMG_UINT32 *pui32FwAddrs,
+                                     IMG_CHAR *pszSyncInfos, size_t len)
+{
+	IMG_UINT32 i;
+
+	if (!pszSyncInfos || !pui32FwAddrs || len == 0)
 	{
-		OSSNPrintf(pszSyncInfo, len, "(Record may be lost)");
+		return;
 	}
+
+	OSLockAcquire(psDevNode->hSyncCheckpointRecordLock);
+	for (i = 0; i < ui32NumFwAddrs; i++)
+	{
+		_SyncCheckpointRecordLookupLocked(psDevNode, pui32FwAddrs[i],
+		                                  &pszSyncInfos[i * len], len);
+	}
+	OSLockRelease(psDevNode->hSyncCheckpointRecordLock);
 }
 
 static PVRSRV_ERROR
@@ -2730,7 +2924,17 @@ _SyncCheckpointRecordAdd(
 	}
 
 	OSLockAcquire(psDevNode->hSyncCheckpointRecordLock);
-	if (psDevNode->ui32SyncCheckpointRecordCount < SYNC_CHECKPOINT_RECORD_LIMIT)
+	if (psDevNode->ui32SyncCheckpointRecordCount < SYNC_CHECKPOINT_RECORD_LIMIT &&
+	    !_SyncCheckpointRecordIndex(psDevNode, psSyncRec))
+	{
+		PVR_DPF((PVR_DBG_ERROR, "%s: Failed to index sync checkpoint record \"%s\"",
+				__func__,
+				pszClassName));
+		OSFreeMem(psSyncRec);
+		psSyncRec = NULL;
+		eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+	}
+	else if (psDevNode->ui32SyncCheckpointRecordCount < SYNC_CHECKPOINT_RECORD_LIMIT)
 	{
 		dllist_add_to_head(&psDevNode->sSyncCheckpointRecordList, &psSyncRec->sNode);
 		psDevNode->ui32SyncCheckpointRecordCount++;
@@ -2773,6 +2977,7 @@ _SyncCheckpointRecordRemove(PSYNC_CHECKPOINT_RECORD_HANDLE hRecord)
 	OSLockAcquire(psDevNode->hSyncCheckpointRecordLock);
 
 	dllist_remove_node(&pSync->sNode);
+	_SyncCheckpointRecordUnindex(psDevNode, pSync);
 
 	if (psDevNode->uiSyncCheckpointRecordFreeIdx >= PVRSRV_FULL_SYNC_TRACKING_HISTORY_LEN)
 	{
@@ -2916,6 +3121,9 @@ static PVRSRV_ERROR _SyncCheckpointRecordListInit(PVRSRV_DEVICE_NODE *psDevNode)
 	PVR_GOTO_IF_ERROR(eError, fail_lock_create);
 	dllist_init(&psDevNode->sSyncCheckpointRecordList);
 
+	psDevNode->psSyncCheckpointRecordHash = HASH_Create(SYNC_CHECKPOINT_RECORD_HASH_SIZE);
+	PVR_GOTO_IF_NOMEM(psDevNode->psSyncCheckpointRecordHash, eError, fail_hash_create);
+
 	psDevNode->ui32SyncCheckpointRecordCount = 0;
 	psDevNode->ui32SyncCheckpointRecordCountHighWatermark = 0;
 
@@ -2929,6 +3137,9 @@ static PVRSRV_ERROR _SyncCheckpointRecordListInit(PVRSRV_DEVICE_NODE *psDevNode)
 	return PVRSRV_OK;
 
 fail_dbg_register:
+	HASH_Delete(psDevNode->psSyncCheckpointRecordHash);
+	psDevNode->psSyncCheckpointRecordHash = NULL;
+fail_hash_create:
 	OSLockDestroy(psDevNode->hSyncCheckpointRecordLock);
 fail_lock_create:
 	return eError;
@@ -2946,9 +3157,13 @@ static void _SyncCheckpointRecordListDeinit(PVRSRV_DEVICE_NODE *psDevNode)
 				IMG_CONTAINER_OF(psNode, struct SYNC_CHECKPOINT_RECORD, sNode);
 
 		dllist_remove_node(psNode);
+		_SyncCheckpointRecordUnindex(psDevNode, pSyncCheckpointRec);
 		OSFreeMem(pSyncCheckpointRec);
 	}
 
+	HASH_Delete(psDevNode->psSyncCheckpointRecordHash);
+	psDevNode->psSyncCheckpointRecordHash = NULL;
+
 	for (i = 0; i < PVRSRV_FULL_SYNC_TRACKING_HISTORY_LEN; i++)
 	{
 		if (psDevNode->apsSyncCheckpointRecordsFreed[i])
@@ -449,6 +449,9 @@ SyncCheckpointDropRef(PSYNC_CHECKPOINT psSyncCheckpoint);
                 that fence contains.
                 This function in turn calls a function provided by the
                 OS native sync implementation.
+                Checkpoints which are already signalled or repeated in the
+                list are removed (except in PDUMP builds), so the caller
+                only waits on those still outstanding.
 
 @Input          psSyncCheckpointContext The sync checkpoint context
                                         on which checkpoints should be
@@ -460,7 +463,8 @@ SyncCheckpointDropRef(PSYNC_CHECKPOINT psSyncCheckpoint);
 
 @Output         pui32NumSyncCheckpoints The number of sync checkpoints the
                                         fence contains. Can return 0 if
-                                        passed a null (-1) fence.
+                                        passed a null (-1) fence, or if
+                                        all its checkpoints are signalled.
 
 @Output         papsSyncCheckpoints     List of sync checkpoints the fence
                                         contains
@@ -790,6 +794,36 @@ SyncCheckpointRecordLookup(PPVRSRV_DEVICE_NODE psDevNode,
                            IMG_UINT32 ui32FwAddr,
                            IMG_CHAR * pszSyncInfo, size_t len);
 
+/*************************************************************************/ /*!
+@Function       SyncCheckpointRecordLookupBatch
+
+@Description    Returns debug strings for a set of sync checkpoints,
+                resolving all of them under a single acquisition of the
+                record lock.
+
+@Input          psDevNode               The device owning the sync
+                                        checkpoints to lookup
+
+@Input          ui32NumFwAddrs          Number of addresses to lookup
+
+@Input          pui32FwAddrs            Firmware addresses of the sync
+                                        checkpoints to lookup
+
+@Input          pszSyncInfos            Character array of
+                                        ui32NumFwAddrs * len bytes, string i
+                                        is written at offset i * len
+
+@Input          len                     Len of each string
+
+@Return         None
+*/
+/*****************************************************************************/
+void
+SyncCheckpointRecordLookupBatch(PPVRSRV_DEVICE_NODE psDevNode,
+                                IMG_UINT32 ui32NumFwAddrs,
+                                const IMG_UINT32 *pui32FwAddrs,
+                                IMG_CHAR *pszSyncInfos, size_t len);
+
 #if defined(PDUMP)
 /*************************************************************************/ /*!
 @Function       PVRSRVSyncCheckpointFencePDumpPolKM
@@ -89,6 +89,21 @@ typedef struct _TL_SNODE_* PTL_SNODE;
  *                    consumer has a chance to obtain the data from the stream.
  *                    Stream can only be destroyed when ui32RefCount == 1.
  */
+/*! Maximum number of concurrently outstanding reservations on a
+ * TL_FLAG_MULTI_PRODUCER stream. */
+#define TL_MP_MAX_INFLIGHT 16U
+
+/*! One outstanding reservation on a multi-producer stream. Entries are kept in
+ * reservation order in a ring; ui32Write is only advanced past an entry once
+ * it and all entries before it have been committed. */
+typedef struct _TL_MP_RESERVATION_
+{
+	IMG_UINT32              ui32Start;      /*!< Offset of the packet header (after any padding) */
+	IMG_UINT32              ui32End;        /*!< Write offset following this reservation */
+	IMG_UINT32              ui32Reserved;   /*!< Aligned data bytes reserved */
+	IMG_BOOL                bCommitted;     /*!< Producer has committed the data */
+} TL_MP_RESERVATION;
+
 typedef struct _TL_STREAM_
 {
 	IMG_CHAR                szName[PVRSRVTL_MAX_STREAM_NAME_SIZE];  /*!< String name identifier */
@@ -139,6 +154,14 @@ typedef struct _TL_STREAM_
 	IMG_BOOL                bNoWrapPermanent;                       /*!< Flag: Prevents buffer wrap and subsequent data loss
 	                                                                     *    as well as resetting the read position on close. */
 
+	TL_MP_RESERVATION       *psMPRing;                              /*!< Outstanding reservations, only allocated for
+	                                                                     *    TL_FLAG_MULTI_PRODUCER streams */
+	IMG_UINT32              ui32MPHead;                             /*!< Ring index of the oldest outstanding reservation */
+	IMG_UINT32              ui32MPCount;                            /*!< Number of outstanding reservations */
+	IMG_UINT32              ui32Reserve;                            /*!< Offset following the newest reservation, runs ahead
+	                                                                     *    of ui32Write while ui32MPCount is non-zero.
+	                                                                     *    The ring state is guarded by hStreamWLock. */
+
 #if defined(TL_BUFFER_STATS)
 	IMG_UINT32              ui32CntReadFails;                       /*!< Tracks how many times reader failed to acquire read lock */
 	IMG_UINT32              ui32CntReadSuccesses;                   /*!< Tracks how many times reader acquires read lock successfully */
@@ -159,6 +182,10 @@ typedef struct _TL_STREAM_
 	IMG_UINT32              ui32SignalNotSent;  /*!< Counters used to analysing stream performance, see ++ loc */
 	IMG_UINT32              ui32ManSyncs;       /*!< Counters used to analysing stream performance, see ++ loc */
 	IMG_UINT32              ui32ProducerByteCount; /*!< Counters used to analysing stream performance, see ++ loc */
+	IMG_UINT32              ui32MPReserves;     /*!< Multi-producer reservations granted */
+	IMG_UINT32              ui32MPDrops;        /*!< Multi-producer reservations refused for lack of space or ring slots */
+	IMG_UINT32              ui32MPOutOfOrder;   /*!< Multi-producer commits that had to wait for an older reservation */
+	IMG_UINT32              ui32MPMaxInFlight;  /*!< High watermark of outstanding multi-producer reservations */
 
 	/* Not protected by the lock, inc in the reader thread which is currently singular */
 	IMG_UINT32              ui32AcquireRead1;   /*!< Counters used to analysing stream performance, see ++ loc */
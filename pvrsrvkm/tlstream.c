@@ -304,6 +304,21 @@ TLStreamCreate(IMG_HANDLE *phStream,
 		}
 	}
 
+	if (ui32StreamFlags & TL_FLAG_MULTI_PRODUCER)
+	{
+		/* Overwriting old data would race with producers still writing into
+		 * their reservations, so drop-oldest is not supported here. */
+		if (psTmp->eOpMode == TL_OPMODE_DROP_OLDEST)
+		{
+			PVR_DPF((PVR_DBG_ERROR, "Multi-producer TL stream cannot use DROP_OLDEST"));
+			eError = PVRSRV_ERROR_INVALID_PARAMS;
+			goto e1;
+		}
+
+		psTmp->psMPRing = OSAllocZMem(sizeof(TL_MP_RESERVATION) * TL_MP_MAX_INFLIGHT);
+		PVR_GOTO_IF_NOMEM(psTmp->psMPRing, eError, e1);
+	}
+
 	/* Additional synchronisation object required for some streams e.g. blocking */
 	eError = OSEventObjectCreate(NULL, &psTmp->hProducerEventObj);
 	PVR_GOTO_IF_ERROR(eError, e1);
@@ -330,6 +345,9 @@ TLStreamCreate(IMG_HANDLE *phStream,
 	psTmp->ui32Read = 0;
 	psTmp->ui32Write = 0;
 	psTmp->ui32Pending = NOTHING_PENDING;
+	psTmp->ui32Reserve = 0;
+	psTmp->ui32MPHead = 0;
+	psTmp->ui32MPCount = 0;
 	psTmp->bReadPending = IMG_FALSE;
 	psTmp->bSignalPending = IMG_FALSE;
 
@@ -408,6 +426,10 @@ e3:
 e2:
 	OSEventObjectDestroy(psTmp->hProducerEventObj);
 e1:
+	if (psTmp->psMPRing != NULL)
+	{
+		OSFreeMem(psTmp->psMPRing);
+	}
 	OSFreeMem(psTmp);
 e0:
 	OSLockRelease (TLGGD()->hTLGDLock);
@@ -425,7 +447,7 @@ void TLStreamReset(IMG_HANDLE hStream)
 
 	OSLockAcquire(psStream->hStreamWLock);
 
-	while (psStream->ui32Pending != NOTHING_PENDING)
+	while (psStream->ui32Pending != NOTHING_PENDING || psStream->ui32MPCount != 0)
 	{
 		/* We're in the middle of a write so we cannot reset the stream.
 		 * We are going to wait until the data is committed. Release lock while
@@ -459,6 +481,7 @@ void TLStreamReset(IMG_HANDLE hStream)
 
 	psStream->ui32Read = 0;
 	psStream->ui32Write = 0;
+	psStream->ui32Reserve = 0;
 	/* we know that ui32Pending already has correct value (no need to set) */
 
 	OSLockRelease(psStream->hStreamWLock);
@@ -514,7 +537,7 @@ TLStreamReconfigure(
 	 * while its mode is being reconfigured
 	 */
 	OSLockAcquire (psTmp->hStreamWLock);
-	if (NOTHING_PENDING != psTmp->ui32Pending)
+	if (NOTHING_PENDING != psTmp->ui32Pending || psTmp->ui32MPCount != 0)
 	{
 		OSLockRelease (psTmp->hStreamWLock);
 		PVR_DPF_RETURN_RC(PVRSRV_ERROR_NOT_READY);
@@ -522,6 +545,12 @@ TLStreamReconfigure(
 	psTmp->ui32Pending = 0;
 	OSLockRelease (psTmp->hStreamWLock);
 
+	if (psTmp->psMPRing != NULL && eOpMode == TL_OPMODE_DROP_OLDEST)
+	{
+		eError = PVRSRV_ERROR_INVALID_PARAMS;
+		goto e2;
+	}
+
 	psTmp->eOpMode = eOpMode;
 	if (psTmp->eOpMode == TL_OPMODE_BLOCK)
 	{
@@ -536,6 +565,7 @@ TLStreamReconfigure(
 		}
 	}
 
+e2:
 	OSLockAcquire (psTmp->hStreamWLock);
 	psTmp->ui32Pending = NOTHING_PENDING;
 	OSLockRelease (psTmp->hStreamWLock);
@@ -882,8 +912,9 @@ DoTLStreamReserve(IMG_HANDLE hStream,
 	ui32LWrite = psTmp->ui32Write;
 	ui32LPending = psTmp->ui32Pending;
 
-	/* Multiple pending reserves are not supported. */
-	if (NOTHING_PENDING != ui32LPending)
+	/* Multiple pending reserves are not supported. Streams created with
+	 * TL_FLAG_MULTI_PRODUCER should use TLStreamReserveMP instead. */
+	if (NOTHING_PENDING != ui32LPending || psTmp->ui32MPCount != 0)
 	{
 		OSLockRelease (psTmp->hStreamWLock);
 		PVR_DPF_RETURN_RC(PVRSRV_ERROR_NOT_READY);
@@ -1156,6 +1187,87 @@ TLStreamReserveReturnFlags(IMG_HANDLE hStream,
 	return DoTLStreamReserve(hStream, ppui8Data, ui32Size, ui32Size, PVRSRVTL_PACKETTYPE_DATA, NULL, pui32Flags);
 }
 
+/* Updates the buffer statistics and signals waiting consumers once the write
+ * offset has been advanced from ui32OldWrite. Called with hStreamWLock held. */
+static PVRSRV_ERROR
+DoTLStreamPublish(PTL_STREAM psTmp,
+				IMG_UINT32 ui32OldWrite,
+				IMG_UINT32 ui32LRead)
+{
+	PVRSRV_ERROR eError = PVRSRV_OK;
+
+#if defined(TL_BUFFER_STATS)
+	IMG_UINT32 ui32LWrite = psTmp->ui32Write;
+	IMG_UINT32 ui32UnreadBytes;
+
+	/* Calculate new number of bytes unread */
+	if (ui32LWrite > ui32LRead)
+	{
+		ui32UnreadBytes = (ui32LWrite-ui32LRead);
+	}
+	else if (ui32LWrite < ui32LRead)
+	{
+		ui32UnreadBytes = (psTmp->ui32Size-ui32LRead+ui32LWrite);
+	}
+	else
+	{ /* else equal, ignore */
+		ui32UnreadBytes = 0;
+	}
+
+	/* Calculate high water mark for debug purposes */
+	if (ui32UnreadBytes > psTmp->ui32BufferUt)
+	{
+		psTmp->ui32BufferUt = ui32UnreadBytes;
+	}
+
+	/* IF there has been no-reader since first reserve on an empty-buffer,
+	 * AND current utilisation is considerably high (90%), calculate the
+	 * time taken to fill up the buffer */
+	if ((OSAtomicRead(&psTmp->bNoReaderSinceFirstReserve) == 1) &&
+	    (TLStreamGetUT(psTmp) >= 90 * psTmp->ui32Size/100))
+	{
+		IMG_UINT32 ui32TimeToFullInUs = OSClockus() - psTmp->ui32TimeStart;
+		if (psTmp->ui32MinTimeToFullInUs > ui32TimeToFullInUs)
+		{
+			psTmp->ui32MinTimeToFullInUs = ui32TimeToFullInUs;
+		}
+		/* Following write ensures ui32MinTimeToFullInUs doesn't lose its
+		 * real (expected) value in case there is no reader until next Commit call */
+		OSAtomicWrite(&psTmp->bNoReaderSinceFirstReserve, 0);
+	}
+#endif
+
+	if (!psTmp->bNoSignalOnCommit)
+	{
+		/* If we have transitioned from an empty buffer to a non-empty buffer, we
+		 * must signal possibly waiting consumer. BUT, let the signal be "deferred"
+		 * until buffer is at least 'ui32ThresholdUsageForSignal' bytes full. This
+		 * avoids a race between OSEventObjectSignal and OSEventObjectWaitTimeout
+		 * (in TLServerAcquireDataKM), where a "signal" might happen before "wait",
+		 * resulting into signal being lost and stream-reader waiting even though
+		 * buffer is no-more empty */
+		if (ui32OldWrite == ui32LRead)
+		{
+			psTmp->bSignalPending = IMG_TRUE;
+		}
+
+		if (psTmp->bSignalPending && (TLStreamGetUT(psTmp) >= psTmp->ui32ThresholdUsageForSignal))
+		{
+			TL_COUNTER_INC(psTmp->ui32SignalsSent);
+			psTmp->bSignalPending = IMG_FALSE;
+
+			/* Signal consumers that may be waiting */
+			eError = OSEventObjectSignal(psTmp->psNode->hReadEventObj);
+		}
+		else
+		{
+			TL_COUNTER_INC(psTmp->ui32SignalNotSent);
+		}
+	}
+
+	return eError;
+}
+
 PVRSRV_ERROR
 TLStreamCommit(IMG_HANDLE hStream, IMG_UINT32 ui32ReqSize)
 {
@@ -1163,10 +1275,6 @@ TLStreamCommit(IMG_HANDLE hStream, IMG_UINT32 ui32ReqSize)
 	IMG_UINT32 ui32LRead, ui32OldWrite, ui32LWrite, ui32LPending;
 	PVRSRV_ERROR eError;
 
-#if defined(TL_BUFFER_STATS)
-	IMG_UINT32 ui32UnreadBytes;
-#endif
-
 	PVR_DPF_ENTERED;
 
 	if (NULL == hStream)
@@ -1197,28 +1305,6 @@ TLStreamCommit(IMG_HANDLE hStream, IMG_UINT32 ui32ReqSize)
 	/* and reset LPending to 0 since data are now submitted */
 	ui32LPending = NOTHING_PENDING;
 
-#if defined(TL_BUFFER_STATS)
-	/* Calculate new number of bytes unread */
-	if (ui32LWrite > ui32LRead)
-	{
-		ui32UnreadBytes = (ui32LWrite-ui32LRead);
-	}
-	else if (ui32LWrite < ui32LRead)
-	{
-		ui32UnreadBytes = (psTmp->ui32Size-ui32LRead+ui32LWrite);
-	}
-	else
-	{ /* else equal, ignore */
-		ui32UnreadBytes = 0;
-	}
-
-	/* Calculate high water mark for debug purposes */
-	if (ui32UnreadBytes > psTmp->ui32BufferUt)
-	{
-		psTmp->ui32BufferUt = ui32UnreadBytes;
-	}
-#endif
-
 	/* Memory barrier required to ensure prior data written by writer is
 	 * flushed from WC buffer to main memory. */
 	OSWriteMemoryBarrier(NULL);
@@ -1238,61 +1324,303 @@ TLStreamCommit(IMG_HANDLE hStream, IMG_UINT32 ui32ReqSize)
 	TL_COUNTER_ADD(psTmp->ui32ProducerByteCount, ui32ReqSize);
 	TL_COUNTER_INC(psTmp->ui32NumCommits);
 
-#if defined(TL_BUFFER_STATS)
-	/* IF there has been no-reader since first reserve on an empty-buffer,
-	 * AND current utilisation is considerably high (90%), calculate the
-	 * time taken to fill up the buffer */
-	if ((OSAtomicRead(&psTmp->bNoReaderSinceFirstReserve) == 1) &&
-	    (TLStreamGetUT(psTmp) >= 90 * psTmp->ui32Size/100))
+	eError = DoTLStreamPublish(psTmp, ui32OldWrite, ui32LRead);
+	OSLockRelease (psTmp->hStreamWLock);
+
+	PVR_DPF_RETURN_RC(eError);
+}
+
+PVRSRV_ERROR
+TLStreamReserveMP(IMG_HANDLE hStream,
+				IMG_UINT8 **ppui8Data,
+				IMG_UINT32 ui32Size)
+{
+	PTL_STREAM psTmp;
+	TL_MP_RESERVATION *psRes;
+	IMG_UINT32 *pui32Buf, ui32LRead, ui32LReserve, lReqSizeAligned, lReqSizeActual;
+	IMG_INT pad, iFreeSpace;
+	PVRSRVTL_PPACKETHDR pHdr;
+
+	PVR_DPF_ENTERED;
+
+	if (NULL == hStream || NULL == ppui8Data)
 	{
-		IMG_UINT32 ui32TimeToFullInUs = OSClockus() - psTmp->ui32TimeStart;
-		if (psTmp->ui32MinTimeToFullInUs > ui32TimeToFullInUs)
-		{
-			psTmp->ui32MinTimeToFullInUs = ui32TimeToFullInUs;
-		}
-		/* Following write ensures ui32MinTimeToFullInUs doesn't lose its
-		 * real (expected) value in case there is no reader until next Commit call */
-		OSAtomicWrite(&psTmp->bNoReaderSinceFirstReserve, 0);
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_INVALID_PARAMS);
 	}
-#endif
+	psTmp = (PTL_STREAM)hStream;
+	*ppui8Data = NULL;
 
-	if (!psTmp->bNoSignalOnCommit)
+	if (NULL == psTmp->psMPRing)
 	{
-		/* If we have transitioned from an empty buffer to a non-empty buffer, we
-		 * must signal possibly waiting consumer. BUT, let the signal be "deferred"
-		 * until buffer is at least 'ui32ThresholdUsageForSignal' bytes full. This
-		 * avoids a race between OSEventObjectSignal and OSEventObjectWaitTimeout
-		 * (in TLServerAcquireDataKM), where a "signal" might happen before "wait",
-		 * resulting into signal being lost and stream-reader waiting even though
-		 * buffer is no-more empty */
-		if (ui32OldWrite == ui32LRead)
+		PVR_DPF((PVR_DBG_ERROR, "%s: Stream '%s' is not a multi-producer stream",
+		         __func__, psTmp->szName));
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_INVALID_PARAMS);
+	}
+
+	/* The buffer is only used in "rounded" (aligned) chunks */
+	lReqSizeAligned = PVRSRVTL_ALIGN(ui32Size);
+
+	if (psTmp->ui32MaxPacketSize < lReqSizeAligned)
+	{
+		PVR_DPF((PVR_DBG_ERROR, "Requested Size: %u > TL Max Packet size: %u", lReqSizeAligned, psTmp->ui32MaxPacketSize));
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_TLPACKET_SIZE_LIMIT_EXCEEDED);
+	}
+
+	/* Unlike DoTLStreamReserve the lock is held for the whole reservation so
+	 * that each producer is handed a distinct, ordered slice of the buffer.
+	 * Only headers are written here, the payload copy happens unlocked. */
+	OSLockAcquire (psTmp->hStreamWLock);
+
+	/* A single-producer reservation (or a reconfigure) is in progress */
+	if (NOTHING_PENDING != psTmp->ui32Pending)
+	{
+		OSLockRelease (psTmp->hStreamWLock);
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_NOT_READY);
+	}
+
+	for (;;)
+	{
+		ui32LRead = psTmp->ui32Read;
+		ui32LReserve = (psTmp->ui32MPCount == 0) ? psTmp->ui32Write : psTmp->ui32Reserve;
+
+		/* If there is enough contiguous space following the reserve
+		 * position then no padding is required */
+		if (psTmp->ui32Size
+			< ui32LReserve + lReqSizeAligned + sizeof(PVRSRVTL_PACKETHDR))
 		{
-			psTmp->bSignalPending = IMG_TRUE;
+			pad = psTmp->ui32Size - ui32LReserve;
+		}
+		else
+		{
+			pad = 0;
 		}
 
-		if (psTmp->bSignalPending && (TLStreamGetUT(psTmp) >= psTmp->ui32ThresholdUsageForSignal))
+		lReqSizeActual = lReqSizeAligned + sizeof(PVRSRVTL_PACKETHDR) + pad;
+		if (psTmp->bNoWrapPermanent)
 		{
-			TL_COUNTER_INC(psTmp->ui32SignalsSent);
-			psTmp->bSignalPending = IMG_FALSE;
+			iFreeSpace = bufSpaceLeft(ui32LRead, ui32LReserve, psTmp->ui32Size);
+		}
+		else
+		{
+			iFreeSpace = circbufSpaceLeft(ui32LRead, ui32LReserve, psTmp->ui32Size);
+		}
 
-			/* Signal consumers that may be waiting */
-			eError = OSEventObjectSignal(psTmp->psNode->hReadEventObj);
-			if (eError != PVRSRV_OK)
+		if (psTmp->ui32MPCount < TL_MP_MAX_INFLIGHT &&
+		    iFreeSpace >= (IMG_INT) lReqSizeActual)
+		{
+			break;
+		}
+
+		if (psTmp->eOpMode == TL_OPMODE_BLOCK)
+		{
+			/* Wait for the reader to free space, or for older producers to
+			 * commit and release ring slots. */
+			OSLockRelease (psTmp->hStreamWLock);
+			(void) OSEventObjectWaitTimeout(psTmp->hProducerEvent, READ_PENDING_TIMEOUT_US);
+			OSLockAcquire (psTmp->hStreamWLock);
+			continue;
+		}
+
+		/* Drop the new data. The write failed marker can only be placed when
+		 * nothing is outstanding as it has to be published immediately. */
+		if (psTmp->ui32MPCount == 0)
+		{
+			pui32Buf = ui32LReserve
+					  ?
+					    (void *)&psTmp->pbyBuffer[ui32LReserve - sizeof(PVRSRVTL_PACKETHDR)]
+					   : // Previous four bytes are not guaranteed to be a packet header...
+					    (void *)&psTmp->pbyBuffer[psTmp->ui32Size - PVRSRVTL_PACKET_ALIGNMENT];
+
+			pHdr = GET_PACKET_HDR(pui32Buf);
+			if (PVRSRVTL_PACKETTYPE_MOST_RECENT_WRITE_FAILED != GET_PACKET_TYPE(pHdr))
 			{
-				OSLockRelease (psTmp->hStreamWLock);
-				PVR_DPF_RETURN_RC(eError);
+				pui32Buf = (void *)&psTmp->pbyBuffer[ui32LReserve];
+				pHdr = GET_PACKET_HDR(pui32Buf);
+				DoTLSetPacketHeader(pHdr, PVRSRVTL_SET_PACKET_WRITE_FAILED);
+
+				OSWriteMemoryBarrier(NULL);
+				psTmp->ui32Write = (ui32LReserve + sizeof(PVRSRVTL_PACKETHDR)) % psTmp->ui32Size;
 			}
 		}
-		else
+
+		TL_COUNTER_INC(psTmp->ui32MPDrops);
+		OSLockRelease (psTmp->hStreamWLock);
+
+		/* Inform call of permanent stream misuse, no space left,
+		 * the size of the stream will need to be increased. */
+		if (psTmp->bNoWrapPermanent)
 		{
-			TL_COUNTER_INC(psTmp->ui32SignalNotSent);
+			PVR_DPF_RETURN_RC(PVRSRV_ERROR_STREAM_NOT_ENOUGH_SPACE);
 		}
+
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_STREAM_FULL);
+	}
+
+#if defined(TL_BUFFER_STATS)
+	/* If writing into an empty buffer, start recording time-to-full */
+	if (psTmp->ui32MPCount == 0 && ui32LRead == psTmp->ui32Write)
+	{
+		OSAtomicWrite(&psTmp->bNoReaderSinceFirstReserve, 1);
+		psTmp->ui32TimeStart = OSClockus();
+	}
+
+	if (ui32Size > psTmp->ui32MaxReserveWatermark)
+	{
+		psTmp->ui32MaxReserveWatermark = ui32Size;
+	}
+#endif
+
+	if (pad)
+	{
+		/* Inserting padding packet, published together with this reservation */
+		pui32Buf = (void *)&psTmp->pbyBuffer[ui32LReserve];
+		pHdr = GET_PACKET_HDR(pui32Buf);
+		DoTLSetPacketHeader(pHdr,
+			PVRSRVTL_SET_PACKET_PADDING(pad-sizeof(PVRSRVTL_PACKETHDR)));
+
+		ui32LReserve = (ui32LReserve + pad) % psTmp->ui32Size;
+		/* Detect unaligned pad value */
+		PVR_ASSERT(ui32LReserve == 0);
 	}
+
+	/* Insert size-stamped packet header */
+	pui32Buf = (void *) &psTmp->pbyBuffer[ui32LReserve];
+	pHdr = GET_PACKET_HDR(pui32Buf);
+	DoTLSetPacketHeader(pHdr,
+		PVRSRVTL_SET_PACKET_HDR(ui32Size, PVRSRVTL_PACKETTYPE_DATA));
+
+	psRes = &psTmp->psMPRing[(psTmp->ui32MPHead + psTmp->ui32MPCount) % TL_MP_MAX_INFLIGHT];
+	psRes->ui32Start = ui32LReserve;
+	psRes->ui32End = (ui32LReserve + sizeof(PVRSRVTL_PACKETHDR) + lReqSizeAligned) % psTmp->ui32Size;
+	psRes->ui32Reserved = lReqSizeAligned;
+	psRes->bCommitted = IMG_FALSE;
+
+	psTmp->ui32MPCount++;
+	psTmp->ui32Reserve = psRes->ui32End;
+
+#if defined(TL_BUFFER_STATS)
+	TL_COUNTER_INC(psTmp->ui32MPReserves);
+	TL_COUNTER_INC(psTmp->ui32CntNumWriteSuccess);
+	if (psTmp->ui32MPCount > psTmp->ui32MPMaxInFlight)
+	{
+		psTmp->ui32MPMaxInFlight = psTmp->ui32MPCount;
+	}
+#endif
+
+	/* return the next position in the buffer to the user */
+	*ppui8Data = &psTmp->pbyBuffer[ui32LReserve + sizeof(PVRSRVTL_PACKETHDR)];
+
 	OSLockRelease (psTmp->hStreamWLock);
 
 	PVR_DPF_RETURN_OK;
 }
 
+PVRSRV_ERROR
+TLStreamCommitMP(IMG_HANDLE hStream,
+				IMG_UINT8 *pui8Data,
+				IMG_UINT32 ui32Size)
+{
+	PTL_STREAM psTmp;
+	TL_MP_RESERVATION *psRes = NULL;
+	IMG_UINT32 i, ui32Idx, ui32LRead, ui32OldWrite, ui32LWrite, lReqSizeAligned;
+	PVRSRVTL_PPACKETHDR pHdr;
+	PVRSRV_ERROR eError;
+
+	PVR_DPF_ENTERED;
+
+	if (NULL == hStream)
+	{
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_INVALID_PARAMS);
+	}
+	psTmp = (PTL_STREAM)hStream;
+
+	if (NULL == psTmp->psMPRing || NULL == pui8Data)
+	{
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_INVALID_PARAMS);
+	}
+
+	lReqSizeAligned = PVRSRVTL_ALIGN(ui32Size);
+
+	/* Memory barrier required to ensure prior data written by this producer
+	 * is flushed from WC buffer to main memory before it can be published,
+	 * possibly by another producer's commit. */
+	OSWriteMemoryBarrier(NULL);
+
+	OSLockAcquire (psTmp->hStreamWLock);
+
+	/* Find the reservation this data pointer belongs to */
+	for (i = 0; i < psTmp->ui32MPCount; i++)
+	{
+		ui32Idx = (psTmp->ui32MPHead + i) % TL_MP_MAX_INFLIGHT;
+		if (!psTmp->psMPRing[ui32Idx].bCommitted &&
+		    &psTmp->pbyBuffer[psTmp->psMPRing[ui32Idx].ui32Start + sizeof(PVRSRVTL_PACKETHDR)] == pui8Data)
+		{
+			psRes = &psTmp->psMPRing[ui32Idx];
+			break;
+		}
+	}
+
+	if (psRes == NULL || lReqSizeAligned > psRes->ui32Reserved)
+	{
+		OSLockRelease (psTmp->hStreamWLock);
+		PVR_DPF_RETURN_RC(PVRSRV_ERROR_STREAM_MISUSE);
+	}
+
+	/* Later reservations are already placed after this one so the span cannot
+	 * shrink; stamp the real size and pad out whatever was not used. */
+	pHdr = GET_PACKET_HDR(&psTmp->pbyBuffer[psRes->ui32Start]);
+	DoTLSetPacketHeader(pHdr,
+		PVRSRVTL_SET_PACKET_HDR(ui32Size, PVRSRVTL_PACKETTYPE_DATA));
+	if (lReqSizeAligned < psRes->ui32Reserved)
+	{
+		pHdr = GET_PACKET_HDR(&pui8Data[lReqSizeAligned]);
+		DoTLSetPacketHeader(pHdr,
+			PVRSRVTL_SET_PACKET_PADDING(psRes->ui32Reserved - lReqSizeAligned - sizeof(PVRSRVTL_PACKETHDR)));
+	}
+	OSWriteMemoryBarrier(NULL);
+
+	psRes->bCommitted = IMG_TRUE;
+
+	TL_COUNTER_ADD(psTmp->ui32ProducerByteCount, lReqSizeAligned + sizeof(PVRSRVTL_PACKETHDR));
+	TL_COUNTER_INC(psTmp->ui32NumCommits);
+
+	if (i != 0)
+	{
+		/* An older reservation is still being written, whoever commits it
+		 * will publish this packet too. */
+		TL_COUNTER_INC(psTmp->ui32MPOutOfOrder);
+		OSLockRelease (psTmp->hStreamWLock);
+		PVR_DPF_RETURN_OK;
+	}
+
+	/* Advance the write offset over every leading committed reservation */
+	ui32LRead = psTmp->ui32Read;
+	ui32OldWrite = psTmp->ui32Write;
+	ui32LWrite = ui32OldWrite;
+	while (psTmp->ui32MPCount != 0 && psTmp->psMPRing[psTmp->ui32MPHead].bCommitted)
+	{
+		ui32LWrite = psTmp->psMPRing[psTmp->ui32MPHead].ui32End;
+		psTmp->ui32MPHead = (psTmp->ui32MPHead + 1) % TL_MP_MAX_INFLIGHT;
+		psTmp->ui32MPCount--;
+	}
+
+	psTmp->ui32Write = ui32LWrite;
+
+	/* Ensure write pointer is flushed */
+	OSWriteMemoryBarrier(&psTmp->ui32Write);
+
+	eError = DoTLStreamPublish(psTmp, ui32OldWrite, ui32LRead);
+	OSLockRelease (psTmp->hStreamWLock);
+
+	/* Ring slots were freed, wake producers blocked on a full ring */
+	if (psTmp->eOpMode == TL_OPMODE_BLOCK)
+	{
+		(void) OSEventObjectSignal(psTmp->hProducerEventObj);
+	}
+
+	PVR_DPF_RETURN_RC(eError);
+}
+
 PVRSRV_ERROR
 TLStreamWrite(IMG_HANDLE hStream, IMG_UINT8 *pui8Src, IMG_UINT32 ui32Size)
 {
@@ -1776,6 +2104,11 @@ TLStreamDestroy (PTL_STREAM psStream)
 	OSEventObjectClose(psStream->hProducerEvent);
 	OSEventObjectDestroy(psStream->hProducerEventObj);
 
+	if (psStream->psMPRing != NULL)
+	{
+		OSFreeMem(psStream->psMPRing);
+	}
+
 	TLFreeSharedMem(psStream);
 	OSFreeMem(psStream);
 }
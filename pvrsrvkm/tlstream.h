@@ -156,6 +156,12 @@ static_assert(TL_OPMODE_LAST <= TL_OPMODE_MASK,
 /*! Defer allocation of stream's shared memory until first open. */
 #define TL_FLAG_ALLOCATE_ON_FIRST_OPEN (1U<<11)
 
+/*! Allow several producers to hold reservations on the stream at the same
+ * time through TLStreamReserveMP/TLStreamCommitMP. Packets become visible to
+ * the reader in reservation order once every earlier reservation has been
+ * committed. Not supported in combination with TL_OPMODE_DROP_OLDEST. */
+#define TL_FLAG_MULTI_PRODUCER         (1U<<12)
+
 /*! Structure used to pass internal TL stream sizes information to users.*/
 typedef struct _TL_STREAM_INFO_
 {
@@ -464,6 +470,65 @@ PVRSRV_ERROR
 TLStreamCommit(IMG_HANDLE hStream,
                IMG_UINT32 ui32Size);
 
+/*************************************************************************/ /*!
+ @Function      TLStreamReserveMP
+ @Description   Reserve space in the buffer of a stream created with
+                  TL_FLAG_MULTI_PRODUCER. Unlike TLStreamReserve, several
+                  reservations may be outstanding at once (up to
+                  TL_MP_MAX_INFLIGHT). Every successful call must be followed
+                  by a matching TLStreamCommitMP call with the returned data
+                  pointer.
+ @Input         hStream         Stream handle.
+ @Output        ppui8Data       Pointer to a pointer to a location in the
+                                  buffer. The caller can then use this address
+                                  in writing data into the stream.
+ @Input         ui32Size        Number of bytes to reserve in buffer.
+ @Return        PVRSRV_ERROR_INVALID_PARAMS  NULL stream handle or the stream
+                                             was not created with
+                                             TL_FLAG_MULTI_PRODUCER.
+ @Return        PVRSRV_ERROR_NOT_READY       A TLStreamReserve reservation is
+                                             pending on the stream.
+ @Return        PVRSRV_ERROR_STREAM_FULL     Not enough free space or too many
+                                             reservations in flight.
+ @Return        PVRSRV_ERROR_TLPACKET_SIZE_LIMIT_EXCEEDED  The reserve size
+                                                           requested is larger
+                                                           than max TL packet size
+ @Return        PVRSRV_ERROR_STREAM_NOT_ENOUGH_SPACE Permanent stream buffer
+                                                     does not have enough space
+                                                     for the reserve.
+ @Return        PVRSRV_OK                    Success, output arguments valid.
+*/ /**************************************************************************/
+PVRSRV_ERROR
+TLStreamReserveMP(IMG_HANDLE hStream,
+                  IMG_UINT8  **ppui8Data,
+                  IMG_UINT32 ui32Size);
+
+/*************************************************************************/ /*!
+ @Function      TLStreamCommitMP
+ @Description   Commit a reservation made with TLStreamReserveMP. Commits may
+                  happen in any order; the data only becomes visible to the
+                  reader once all earlier reservations are committed too.
+                  Committing fewer bytes than were reserved is allowed, the
+                  remainder is turned into a padding packet.
+ @Input         hStream         Stream handle.
+ @Input         pui8Data        Data pointer returned by TLStreamReserveMP.
+ @Input         ui32Size        Number of bytes that have been added to the
+                                  stream.
+ @Return        PVRSRV_ERROR_INVALID_PARAMS  NULL stream handle.
+ @Return        PVRSRV_ERROR_STREAM_MISUSE   pui8Data does not match an
+                                             outstanding reservation or
+                                             ui32Size exceeds the reserved
+                                             size.
+ @Return        eError                       Commit was successful but
+                                             internal services call returned
+                                             eError error number.
+ @Return        PVRSRV_OK
+*/ /**************************************************************************/
+PVRSRV_ERROR
+TLStreamCommitMP(IMG_HANDLE hStream,
+                 IMG_UINT8  *pui8Data,
+                 IMG_UINT32 ui32Size);
+
 /*************************************************************************/ /*!
  @Function      TLStreamWrite
  @Description   Combined Reserve/Commit call. This function Reserves space in
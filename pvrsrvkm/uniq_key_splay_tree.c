@@ -173,6 +173,7 @@ IMG_PSPLAY_TREE PVRSRVInsert(IMG_PSPLAY_FLAGS_T uiFlags, IMG_PSPLAY_TREE psTree)
 
 	psNew->uiFlags = uiFlags;
 	OSCachedMemSet(&(psNew->buckets[0]), 0, sizeof(psNew->buckets));
+	psNew->psFreeIndex = NULL;
 
 #if defined(PVR_CTZLL)
 	psNew->bHasEltsMapping = ~(((IMG_ELTS_MAPPINGS) 1 << (sizeof(psNew->buckets) / (sizeof(psNew->buckets[0])))) - 1);
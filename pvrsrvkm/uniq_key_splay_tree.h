@@ -79,6 +79,11 @@ typedef struct img_splay_tree
     IMG_ELTS_MAPPINGS bHasEltsMapping;
 #endif
 	struct _BT_ * buckets[FREE_TABLE_LIMIT];
+
+	/* root of the (size, base) ordered index of the free boundary tags
+	   with these flags, only maintained by arenas created with
+	   RA_POLICY_FREE_INDEX_TREE */
+	struct _BT_ * psFreeIndex;
 } IMG_SPLAY_TREE, *IMG_PSPLAY_TREE;
 
 IMG_PSPLAY_TREE PVRSRVSplay (IMG_PSPLAY_FLAGS_T uiFlags, IMG_PSPLAY_TREE psTree);
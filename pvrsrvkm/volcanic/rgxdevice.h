@@ -301,6 +301,9 @@ typedef struct _PVRSRV_DEVICE_FEATURE_CONFIG_
 #define RETURN_DATA_ARRAY_SIZE      ((1U) << RETURN_DATA_ARRAY_SIZE_LOG2)
 #define RETURN_DATA_ARRAY_WRAP_MASK (RETURN_DATA_ARRAY_SIZE - 1)
 
+/* Number of buckets in the ZS buffer backing latency histogram */
+#define RGX_ZSBUFFER_BACKING_LATENCY_BUCKETS	5U
+
 #define WORKLOAD_HASH_SIZE_LOG2		6
 #define WORKLOAD_HASH_SIZE			((1U) << WORKLOAD_HASH_SIZE_LOG2)
 #define WORKLOAD_HASH_WRAP_MASK		(WORKLOAD_HASH_SIZE - 1)
@@ -349,13 +352,15 @@ typedef union _RGX_WORKLOAD_
  * is evicted if the CB is full and the driver matches the characteristics
  * to the matching data.
  *
- * o If the driver finds a match the existing cycle estimate is averaged with
- *   the actual cycles used.
+ * o If the driver finds a match the existing cycle estimate is blended with
+ *   the actual cycles used (exponentially weighted moving average).
  * o Otherwise a new hash entry is created with the actual cycles for this
  *   workload.
  *
  * Subsequently if a match is found during command submission, the estimate
  * is passed to the scheduler, e.g. adjust the GPU frequency if PDVFS is enabled.
+ * If there is no match, the per-DM linear model (see WORKLOAD_MODEL) is used
+ * once it has been trained on enough completed workloads.
  */
 typedef struct _WORKLOAD_HASH_ENTRY_
 {
@@ -364,6 +369,34 @@ typedef struct _WORKLOAD_HASH_ENTRY_
 	IMG_UINT16 ui16KbytesWritten;
 } WORKLOAD_HASH_ENTRY;
 
+/* Weight of a newly completed workload in the per-key moving average (1/4) */
+#define WORKLOAD_EWMA_SHIFT			2
+
+#define WORKLOAD_MODEL_MAX_FEATURES		5
+#define WORKLOAD_MODEL_FRAC_BITS		16
+#define WORKLOAD_MODEL_FEATURE_MAX		((1U << 14) - 1U)
+#define WORKLOAD_MODEL_BIAS_FEATURE		(1U << 8)
+#define WORKLOAD_MODEL_MIN_SAMPLES		8U
+
+/*!
+ * Extracts the model features of a workload into aui32Features, each clamped
+ * to WORKLOAD_MODEL_FEATURE_MAX. Returns the number of features written.
+ */
+typedef IMG_UINT32 (WORKEST_FEATURE_FUNC)(const RGX_WORKLOAD *psWorkload,
+                                           IMG_UINT32 *aui32Features);
+
+/*!
+ * Online linear model predicting cycles from the workload characteristics.
+ * Weights are signed fixed point (WORKLOAD_MODEL_FRAC_BITS fractional bits)
+ * and are trained with normalised LMS on every completed workload.
+ */
+typedef struct _WORKLOAD_MODEL_
+{
+	WORKEST_FEATURE_FUNC	*pfnFeatures;
+	IMG_INT64		ai64Weights[WORKLOAD_MODEL_MAX_FEATURES];
+	IMG_UINT32		ui32Samples;
+} WORKLOAD_MODEL;
+
 typedef struct _WORKLOAD_MATCHING_DATA_
 {
 	POS_LOCK				psHashLock;
@@ -371,6 +404,7 @@ typedef struct _WORKLOAD_MATCHING_DATA_
 	RGX_WORKLOAD				asHashKeys[WORKLOAD_HASH_SIZE];
 	WORKLOAD_HASH_ENTRY			aui64HashData[WORKLOAD_HASH_SIZE];
 	IMG_UINT32				ui32HashArrayWO;	/*! track the most recent workload estimates */
+	WORKLOAD_MODEL				sModel;			/*! fallback estimator for unmatched workloads */
 } WORKLOAD_MATCHING_DATA;
 
 /*!
@@ -414,6 +448,29 @@ typedef struct _WORKEST_HOST_DATA_
 														 by the host before clean up. */
 } WORKEST_HOST_DATA;
 
+/*!
+ * Where the cycle estimate passed to the firmware for a workload came from.
+ */
+typedef enum _WORKEST_PREDICTION_SOURCE_
+{
+	WORKEST_PREDICTION_NONE = 0,	/*!< no estimate was passed to the firmware */
+	WORKEST_PREDICTION_HASH,	/*!< exact match of the workload characteristics */
+	WORKEST_PREDICTION_MODEL,	/*!< linear model over the characteristics */
+	WORKEST_PREDICTION_SOURCE_COUNT
+} WORKEST_PREDICTION_SOURCE;
+
+/*!
+ * Prediction error statistics, accumulated per DM and prediction source
+ * when a workload completes.
+ */
+typedef struct _WORKEST_ERROR_STATS_
+{
+	IMG_UINT64				ui64Samples;
+	IMG_UINT64				ui64ActualCycles;	/*!< sum of actual cycles */
+	IMG_UINT64				ui64AbsErrorCycles;	/*!< sum of |predicted - actual| */
+	IMG_UINT64				ui64Underestimates;	/*!< predictions below actual */
+} WORKEST_ERROR_STATS;
+
 /*!
  * Entries in the list of submitted workloads, used when the completed command
  * returns data to the host.
@@ -428,8 +485,10 @@ typedef struct _WORKEST_RETURN_DATA_
 	WORKEST_HOST_DATA		*psWorkEstHostData;
 	WORKLOAD_MATCHING_DATA	*psWorkloadMatchingData;
 	RGX_WORKLOAD			sWorkloadCharacteristics;
-#if defined(PVRSRV_ANDROID_TRACK_WORKLOAD_ESTIMATES)
 	RGXFWIF_CCB_CMD_TYPE		eCmdType;
+	IMG_UINT64			ui64CyclesPredicted;
+	WORKEST_PREDICTION_SOURCE	ePredictionSource;
+#if defined(PVRSRV_ANDROID_TRACK_WORKLOAD_ESTIMATES)
 	IMG_UINT64			ui64SubmitTime;
 	IMG_UINT64			ui64Deadline;
 	IMG_UINT32			ui32Uid;
@@ -669,6 +728,8 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	WORKEST_RETURN_DATA     asReturnData[RETURN_DATA_ARRAY_SIZE];
 	IMG_UINT32              ui32ReturnDataWO;
 	POS_LOCK                hWorkEstLock;
+	/* Prediction error statistics, protected by hWorkEstLock */
+	WORKEST_ERROR_STATS     aasWorkEstStats[RGXFWIF_DM_MAX][WORKEST_PREDICTION_SOURCE_COUNT];
 #endif
 
 #if defined(SUPPORT_PDVFS)
@@ -772,8 +833,16 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 
 	POS_LOCK				hLockZSBuffer;		/*!< Lock to protect simultaneous access to ZSBuffers */
 	DLLIST_NODE				sZSBufferHead;		/*!< List of on-demand ZSBuffers */
+	DLLIST_NODE				sZSBufferWarmHead;	/*!< ZSBuffers unbacked but still mapped, oldest first */
+	IMG_UINT32				ui32ZSBufferWarmCount;	/*!< Number of ZSBuffers on sZSBufferWarmHead */
+	IMG_DEVMEM_SIZE_T		uiZSBufferWarmSize;	/*!< Bytes kept mapped by sZSBufferWarmHead */
+	IMG_UINT32				ui32ZSBufferWarmHits;	/*!< Backing requests satisfied by a warm mapping */
+	IMG_UINT32				ui32ZSBufferWarmMisses;	/*!< Backing requests which had to map the PMR */
+	IMG_UINT32				ui32ZSBufferWarmEvictions;	/*!< Warm mappings released */
+	IMG_UINT32				aui32ZSBufferBackingLatency[RGX_ZSBUFFER_BACKING_LATENCY_BUCKETS]; /*!< Backing times, decades from 10us */
 	POS_LOCK				hLockFreeList;		/*!< Lock to protect simultaneous access to Freelists */
 	DLLIST_NODE				sFreeListHead;		/*!< List of growable Freelists */
+	HASH_TABLE				*psFreeListHashTable;	/*!< Growable Freelists indexed by FW freelist ID */
 	PSYNC_PRIM_CONTEXT		hSyncPrimContext;
 	PVRSRV_CLIENT_SYNC_PRIM	*psPowSyncPrim;
 
@@ -839,6 +908,17 @@ typedef struct _PVRSRV_RGXDEV_INFO_
 	DLLIST_NODE				sKCCBDeferredCommandsListHead;
 	IMG_UINT32				ui32KCCBDeferredCommandsCount; /*!< No of commands in the deferred list */
 
+	/* KCCB submission batching, see RGXKCCBBatchBegin(). Protected by the
+	 * power lock. */
+	IMG_UINT32				ui32KCCBBatchDepth;          /*!< Nesting depth of open KCCB batches */
+	IMG_UINT32				ui32KCCBPendingCmds;         /*!< Commands written but not yet published to the FW */
+	IMG_UINT64				ui64KCCBPendingSinceNs;      /*!< Time the oldest pending command was written */
+	IMG_UINT64				ui64KCCBCmdsSubmitted;       /*!< Commands published to the FW */
+	IMG_UINT64				ui64KCCBDoorbells;           /*!< MTS kicks for the KCCB */
+	IMG_UINT32				ui32KCCBMaxCmdsPerDoorbell;  /*!< Largest number of commands covered by one MTS kick */
+	IMG_UINT64				ui64KCCBPendingTimeNs;       /*!< Total time commands waited for their MTS kick */
+	IMG_UINT64				ui64KCCBMaxPendingTimeNs;    /*!< Longest time a command waited for its MTS kick */
+
 	/* Linked lists of contexts on this device */
 	DLLIST_NODE				sRenderCtxtListHead;
 	DLLIST_NODE				sComputeCtxtListHead;
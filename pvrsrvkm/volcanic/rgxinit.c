@@ -1204,6 +1204,7 @@ PVRSRV_ERROR RGXInitDevPart2(PVRSRV_DEVICE_NODE	*psDeviceNode,
 	eError = OSLockCreate(&psDevInfo->hLockZSBuffer);
 	PVR_LOG_GOTO_IF_ERROR(eError, "OSLockCreate(LockZSBuffer)", ErrorExit);
 	dllist_init(&psDevInfo->sZSBufferHead);
+	dllist_init(&psDevInfo->sZSBufferWarmHead);
 	psDevInfo->ui32ZSBufferCurrID = 1;
 
 	/* Initialise lists of growable Freelists */
@@ -1211,6 +1212,11 @@ PVRSRV_ERROR RGXInitDevPart2(PVRSRV_DEVICE_NODE	*psDeviceNode,
 	PVR_LOG_GOTO_IF_ERROR(eError, "OSLockCreate(LockFreeList)", ErrorExit);
 	dllist_init(&psDevInfo->sFreeListHead);
 	psDevInfo->ui64FreelistCurrID = 1;
+	psDevInfo->psFreeListHashTable = HASH_Create_Extended(RGX_FREELIST_HASH_SIZE,
+	                                                      sizeof(psDevInfo->ui64FreelistCurrID),
+	                                                      HASH_Func_Default,
+	                                                      HASH_Key_Comp_Default);
+	PVR_LOG_GOTO_IF_NOMEM(psDevInfo->psFreeListHashTable, eError, ErrorExit);
 
 	eError = OSLockCreate(&psDevInfo->hDebugFaultInfoLock);
 	PVR_LOG_GOTO_IF_ERROR(eError, "OSLockCreate(DebugFaultInfoLock)", ErrorExit);
@@ -3074,6 +3080,12 @@ static void DevPart2DeInitRGX(PVRSRV_DEVICE_NODE *psDeviceNode)
 	}
 
 	/* De-init Freelists/ZBuffers... */
+	if (psDevInfo->psFreeListHashTable != NULL)
+	{
+		HASH_Delete(psDevInfo->psFreeListHashTable);
+		psDevInfo->psFreeListHashTable = NULL;
+	}
+
 	if (psDevInfo->hLockFreeList != NULL)
 	{
 		OSLockDestroy(psDevInfo->hLockFreeList);
@@ -4532,6 +4544,7 @@ PVRSRV_ERROR RGXRegisterDevice(PVRSRV_DEVICE_NODE *psDeviceNode)
 	psDeviceNode->pfnMMUCacheInvalidate = RGXMMUCacheInvalidate;
 	psDeviceNode->pfnMMUCacheInvalidateKick = RGXMMUCacheInvalidateKick;
 	psDeviceNode->pfnMMUCacheInvalidateKickAndWait = NULL;
+	psDeviceNode->pfnMMUCacheInvalidateKickDeferred = RGXMMUCacheInvalidateKickDeferred;
 #if defined(RGX_BRN71422_TARGET_HARDWARE_PHYSICAL_ADDR)
 	psDeviceNode->pfnMMUTopLevelPxWorkarounds = RGXMapBRN71422TargetPhysicalAddress;
 #else
@@ -270,6 +270,16 @@ IMG_BOOL RGXDumpFreeListPageList(RGX_FREELIST *psFreeList)
 				psFreeList->sFreeListFWDevVAddr.ui32Addr,
 				psFreeList->ui64FreelistID,
 				psFreeList->ui64FreelistChecksum));
+	PVR_LOG(("  Pages %u+%u/%u, FW grow requests %u, partial renders %u, pre-grown pages %u (hits %u, misses %u, step x%u)",
+				psFreeList->ui32CurrentFLPages,
+				psFreeList->ui32ReadyFLPages,
+				psFreeList->ui32MaxFLPages,
+				psFreeList->ui32NumGrowReqByFW,
+				psFreeList->ui32NumPartialRenders,
+				psFreeList->ui32NumPreGrowPages,
+				psFreeList->ui32NumPreGrowHits,
+				psFreeList->ui32NumPreGrowMisses,
+				psFreeList->ui32PreGrowSteps));
 
 	/* Dump Init FreeList page list */
 	PVR_LOG(("  Initial Memory block"));
@@ -838,26 +848,83 @@ static PVRSRV_ERROR RGXShrinkFreeList(PDLLIST_NODE pListHeader,
 	return eError;
 }
 
+/* Looks up a freelist by FW ID. hLockFreeList must be held by the caller. */
+static INLINE RGX_FREELIST *_LookupFreeList(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_UINT64 ui64FreelistID)
+{
+	return (RGX_FREELIST *) HASH_Retrieve_Extended(psDevInfo->psFreeListHashTable, &ui64FreelistID);
+}
+
 static RGX_FREELIST *FindFreeList(PVRSRV_RGXDEV_INFO *psDevInfo, IMG_UINT64 ui64FreelistID)
 {
-	DLLIST_NODE *psNode, *psNext;
-	RGX_FREELIST *psFreeList = NULL;
+	RGX_FREELIST *psFreeList;
 
 	OSLockAcquire(psDevInfo->hLockFreeList);
+	psFreeList = _LookupFreeList(psDevInfo, ui64FreelistID);
+	OSLockRelease(psDevInfo->hLockFreeList);
 
-	dllist_foreach_node(&psDevInfo->sFreeListHead, psNode, psNext)
+	return psFreeList;
+}
+
+/*
+ *  Predictive growth: FW grow requests which arrive in quick succession
+ *  mean the freelist is being consumed faster than it is grown, so each
+ *  one in a burst grants a further multiple of the grow size ahead of
+ *  demand. The FW only accepts grow updates in reply to its own requests,
+ *  so this is where pages can be handed out early. Once the freelist goes
+ *  quiet the multiple decays back to a single grow step; pages already in
+ *  the FW freelist cannot be returned while it is live.
+ */
+#define RGX_FREELIST_PREGROW_WINDOW_MS		500U
+#define RGX_FREELIST_PREGROW_DECAY_MS		5000U
+#define RGX_FREELIST_PREGROW_MAX_STEPS		4U
+
+static IMG_UINT32 _CalculateFreelistGrowPages(RGX_FREELIST *psFreeList)
+{
+	IMG_UINT32 ui32NowMs = OSClockms();
+	IMG_UINT32 ui32SinceLastMs = ui32NowMs - psFreeList->ui32LastGrowReqTimeMs;
+	IMG_UINT32 ui32AvailPages = psFreeList->ui32MaxFLPages -
+	                            (psFreeList->ui32CurrentFLPages + psFreeList->ui32ReadyFLPages);
+
+	if (psFreeList->ui32NumGrowReqByFW == 0 || ui32SinceLastMs > RGX_FREELIST_PREGROW_DECAY_MS)
 	{
-		RGX_FREELIST *psThisFreeList = IMG_CONTAINER_OF(psNode, RGX_FREELIST, sNode);
+		/* First request, or the freelist has been underused for a while */
+		if (psFreeList->ui32LastPreGrowPages != 0)
+		{
+			psFreeList->ui32NumPreGrowMisses++;
+		}
+		psFreeList->ui32PreGrowSteps = 1;
+	}
+	else
+	{
+		/* Everything granted last time, pre-grown pages included, has been used */
+		if (psFreeList->ui32LastPreGrowPages != 0)
+		{
+			psFreeList->ui32NumPreGrowHits++;
+		}
 
-		if (psThisFreeList->ui64FreelistID == ui64FreelistID)
+		if (ui32SinceLastMs <= RGX_FREELIST_PREGROW_WINDOW_MS)
 		{
-			psFreeList = psThisFreeList;
-			break;
+			if (psFreeList->ui32PreGrowSteps < RGX_FREELIST_PREGROW_MAX_STEPS)
+			{
+				psFreeList->ui32PreGrowSteps++;
+			}
+		}
+		else if (psFreeList->ui32PreGrowSteps > 1)
+		{
+			psFreeList->ui32PreGrowSteps--;
 		}
 	}
 
-	OSLockRelease(psDevInfo->hLockFreeList);
-	return psFreeList;
+	psFreeList->ui32LastGrowReqTimeMs = ui32NowMs;
+
+	/* Never ask for more than the freelist has room for */
+	while (psFreeList->ui32PreGrowSteps > 1 &&
+	       psFreeList->ui32PreGrowSteps * psFreeList->ui32GrowFLPages > ui32AvailPages)
+	{
+		psFreeList->ui32PreGrowSteps--;
+	}
+
+	return psFreeList->ui32PreGrowSteps * psFreeList->ui32GrowFLPages;
 }
 
 void RGXProcessRequestGrow(PVRSRV_RGXDEV_INFO *psDevInfo,
@@ -885,15 +952,26 @@ void RGXProcessRequestGrow(PVRSRV_RGXDEV_INFO *psDevInfo,
 	psFreeList->ui32CurrentFLPages += psFreeList->ui32ReadyFLPages;
 	psFreeList->ui32ReadyFLPages = 0;
 
-	/* Try to grow the freelist */
+	/* Try to grow the freelist, ahead of demand if requests are arriving in a burst */
+	ui32GrowValue = _CalculateFreelistGrowPages(psFreeList);
 	eError = RGXGrowFreeList(psFreeList,
-	                         psFreeList->ui32GrowFLPages,
+	                         ui32GrowValue,
 	                         &psFreeList->sMemoryBlockHead);
+	if (eError != PVRSRV_OK && ui32GrowValue > psFreeList->ui32GrowFLPages)
+	{
+		/* Fall back to the size the FW asked for */
+		psFreeList->ui32PreGrowSteps = 1;
+		ui32GrowValue = psFreeList->ui32GrowFLPages;
+		eError = RGXGrowFreeList(psFreeList,
+		                         ui32GrowValue,
+		                         &psFreeList->sMemoryBlockHead);
+	}
 
 	if (eError == PVRSRV_OK)
 	{
-		/* Grow successful, return size of grow size */
-		ui32GrowValue = psFreeList->ui32GrowFLPages;
+		/* Grow successful, ui32GrowValue holds the grow size */
+		psFreeList->ui32LastPreGrowPages = ui32GrowValue - psFreeList->ui32GrowFLPages;
+		psFreeList->ui32NumPreGrowPages += psFreeList->ui32LastPreGrowPages;
 
 		psFreeList->ui32NumGrowReqByFW++;
 
@@ -911,8 +989,10 @@ void RGXProcessRequestGrow(PVRSRV_RGXDEV_INFO *psDevInfo,
 	}
 	else
 	{
-		/* Grow failed */
+		/* Grow failed, the FW will have to partially render to free up pages */
 		ui32GrowValue = 0;
+		psFreeList->ui32LastPreGrowPages = 0;
+		psFreeList->ui32NumPartialRenders++;
 		PVR_DPF((PVR_DBG_ERROR,
 		         "Grow for FreeList %p failed (%s)",
 		         psFreeList,
@@ -1214,33 +1294,30 @@ void RGXProcessRequestFreelistsReconstruction(PVRSRV_RGXDEV_INFO *psDevInfo,
 	 *  PIDs is calculated from the list of freelists in this first pass.
 	 */
 	OSLockAcquire(psDevInfo->hLockFreeList);
-	dllist_foreach_node(&psDevInfo->sFreeListHead, psNode, psNext)
+	for (ui32Loop = 0; ui32Loop < ui32FreelistsCount; ui32Loop++)
 	{
-		RGX_FREELIST  *psFreeList   = IMG_CONTAINER_OF(psNode, RGX_FREELIST, sNode);
+		IMG_UINT64    ui64FreelistID = bUse32BitIds ? (IMG_UINT64)paui32Freelists[ui32Loop] :
+		                                              paui64Freelists[ui32Loop];
+		RGX_FREELIST  *psFreeList    = _LookupFreeList(psDevInfo, ui64FreelistID);
+		IMG_UINT32    ui32PIDLoop;
 
-		for (ui32Loop = 0; ui32Loop < ui32FreelistsCount; ui32Loop++)
+		if (psFreeList == NULL)
 		{
-			IMG_UINT32 ui32PIDLoop;
+			continue;
+		}
 
-			IMG_BOOL bIdMatch =
-			    bUse32BitIds ? ((IMG_UINT64)paui32Freelists[ui32Loop] == psFreeList->ui64FreelistID) :
-			                               (paui64Freelists[ui32Loop] == psFreeList->ui64FreelistID);
-			if (bIdMatch)
+		for (ui32PIDLoop = 0; ui32PIDLoop < ui32PIDCount; ui32PIDLoop++)
+		{
+			if (aui32PIDList[ui32PIDLoop] == psFreeList->ownerPid)
 			{
-				for (ui32PIDLoop = 0; ui32PIDLoop < ui32PIDCount; ui32PIDLoop++)
-				{
-					if (aui32PIDList[ui32PIDLoop] == psFreeList->ownerPid)
-					{
-						break;
-					}
-				}
-
-				if (ui32PIDLoop == ui32PIDCount)
-				{
-					aui32PIDList[ui32PIDCount++] = psFreeList->ownerPid;
-				}
+				break;
 			}
 		}
+
+		if (ui32PIDLoop == ui32PIDCount)
+		{
+			aui32PIDList[ui32PIDCount++] = psFreeList->ownerPid;
+		}
 	}
 	dllist_foreach_node(&psDevInfo->sFreeListHead, psNode, psNext)
 	{
@@ -2002,6 +2079,13 @@ PVRSRV_ERROR RGXCreateFreeList(CONNECTION_DATA       *psConnection,
 	psFreeList->ui64FreelistChecksum = 0;
 	psFreeList->ui32RefCount = 0;
 	psFreeList->bCheckFreelist = bCheckFreelist;
+	psFreeList->ui32NumPartialRenders = 0;
+	psFreeList->ui32PreGrowSteps = 1;
+	psFreeList->ui32LastPreGrowPages = 0;
+	psFreeList->ui32LastGrowReqTimeMs = 0;
+	psFreeList->ui32NumPreGrowPages = 0;
+	psFreeList->ui32NumPreGrowHits = 0;
+	psFreeList->ui32NumPreGrowMisses = 0;
 	dllist_init(&psFreeList->sMemoryBlockHead);
 	dllist_init(&psFreeList->sMemoryBlockInitHead);
 #if !defined(SUPPORT_SHADOW_FREELISTS)
@@ -2016,6 +2100,15 @@ PVRSRV_ERROR RGXCreateFreeList(CONNECTION_DATA       *psConnection,
 	                                 (psDevInfo->ui64FreelistCurrID++) :
 	                                 (IMG_UINT32)(psDevInfo->ui64FreelistCurrID++);
 	PVR_ASSERT(bFWSupports64BitFLId || (psFreeList->ui64FreelistID >> 32) == 0U);
+	if (!HASH_Insert_Extended(psDevInfo->psFreeListHashTable,
+	                          &psFreeList->ui64FreelistID,
+	                          (uintptr_t) psFreeList))
+	{
+		OSLockRelease(psDevInfo->hLockFreeList);
+		PVR_DPF((PVR_DBG_ERROR, "%s: Failed to index freelist", __func__));
+		eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+		goto ErrorHashInsert;
+	}
 	dllist_add_to_tail(&psDevInfo->sFreeListHead, &psFreeList->sNode);
 	OSLockRelease(psDevInfo->hLockFreeList);
 
@@ -2186,7 +2279,9 @@ ErrorWritePMR:
 	/* Remove freelists from list */
 	OSLockAcquire(psDevInfo->hLockFreeList);
 	dllist_remove_node(&psFreeList->sNode);
+	HASH_Remove_Extended(psDevInfo->psFreeListHashTable, &psFreeList->ui64FreelistID);
 	OSLockRelease(psDevInfo->hLockFreeList);
+ErrorHashInsert:
 	RGXUnsetFirmwareAddress(psFWFreelistMemDesc);
 
 ErrorSetFwAddr:
@@ -2246,6 +2341,7 @@ PVRSRV_ERROR RGXDestroyFreeList(RGX_FREELIST *psFreeList)
 
 	/* Remove FreeList from linked list before we destroy it... */
 	dllist_remove_node(&psFreeList->sNode);
+	HASH_Remove_Extended(psFreeList->psDevInfo->psFreeListHashTable, &psFreeList->ui64FreelistID);
 #if !defined(SUPPORT_SHADOW_FREELISTS)
 	/* Confirm all HWRTData nodes are freed before releasing freelist */
 	PVR_ASSERT(dllist_is_empty(&psFreeList->sNodeHWRTDataHead));
@@ -2469,6 +2565,110 @@ ErrorAllocCleanup:
 }
 
 
+/*
+ *  ZS buffer warm pool: unbacking an on-demand ZS buffer leaves its PMR
+ *  mapped for a while, so that a backing request shortly afterwards (apps
+ *  alternating between render passes) does not pay for another allocation,
+ *  map and MMU invalidate while the FW waits. The physical backing belongs
+ *  to the buffer's own PMR, so the pool holds buffers rather than pages.
+ *  Warm mappings are released once they time out, when the pool is over
+ *  its size limit, or when mapping another buffer runs out of memory.
+ */
+#define RGX_ZSBUFFER_WARM_TIMEOUT_MS		2000U
+#define RGX_ZSBUFFER_WARM_POOL_MAX_SIZE		(64U * 1024U * 1024U)
+
+/* Releases the mapping of a warm ZS buffer. hLockZSBuffer must be held. */
+static PVRSRV_ERROR _RGXZSBufferWarmEvict(RGX_ZSBUFFER_DATA *psZSBuffer)
+{
+	PVRSRV_RGXDEV_INFO *psDevInfo = psZSBuffer->psDevInfo;
+	PVRSRV_ERROR eError;
+
+	PVR_ASSERT(psZSBuffer->bIsWarm);
+
+	eError = DevmemIntUnmapPMR(psZSBuffer->psReservation);
+	PVR_LOG_RETURN_IF_ERROR(eError, "DevmemIntUnmapPMR");
+
+	dllist_remove_node(&psZSBuffer->sWarmNode);
+	psZSBuffer->bIsWarm = IMG_FALSE;
+	psDevInfo->ui32ZSBufferWarmCount--;
+	psDevInfo->uiZSBufferWarmSize -= PMR_LogicalSize(psZSBuffer->psPMR);
+	psDevInfo->ui32ZSBufferWarmEvictions++;
+
+	PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing removed (warm pool)",
+	                          psZSBuffer,
+	                          psZSBuffer->ui32ZSBufferID));
+
+	return PVRSRV_OK;
+}
+
+/*
+ * Releases warm mappings, oldest first, until the pool has room for
+ * uiNeededSize more bytes and holds nothing older than the timeout.
+ * hLockZSBuffer must be held.
+ */
+static void _RGXZSBufferWarmTrim(PVRSRV_RGXDEV_INFO *psDevInfo,
+                                 IMG_DEVMEM_SIZE_T uiNeededSize)
+{
+	DLLIST_NODE *psNode, *psNext;
+	IMG_UINT32 ui32NowMs = OSClockms();
+
+	dllist_foreach_node(&psDevInfo->sZSBufferWarmHead, psNode, psNext)
+	{
+		RGX_ZSBUFFER_DATA *psZSBuffer = IMG_CONTAINER_OF(psNode, RGX_ZSBUFFER_DATA, sWarmNode);
+
+		if (psDevInfo->uiZSBufferWarmSize + uiNeededSize <= RGX_ZSBUFFER_WARM_POOL_MAX_SIZE &&
+		    (ui32NowMs - psZSBuffer->ui32WarmSinceMs) < RGX_ZSBUFFER_WARM_TIMEOUT_MS)
+		{
+			break;
+		}
+
+		if (_RGXZSBufferWarmEvict(psZSBuffer) != PVRSRV_OK)
+		{
+			break;
+		}
+	}
+}
+
+static void _RGXZSBufferRecordBackingLatency(PVRSRV_RGXDEV_INFO *psDevInfo,
+                                             IMG_UINT64 ui64StartNs)
+{
+	IMG_UINT64 ui64ElapsedNs = OSClockns64() - ui64StartNs;
+	IMG_UINT64 ui64LimitNs = 10000;
+	IMG_UINT32 ui32Bucket;
+
+	for (ui32Bucket = 0;
+	     ui32Bucket < RGX_ZSBUFFER_BACKING_LATENCY_BUCKETS - 1 && ui64ElapsedNs >= ui64LimitNs;
+	     ui32Bucket++)
+	{
+		ui64LimitNs *= 10;
+	}
+
+	psDevInfo->aui32ZSBufferBackingLatency[ui32Bucket]++;
+}
+
+void RGXZSBufferWarmPoolTrim(PVRSRV_RGXDEV_INFO *psDevInfo)
+{
+	OSLockAcquire(psDevInfo->hLockZSBuffer);
+	_RGXZSBufferWarmTrim(psDevInfo, 0);
+	OSLockRelease(psDevInfo->hLockZSBuffer);
+}
+
+void RGXZSBufferWarmPoolStatsPrint(PVRSRV_RGXDEV_INFO *psDevInfo,
+                                   DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
+                                   void *pvDumpDebugFile)
+{
+	const IMG_UINT32 *pui32Latency = psDevInfo->aui32ZSBufferBackingLatency;
+
+	PVR_DUMPDEBUG_LOG("ZS Buffer warm pool: %u buffers (%" IMG_UINT64_FMTSPEC " bytes), hits %u, misses %u, evictions %u",
+	                  psDevInfo->ui32ZSBufferWarmCount,
+	                  (IMG_UINT64)psDevInfo->uiZSBufferWarmSize,
+	                  psDevInfo->ui32ZSBufferWarmHits,
+	                  psDevInfo->ui32ZSBufferWarmMisses,
+	                  psDevInfo->ui32ZSBufferWarmEvictions);
+	PVR_DUMPDEBUG_LOG("ZS Buffer backing latency: <10us %u, <100us %u, <1ms %u, <10ms %u, >=10ms %u",
+	                  pui32Latency[0], pui32Latency[1], pui32Latency[2], pui32Latency[3], pui32Latency[4]);
+}
+
 /*
 	RGXDestroyZSBuffer
 */
@@ -2498,6 +2698,16 @@ PVRSRV_ERROR RGXDestroyZSBufferKM(RGX_ZSBUFFER_DATA *psZSBuffer)
 		return PVRSRV_ERROR_RETRY;
 	}
 
+	if (psZSBuffer->bIsWarm)
+	{
+		eError2 = _RGXZSBufferWarmEvict(psZSBuffer);
+		if (eError2 != PVRSRV_OK)
+		{
+			OSLockRelease(hLockZSBuffer);
+			return eError2;
+		}
+	}
+
 	/* Free the firmware render context. */
 	RGXUnsetFirmwareAddress(psZSBuffer->psFWZSBufferMemDesc);
 	DevmemFwUnmapAndFree(psZSBuffer->psDevInfo, psZSBuffer->psFWZSBufferMemDesc);
@@ -2530,6 +2740,7 @@ RGXBackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 {
 	POS_LOCK hLockZSBuffer;
 	PVRSRV_ERROR eError;
+	IMG_UINT64 ui64StartNs = OSClockns64();
 
 	if (!psZSBuffer)
 	{
@@ -2550,7 +2761,25 @@ RGXBackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 
 	OSLockAcquire(hLockZSBuffer);
 
-	if (psZSBuffer->bIsBacked == IMG_FALSE)
+	if (psZSBuffer->bIsWarm)
+	{
+		PVRSRV_RGXDEV_INFO *psDevInfo = psZSBuffer->psDevInfo;
+
+		/* Still mapped from the last time it was backed */
+		dllist_remove_node(&psZSBuffer->sWarmNode);
+		psZSBuffer->bIsWarm = IMG_FALSE;
+		psDevInfo->ui32ZSBufferWarmCount--;
+		psDevInfo->uiZSBufferWarmSize -= PMR_LogicalSize(psZSBuffer->psPMR);
+		psDevInfo->ui32ZSBufferWarmHits++;
+		_RGXZSBufferRecordBackingLatency(psDevInfo, ui64StartNs);
+
+		PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing reused (warm pool)",
+		                          psZSBuffer,
+		                          psZSBuffer->ui32ZSBufferID));
+
+		psZSBuffer->bIsBacked = IMG_TRUE;
+	}
+	else if (psZSBuffer->bIsBacked == IMG_FALSE)
 	{
 		IMG_HANDLE hDevmemHeap;
 
@@ -2563,6 +2792,15 @@ RGXBackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 		}
 
 		eError = DevmemIntMapPMR(psZSBuffer->psReservation, psZSBuffer->psPMR);
+		if (eError != PVRSRV_OK &&
+		    !dllist_is_empty(&psZSBuffer->psDevInfo->sZSBufferWarmHead))
+		{
+			/* The failure is most likely the page allocation
+			 * (PVRSRV_ERROR_PMR_FAILED_TO_ALLOC_PAGES), give back the
+			 * warm pool's pages and try again */
+			_RGXZSBufferWarmTrim(psZSBuffer->psDevInfo, RGX_ZSBUFFER_WARM_POOL_MAX_SIZE);
+			eError = DevmemIntMapPMR(psZSBuffer->psReservation, psZSBuffer->psPMR);
+		}
 		if (eError != PVRSRV_OK)
 		{
 			PVR_DPF((PVR_DBG_ERROR,
@@ -2578,6 +2816,9 @@ RGXBackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 		                          psZSBuffer,
 		                          psZSBuffer->ui32ZSBufferID));
 
+		psZSBuffer->psDevInfo->ui32ZSBufferWarmMisses++;
+		_RGXZSBufferRecordBackingLatency(psZSBuffer->psDevInfo, ui64StartNs);
+
 		psZSBuffer->bIsBacked = IMG_TRUE;
 	}
 
@@ -2662,6 +2903,32 @@ RGXUnbackingZSBuffer(RGX_ZSBUFFER_DATA *psZSBuffer)
 
 	if (psZSBuffer->bOnDemand && psZSBuffer->bIsBacked == IMG_TRUE)
 	{
+#if !defined(PDUMP)
+		PVRSRV_RGXDEV_INFO *psDevInfo = psZSBuffer->psDevInfo;
+		IMG_DEVMEM_SIZE_T uiSize = PMR_LogicalSize(psZSBuffer->psPMR);
+
+		if (uiSize <= RGX_ZSBUFFER_WARM_POOL_MAX_SIZE)
+		{
+			/* Keep the mapping around in case the buffer is backed again soon */
+			_RGXZSBufferWarmTrim(psDevInfo, uiSize);
+
+			psZSBuffer->bIsWarm = IMG_TRUE;
+			psZSBuffer->ui32WarmSinceMs = OSClockms();
+			dllist_add_to_tail(&psDevInfo->sZSBufferWarmHead, &psZSBuffer->sWarmNode);
+			psDevInfo->ui32ZSBufferWarmCount++;
+			psDevInfo->uiZSBufferWarmSize += uiSize;
+
+			PVR_DPF((PVR_DBG_MESSAGE, "ZS Buffer [%p, ID=0x%08x]: Physical backing kept warm",
+										psZSBuffer,
+										psZSBuffer->ui32ZSBufferID));
+
+			psZSBuffer->bIsBacked = IMG_FALSE;
+			OSLockRelease(hLockZSBuffer);
+
+			return PVRSRV_OK;
+		}
+#endif
+
 		eError = DevmemIntUnmapPMR(psZSBuffer->psReservation);
 		if (eError != PVRSRV_OK)
 		{
@@ -5209,6 +5476,9 @@ PVRSRV_ERROR PVRSRVRGXKickTA3DKM(RGX_SERVER_RENDER_CONTEXT	*psRenderContext,
 		goto fail_acquirepowerlock;
 	}
 
+	/* Publish the TA and 3D kernel CCB commands with a single MTS kick */
+	RGXKCCBBatchBegin(psDevInfo);
+
 	if (ui32TACmdCount)
 	{
 		ui32TACmdOffset = RGXGetHostWriteOffsetCCB(FWCommonContextGetClientCCB(psRenderContext->sTAData.psServerCommonContext));
@@ -5418,6 +5688,7 @@ PVRSRV_ERROR PVRSRVRGXKickTA3DKM(RGX_SERVER_RENDER_CONTEXT	*psRenderContext,
 		                        RGX_HWPERF_KICK_TYPE2_3D);
 	}
 
+	RGXKCCBBatchEnd(psDevInfo);
 	PVRSRVPowerUnlock(psDevInfo->psDeviceNode);
 
 #if defined(NO_HARDWARE)
@@ -5533,6 +5804,7 @@ PVRSRV_ERROR PVRSRVRGXKickTA3DKM(RGX_SERVER_RENDER_CONTEXT	*psRenderContext,
 
 fail_3dsubmitcmd:
 fail_tasubmitcmd:
+	RGXKCCBBatchEnd(psDevInfo);
 	PVRSRVPowerUnlock(psDevInfo->psDeviceNode);
 fail_acquirepowerlock:
 fail_3dattachcleanupctls:
@@ -58,6 +58,9 @@ typedef struct _RGX_SERVER_RENDER_CONTEXT_ RGX_SERVER_RENDER_CONTEXT;
 typedef struct _RGX_FREELIST_ RGX_FREELIST;
 typedef struct _RGX_PMR_NODE_ RGX_PMR_NODE;
 
+/* Initial size of the per-device freelist ID lookup table */
+#define RGX_FREELIST_HASH_SIZE		32U
+
 /*****************************************************************************
  * The Design of Data Storage System for Render Targets                      *
  * ====================================================                      *
@@ -170,6 +173,15 @@ struct _RGX_FREELIST_ {
 	IMG_UINT32				ui32NumGrowReqByApp;	/* Total number of grow requests by Application */
 	IMG_UINT32				ui32NumGrowReqByFW;		/* Total Number of grow requests by Firmware */
 	IMG_UINT32				ui32NumHighPages;		/* High Mark of pages in the freelist */
+	IMG_UINT32				ui32NumPartialRenders;	/* FW grow requests that could not be satisfied, forcing a partial render */
+
+	/* Predictive growth */
+	IMG_UINT32				ui32PreGrowSteps;		/* Multiple of ui32GrowFLPages granted on the next FW grow request */
+	IMG_UINT32				ui32LastPreGrowPages;	/* Pages granted above ui32GrowFLPages by the last grow */
+	IMG_UINT32				ui32LastGrowReqTimeMs;	/* Time of the last FW grow request */
+	IMG_UINT32				ui32NumPreGrowPages;	/* Total pages granted ahead of demand */
+	IMG_UINT32				ui32NumPreGrowHits;		/* Pre-grows consumed before the next grow request */
+	IMG_UINT32				ui32NumPreGrowMisses;	/* Pre-grows left unused when the freelist went quiet */
 
 	IMG_PID					ownerPid;				/* Pid of the owner of the list */
 
@@ -215,6 +227,9 @@ typedef struct {
 	IMG_UINT32				ui32RefCount;
 	IMG_BOOL				bOnDemand;
 	IMG_BOOL				bIsBacked;
+	IMG_BOOL				bIsWarm;				/* Unbacked, but still mapped on sZSBufferWarmHead */
+	IMG_UINT32				ui32WarmSinceMs;		/* Time the buffer was put on the warm list */
+	DLLIST_NODE				sWarmNode;
 
 	IMG_UINT32				ui32NumReqByApp;		/* Number of Backing Requests from Application */
 	IMG_UINT32				ui32NumReqByFW;			/* Number of Backing Requests from Firmware */
@@ -303,6 +318,23 @@ void RGXProcessRequestZSBufferBacking(PVRSRV_RGXDEV_INFO *psDevInfo,
 void RGXProcessRequestZSBufferUnbacking(PVRSRV_RGXDEV_INFO *psDevInfo,
 										IMG_UINT32 ui32ZSBufferID);
 
+/*************************************************************************/ /*!
+@Function       RGXZSBufferWarmPoolTrim
+@Description    Releases the mappings of ZS buffers which have been unbacked
+                for longer than the warm pool timeout.
+@Input          psDevInfo    Device info
+*/ /**************************************************************************/
+void RGXZSBufferWarmPoolTrim(PVRSRV_RGXDEV_INFO *psDevInfo);
+
+/*************************************************************************/ /*!
+@Function       RGXZSBufferWarmPoolStatsPrint
+@Description    Prints the ZS buffer warm pool hit rate and the backing
+                latency histogram.
+*/ /**************************************************************************/
+void RGXZSBufferWarmPoolStatsPrint(PVRSRV_RGXDEV_INFO *psDevInfo,
+                                   DUMPDEBUG_PRINTF_FUNC *pfnDumpDebugPrintf,
+                                   void *pvDumpDebugFile);
+
 /*
 	RGXGrowFreeList
 */
@@ -0,0 +1,466 @@
+/*************************************************************************/ /*!
+@File
+@Title          RGX TA/3D kick bridge entry point with lockless handle lookup
+@Copyright      Copyright (c) Imagination Technologies Ltd. All Rights Reserved
+@Description    Replacement for the generated RGXKickTA3D2 bridge wrapper
+                that looks handles up with PVRSRVLookupHandleLockless, so
+                concurrent kicks from several client threads do not contend
+                on the connection handle base lock. Only the handle lookup
+                differs from the generated wrapper; argument marshalling is
+                done by small helpers rather than copied out in full.
+                InitRGXTA3DKickBridge installs it over the generated entry,
+                which keeps the generated bridge sources unmodified.
+@License        Dual MIT/GPLv2
+
+The contents of this file are subject to the MIT license as set out below.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+Alternatively, the contents of this file may be used under the terms of
+the GNU General Public License Version 2 ("GPL") in which case the provisions
+of GPL are applicable instead of those above.
+
+If you wish to allow use of your version of this file only under the terms of
+GPL, and not to allow others to use your version of this file under the terms
+of the MIT license, indicate your decision by deleting the provisions above
+and replace them with the notice and other provisions required by GPL as set
+out in the file called "GPL-COPYING" included in this distribution. If you do
+not delete the provisions above, a recipient may use your version of this file
+under the terms of either the MIT license or GPL.
+
+This License is also included in this distribution in the file called
+"MIT-COPYING".
+
+EXCEPT AS OTHERWISE STATED IN A NEGOTIATED AGREEMENT: (A) THE SOFTWARE IS
+PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+PURPOSE AND NONINFRINGEMENT; AND (B) IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/ /**************************************************************************/
+
+#include "img_defs.h"
+
+#include "rgxta3d.h"
+
+#include "common_rgxta3d_bridge.h"
+
+#include "allocmem.h"
+#include "osfunc.h"
+#include "pvr_debug.h"
+#include "connection_server.h"
+#include "pvr_bridge.h"
+#include "srvcore.h"
+#include "handle.h"
+
+/* Array arguments copied in from user space. They are carved out of the
+ * remainder of the bridge input buffer when they fit, otherwise out of a
+ * separate allocation, exactly as the generated wrappers do. The first
+ * copy failure is latched in eError so the caller checks it only once.
+ */
+typedef struct _KICK_ARRAY_ARGS_
+{
+	IMG_BYTE *pui8Buffer;
+	IMG_UINT32 ui32NextOffset;
+	PVRSRV_ERROR eError;
+} KICK_ARRAY_ARGS;
+
+static void *_KickArrayCarve(KICK_ARRAY_ARGS *psArgs, size_t uiSize)
+{
+	void *pvArray;
+
+	if (uiSize == 0)
+	{
+		return NULL;
+	}
+
+	pvArray = IMG_OFFSET_ADDR(psArgs->pui8Buffer, psArgs->ui32NextOffset);
+	psArgs->ui32NextOffset += uiSize;
+
+	return pvArray;
+}
+
+/* Zeroed space for looked up pointers, so a partial lookup unwinds cleanly */
+static void *_KickArrayReserve(KICK_ARRAY_ARGS *psArgs, size_t uiSize)
+{
+	void *pvArray = _KickArrayCarve(psArgs, uiSize);
+
+	if (pvArray != NULL)
+	{
+		OSCachedMemSet(pvArray, 0, uiSize);
+	}
+
+	return pvArray;
+}
+
+static void *_KickArrayCopyIn(KICK_ARRAY_ARGS *psArgs,
+			      const void __user *pvUserArray, size_t uiSize)
+{
+	void *pvArray = _KickArrayCarve(psArgs, uiSize);
+
+	if (pvArray != NULL && psArgs->eError == PVRSRV_OK &&
+	    OSCopyFromUser(NULL, pvArray, pvUserArray, uiSize) != PVRSRV_OK)
+	{
+		psArgs->eError = PVRSRV_ERROR_INVALID_PARAMS;
+	}
+
+	return pvArray;
+}
+
+/* Handles are looked up in order and the first failure stops the lookup, so
+ * every entry after a failed one is still NULL and is skipped on release.
+ */
+static PVRSRV_ERROR _KickLookupHandles(PVRSRV_HANDLE_BASE *psBase, void **ppvData,
+				       const IMG_HANDLE *phHandles, IMG_UINT32 ui32Count,
+				       PVRSRV_HANDLE_TYPE eType)
+{
+	IMG_UINT32 i;
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		PVRSRV_ERROR eError =
+		    PVRSRVLookupHandleLockless(psBase, &ppvData[i], phHandles[i], eType);
+		if (unlikely(eError != PVRSRV_OK))
+		{
+			return eError;
+		}
+	}
+
+	return PVRSRV_OK;
+}
+
+static void _KickReleaseHandles(PVRSRV_HANDLE_BASE *psBase, void *const *ppvData,
+				const IMG_HANDLE *phHandles, IMG_UINT32 ui32Count,
+				PVRSRV_HANDLE_TYPE eType)
+{
+	IMG_UINT32 i;
+
+	if (ppvData == NULL || phHandles == NULL)
+	{
+		return;
+	}
+
+	for (i = 0; i < ui32Count; i++)
+	{
+		if (ppvData[i] != NULL)
+		{
+			PVRSRVReleaseHandleLockless(psBase, phHandles[i], eType);
+		}
+	}
+}
+
+static size_t
+PVRSRVBridgeRGXKickTA3D2Lockless(IMG_UINT32 ui32DispatchTableEntry,
+				 IMG_UINT8 * psRGXKickTA3D2IN_UI8,
+				 IMG_UINT8 * psRGXKickTA3D2OUT_UI8,
+				 CONNECTION_DATA * psConnection)
+{
+	PVRSRV_BRIDGE_IN_RGXKICKTA3D2 *psIN =
+	    (PVRSRV_BRIDGE_IN_RGXKICKTA3D2 *) IMG_OFFSET_ADDR(psRGXKickTA3D2IN_UI8, 0);
+	PVRSRV_BRIDGE_OUT_RGXKICKTA3D2 *psOUT =
+	    (PVRSRV_BRIDGE_OUT_RGXKICKTA3D2 *) IMG_OFFSET_ADDR(psRGXKickTA3D2OUT_UI8, 0);
+	PVRSRV_HANDLE_BASE *psBase = psConnection->psHandleBase;
+	const IMG_UINT32 ui32TAFenceCount = psIN->ui32ClientTAFenceCount;
+	const IMG_UINT32 ui32TAUpdateCount = psIN->ui32ClientTAUpdateCount;
+	const IMG_UINT32 ui323DUpdateCount = psIN->ui32Client3DUpdateCount;
+	const IMG_UINT32 ui32SyncPMRCount = psIN->ui32SyncPMRCount;
+
+	KICK_ARRAY_ARGS sArgs = { NULL, 0, PVRSRV_OK };
+	IMG_BOOL bHaveEnoughSpace = IMG_FALSE;
+	IMG_UINT32 ui32BufferSize = 0;
+	IMG_UINT64 ui64BufferSize;
+	PVRSRV_ERROR eError;
+
+	RGX_SERVER_RENDER_CONTEXT *psRenderContextInt = NULL;
+	SYNC_PRIMITIVE_BLOCK **psClientTAFenceSyncPrimBlockInt = NULL;
+	IMG_HANDLE *hClientTAFenceSyncPrimBlockInt2 = NULL;
+	IMG_UINT32 *ui32ClientTAFenceSyncOffsetInt = NULL;
+	IMG_UINT32 *ui32ClientTAFenceValueInt = NULL;
+	SYNC_PRIMITIVE_BLOCK **psClientTAUpdateSyncPrimBlockInt = NULL;
+	IMG_HANDLE *hClientTAUpdateSyncPrimBlockInt2 = NULL;
+	IMG_UINT32 *ui32ClientTAUpdateSyncOffsetInt = NULL;
+	IMG_UINT32 *ui32ClientTAUpdateValueInt = NULL;
+	SYNC_PRIMITIVE_BLOCK **psClient3DUpdateSyncPrimBlockInt = NULL;
+	IMG_HANDLE *hClient3DUpdateSyncPrimBlockInt2 = NULL;
+	IMG_UINT32 *ui32Client3DUpdateSyncOffsetInt = NULL;
+	IMG_UINT32 *ui32Client3DUpdateValueInt = NULL;
+	SYNC_PRIMITIVE_BLOCK *psPRFenceUFOSyncPrimBlockInt = NULL;
+	IMG_CHAR *uiUpdateFenceNameInt = NULL;
+	IMG_CHAR *uiUpdateFenceName3DInt = NULL;
+	IMG_BYTE *ui8TACmdInt = NULL;
+	IMG_BYTE *ui83DPRCmdInt = NULL;
+	IMG_BYTE *ui83DCmdInt = NULL;
+	RGX_KM_HW_RT_DATASET *psKMHWRTDataSetInt = NULL;
+	RGX_ZSBUFFER_DATA *psZSBufferInt = NULL;
+	RGX_ZSBUFFER_DATA *psMSAAScratchBufferInt = NULL;
+	IMG_UINT32 *ui32SyncPMRFlagsInt = NULL;
+	PMR **psSyncPMRsInt = NULL;
+	IMG_HANDLE *hSyncPMRsInt2 = NULL;
+
+	if (unlikely(ui32TAFenceCount > PVRSRV_MAX_SYNCS ||
+		     ui32TAUpdateCount > PVRSRV_MAX_SYNCS ||
+		     ui323DUpdateCount > PVRSRV_MAX_SYNCS ||
+		     psIN->ui32TACmdSize > RGXFWIF_DM_INDEPENDENT_KICK_CMD_SIZE ||
+		     psIN->ui323DPRCmdSize > RGXFWIF_DM_INDEPENDENT_KICK_CMD_SIZE ||
+		     psIN->ui323DCmdSize > RGXFWIF_DM_INDEPENDENT_KICK_CMD_SIZE ||
+		     ui32SyncPMRCount > PVRSRV_MAX_SYNCS))
+	{
+		eError = PVRSRV_ERROR_BRIDGE_ARRAY_SIZE_TOO_BIG;
+		goto RGXKickTA3D2_exit;
+	}
+
+	ui64BufferSize =
+	    ((IMG_UINT64) ui32TAFenceCount + ui32TAUpdateCount + ui323DUpdateCount) *
+	    (sizeof(SYNC_PRIMITIVE_BLOCK *) + sizeof(IMG_HANDLE) + 2 * sizeof(IMG_UINT32)) +
+	    ((IMG_UINT64) 2 * PVRSRV_SYNC_NAME_LENGTH * sizeof(IMG_CHAR)) +
+	    ((IMG_UINT64) psIN->ui32TACmdSize + psIN->ui323DPRCmdSize + psIN->ui323DCmdSize) +
+	    ((IMG_UINT64) ui32SyncPMRCount *
+	     (sizeof(IMG_UINT32) + sizeof(PMR *) + sizeof(IMG_HANDLE)));
+
+	if (ui64BufferSize > IMG_UINT32_MAX)
+	{
+		eError = PVRSRV_ERROR_BRIDGE_BUFFER_TOO_SMALL;
+		goto RGXKickTA3D2_exit;
+	}
+
+	ui32BufferSize = (IMG_UINT32) ui64BufferSize;
+
+	if (ui32BufferSize != 0)
+	{
+		/* Try to use remainder of input buffer for copies if possible, word-aligned for safety. */
+		IMG_UINT32 ui32InBufferOffset = PVR_ALIGN(sizeof(*psIN), sizeof(unsigned long));
+		IMG_UINT32 ui32InBufferExcessSize =
+		    ui32InBufferOffset >=
+		    PVRSRV_MAX_BRIDGE_IN_SIZE ? 0 : PVRSRV_MAX_BRIDGE_IN_SIZE - ui32InBufferOffset;
+
+		bHaveEnoughSpace = ui32BufferSize <= ui32InBufferExcessSize;
+		if (bHaveEnoughSpace)
+		{
+			sArgs.pui8Buffer = &((IMG_BYTE *) (void *)psIN)[ui32InBufferOffset];
+		}
+		else
+		{
+			sArgs.pui8Buffer = OSAllocMemNoStats(ui32BufferSize);
+			if (!sArgs.pui8Buffer)
+			{
+				eError = PVRSRV_ERROR_OUT_OF_MEMORY;
+				goto RGXKickTA3D2_exit;
+			}
+		}
+	}
+
+	psClientTAFenceSyncPrimBlockInt =
+	    _KickArrayReserve(&sArgs, ui32TAFenceCount * sizeof(SYNC_PRIMITIVE_BLOCK *));
+	hClientTAFenceSyncPrimBlockInt2 =
+	    _KickArrayCopyIn(&sArgs, psIN->phClientTAFenceSyncPrimBlock,
+			     ui32TAFenceCount * sizeof(IMG_HANDLE));
+	ui32ClientTAFenceSyncOffsetInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32ClientTAFenceSyncOffset,
+			     ui32TAFenceCount * sizeof(IMG_UINT32));
+	ui32ClientTAFenceValueInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32ClientTAFenceValue,
+			     ui32TAFenceCount * sizeof(IMG_UINT32));
+
+	psClientTAUpdateSyncPrimBlockInt =
+	    _KickArrayReserve(&sArgs, ui32TAUpdateCount * sizeof(SYNC_PRIMITIVE_BLOCK *));
+	hClientTAUpdateSyncPrimBlockInt2 =
+	    _KickArrayCopyIn(&sArgs, psIN->phClientTAUpdateSyncPrimBlock,
+			     ui32TAUpdateCount * sizeof(IMG_HANDLE));
+	ui32ClientTAUpdateSyncOffsetInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32ClientTAUpdateSyncOffset,
+			     ui32TAUpdateCount * sizeof(IMG_UINT32));
+	ui32ClientTAUpdateValueInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32ClientTAUpdateValue,
+			     ui32TAUpdateCount * sizeof(IMG_UINT32));
+
+	psClient3DUpdateSyncPrimBlockInt =
+	    _KickArrayReserve(&sArgs, ui323DUpdateCount * sizeof(SYNC_PRIMITIVE_BLOCK *));
+	hClient3DUpdateSyncPrimBlockInt2 =
+	    _KickArrayCopyIn(&sArgs, psIN->phClient3DUpdateSyncPrimBlock,
+			     ui323DUpdateCount * sizeof(IMG_HANDLE));
+	ui32Client3DUpdateSyncOffsetInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32Client3DUpdateSyncOffset,
+			     ui323DUpdateCount * sizeof(IMG_UINT32));
+	ui32Client3DUpdateValueInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32Client3DUpdateValue,
+			     ui323DUpdateCount * sizeof(IMG_UINT32));
+
+	uiUpdateFenceNameInt =
+	    _KickArrayCopyIn(&sArgs, psIN->puiUpdateFenceName,
+			     PVRSRV_SYNC_NAME_LENGTH * sizeof(IMG_CHAR));
+	uiUpdateFenceName3DInt =
+	    _KickArrayCopyIn(&sArgs, psIN->puiUpdateFenceName3D,
+			     PVRSRV_SYNC_NAME_LENGTH * sizeof(IMG_CHAR));
+
+	ui8TACmdInt = _KickArrayCopyIn(&sArgs, psIN->pui8TACmd, psIN->ui32TACmdSize);
+	ui83DPRCmdInt = _KickArrayCopyIn(&sArgs, psIN->pui83DPRCmd, psIN->ui323DPRCmdSize);
+	ui83DCmdInt = _KickArrayCopyIn(&sArgs, psIN->pui83DCmd, psIN->ui323DCmdSize);
+
+	ui32SyncPMRFlagsInt =
+	    _KickArrayCopyIn(&sArgs, psIN->pui32SyncPMRFlags,
+			     ui32SyncPMRCount * sizeof(IMG_UINT32));
+	psSyncPMRsInt = _KickArrayReserve(&sArgs, ui32SyncPMRCount * sizeof(PMR *));
+	hSyncPMRsInt2 =
+	    _KickArrayCopyIn(&sArgs, psIN->phSyncPMRs, ui32SyncPMRCount * sizeof(IMG_HANDLE));
+
+	eError = sArgs.eError;
+	if (unlikely(eError != PVRSRV_OK))
+	{
+		goto RGXKickTA3D2_exit;
+	}
+
+	uiUpdateFenceNameInt[PVRSRV_SYNC_NAME_LENGTH - 1] = '\0';
+	uiUpdateFenceName3DInt[PVRSRV_SYNC_NAME_LENGTH - 1] = '\0';
+
+	/* Kick hot path: look up handles without the handle base lock. */
+	eError = _KickLookupHandles(psBase, (void **)&psRenderContextInt,
+				    &psIN->hRenderContext, 1,
+				    PVRSRV_HANDLE_TYPE_RGX_SERVER_RENDER_CONTEXT);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)psClientTAFenceSyncPrimBlockInt,
+				    hClientTAFenceSyncPrimBlockInt2, ui32TAFenceCount,
+				    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)psClientTAUpdateSyncPrimBlockInt,
+				    hClientTAUpdateSyncPrimBlockInt2, ui32TAUpdateCount,
+				    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)psClient3DUpdateSyncPrimBlockInt,
+				    hClient3DUpdateSyncPrimBlockInt2, ui323DUpdateCount,
+				    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)&psPRFenceUFOSyncPrimBlockInt,
+				    &psIN->hPRFenceUFOSyncPrimBlock, 1,
+				    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)&psKMHWRTDataSetInt,
+				    &psIN->hKMHWRTDataSet, psIN->hKMHWRTDataSet ? 1 : 0,
+				    PVRSRV_HANDLE_TYPE_RGX_KM_HW_RT_DATASET);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)&psZSBufferInt,
+				    &psIN->hZSBuffer, psIN->hZSBuffer ? 1 : 0,
+				    PVRSRV_HANDLE_TYPE_RGX_FWIF_ZSBUFFER);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)&psMSAAScratchBufferInt,
+				    &psIN->hMSAAScratchBuffer, psIN->hMSAAScratchBuffer ? 1 : 0,
+				    PVRSRV_HANDLE_TYPE_RGX_FWIF_ZSBUFFER);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+	eError = _KickLookupHandles(psBase, (void **)psSyncPMRsInt,
+				    hSyncPMRsInt2, ui32SyncPMRCount,
+				    PVRSRV_HANDLE_TYPE_PHYSMEM_PMR);
+	PVR_GOTO_IF_ERROR(eError, RGXKickTA3D2_exit);
+
+	eError =
+	    PVRSRVRGXKickTA3DKM(psRenderContextInt,
+				ui32TAFenceCount,
+				psClientTAFenceSyncPrimBlockInt,
+				ui32ClientTAFenceSyncOffsetInt,
+				ui32ClientTAFenceValueInt,
+				ui32TAUpdateCount,
+				psClientTAUpdateSyncPrimBlockInt,
+				ui32ClientTAUpdateSyncOffsetInt,
+				ui32ClientTAUpdateValueInt,
+				ui323DUpdateCount,
+				psClient3DUpdateSyncPrimBlockInt,
+				ui32Client3DUpdateSyncOffsetInt,
+				ui32Client3DUpdateValueInt,
+				psPRFenceUFOSyncPrimBlockInt,
+				psIN->ui32PRFenceUFOSyncOffset,
+				psIN->ui32PRFenceValue,
+				psIN->hCheckFence,
+				psIN->hUpdateTimeline,
+				&psOUT->hUpdateFence,
+				uiUpdateFenceNameInt,
+				psIN->hCheckFence3D,
+				psIN->hUpdateTimeline3D,
+				&psOUT->hUpdateFence3D,
+				uiUpdateFenceName3DInt,
+				psIN->ui32TACmdSize,
+				ui8TACmdInt,
+				psIN->ui323DPRCmdSize,
+				ui83DPRCmdInt,
+				psIN->ui323DCmdSize,
+				ui83DCmdInt,
+				psIN->ui32ExtJobRef,
+				psIN->bbKickTA,
+				psIN->bbKickPR,
+				psIN->bbKick3D,
+				psIN->bbAbort,
+				psIN->ui32PDumpFlags,
+				psKMHWRTDataSetInt,
+				psZSBufferInt,
+				psMSAAScratchBufferInt,
+				ui32SyncPMRCount,
+				ui32SyncPMRFlagsInt,
+				psSyncPMRsInt,
+				psIN->ui32RenderTargetSize,
+				psIN->ui32NumberOfDrawCalls,
+				psIN->ui32NumberOfIndices,
+				psIN->ui32NumberOfMRTs, psIN->ui64Deadline);
+
+RGXKickTA3D2_exit:
+
+	/* Unreference the previously looked up handles */
+	_KickReleaseHandles(psBase, (void **)&psRenderContextInt, &psIN->hRenderContext, 1,
+			    PVRSRV_HANDLE_TYPE_RGX_SERVER_RENDER_CONTEXT);
+	_KickReleaseHandles(psBase, (void **)psClientTAFenceSyncPrimBlockInt,
+			    hClientTAFenceSyncPrimBlockInt2, ui32TAFenceCount,
+			    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	_KickReleaseHandles(psBase, (void **)psClientTAUpdateSyncPrimBlockInt,
+			    hClientTAUpdateSyncPrimBlockInt2, ui32TAUpdateCount,
+			    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	_KickReleaseHandles(psBase, (void **)psClient3DUpdateSyncPrimBlockInt,
+			    hClient3DUpdateSyncPrimBlockInt2, ui323DUpdateCount,
+			    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	_KickReleaseHandles(psBase, (void **)&psPRFenceUFOSyncPrimBlockInt,
+			    &psIN->hPRFenceUFOSyncPrimBlock, 1,
+			    PVRSRV_HANDLE_TYPE_SYNC_PRIMITIVE_BLOCK);
+	_KickReleaseHandles(psBase, (void **)&psKMHWRTDataSetInt, &psIN->hKMHWRTDataSet, 1,
+			    PVRSRV_HANDLE_TYPE_RGX_KM_HW_RT_DATASET);
+	_KickReleaseHandles(psBase, (void **)&psZSBufferInt, &psIN->hZSBuffer, 1,
+			    PVRSRV_HANDLE_TYPE_RGX_FWIF_ZSBUFFER);
+	_KickReleaseHandles(psBase, (void **)&psMSAAScratchBufferInt,
+			    &psIN->hMSAAScratchBuffer, 1, PVRSRV_HANDLE_TYPE_RGX_FWIF_ZSBUFFER);
+	_KickReleaseHandles(psBase, (void **)psSyncPMRsInt, hSyncPMRsInt2, ui32SyncPMRCount,
+			    PVRSRV_HANDLE_TYPE_PHYSMEM_PMR);
+
+	/* Allocated space should be equal to the last updated offset */
+#ifdef PVRSRV_NEED_PVR_ASSERT
+	if (eError == PVRSRV_OK)
+		PVR_ASSERT(ui32BufferSize == sArgs.ui32NextOffset);
+#endif /* PVRSRV_NEED_PVR_ASSERT */
+
+	if (!bHaveEnoughSpace && sArgs.pui8Buffer)
+		OSFreeMemNoStats(sArgs.pui8Buffer);
+
+	psOUT->eError = eError;
+
+	return offsetof(PVRSRV_BRIDGE_OUT_RGXKICKTA3D2, eError);
+}
+
+PVRSRV_ERROR InitRGXTA3DKickBridge(void);
+
+/*
+ * Replace the generated RGXKickTA3D2 entry with the lockless one. Must be
+ * called after InitRGXTA3DBridge. DeinitRGXTA3DBridge clears the entry.
+ */
+PVRSRV_ERROR InitRGXTA3DKickBridge(void)
+{
+	UnsetDispatchTableEntry(PVRSRV_BRIDGE_RGXTA3D, PVRSRV_BRIDGE_RGXTA3D_RGXKICKTA3D2);
+
+	SetDispatchTableEntry(PVRSRV_BRIDGE_RGXTA3D, PVRSRV_BRIDGE_RGXTA3D_RGXKICKTA3D2,
+			      PVRSRVBridgeRGXKickTA3D2Lockless, NULL,
+			      sizeof(PVRSRV_BRIDGE_IN_RGXKICKTA3D2),
+			      sizeof(PVRSRV_BRIDGE_OUT_RGXKICKTA3D2));
+
+	return PVRSRV_OK;
+}
@@ -93,12 +93,22 @@ static IMG_UINT32 WorkEstHashFuncRay(size_t uKeySize, void *pKey, IMG_UINT32 uHa
 	return ui32HashKey;
 }
 
+static IMG_UINT32 WorkEstFeaturesRay(const RGX_WORKLOAD *psWorkload, IMG_UINT32 *aui32Features)
+{
+	aui32Features[0] = _WorkEstClampFeature(psWorkload->sRay.ui32DispatchSize >> 10);
+	aui32Features[1] = _WorkEstClampFeature(psWorkload->sRay.ui32AccStructSize >> 10);
+	aui32Features[2] = WORKLOAD_MODEL_BIAS_FEATURE;
+
+	return 3;
+}
+
 void WorkEstInitRay(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEstData)
 {
 	_WorkEstInit(psDevInfo,
 		&psWorkEstData->uWorkloadMatchingData.sRay.sDataRDM,
 		(HASH_FUNC *)WorkEstHashFuncRay,
-		(HASH_KEY_COMP *)WorkEstHashCompareRay);
+		(HASH_KEY_COMP *)WorkEstHashCompareRay,
+		WorkEstFeaturesRay);
 }
 
 void WorkEstDeInitRay(PVRSRV_RGXDEV_INFO *psDevInfo, WORKEST_HOST_DATA *psWorkEstData)